@@ -0,0 +1,95 @@
+#include "CompactFleet.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Tick cost of a mostly idle fleet with and without active-set tracking.
+//
+//   active_set [idle-percent] [minutes]
+//
+// For each fleet size, the first (100 - idle)% of machines run back-to-back
+// Quick Wash cycles and the rest stay Idle with the door open. The fleet is
+// stepped in 1 s ticks for the given simulated minutes, once updating every
+// machine and once updating only the active list.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Run {
+    double nanosPerTick = 0.0;
+    double meanActive = 0.0;
+};
+
+Run runFleet(size_t machines, size_t cycling, long ticks, bool tracking) {
+    CompactFleet fleet(machines);
+    fleet.setActiveTracking(tracking);
+
+    double activeSum = 0.0;
+    auto begin = Clock::now();
+    for (long tick = 0; tick < ticks; tick++) {
+        for (CompactFleet::MachineId id = 0; id < cycling; id++) {
+            State state = fleet.getCurrentState(id);
+            if (state == State::Idle || state == State::Completed) {
+                fleet.closeDoor(id);
+                fleet.selectMode(id, 0);
+                fleet.setLoad(id, 3.0f);
+            } else if (state == State::Ready) {
+                fleet.start(id);
+            }
+        }
+        fleet.tick(1.0f);
+        activeSum += static_cast<double>(fleet.getActiveCount());
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    Run run;
+    run.nanosPerTick = seconds / static_cast<double>(ticks) * 1e9;
+    run.meanActive = activeSum / static_cast<double>(ticks);
+    return run;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    double idlePercent = 95.0;
+    double minutes = 60.0;
+    try {
+        if (argc > 1) {
+            idlePercent = std::stod(argv[1]);
+        }
+        if (argc > 2) {
+            minutes = std::stod(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: active_set [idle-percent] [minutes]\n";
+        return 1;
+    }
+    if (idlePercent < 0.0 || idlePercent > 100.0 || minutes <= 0.0) {
+        std::cerr << "usage: active_set [idle-percent] [minutes]\n";
+        return 1;
+    }
+
+    long ticks = static_cast<long>(minutes * 60.0);
+    std::cout << idlePercent << "% idle, " << minutes << " simulated minutes in 1 s ticks\n";
+    std::cout << std::setw(10) << "machines" << std::setw(10) << "active"
+              << std::setw(14) << "scan us/tick" << std::setw(14) << "list us/tick"
+              << std::setw(10) << "speedup" << std::setw(16) << "ns/active" << "\n";
+
+    for (size_t machines : {10000u, 100000u, 1000000u}) {
+        size_t cycling = static_cast<size_t>(static_cast<double>(machines) * (100.0 - idlePercent) / 100.0);
+        Run scan = runFleet(machines, cycling, ticks, false);
+        Run list = runFleet(machines, cycling, ticks, true);
+
+        std::cout << std::fixed << std::setprecision(0)
+                  << std::setw(10) << machines << std::setw(10) << list.meanActive
+                  << std::setprecision(1)
+                  << std::setw(14) << scan.nanosPerTick / 1e3 << std::setw(14) << list.nanosPerTick / 1e3
+                  << std::setw(9) << scan.nanosPerTick / list.nanosPerTick << "x"
+                  << std::setw(16) << (list.meanActive > 0.0 ? list.nanosPerTick / list.meanActive : 0.0)
+                  << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "BatchStateMachine.hpp"
+#include "CounterRng.hpp"
+#include "StateMachine.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Cost of stepping a fleet's state machines one by one versus in one pass.
+//
+//   batch_step [machines] [steps]
+//
+// For each event density a set of random event patterns is generated up
+// front and replayed step after step, so the timed loops do nothing but
+// apply transitions. "objects" calls StateMachine::transition per machine
+// that has an event; "scalar" and the selected kernel run
+// BatchStateMachine's transition pass over the whole fleet. No actions are
+// registered, so this is the table lookup and change list alone.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using MachineId = BatchStateMachine::MachineId;
+
+constexpr size_t PATTERNS = 16;
+
+std::vector<std::vector<uint8_t>> makePatterns(size_t machines, double density) {
+    CounterRng rng(45, static_cast<uint64_t>(density * 1000.0));
+    uint64_t threshold = static_cast<uint64_t>(density * 1e6);
+    std::vector<std::vector<uint8_t>> patterns(PATTERNS, std::vector<uint8_t>(machines, BatchStateMachine::NO_EVENT));
+    for (auto& pattern : patterns) {
+        for (uint8_t& event : pattern) {
+            if (rng.next() % 1000000 < threshold) {
+                event = static_cast<uint8_t>(rng.next() % EVENT_TYPE_COUNT);
+            }
+        }
+    }
+    return patterns;
+}
+
+double runObjects(const std::vector<std::vector<uint8_t>>& patterns, size_t machines, long steps, size_t& fired) {
+    std::vector<StateMachine> fleet(machines);
+    fired = 0;
+    auto begin = Clock::now();
+    for (long step = 0; step < steps; step++) {
+        const std::vector<uint8_t>& events = patterns[static_cast<size_t>(step) % PATTERNS];
+        for (size_t id = 0; id < machines; id++) {
+            if (events[id] != BatchStateMachine::NO_EVENT && fleet[id].transition(static_cast<EventType>(events[id]))) {
+                fired++;
+            }
+        }
+    }
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+template <typename Kernel>
+double runKernel(const std::vector<std::vector<uint8_t>>& patterns, size_t machines, long steps, size_t& fired,
+                 Kernel kernel) {
+    std::vector<uint8_t> states(machines, static_cast<uint8_t>(State::Idle));
+    std::vector<uint8_t> events(machines);
+    std::vector<MachineId> changed(machines);
+    std::vector<uint8_t> previous(machines);
+    fired = 0;
+    double seconds = 0.0;
+    for (long step = 0; step < steps; step++) {
+        // The copy stands in for posting and is left out of the timing.
+        std::memcpy(events.data(), patterns[static_cast<size_t>(step) % PATTERNS].data(), machines);
+        auto begin = Clock::now();
+        fired += kernel(states.data(), events.data(), machines, changed.data(), previous.data());
+        seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+    }
+    return seconds;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 100000;
+    long steps = 200;
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            steps = std::stol(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: batch_step [machines] [steps]\n";
+        return 1;
+    }
+    if (machines == 0 || steps <= 0) {
+        std::cerr << "usage: batch_step [machines] [steps]\n";
+        return 1;
+    }
+
+    double machineSteps = static_cast<double>(machines) * static_cast<double>(steps);
+    std::cout << machines << " machines, " << steps << " steps, kernel " << BatchStateMachine::kernelName() << "\n";
+    std::cout << std::setw(9) << "events" << std::setw(16) << "objects ns/m"
+              << std::setw(16) << "scalar ns/m" << std::setw(16) << "kernel ns/m"
+              << std::setw(10) << "speedup" << "\n";
+
+    for (double density : {0.0, 0.01, 0.1, 0.5, 1.0}) {
+        auto patterns = makePatterns(machines, density);
+        size_t objectFired = 0;
+        size_t scalarFired = 0;
+        size_t kernelFired = 0;
+        double objects = runObjects(patterns, machines, steps, objectFired);
+        double scalar = runKernel(patterns, machines, steps, scalarFired, BatchStateMachine::transitionScalar);
+        double kernel = runKernel(patterns, machines, steps, kernelFired, BatchStateMachine::transitionKernel);
+        if (objectFired != scalarFired || objectFired != kernelFired) {
+            std::cerr << "transition counts differ: " << objectFired << " " << scalarFired << " " << kernelFired << "\n";
+            return 1;
+        }
+
+        std::cout << std::fixed << std::setprecision(0) << std::setw(8) << density * 100.0 << "%"
+                  << std::setprecision(2)
+                  << std::setw(16) << objects / machineSteps * 1e9
+                  << std::setw(16) << scalar / machineSteps * 1e9
+                  << std::setw(16) << kernel / machineSteps * 1e9
+                  << std::setprecision(1) << std::setw(9) << objects / kernel << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "CompactFleet.hpp"
+#include "Fleet.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Fleet checkpoint cost on the simulation thread and restore time.
+//
+//   checkpoint [machines] [path]
+//
+// Every machine is put mid-cycle first. For Fleet it times a synchronous
+// saveCheckpoint(), the simulation thread's share of a background capture()
+// (the call itself plus the extra cost of the ticks that overlap the worker),
+// and restoring into an existing and into an empty fleet. For CompactFleet
+// it times saving and restoring the same checkpoint.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisSince(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+template<typename Fn>
+double timeMillis(Fn&& fn) {
+    auto begin = Clock::now();
+    fn();
+    return millisSince(begin);
+}
+
+void startCycles(Fleet& fleet) {
+    for (size_t id = 0; id < fleet.size(); id++) {
+        WashingMachine& machine = fleet.getMachine(id);
+        machine.closeDoor();
+        machine.selectMode(static_cast<int>(id % 4));
+        machine.setLoad(3.0f);
+    }
+    fleet.tick(0.1f);
+    for (size_t id = 0; id < fleet.size(); id++) {
+        fleet.getMachine(id).start();
+    }
+    for (int t = 0; t < 90; t++) {
+        fleet.tick(1.0f);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 100000;
+    std::string path = "checkpoint_bench.bin";
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            path = argv[2];
+        }
+    } catch (...) {
+        std::cerr << "usage: checkpoint [machines] [path]\n";
+        return 1;
+    }
+    if (machines == 0) {
+        std::cerr << "usage: checkpoint [machines] [path]\n";
+        return 1;
+    }
+
+    MachineCore::defaultModes();
+    Fleet fleet(machines);
+    startCycles(fleet);
+
+    std::vector<uint8_t> buffer;
+    fleet.saveCheckpoint(buffer);
+    double save = timeMillis([&] { fleet.saveCheckpoint(buffer); });
+
+    const int ticks = 10;
+    double plainTicks = timeMillis([&] {
+        for (int t = 0; t < ticks; t++) {
+            fleet.tick(1.0f);
+        }
+    });
+
+    BackgroundCheckpointer checkpointer;
+    checkpointer.capture(fleet, path);
+    checkpointer.waitIdle();
+    double capture = 0.0;
+    double overlappedTicks = 0.0;
+    double persisted = timeMillis([&] {
+        capture = timeMillis([&] { checkpointer.capture(fleet, path); });
+        overlappedTicks = timeMillis([&] {
+            for (int t = 0; t < ticks; t++) {
+                fleet.tick(1.0f);
+            }
+        });
+        checkpointer.waitIdle();
+    });
+    std::remove(path.c_str());
+
+    fleet.saveCheckpoint(buffer);
+    double restoreExisting = timeMillis([&] { fleet.restoreCheckpoint(buffer); });
+    double restoreEmpty = 0.0;
+    {
+        Fleet restored;
+        restoreEmpty = timeMillis([&] { restored.restoreCheckpoint(buffer); });
+    }
+
+    CompactFleet compact;
+    double compactRestoreEmpty = timeMillis([&] { compact.restoreCheckpoint(buffer); });
+    std::vector<uint8_t> compactBuffer;
+    compact.saveCheckpoint(compactBuffer);
+    double compactSave = timeMillis([&] { compact.saveCheckpoint(compactBuffer); });
+    double compactRestore = timeMillis([&] { compact.restoreCheckpoint(compactBuffer); });
+
+    std::cout << machines << " machines mid-cycle, " << buffer.size() / 1024 << " KiB checkpoint\n\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Fleet\n";
+    std::cout << "  saveCheckpoint               " << save << " ms\n";
+    std::cout << "  capture() call               " << capture << " ms\n";
+    std::cout << "  " << ticks << " ticks, plain              " << plainTicks << " ms\n";
+    std::cout << "  " << ticks << " ticks, during capture     " << overlappedTicks << " ms\n";
+    std::cout << "  capture to file written      " << persisted << " ms\n";
+    std::cout << "  restore into existing fleet  " << restoreExisting << " ms\n";
+    std::cout << "  restore into empty fleet     " << restoreEmpty << " ms\n";
+    std::cout << "CompactFleet\n";
+    std::cout << "  saveCheckpoint               " << compactSave << " ms\n";
+    std::cout << "  restore into existing fleet  " << compactRestore << " ms\n";
+    std::cout << "  restore into empty fleet     " << compactRestoreEmpty << " ms\n";
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include "ControlClient.hpp"
+#include "ControlServer.hpp"
+#include "Fleet.hpp"
+#include "Reactor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Load generator for the control socket. Each connection runs on its own
+// thread and keeps a window of pipelined requests in flight: it queues a
+// window, flushes once, and times each response against the send.
+//
+//   control_load [--socket PATH] [--connections N] [--depth D]
+//                [--seconds S] [--machines M] [--mix status|commands|mixed]
+//
+// Without --socket an in-process server with an M-machine fleet is started
+// on its own thread, ticking at 50 ms like `washing_machine --serve`.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string socketPath;
+    int connections = 4;
+    int depth = 256;
+    double seconds = 3.0;
+    size_t machines = 64;
+    std::string mix = "mixed";
+};
+
+struct ConnectionResult {
+    uint64_t completed = 0;
+    uint64_t errors = 0;
+    std::vector<uint32_t> latencies;
+};
+
+ControlRequest nextRequest(const Options& options, uint32_t seq, uint32_t machineId) {
+    static const ControlOp commandCycle[] = {
+        ControlOp::SetLoad, ControlOp::SelectMode, ControlOp::CloseDoor, ControlOp::OpenDoor
+    };
+    ControlOp op = ControlOp::GetStatus;
+    if (options.mix == "commands" || (options.mix == "mixed" && seq % 2 == 1)) {
+        op = commandCycle[(seq / 2) % 4];
+    }
+    if (op == ControlOp::SetLoad) {
+        return makeRequest(op, seq, machineId, 3.0f);
+    }
+    return makeRequest(op, seq, machineId, static_cast<uint32_t>(seq % 4));
+}
+
+void runConnection(const Options& options, int index, Clock::time_point deadline, ConnectionResult& result) {
+    ControlClient client;
+    if (!client.connect(options.socketPath)) {
+        result.errors++;
+        return;
+    }
+
+    std::vector<Clock::time_point> sentAt(static_cast<size_t>(options.depth));
+    uint32_t seq = 0;
+    ControlResponse response;
+
+    while (Clock::now() < deadline) {
+        uint32_t first = seq;
+        Clock::time_point now = Clock::now();
+        for (int i = 0; i < options.depth; i++) {
+            uint32_t machineId = static_cast<uint32_t>((static_cast<size_t>(index) * 7919 + seq) % options.machines);
+            client.queue(nextRequest(options, seq, machineId));
+            sentAt[seq - first] = now;
+            seq++;
+        }
+        if (!client.flush()) {
+            result.errors++;
+            return;
+        }
+
+        for (int i = 0; i < options.depth; i++) {
+            if (!client.receive(response)) {
+                result.errors++;
+                return;
+            }
+            if (response.kind == ControlFrameKind::StatusBatch) {
+                i--;
+                continue;
+            }
+            if (response.result != ControlResult::Ok) {
+                result.errors++;
+            }
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - sentAt[response.seq - first]);
+            result.latencies.push_back(static_cast<uint32_t>(std::min<int64_t>(latency.count(), UINT32_MAX)));
+            result.completed++;
+        }
+    }
+}
+
+double percentileMicros(std::vector<uint32_t>& values, double percentile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<long>(index), values.end());
+    return values[index] / 1000.0;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--socket") {
+            options.socketPath = value;
+        } else if (arg == "--connections") {
+            options.connections = std::max(1, std::stoi(value));
+        } else if (arg == "--depth") {
+            options.depth = std::max(1, std::stoi(value));
+        } else if (arg == "--seconds") {
+            options.seconds = std::stod(value);
+        } else if (arg == "--machines") {
+            options.machines = std::max<size_t>(1, std::stoul(value));
+        } else if (arg == "--mix") {
+            options.mix = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            std::cerr << "usage: control_load [--socket PATH] [--connections N] [--depth D] "
+                         "[--seconds S] [--machines M] [--mix status|commands|mixed]\n";
+            return 1;
+        }
+    } catch (...) {
+        std::cerr << "Invalid option value.\n";
+        return 1;
+    }
+
+    std::unique_ptr<Fleet> fleet;
+    std::unique_ptr<Reactor> reactor;
+    std::unique_ptr<ControlServer> server;
+    std::thread serverThread;
+    if (options.socketPath.empty()) {
+        options.socketPath = "/tmp/washing_machine_load." + std::to_string(getpid()) + ".sock";
+        fleet = std::make_unique<Fleet>(options.machines);
+        reactor = std::make_unique<Reactor>();
+        server = std::make_unique<ControlServer>(*reactor, *fleet);
+        if (!server->listen(options.socketPath)) {
+            std::cerr << "Failed to listen on " << options.socketPath << "\n";
+            return 1;
+        }
+        serverThread = std::thread([&] {
+            PeriodicTimer timer(std::chrono::milliseconds(50));
+            reactor->add(timer.getFd(), EPOLLIN, [&](uint32_t) {
+                uint64_t expirations = timer.readExpirations();
+                if (expirations > 0) {
+                    fleet->tick(0.05f * static_cast<float>(expirations));
+                    server->publishStatus();
+                }
+            });
+            reactor->run();
+            reactor->remove(timer.getFd());
+        });
+    }
+
+    std::vector<ConnectionResult> results(static_cast<size_t>(options.connections));
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.seconds));
+    for (int i = 0; i < options.connections; i++) {
+        threads.emplace_back(runConnection, std::cref(options), i, deadline, std::ref(results[static_cast<size_t>(i)]));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (serverThread.joinable()) {
+        reactor->stop();
+        serverThread.join();
+        server->close();
+    }
+
+    uint64_t completed = 0;
+    uint64_t errors = 0;
+    std::vector<uint32_t> latencies;
+    for (auto& result : results) {
+        completed += result.completed;
+        errors += result.errors;
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "connections " << options.connections << ", depth " << options.depth
+              << ", mix " << options.mix << ", " << options.machines << " machines\n";
+    std::cout << "requests    " << completed << " in " << elapsed << " s ("
+              << static_cast<double>(completed) / elapsed / 1e6 << " M/s), errors " << errors << "\n";
+    std::cout << "latency us  p50 " << percentileMicros(latencies, 50.0)
+              << "  p99 " << percentileMicros(latencies, 99.0)
+              << "  p99.9 " << percentileMicros(latencies, 99.9)
+              << "  max " << percentileMicros(latencies, 100.0) << "\n";
+    return errors == 0 ? 0 : 1;
+}
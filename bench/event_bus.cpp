@@ -0,0 +1,169 @@
+#include "Fleet.hpp"
+#include "ShardedFleet.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Per-machine event engines against one sharded fleet event bus.
+//
+//   event_bus [machines] [shards]
+//
+// Heap is glibc's allocated bytes (mmap'd blocks included) before and after
+// building each fleet. The tick section runs back-to-back Quick Wash cycles
+// in 1 s ticks for a simulated hour. The broadcast section sends CMD_SET_LOAD
+// to every tenth machine ("one floor") and times it together with the tick
+// that handles it, once through each machine's own queue and once as one
+// batch submission on the bus.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo info = mallinfo();
+    return static_cast<size_t>(info.uordblks) + static_cast<size_t>(info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+double seconds(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+template <typename Restart, typename Tick>
+double runCycles(size_t machines, long ticks, Restart restart, Tick tick) {
+    auto begin = Clock::now();
+    for (long t = 0; t < ticks; t++) {
+        for (size_t id = 0; id < machines; id++) {
+            restart(id);
+        }
+        tick();
+    }
+    return seconds(begin);
+}
+
+void restartCore(MachineCore& core) {
+    State state = core.getCurrentState();
+    if (state == State::Idle || state == State::Completed) {
+        core.closeDoor();
+        core.selectMode(0);
+        core.setLoad(3.0f);
+    } else if (state == State::Ready) {
+        core.start();
+    }
+}
+
+void restartMachine(WashingMachine& machine) {
+    State state = machine.getCurrentState();
+    if (state == State::Idle || state == State::Completed) {
+        machine.closeDoor();
+        machine.selectMode(0);
+        machine.setLoad(3.0f);
+    } else if (state == State::Ready) {
+        machine.start();
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 10000;
+    size_t shards = 8;
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            shards = std::stoul(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: event_bus [machines] [shards]\n";
+        return 1;
+    }
+    if (machines == 0 || shards == 0) {
+        std::cerr << "usage: event_bus [machines] [shards]\n";
+        return 1;
+    }
+
+    const long ticks = 3600;
+    const int broadcasts = 200;
+    double perMachine = 1.0 / static_cast<double>(machines);
+    double machineTicks = static_cast<double>(machines) * static_cast<double>(ticks);
+
+    MachineCore::defaultModes();
+    size_t before = heapInUse();
+    Fleet fleet(machines);
+    double fleetHeap = static_cast<double>(heapInUse() - before) * perMachine;
+
+    before = heapInUse();
+    ShardedFleet sharded(machines, shards);
+    double shardedHeap = static_cast<double>(heapInUse() - before) * perMachine;
+
+    double fleetTick = runCycles(machines, ticks,
+                                 [&](size_t id) { restartMachine(fleet.getMachine(id)); },
+                                 [&] { fleet.tick(1.0f); });
+    double shardedTick = runCycles(machines, ticks,
+                                   [&](size_t id) { restartCore(sharded.getMachine(static_cast<ShardedFleet::MachineId>(id))); },
+                                   [&] { sharded.tick(1.0f); });
+
+    // Finish every cycle so the broadcasts land on idle machines.
+    for (int t = 0; t < 4000; t++) {
+        fleet.tick(1.0f);
+        sharded.tick(1.0f);
+    }
+
+    std::vector<ShardedFleet::MachineId> floor;
+    for (size_t id = 0; id < machines; id += 10) {
+        floor.push_back(static_cast<ShardedFleet::MachineId>(id));
+    }
+    double events = static_cast<double>(floor.size()) * broadcasts;
+
+    auto begin = Clock::now();
+    for (int b = 0; b < broadcasts; b++) {
+        for (ShardedFleet::MachineId id : floor) {
+            fleet.getMachine(id).setLoad(1.0f + static_cast<float>(b % 5));
+        }
+        fleet.tick(0.0f);
+    }
+    double fleetBroadcast = seconds(begin);
+
+    begin = Clock::now();
+    for (int b = 0; b < broadcasts; b++) {
+        for (ShardedFleet::MachineId id : floor) {
+            sharded.getMachine(id).setLoad(1.0f + static_cast<float>(b % 5));
+        }
+        sharded.tick(0.0f);
+    }
+    double shardedSingle = seconds(begin);
+
+    begin = Clock::now();
+    for (int b = 0; b < broadcasts; b++) {
+        sharded.getBus().submit(floor, Event(EventType::CMD_SET_LOAD, 1.0f + static_cast<float>(b % 5)));
+        sharded.tick(0.0f);
+    }
+    double shardedBatch = seconds(begin);
+
+    std::cout << machines << " machines, " << shards << " shards\n\n";
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "heap per machine      EventEngine each " << std::setw(8) << fleetHeap
+              << " B    bus " << std::setw(8) << shardedHeap << " B\n";
+    std::cout << std::setprecision(2);
+    std::cout << "machine-ticks/s       EventEngine each " << std::setw(8) << machineTicks / fleetTick / 1e6
+              << " M    bus " << std::setw(8) << machineTicks / shardedTick / 1e6 << " M\n";
+    std::cout << "broadcast ns/event    EventEngine each " << std::setw(8) << fleetBroadcast / events * 1e9
+              << "      bus " << std::setw(8) << shardedSingle / events * 1e9
+              << "      bus batch " << shardedBatch / events * 1e9 << "\n";
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include "FaultInjector.hpp"
+#include "Fleet.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures the fault injector on its own and the cost of faults on a fleet
+// that keeps cycling.
+//
+//   fault_storm [--machines N] [--hours H] [--rate R] [--threads T]
+//               [--recovery S] [--seed K]
+//
+// The first table drives every fault code at one per simulated second per
+// machine into a counting sink, to show raw injection throughput by thread
+// count. The second runs the fleet for H simulated hours in 1 s ticks, once
+// fault-free and once with each fault code at R per machine-hour. Machines
+// restart a cycle as soon as they are idle, and a faulted machine is cleared
+// after S seconds; recovery is the time from the fault to the next fill.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    size_t machines = 2000;
+    double hours = 2.0;
+    double rate = 0.5;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double recovery = 30.0;
+    uint64_t seed = 1;
+};
+
+struct FleetRun {
+    double wallSeconds = 0.0;
+    uint64_t injected = 0;
+    uint64_t faults = 0;
+    uint64_t cycles = 0;
+    std::vector<double> recoveries;
+};
+
+double seconds(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+void measureInjection(const Options& options) {
+    size_t machines = std::max<size_t>(options.machines, 100000);
+    std::cout << "injection, " << machines << " machines, 5 faults/s each\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "faults" << std::setw(14) << "M/s" << "\n";
+
+    for (unsigned threads = 1; threads <= options.threads; threads *= 2) {
+        FaultInjector injector(options.seed, machines);
+        for (size_t slot = 0; slot < INJECTABLE_FAULT_COUNT; slot++) {
+            injector.setRate(faultFromSlot(slot), 3600.0);
+        }
+        injector.setThreadCount(threads);
+
+        std::vector<uint32_t> perMachine(machines, 0);
+        auto sink = [&perMachine](size_t machine, FaultCode) {
+            perMachine[machine]++;
+            return true;
+        };
+
+        auto begin = Clock::now();
+        size_t delivered = 0;
+        for (int tick = 0; tick < 20; tick++) {
+            delivered += injector.advance(1.0, sink);
+        }
+        double elapsed = seconds(begin);
+        std::cout << std::setw(8) << threads << std::setw(14) << delivered
+                  << std::fixed << std::setprecision(1) << std::setw(14) << delivered / elapsed / 1e6 << "\n";
+    }
+    std::cout << "\n";
+}
+
+FleetRun runFleet(const Options& options, double ratePerHour) {
+    Fleet fleet(options.machines);
+    FaultInjector injector(options.seed, options.machines);
+    for (size_t slot = 0; slot < INJECTABLE_FAULT_COUNT; slot++) {
+        injector.setRate(faultFromSlot(slot), ratePerHour);
+    }
+    injector.setThreadCount(options.threads);
+
+    std::vector<State> previous(options.machines, State::Idle);
+    std::vector<double> faultedAt(options.machines, -1.0);
+    FleetRun run;
+
+    int ticks = static_cast<int>(options.hours * 3600.0);
+    auto begin = Clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        double now = tick + 1.0;
+        run.injected += injector.advance(fleet, 1.0);
+        fleet.tick(1.0f);
+
+        for (size_t id = 0; id < options.machines; id++) {
+            WashingMachine& machine = fleet.getMachine(id);
+            State state = machine.getCurrentState();
+            State before = previous[id];
+            previous[id] = state;
+
+            if (state == State::Fault && before != State::Fault) {
+                run.faults++;
+                faultedAt[id] = now;
+            }
+            if (state == State::Completed && before != State::Completed) {
+                run.cycles++;
+            }
+            if (state == State::Filling && before != State::Filling && faultedAt[id] >= 0.0) {
+                run.recoveries.push_back(now - faultedAt[id]);
+                faultedAt[id] = -1.0;
+            }
+
+            switch (state) {
+                case State::Idle:
+                case State::Completed:
+                    machine.closeDoor();
+                    machine.selectMode(0);
+                    machine.setLoad(3.0f);
+                    break;
+                case State::Ready:
+                    machine.start();
+                    break;
+                case State::Fault:
+                    if (now - faultedAt[id] >= options.recovery) {
+                        machine.clearFault();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    run.wallSeconds = seconds(begin);
+    return run;
+}
+
+void printRun(const std::string& name, const Options& options, const FleetRun& run) {
+    double machineTicks = static_cast<double>(options.machines) * options.hours * 3600.0;
+    double meanRecovery = 0.0;
+    double p99Recovery = 0.0;
+    std::vector<double> recoveries = run.recoveries;
+    if (!recoveries.empty()) {
+        std::sort(recoveries.begin(), recoveries.end());
+        for (double value : recoveries) {
+            meanRecovery += value;
+        }
+        meanRecovery /= static_cast<double>(recoveries.size());
+        p99Recovery = recoveries[static_cast<size_t>(0.99 * static_cast<double>(recoveries.size() - 1))];
+    }
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << run.wallSeconds
+              << std::setw(12) << machineTicks / run.wallSeconds / 1e6
+              << std::setw(10) << run.injected
+              << std::setw(10) << run.faults
+              << std::setw(10) << run.cycles
+              << std::setprecision(1) << std::setw(12) << meanRecovery
+              << std::setw(12) << p99Recovery << "\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << ".\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--machines") {
+                options.machines = std::stoul(value);
+            } else if (arg == "--hours") {
+                options.hours = std::stod(value);
+            } else if (arg == "--rate") {
+                options.rate = std::stod(value);
+            } else if (arg == "--threads") {
+                options.threads = std::max(1u, static_cast<unsigned>(std::stoul(value)));
+            } else if (arg == "--recovery") {
+                options.recovery = std::stod(value);
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value);
+            } else {
+                std::cerr << "Unknown option " << arg << ".\n";
+                return 1;
+            }
+        } catch (...) {
+            std::cerr << "Invalid value for " << arg << ".\n";
+            return 1;
+        }
+    }
+
+    measureInjection(options);
+
+    std::cout << "fleet, " << options.machines << " machines, " << options.hours << " h, "
+              << options.rate << " faults/h per code\n";
+    std::cout << std::left << std::setw(10) << "run" << std::right << std::setw(10) << "wall s"
+              << std::setw(12) << "Mtick/s" << std::setw(10) << "injected" << std::setw(10) << "faults"
+              << std::setw(10) << "cycles" << std::setw(12) << "recover s" << std::setw(12) << "p99 s" << "\n";
+    printRun("baseline", options, runFleet(options, 0.0));
+    printRun("faults", options, runFleet(options, options.rate));
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "CompactFleet.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Error and throughput of each fidelity level against Full.
+//
+//   fidelity [machines] [hours] [step]
+//
+// Two fleets run side by side with the same commands: a reference at Full
+// and one at the level under test. Machines use a mix of modes and loads and
+// are restarted every 10 simulated seconds once they are idle. Each fleet's
+// tick() is timed on its own. Every simulated minute each machine's readings
+// are compared with the reference, and every completed cycle's end time is
+// compared with the matching cycle of the reference.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double seconds = 0.0;
+    double referenceSeconds = 0.0;
+    uint64_t samples = 0;
+    uint64_t stateMismatches = 0;
+    double waterErrorSum = 0.0;
+    double waterErrorMax = 0.0;
+    double rpmErrorSum = 0.0;
+    double rpmErrorMax = 0.0;
+    uint64_t cycles = 0;
+    uint64_t referenceCycles = 0;
+    double endErrorSum = 0.0;
+    double endErrorMax = 0.0;
+    uint64_t endPairs = 0;
+};
+
+void restartIdle(CompactFleet& fleet) {
+    for (CompactFleet::MachineId id = 0; id < fleet.size(); id++) {
+        State state = fleet.getCurrentState(id);
+        if (state == State::Idle || state == State::Completed) {
+            fleet.closeDoor(id);
+            fleet.selectMode(id, static_cast<int>(id % 4));
+            fleet.setLoad(id, 1.0f + static_cast<float>(id % 5));
+        } else if (state == State::Ready) {
+            fleet.start(id);
+        }
+    }
+}
+
+double timedTick(CompactFleet& fleet, float step) {
+    auto begin = Clock::now();
+    fleet.tick(step);
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+Result run(size_t machines, double hours, float step, Fidelity level) {
+    CompactFleet reference(machines);
+    CompactFleet fleet(machines);
+    for (CompactFleet::MachineId id = 0; id < machines; id++) {
+        fleet.setFidelity(id, level);
+    }
+
+    std::vector<std::vector<double>> referenceEnds(machines);
+    std::vector<std::vector<double>> ends(machines);
+    std::vector<State> referencePrevious(machines, State::Idle);
+    std::vector<State> previous(machines, State::Idle);
+
+    Result result;
+    long ticks = static_cast<long>(hours * 3600.0 / step);
+    long restartEvery = std::max(1L, static_cast<long>(10.0f / step));
+    long sampleEvery = std::max(1L, static_cast<long>(60.0f / step));
+
+    for (long tick = 0; tick < ticks; tick++) {
+        if (tick % restartEvery == 0) {
+            restartIdle(reference);
+            restartIdle(fleet);
+        }
+        result.referenceSeconds += timedTick(reference, step);
+        result.seconds += timedTick(fleet, step);
+
+        // Completions are picked up from the state byte, which every level
+        // keeps current, so this loop does not promote anything.
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            State a = reference.getCurrentState(id);
+            State b = fleet.getCurrentState(id);
+            if (a == State::Completed && referencePrevious[id] != State::Completed) {
+                referenceEnds[id].push_back(reference.getTime());
+            }
+            if (b == State::Completed && previous[id] != State::Completed) {
+                ends[id].push_back(fleet.getTime());
+            }
+            referencePrevious[id] = a;
+            previous[id] = b;
+        }
+
+        if ((tick + 1) % sampleEvery == 0) {
+            for (CompactFleet::MachineId id = 0; id < machines; id++) {
+                SensorSample a = reference.getSensorSample(id);
+                SensorSample b = fleet.getSensorSample(id);
+                result.samples++;
+                if (a.state != b.state) {
+                    result.stateMismatches++;
+                    continue;
+                }
+                double water = std::fabs(a.waterLevel - b.waterLevel);
+                double rpm = std::abs(a.motorRPM - b.motorRPM);
+                result.waterErrorSum += water;
+                result.waterErrorMax = std::max(result.waterErrorMax, water);
+                result.rpmErrorSum += rpm;
+                result.rpmErrorMax = std::max(result.rpmErrorMax, rpm);
+            }
+        }
+    }
+
+    for (size_t id = 0; id < machines; id++) {
+        result.referenceCycles += referenceEnds[id].size();
+        result.cycles += ends[id].size();
+        size_t pairs = std::min(referenceEnds[id].size(), ends[id].size());
+        for (size_t k = 0; k < pairs; k++) {
+            double error = std::fabs(referenceEnds[id][k] - ends[id][k]);
+            result.endErrorSum += error;
+            result.endErrorMax = std::max(result.endErrorMax, error);
+            result.endPairs++;
+        }
+    }
+    return result;
+}
+
+const char* levelName(Fidelity level) {
+    switch (level) {
+        case Fidelity::Full: return "Full";
+        case Fidelity::Coarse: return "Coarse";
+        case Fidelity::Statistical: return "Statistical";
+    }
+    return "?";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 10000;
+    double hours = 1.0;
+    float step = 0.1f;
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            hours = std::stod(argv[2]);
+        }
+        if (argc > 3) {
+            step = std::stof(argv[3]);
+        }
+    } catch (...) {
+        std::cerr << "usage: fidelity [machines] [hours] [step]\n";
+        return 1;
+    }
+    if (machines == 0 || hours <= 0.0 || step <= 0.0f) {
+        std::cerr << "usage: fidelity [machines] [hours] [step]\n";
+        return 1;
+    }
+
+    double machineTicks = static_cast<double>(machines) * hours * 3600.0 / step;
+    std::cout << machines << " machines, " << hours << " h in " << step << " s ticks\n";
+    std::cout << std::left << std::setw(13) << "level" << std::right
+              << std::setw(13) << "Mticks/s" << std::setw(9) << "gain"
+              << std::setw(10) << "state %" << std::setw(16) << "water L avg/max"
+              << std::setw(16) << "rpm avg/max" << std::setw(21) << "cycle end s avg/max"
+              << std::setw(9) << "cycles" << "\n";
+
+    for (Fidelity level : {Fidelity::Full, Fidelity::Coarse, Fidelity::Statistical}) {
+        Result r = run(machines, hours, step, level);
+        double matched = static_cast<double>(r.samples - r.stateMismatches);
+        double pairs = std::max<double>(1.0, static_cast<double>(r.endPairs));
+        std::cout << std::left << std::setw(13) << levelName(level) << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(13) << machineTicks / r.seconds / 1e6
+                  << std::setw(8) << r.referenceSeconds / r.seconds << "x"
+                  << std::setprecision(2) << std::setw(10)
+                  << 100.0 * static_cast<double>(r.stateMismatches) / static_cast<double>(r.samples)
+                  << std::setw(9) << r.waterErrorSum / std::max(1.0, matched) << "/"
+                  << std::setprecision(1) << std::setw(6) << r.waterErrorMax
+                  << std::setprecision(1) << std::setw(9) << r.rpmErrorSum / std::max(1.0, matched) << "/"
+                  << std::setprecision(0) << std::setw(6) << r.rpmErrorMax
+                  << std::setprecision(2) << std::setw(14) << r.endErrorSum / pairs << "/"
+                  << std::setw(6) << r.endErrorMax
+                  << std::setw(8) << r.cycles << "/" << r.referenceCycles << "\n";
+    }
+    return 0;
+}
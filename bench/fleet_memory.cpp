@@ -0,0 +1,131 @@
+#include "CompactFleet.hpp"
+#include "Fleet.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Memory and tick cost of the two fleet representations.
+//
+//   fleet_memory [machines] [hours]
+//
+// Heap use is the change in glibc's allocated bytes (including mmap'd blocks)
+// from before construction to after the run, so it includes everything a
+// machine pulls in (maps, callbacks, queues, the thread object), not just
+// sizeof. Both fleets run back-to-back Quick Wash cycles in 1 s ticks for the
+// given simulated hours.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo info = mallinfo();
+    return static_cast<size_t>(info.uordblks) + static_cast<size_t>(info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+double runFleet(Fleet& fleet, long ticks) {
+    auto begin = Clock::now();
+    for (long tick = 0; tick < ticks; tick++) {
+        for (size_t id = 0; id < fleet.size(); id++) {
+            WashingMachine& machine = fleet.getMachine(id);
+            State state = machine.getCurrentState();
+            if (state == State::Idle || state == State::Completed) {
+                machine.closeDoor();
+                machine.selectMode(0);
+                machine.setLoad(3.0f);
+            } else if (state == State::Ready) {
+                machine.start();
+            }
+        }
+        fleet.tick(1.0f);
+    }
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+double runCompact(CompactFleet& fleet, long ticks) {
+    auto begin = Clock::now();
+    for (long tick = 0; tick < ticks; tick++) {
+        for (CompactFleet::MachineId id = 0; id < fleet.size(); id++) {
+            State state = fleet.getCurrentState(id);
+            if (state == State::Idle || state == State::Completed) {
+                fleet.closeDoor(id);
+                fleet.selectMode(id, 0);
+                fleet.setLoad(id, 3.0f);
+            } else if (state == State::Ready) {
+                fleet.start(id);
+            }
+        }
+        fleet.tick(1.0f);
+    }
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 10000;
+    double hours = 1.0;
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            hours = std::stod(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: fleet_memory [machines] [hours]\n";
+        return 1;
+    }
+    if (machines == 0) {
+        std::cerr << "usage: fleet_memory [machines] [hours]\n";
+        return 1;
+    }
+
+    long ticks = static_cast<long>(hours * 3600.0);
+    double machineTicks = static_cast<double>(machines) * static_cast<double>(ticks);
+    double perMachine = 1.0 / static_cast<double>(machines);
+
+    MachineCore::defaultModes();
+    size_t before = heapInUse();
+    Fleet fleet(machines);
+    double fleetSeconds = runFleet(fleet, ticks);
+    double fleetHeap = static_cast<double>(heapInUse() - before) * perMachine;
+
+    before = heapInUse();
+    CompactFleet compact(machines);
+    double compactSeconds = runCompact(compact, ticks);
+    double compactHeap = static_cast<double>(heapInUse() - before) * perMachine;
+    FleetMemoryReport report = compact.getMemoryReport();
+
+    std::cout << machines << " machines, " << hours << " h in 1 s ticks\n\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "WashingMachine   heap " << fleetHeap << " B/machine (sizeof "
+              << sizeof(WashingMachine) << ")\n";
+    std::cout << "CompactFleet     heap " << compactHeap << " B/machine\n\n";
+
+    std::cout << "compact report\n";
+    std::cout << "  hot record     " << report.hotBytes << " B\n";
+    std::cout << "  cold record    " << report.coldBytes << " B\n";
+    std::cout << "  arena          " << report.arenaBytes << " B for " << report.capacity << " slots\n";
+    std::cout << "  event queue    " << report.eventQueueBytes << " B\n";
+    std::cout << "  shared         " << report.sharedBytes << " B (mode table, transitions)\n";
+    std::cout << "  total          " << report.bytesPerMachine() << " B/machine\n\n";
+
+    std::cout << std::setprecision(2);
+    std::cout << "tick  WashingMachine " << machineTicks / fleetSeconds / 1e6 << " M machine-ticks/s\n";
+    std::cout << "tick  CompactFleet   " << machineTicks / compactSeconds / 1e6 << " M machine-ticks/s\n";
+    return 0;
+}
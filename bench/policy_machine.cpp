@@ -0,0 +1,104 @@
+#include "WashingMachine.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Per-tick cost of a WashingMachine, whose events go through an EventEngine,
+// against the same machine built with an InlineEventSink.
+//
+//   policy_machine [machines] [ticks]
+//
+// Both run back-to-back Quick Wash cycles in 1 s ticks, driven from this
+// thread through tick(). "cycles" only restarts finished machines, so events
+// are a handful per cycle. "commands" also pauses every running machine on
+// even ticks and resumes it on odd ones, about one event per machine every
+// two ticks. "same" checks that both builds end with identical machines.
+// Under "commands" they may not: the engine handles a command ahead of
+// system events already queued, the inline sink in the order posted.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using InlineMachine = BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, InlineEventSink>;
+
+template<typename Machine>
+double run(size_t machines, long ticks, bool commands, std::vector<uint8_t>& checkpoint) {
+    std::vector<std::unique_ptr<Machine>> fleet;
+    for (size_t i = 0; i < machines; i++) {
+        fleet.push_back(std::make_unique<Machine>());
+        fleet.back()->initialize();
+        fleet.back()->setOutput(nullptr);
+    }
+
+    auto begin = Clock::now();
+    for (long t = 0; t < ticks; t++) {
+        for (auto& machine : fleet) {
+            State state = machine->getCurrentState();
+            if (state == State::Idle || state == State::Completed) {
+                machine->closeDoor();
+                machine->selectMode(0);
+                machine->setLoad(3.0f);
+            } else if (state == State::Ready) {
+                machine->start();
+            } else if (commands && state == State::Paused) {
+                machine->resume();
+            } else if (commands && t % 2 == 0) {
+                machine->pause();
+            }
+            machine->tick(1.0f);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    checkpoint.clear();
+    for (auto& machine : fleet) {
+        std::vector<uint8_t> one = machine->saveCheckpoint();
+        checkpoint.insert(checkpoint.end(), one.begin(), one.end());
+    }
+    return elapsed;
+}
+
+void report(const char* workload, size_t machines, long ticks, bool commands) {
+    std::vector<uint8_t> engineState;
+    std::vector<uint8_t> inlineState;
+    double engine = run<WashingMachine>(machines, ticks, commands, engineState);
+    double inlined = run<InlineMachine>(machines, ticks, commands, inlineState);
+    double machineTicks = static_cast<double>(machines) * static_cast<double>(ticks);
+
+    std::cout << std::left << std::setw(10) << workload << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << engine / machineTicks * 1e9
+              << std::setw(14) << inlined / machineTicks * 1e9
+              << std::setprecision(2) << std::setw(10) << engine / inlined
+              << std::setw(7) << (engineState == inlineState ? "yes" : "no") << "\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 2000;
+    long ticks = 7200;
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            ticks = std::stol(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: policy_machine [machines] [ticks]\n";
+        return 1;
+    }
+    if (machines == 0 || ticks <= 0) {
+        std::cerr << "usage: policy_machine [machines] [ticks]\n";
+        return 1;
+    }
+
+    std::cout << machines << " machines, " << ticks << " ticks of 1 s\n\n";
+    std::cout << "workload   engine ns/tick  inline ns/tick   speedup   same\n";
+    report("cycles", machines, ticks, false);
+    report("commands", machines, ticks, true);
+    return 0;
+}
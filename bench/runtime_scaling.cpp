@@ -0,0 +1,108 @@
+#include "FleetRuntime.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Machine-ticks per second of a FleetRuntime from one worker up to one per
+// allowed CPU, for the same total fleet.
+//
+//   runtime_scaling [machines] [ticks] [max-workers]
+//
+// Every machine runs back-to-back Quick Wash cycles in 1 s ticks. Idle
+// machines are restarted by a shard hook on their own worker, so the
+// controlling thread only sends ticks. Speedup is against the one-worker run;
+// efficiency is speedup divided by workers.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void restartIdle(size_t, ShardedFleet& shard) {
+    for (size_t id = 0; id < shard.size(); id++) {
+        MachineCore& core = shard.getMachine(static_cast<ShardedFleet::MachineId>(id));
+        State state = core.getCurrentState();
+        if (state == State::Idle || state == State::Completed) {
+            core.closeDoor();
+            core.selectMode(0);
+            core.setLoad(3.0f);
+        } else if (state == State::Ready) {
+            core.start();
+        }
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 100000;
+    long ticks = 600;
+    size_t maxWorkers = FleetRuntime::allowedCpus().size();
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            ticks = std::stol(argv[2]);
+        }
+        if (argc > 3) {
+            maxWorkers = std::stoul(argv[3]);
+        }
+    } catch (...) {
+        std::cerr << "usage: runtime_scaling [machines] [ticks] [max-workers]\n";
+        return 1;
+    }
+    if (machines == 0 || ticks <= 0 || maxWorkers == 0) {
+        std::cerr << "usage: runtime_scaling [machines] [ticks] [max-workers]\n";
+        return 1;
+    }
+
+    MachineCore::defaultModes();
+    std::vector<size_t> counts;
+    for (size_t w = 1; w < maxWorkers; w *= 2) {
+        counts.push_back(w);
+    }
+    counts.push_back(maxWorkers);
+
+    std::cout << machines << " machines, " << ticks << " ticks, "
+              << FleetRuntime::allowedCpus().size() << " allowed CPUs\n\n";
+    std::cout << "workers  cpus          M machine-ticks/s  speedup  efficiency  slowest shard ms\n";
+
+    double machineTicks = static_cast<double>(machines) * static_cast<double>(ticks);
+    double baseline = 0.0;
+    for (size_t workers : counts) {
+        RuntimeOptions options;
+        options.workers = workers;
+        FleetRuntime runtime(machines, options, restartIdle);
+
+        std::string cpus;
+        for (size_t w = 0; w < workers && w < 4; w++) {
+            cpus += (w ? "," : "") + std::to_string(runtime.getWorkerCpu(w));
+        }
+        if (workers > 4) {
+            cpus += ",..";
+        }
+
+        runtime.run(5, 1.0f);
+        double slowest = 0.0;
+        auto begin = Clock::now();
+        for (long t = 0; t < ticks; t++) {
+            runtime.tick(1.0f);
+            slowest += runtime.getTotals().tickSeconds;
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+        double rate = machineTicks / elapsed;
+        if (baseline == 0.0) {
+            baseline = rate;
+        }
+
+        std::cout << std::setw(7) << workers << "  " << std::left << std::setw(12) << cpus << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(19) << rate / 1e6
+                  << std::setw(9) << rate / baseline
+                  << std::setw(12) << rate / baseline / static_cast<double>(workers)
+                  << std::setprecision(3) << std::setw(18) << slowest / static_cast<double>(ticks) * 1e3 << "\n";
+    }
+    return 0;
+}
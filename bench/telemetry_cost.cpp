@@ -0,0 +1,104 @@
+#include "MachineCore.hpp"
+#include "TelemetryRecorder.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Cost and size of per-tick telemetry. Machines run back-to-back Quick Wash
+// cycles in 50 ms ticks for the given simulated hours; each tick is timed
+// without recording, then with a sample recorded per machine per tick.
+//
+//   telemetry_cost [machines] [hours]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void restartIfDone(MachineCore& core) {
+    State state = core.getCurrentState();
+    if (state == State::Idle || state == State::Completed) {
+        core.closeDoor();
+        core.selectMode(0);
+        core.setLoad(3.0f);
+        core.processPendingEvents();
+        core.start();
+    }
+}
+
+double runFleet(size_t machines, long ticks, std::vector<TelemetryRecorder>* recorders) {
+    std::vector<MachineCore> cores(machines);
+    for (MachineCore& core : cores) {
+        core.setOutput(nullptr);
+    }
+
+    const float step = 0.05f;
+    auto begin = Clock::now();
+    for (long tick = 0; tick < ticks; tick++) {
+        double clock = (tick + 1) * static_cast<double>(step);
+        for (size_t id = 0; id < machines; id++) {
+            MachineCore& core = cores[id];
+            restartIfDone(core);
+            core.step(step);
+            if (recorders) {
+                (*recorders)[id].record(clock, core.getSensorSample());
+            }
+        }
+    }
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t machines = 200;
+    double hours = 1.0;
+    try {
+        if (argc > 1) {
+            machines = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            hours = std::stod(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: telemetry_cost [machines] [hours]\n";
+        return 1;
+    }
+
+    long ticks = static_cast<long>(hours * 3600.0 / 0.05);
+    double samples = static_cast<double>(machines) * static_cast<double>(ticks);
+
+    double plain = runFleet(machines, ticks, nullptr);
+    std::vector<TelemetryRecorder> recorders(machines);
+    double recorded = runFleet(machines, ticks, &recorders);
+
+    size_t compressed = 0;
+    size_t memory = 0;
+    for (TelemetryRecorder& recorder : recorders) {
+        recorder.flush();
+        compressed += recorder.getCompressedBytes();
+        memory += recorder.getMemoryBytes();
+    }
+
+    std::ostringstream csv;
+    recorders[0].writeCsv(csv);
+    std::vector<uint8_t> binary;
+    recorders[0].saveBinary(binary);
+
+    double machineHours = static_cast<double>(machines) * hours;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << machines << " machines, " << hours << " h at 20 Hz, " << static_cast<long>(samples) << " samples\n";
+    std::cout << "tick          " << plain / samples * 1e9 << " ns/machine\n";
+    std::cout << "tick+record   " << recorded / samples * 1e9 << " ns/machine ("
+              << (recorded - plain) / samples * 1e9 << " ns overhead)\n";
+    std::cout << std::setprecision(2);
+    std::cout << "compressed    " << compressed / samples << " B/sample, "
+              << compressed / machineHours / 1024.0 << " KiB per machine-hour\n";
+    std::cout << "resident      " << memory / machineHours / 1024.0 << " KiB per machine-hour\n";
+    std::cout << "machine 0     binary " << binary.size() / 1024.0 << " KiB, csv "
+              << csv.str().size() / 1024.0 << " KiB\n";
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "WashingMachine.hpp"
+#include "CLI.hpp"
+#include "ReactorShell.hpp"
+#include "TickTimingStats.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Compares tick timing of the threaded sleep_for loop with the timerfd
+// reactor, each driving a machine through an active cycle.
+//   tick_jitter [seconds]
+
+namespace {
+
+void prepare(WashingMachine& machine) {
+    machine.initialize();
+    machine.setOutput(nullptr);
+    machine.closeDoor();
+    machine.setLoad(3.0f);
+    machine.selectMode(1);
+    machine.tick(0.0f);
+    machine.start();
+}
+
+void printRow(const std::string& name, const TickTimingStats& stats) {
+    std::cout << std::left << std::setw(10) << name << std::right
+              << std::setw(8) << stats.getTickCount()
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << stats.getMeanJitterMicros()
+              << std::setw(12) << stats.getPercentileJitterMicros(50.0)
+              << std::setw(12) << stats.getPercentileJitterMicros(99.0)
+              << std::setw(12) << stats.getMaxJitterMicros()
+              << std::setw(14) << stats.getDriftMicros() / 1000.0 << "\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? std::stod(argv[1]) : 3.0;
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(seconds));
+
+    WashingMachine threaded;
+    prepare(threaded);
+    threaded.run();
+    std::this_thread::sleep_for(duration);
+    threaded.shutdown();
+    TickTimingStats threadedStats = threaded.getTickStats();
+
+    std::cout << "tick period 50 ms, " << seconds << " s per loop\n\n";
+    std::cout << std::left << std::setw(10) << "loop" << std::right
+              << std::setw(8) << "ticks" << std::setw(12) << "mean us"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+              << std::setw(12) << "max us" << std::setw(14) << "drift ms" << "\n";
+    printRow("sleep_for", threadedStats);
+
+#ifdef __linux__
+    WashingMachine reactive;
+    prepare(reactive);
+    std::ostringstream sink;
+    CLI cli(reactive, sink);
+    ReactorShell shell(reactive, cli, -1);
+    shell.runFor(duration);
+    printRow("timerfd", shell.getTickStats());
+#endif
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "ShardedFleet.hpp"
+#include "TimingWheel.hpp"
+#include "CounterRng.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Timing wheel costs at fleet scale.
+//
+//   timer_wheel [timers] [machines]
+//
+// The first part arms [timers] deadlines spread over an hour at 0.1 s
+// resolution, cancels and re-arms half of them (the pattern of machines
+// moving between phases), then turns the wheel through the hour. The second
+// part runs back-to-back Quick Wash cycles on a ShardedFleet for a simulated
+// hour, with and without every machine's watchdog on one shared wheel.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+struct Counter : TimerListener {
+    uint64_t fired = 0;
+    void onTimerExpired(uint32_t) override {
+        fired++;
+    }
+};
+
+double runFleet(size_t machines, TimingWheel* wheel, size_t& armed) {
+    ShardedFleet fleet(machines, 8);
+    fleet.connectTimingWheel(wheel);
+    auto begin = Clock::now();
+    for (int t = 0; t < 3600; t++) {
+        for (size_t id = 0; id < machines; id++) {
+            MachineCore& core = fleet.getMachine(static_cast<ShardedFleet::MachineId>(id));
+            State state = core.getCurrentState();
+            if (state == State::Idle || state == State::Completed) {
+                core.closeDoor();
+                core.selectMode(0);
+                core.setLoad(3.0f);
+            } else if (state == State::Ready) {
+                core.start();
+            }
+        }
+        fleet.tick(1.0f);
+    }
+    double elapsed = seconds(begin);
+    armed = wheel ? wheel->getArmedCount() : 0;
+    return elapsed;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t timers = 2000000;
+    size_t machines = 100000;
+    try {
+        if (argc > 1) {
+            timers = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            machines = std::stoul(argv[2]);
+        }
+    } catch (...) {
+        std::cerr << "usage: timer_wheel [timers] [machines]\n";
+        return 1;
+    }
+    if (timers == 0 || machines == 0) {
+        std::cerr << "usage: timer_wheel [timers] [machines]\n";
+        return 1;
+    }
+
+    TimingWheel wheel(0.1f);
+    Counter counter;
+    CounterRng rng(46, 0);
+    std::vector<TimingWheel::TimerId> ids(timers);
+    wheel.reserve(timers);
+
+    auto begin = Clock::now();
+    for (size_t i = 0; i < timers; i++) {
+        ids[i] = wheel.arm(static_cast<float>(rng.next() % 36000) * 0.1f, &counter, static_cast<uint32_t>(i));
+    }
+    double arm = seconds(begin);
+
+    begin = Clock::now();
+    for (size_t i = 0; i < timers; i += 2) {
+        wheel.cancel(ids[i]);
+        ids[i] = wheel.arm(static_cast<float>(rng.next() % 36000) * 0.1f, &counter, static_cast<uint32_t>(i));
+    }
+    double rearm = seconds(begin);
+    size_t bytes = wheel.getMemoryBytes();
+
+    begin = Clock::now();
+    for (int t = 0; t < 3601; t++) {
+        wheel.advance(1.0f);
+    }
+    double turn = seconds(begin);
+
+    MachineCore::defaultModes();
+    size_t armed = 0;
+    double without = runFleet(machines, nullptr, armed);
+    TimingWheel fleetWheel;
+    double with = runFleet(machines, &fleetWheel, armed);
+    double machineTicks = static_cast<double>(machines) * 3600.0;
+
+    double count = static_cast<double>(timers);
+    std::cout << timers << " timers over one hour at 0.1 s\n\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "arm                   " << std::setw(8) << arm / count * 1e9 << " ns/timer\n";
+    std::cout << "cancel + re-arm       " << std::setw(8) << rearm / (count / 2) * 1e9 << " ns/timer\n";
+    std::cout << "turn one hour         " << std::setw(8) << turn / count * 1e9 << " ns/timer   ("
+              << counter.fired << " fired)\n";
+    std::cout << "memory                " << std::setw(8) << static_cast<double>(bytes) / count << " B/timer\n\n";
+    std::cout << machines << " machines, Quick Wash cycles for an hour\n\n";
+    std::cout << std::setprecision(2);
+    std::cout << "machine-ticks/s       no watchdog " << std::setw(7) << machineTicks / without / 1e6
+              << " M    watchdog " << std::setw(7) << machineTicks / with / 1e6 << " M\n";
+    std::cout << "watchdog deadlines    " << fleetWheel.getExpiredCount() << " fired, "
+              << armed << " armed at the end\n";
+    return 0;
+}
@@ -0,0 +1,60 @@
+# Turns a wash mode file into a header holding the same modes as a constexpr
+# array, so the default mode table costs no parsing or allocation at startup.
+#
+#   cmake -DINPUT=<wash_modes.json> -DOUTPUT=<WashModeCatalog.hpp> -P EmbedWashModes.cmake
+#
+# Reads the file the way ConfigManager::loadConfig() does: every object with
+# a "name" is a mode, and a missing field keeps the WashMode default.
+
+if(NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "EmbedWashModes.cmake needs -DINPUT and -DOUTPUT")
+endif()
+
+file(READ "${INPUT}" json)
+string(REGEX MATCHALL "{[^{}]*}" objects "${json}")
+
+set(space "[ \t\r\n]*")
+
+function(read_field object key pattern default out)
+    if(object MATCHES "\"${key}\"${space}:${space}(${pattern})")
+        set(${out} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+    else()
+        set(${out} "${default}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+set(entries "")
+set(count 0)
+foreach(object IN LISTS objects)
+    if(NOT object MATCHES "\"name\"${space}:${space}\"([^\"]*)\"")
+        continue()
+    endif()
+    set(name "${CMAKE_MATCH_1}")
+    read_field("${object}" duration_minutes "-?[0-9]+" 30 duration)
+    read_field("${object}" spin_speed_rpm "-?[0-9]+" 800 spin)
+    read_field("${object}" water_level_liters "-?[0-9.eE+-]+" 30 water)
+    read_field("${object}" temperature_celsius "-?[0-9]+" 40 temperature)
+    if(water MATCHES "^-?[0-9]+$")
+        string(APPEND water ".0")
+    endif()
+    string(APPEND entries "    WashMode(\"${name}\", ${duration}, ${spin}, ${water}f, ${temperature}),\n")
+    math(EXPR count "${count} + 1")
+endforeach()
+
+if(count EQUAL 0)
+    message(FATAL_ERROR "${INPUT} defines no wash modes")
+endif()
+
+file(WRITE "${OUTPUT}"
+"// Generated from config/wash_modes.json by cmake/EmbedWashModes.cmake.
+#ifndef WASH_MODE_CATALOG_HPP
+#define WASH_MODE_CATALOG_HPP
+
+#include \"WashMode.hpp\"
+#include <array>
+
+inline constexpr std::array<WashMode, ${count}> BUILTIN_WASH_MODES = {{
+${entries}}};
+
+#endif
+")
@@ -0,0 +1,87 @@
+#ifndef BATCH_STATE_MACHINE_HPP
+#define BATCH_STATE_MACHINE_HPP
+
+#include "Types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// The states of a whole fleet stepped together. States live in one byte
+// array and each tick's events in a parallel one (at most one event per
+// machine per step). step() applies StateMachine's transition table to every
+// machine in one pass and collects the machines that took a transition,
+// including Ready to Ready on a new mode selection, which StateMachine also
+// reports. Exit and enter actions then run for that list only, in machine
+// order, and may post events for the next step.
+//
+// On x86-64 the pass skips 16 or 32 machines at a time when none of them has
+// an event, and with AVX2 resolves the rest with a gather from a widened copy
+// of the table. Elsewhere it is the same loop one machine at a time.
+class BatchStateMachine {
+public:
+    using MachineId = uint32_t;
+    // Same argument order as StateMachine: exit actions get (old, new),
+    // enter actions get (new, old).
+    using Action = std::function<void(MachineId, State, State)>;
+
+    static constexpr size_t STATE_COUNT = static_cast<size_t>(State::Fault) + 1;
+    static constexpr size_t ROW_SIZE = 32;
+    static constexpr uint8_t NO_EVENT = 0xFF;
+    static constexpr uint8_t NO_TRANSITION = 0xFF;
+
+    static_assert(EVENT_TYPE_COUNT < ROW_SIZE, "NO_EVENT must map to an empty column");
+
+    // Applies events[i] to states[i] for every i below count and resets each
+    // event to NO_EVENT. Ids of machines that took a transition go to changed
+    // and their old states to previous, both sized for count entries; the
+    // return value is how many there were.
+    static size_t transitionKernel(uint8_t* states, uint8_t* events, size_t count,
+                                   MachineId* changed, uint8_t* previous);
+    // The portable loop, for comparison with whatever the kernel selected.
+    static size_t transitionScalar(uint8_t* states, uint8_t* events, size_t count,
+                                   MachineId* changed, uint8_t* previous);
+    static const char* kernelName();
+
+private:
+    std::vector<uint8_t> states;
+    std::vector<uint8_t> events;
+    std::vector<MachineId> changed;
+    std::vector<uint8_t> previous;
+    size_t changedCount;
+    std::array<std::vector<Action>, STATE_COUNT> onEnter;
+    std::array<std::vector<Action>, STATE_COUNT> onExit;
+
+public:
+    explicit BatchStateMachine(size_t machineCount = 0);
+
+    // New machines start Idle with no event; shrinking drops the highest ids.
+    void resize(size_t machineCount);
+    size_t size() const;
+
+    State getState(MachineId id) const;
+    // Sets the state without running any action, like restoring a checkpoint.
+    void setState(MachineId id, State state);
+
+    // Queues an event for the next step. Returns false if the machine already
+    // has one; the caller keeps it for the step after.
+    bool post(MachineId id, EventType event);
+    bool hasEvent(MachineId id) const;
+
+    void registerOnEnter(State state, Action action);
+    void registerOnExit(State state, Action action);
+
+    size_t step();
+
+    // Machines that took a transition in the last step, in id order, and
+    // their old states.
+    size_t getChangedCount() const;
+    MachineId getChanged(size_t index) const;
+    State getPrevious(size_t index) const;
+
+    const uint8_t* stateData() const;
+};
+
+#endif
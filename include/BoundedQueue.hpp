@@ -0,0 +1,117 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+// Fixed-capacity multi-producer / multi-consumer ring (Vyukov). The cells are
+// allocated by the first push, so a queue that is never used costs only the
+// object itself; after that tryPush/tryPop never allocate and never block.
+template<typename T>
+class BoundedQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        std::optional<T> value;
+    };
+
+    std::atomic<Cell*> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t p = 2;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // Racing first pushes each build a ring; one is published, the rest are
+    // freed.
+    Cell* allocate() {
+        std::unique_ptr<Cell[]> fresh(new Cell[mask + 1]);
+        for (size_t i = 0; i <= mask; ++i) {
+            fresh[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        Cell* expected = nullptr;
+        if (cells.compare_exchange_strong(expected, fresh.get(), std::memory_order_acq_rel)) {
+            return fresh.release();
+        }
+        return expected;
+    }
+
+public:
+    explicit BoundedQueue(size_t requestedCapacity)
+        : cells(nullptr),
+          mask(roundUpPowerOfTwo(requestedCapacity) - 1),
+          enqueuePos(0),
+          dequeuePos(0) {}
+
+    ~BoundedQueue() {
+        delete[] cells.load(std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    bool tryPush(const T& value) {
+        Cell* ring = cells.load(std::memory_order_acquire);
+        if (!ring) {
+            ring = allocate();
+        }
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = ring[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value.emplace(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> tryPop() {
+        Cell* ring = cells.load(std::memory_order_acquire);
+        if (!ring) {
+            return std::nullopt;
+        }
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = ring[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::optional<T> result(std::move(cell.value));
+                    cell.value.reset();
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return result;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+#endif
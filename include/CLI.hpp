@@ -2,28 +2,33 @@
 #define CLI_HPP
 
 #include "WashingMachine.hpp"
+#include "CommandTable.hpp"
 #include <atomic>
+#include <iostream>
 #include <string>
-#include <vector>
+#include <string_view>
 
 class CLI {
 private:
     WashingMachine& machine;
+    std::ostream& out;
     std::atomic<bool> running;
 
-    void printWelcome();
     void printHelp();
     void printStatus();
     void printModes();
 
-    bool parseCommand(const std::string& input);
-    std::vector<std::string> tokenize(const std::string& input);
+    bool parseCommand(std::string_view input);
+    bool runCommand(const CommandSpec& command, const CommandTokens& tokens);
     void clearScreen();
 
 public:
-    CLI(WashingMachine& machine);
+    CLI(WashingMachine& machine, std::ostream& out = std::cout);
 
     void start();
+    bool execute(std::string_view input);
+    void printWelcome();
+    void printPrompt();
     void stop();
     bool isRunning() const;
 };
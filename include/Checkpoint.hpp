@@ -0,0 +1,113 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+constexpr uint32_t CHECKPOINT_MAGIC = 0x50434D57;
+constexpr uint16_t CHECKPOINT_VERSION = 2;
+
+enum class CheckpointKind : uint16_t {
+    Machine = 1,
+    Fleet = 2,
+    Telemetry = 3
+};
+
+// Header: magic, version, kind, record count. Records are fixed-size and
+// stored in host byte order.
+class CheckpointWriter {
+private:
+    std::vector<uint8_t>& buffer;
+
+public:
+    explicit CheckpointWriter(std::vector<uint8_t>& buffer) : buffer(buffer) {}
+
+    template<typename T>
+    void write(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint fields must be trivially copyable");
+        size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    void writeHeader(CheckpointKind kind, uint32_t count) {
+        write<uint32_t>(CHECKPOINT_MAGIC);
+        write<uint16_t>(CHECKPOINT_VERSION);
+        write<uint16_t>(static_cast<uint16_t>(kind));
+        write<uint32_t>(count);
+    }
+
+    void writeBytes(const uint8_t* bytes, size_t count) {
+        buffer.insert(buffer.end(), bytes, bytes + count);
+    }
+
+    void reserve(size_t bytes) {
+        buffer.reserve(buffer.size() + bytes);
+    }
+};
+
+class CheckpointReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+
+public:
+    CheckpointReader(const uint8_t* data, size_t size)
+        : data(data), size(size), offset(0), ok(true) {}
+
+    explicit CheckpointReader(const std::vector<uint8_t>& buffer)
+        : CheckpointReader(buffer.data(), buffer.size()) {}
+
+    template<typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint fields must be trivially copyable");
+        if (!ok || size - offset < sizeof(T)) {
+            ok = false;
+            return false;
+        }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(std::vector<uint8_t>& bytes, size_t count) {
+        if (!ok || size - offset < count) {
+            ok = false;
+            return false;
+        }
+        bytes.assign(data + offset, data + offset + count);
+        offset += count;
+        return true;
+    }
+
+    bool readHeader(CheckpointKind expected, uint32_t& count) {
+        uint32_t magic = 0;
+        uint16_t version = 0;
+        uint16_t kind = 0;
+        if (!read(magic) || !read(version) || !read(kind) || !read(count)) {
+            return false;
+        }
+        ok = magic == CHECKPOINT_MAGIC && version == CHECKPOINT_VERSION &&
+             kind == static_cast<uint16_t>(expected);
+        return ok;
+    }
+
+    bool good() const {
+        return ok;
+    }
+
+    size_t remaining() const {
+        return size - offset;
+    }
+};
+
+bool writeCheckpointFile(const std::string& path, const std::vector<uint8_t>& buffer);
+bool readCheckpointFile(const std::string& path, std::vector<uint8_t>& buffer);
+
+#endif
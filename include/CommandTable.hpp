@@ -0,0 +1,104 @@
+#ifndef COMMAND_TABLE_HPP
+#define COMMAND_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class CommandId {
+    Open,
+    Close,
+    Load,
+    Mode,
+    Modes,
+    Start,
+    Pause,
+    Resume,
+    Stop,
+    Emergency,
+    Status,
+    Help,
+    Clear,
+    Exit
+};
+
+struct CommandSpec {
+    CommandId id;
+    std::string_view name;
+    std::string_view alias;
+    std::string_view args;
+    std::string_view group;
+    std::string_view help;
+    size_t minArgs;
+};
+
+// The CLI vocabulary. Lookup, argument checking and the help screen are all
+// driven from this table; help groups appear in table order.
+inline constexpr std::array<CommandSpec, 14> COMMAND_SPECS = {{
+    {CommandId::Open, "open", "", "", "Door Control", "Open the door", 0},
+    {CommandId::Close, "close", "", "", "Door Control", "Close the door", 0},
+    {CommandId::Load, "load", "", "<kg>", "Load & Mode", "Set load weight (0-6 kg)", 1},
+    {CommandId::Mode, "mode", "", "<1-4>", "Load & Mode", "Select wash mode", 1},
+    {CommandId::Modes, "modes", "", "", "Load & Mode", "Show available modes", 0},
+    {CommandId::Start, "start", "", "", "Cycle Control", "Start wash cycle", 0},
+    {CommandId::Pause, "pause", "", "", "Cycle Control", "Pause current cycle", 0},
+    {CommandId::Resume, "resume", "", "", "Cycle Control", "Resume paused cycle", 0},
+    {CommandId::Stop, "stop", "", "", "Cycle Control", "Stop/cancel cycle", 0},
+    {CommandId::Emergency, "emergency", "", "", "Cycle Control", "Emergency stop (immediate)", 0},
+    {CommandId::Status, "status", "", "", "Information", "Show current status", 0},
+    {CommandId::Help, "help", "", "", "Information", "Show this help message", 0},
+    {CommandId::Clear, "clear", "cls", "", "Information", "Clear screen", 0},
+    {CommandId::Exit, "exit", "quit", "", "Information", "Exit simulator", 0},
+}};
+
+constexpr char asciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (asciiLower(a[i]) != asciiLower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Case-insensitive FNV-1a, seeded so the table builder can search for a
+// collision-free seed.
+constexpr uint32_t commandHash(std::string_view text, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : text) {
+        hash ^= static_cast<uint8_t>(asciiLower(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const CommandSpec* findCommand(std::string_view name);
+
+struct CommandTokens {
+    static constexpr size_t MAX_TOKENS = 8;
+
+    std::array<std::string_view, MAX_TOKENS> tokens;
+    size_t count;
+
+    std::string_view operator[](size_t index) const {
+        return tokens[index];
+    }
+};
+
+// Splits on blanks without copying; tokens point into the input, which must
+// outlive the result. Tokens beyond MAX_TOKENS are dropped.
+CommandTokens tokenizeCommand(std::string_view input);
+
+// Whole-token numeric parsing via std::from_chars: "3", "2.5" and "-1" are
+// accepted, "3kg" and "" are not.
+bool parseNumber(std::string_view text, int& value);
+bool parseNumber(std::string_view text, float& value);
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef COMPACT_FLEET_HPP
+#define COMPACT_FLEET_HPP
+
+#include "Checkpoint.hpp"
+#include "ConfigManager.hpp"
+#include "EventEngine.hpp"
+#include "FleetArena.hpp"
+#include "SimTime.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// How closely a machine's cycle phases are simulated.
+enum class Fidelity : uint8_t {
+    Full,         // water and motor integrated every tick
+    Coarse,       // one analytic update per phase; readings interpolated
+    Statistical   // phase boundaries only; readings are phase nominals
+};
+
+// Everything update() reads or writes for a machine in a cycle.
+struct CompactMachineHot {
+    static constexpr uint8_t DOOR_OPEN = 0x01;
+    static constexpr uint8_t DOOR_LOCKED = 0x02;
+    static constexpr uint8_t INLET_OPEN = 0x04;
+    static constexpr uint8_t DRAIN_OPEN = 0x08;
+    static constexpr uint8_t MOTOR_RUNNING = 0x10;
+
+    SimTime cycleTimeElapsed = 0;
+    SimTime totalCycleTime = 0;
+    SimTime phaseTimeElapsed = 0;
+    SimTime currentPhaseTime = 0;
+    float waterLevel = 0.0f;
+    float targetWaterLevel = 0.0f;
+    float reservoirLevel = 100.0f;
+    int32_t motorRPM = 0;
+    int32_t targetRPM = 0;
+    uint8_t state = static_cast<uint8_t>(State::Idle);
+    uint8_t flags = DOOR_OPEN;
+    uint8_t direction = static_cast<uint8_t>(Direction::Stopped);
+    uint8_t pausedFrom = static_cast<uint8_t>(State::Idle);
+};
+
+// Settings and the cycle plan; touched by commands and phase changes only.
+struct CompactMachineCold {
+    static constexpr uint8_t NO_PLAN = 0xFF;
+
+    SimTime phaseStart = 0;
+    float loadKg = 0.0f;
+    float planLoadKg = 0.0f;
+    float planTargetWater = 0.0f;
+    float planFillTime = 0.0f;
+    float planWashTime = 0.0f;
+    float planRinseTime = 0.0f;
+    float planSpinTime = 0.0f;
+    int32_t planWashRPM = 0;
+    int32_t planSpinRPM = 0;
+    uint32_t deadlineGeneration = 0;
+    uint8_t modeIndex = 0;
+    uint8_t planModeIndex = NO_PLAN;
+    uint8_t fault = static_cast<uint8_t>(FaultCode::None);
+    bool listed = false;
+    bool monitored = false;
+    Fidelity fidelity = Fidelity::Full;
+    Fidelity effective = Fidelity::Full;
+};
+
+struct CompactEvent {
+    uint32_t machine;
+    uint8_t type;
+    bool hasData;
+    union {
+        int32_t intValue;
+        float floatValue;
+    };
+};
+
+struct CompactDeadline {
+    SimTime at;
+    uint32_t machine;
+    uint32_t generation;
+
+    bool operator>(const CompactDeadline& other) const { return at > other.at; }
+};
+
+struct FleetMemoryReport {
+    size_t machines = 0;
+    size_t capacity = 0;
+    size_t hotBytes = 0;
+    size_t coldBytes = 0;
+    size_t arenaBytes = 0;
+    size_t eventQueueBytes = 0;
+    size_t activeListBytes = 0;
+    size_t deadlineBytes = 0;
+    size_t sharedBytes = 0;
+
+    size_t totalBytes() const {
+        return arenaBytes + eventQueueBytes + activeListBytes + deadlineBytes + sharedBytes;
+    }
+    double bytesPerMachine() const {
+        return machines ? static_cast<double>(totalBytes()) / static_cast<double>(machines) : 0.0;
+    }
+};
+
+// Fleet-mode machines as plain records instead of WashingMachine objects.
+// Per-tick fields sit in one array and settings in another, both carved from
+// a single arena; the mode table is shared and there is no thread, event
+// engine or callback per machine. Events raised by any machine go into one
+// fleet-wide FIFO that is drained at the start of the next tick, so a machine
+// here behaves exactly like a detached MachineCore stepped with the same
+// commands and time steps. Water comes from each machine's own reservoir;
+// shared supply and power admission stay with Fleet.
+//
+// update() only visits machines on the active list. A machine joins it when
+// a command or event reaches it and leaves once a tick would no longer change
+// it: not in a cycle phase, motor stopped, valves settled and the door lock
+// in its final position. Idle, Ready, DoorOpen and Completed machines, and a
+// Paused machine whose drum has stopped, cost nothing per tick.
+//
+// A Coarse or Statistical machine is not on the active list during its cycle
+// phases. Each phase gets one deadline computed from its analytic duration.
+// When it expires, a Coarse machine is brought to the end-of-phase state in
+// closed form and posts the usual completion event. A Statistical machine
+// moves straight to the next phase using nominal values. Any command, injected
+// fault or monitor promotes the machine to Full for the rest of its cycle;
+// the configured level applies again from the next start.
+class CompactFleet {
+public:
+    using MachineId = uint32_t;
+    static constexpr int MAX_MODES = CompactMachineCold::NO_PLAN;
+
+private:
+    std::shared_ptr<const ConfigManager> modes;
+    FleetArena arena;
+    CompactMachineHot* hot;
+    CompactMachineCold* cold;
+    size_t count;
+    size_t capacity;
+    std::vector<CompactEvent> pending;
+    std::vector<MachineId> active;
+    bool tracking;
+    SimTime clock;
+    std::vector<CompactDeadline> deadlines;
+
+    void reserve(size_t machines);
+    void wake(MachineId id);
+    bool isQuiescent(MachineId id) const;
+    void rebuildActive();
+
+    bool isDeadlineDriven(MachineId id) const;
+    CompactMachineHot estimate(MachineId id) const;
+    CompactMachineHot reading(MachineId id) const;
+    void scheduleBoundary(MachineId id);
+    void fireDeadlines();
+    void promote(MachineId id);
+    void applyFidelity(MachineId id);
+
+    void post(MachineId id, EventType type);
+    void post(MachineId id, EventType type, int32_t value);
+    void post(MachineId id, EventType type, float value);
+    void handleEvent(const CompactEvent& event);
+    void updateMachine(MachineId id, SimTime deltaTime);
+
+    void enterState(MachineId id, State newState, State oldState);
+    void forceState(MachineId id, State state);
+    void currentPlan(MachineId id);
+    bool validateStart(MachineId id) const;
+
+    void updateWater(MachineId id, SimTime deltaTime);
+    void updateMotor(MachineId id, SimTime deltaTime);
+    void startFilling(MachineId id, float target);
+    void stopFilling(MachineId id);
+    void startDraining(MachineId id);
+    void startMotor(MachineId id, int rpm, Direction direction);
+    void stopMotor(MachineId id);
+    void emergencyStopMotor(MachineId id);
+    void unlockDoorWhenSafe(MachineId id);
+
+    void saveState(MachineId id, CheckpointWriter& writer) const;
+    bool decodeState(CheckpointReader& reader, CompactMachineHot& m, CompactMachineCold& c) const;
+
+public:
+    explicit CompactFleet(size_t machineCount = 0, std::shared_ptr<const ConfigManager> modeTable = nullptr);
+
+    CompactFleet(const CompactFleet&) = delete;
+    CompactFleet& operator=(const CompactFleet&) = delete;
+
+    // New machines start like a fresh MachineCore; shrinking drops the
+    // highest ids along with their queued events.
+    void resize(size_t machineCount);
+    size_t size() const;
+    size_t getCapacity() const;
+
+    void processPendingEvents();
+    void update(float deltaTime);
+    void update(SimTime deltaTime);
+    void tick(float deltaTime);
+    void tick(SimTime deltaTime);
+    size_t getPendingCount() const;
+
+    // With tracking off every machine is updated every tick; the result is
+    // the same, only slower.
+    void setActiveTracking(bool enabled);
+    bool getActiveTracking() const;
+    size_t getActiveCount() const;
+
+    // Both take effect at once, mid-phase included: a monitored machine runs
+    // at Full, otherwise at its configured level.
+    void setFidelity(MachineId id, Fidelity level);
+    Fidelity getFidelity(MachineId id) const;
+    Fidelity getEffectiveFidelity(MachineId id) const;
+    void setMonitored(MachineId id, bool monitored);
+    bool isMonitored(MachineId id) const;
+    // Simulated seconds since the fleet was created.
+    double getTime() const;
+
+    void openDoor(MachineId id);
+    void closeDoor(MachineId id);
+    void selectMode(MachineId id, int modeIndex);
+    void setLoad(MachineId id, float kg);
+    void start(MachineId id);
+    void pause(MachineId id);
+    void resume(MachineId id);
+    void stop(MachineId id);
+    void emergencyStop(MachineId id);
+    void clearFault(MachineId id);
+    PushResult injectFault(MachineId id, FaultCode fault);
+
+    State getCurrentState(MachineId id) const;
+    State getPausedFromState(MachineId id) const;
+    SystemStatus getStatus(MachineId id) const;
+    SensorSample getSensorSample(MachineId id) const;
+    const ConfigManager& getModeTable() const;
+
+    FleetMemoryReport getMemoryReport() const;
+
+    // Fleet checkpoints in the same record layout as Fleet's, so either can
+    // restore the other's. A compact machine keeps no previous state and
+    // saves its current one there. Restoring drops queued events, keeps each
+    // machine's fidelity settings and runs restored machines at Full until
+    // their next start; a bad record leaves the fleet as it was.
+    void saveCheckpoint(std::vector<uint8_t>& buffer) const;
+    bool restoreCheckpoint(const std::vector<uint8_t>& buffer);
+};
+
+#endif
@@ -2,27 +2,57 @@
 #define CONFIG_MANAGER_HPP
 
 #include "WashMode.hpp"
+#include <cstddef>
+#include <ostream>
 #include <vector>
 #include <string>
 
+// A read-only run of modes, either the built-in catalog or a loaded table.
+class WashModeList {
+private:
+    const WashMode* first;
+    size_t count;
+
+public:
+    WashModeList(const WashMode* first, size_t count) : first(first), count(count) {}
+
+    const WashMode* begin() const { return first; }
+    const WashMode* end() const { return first + count; }
+    size_t size() const { return count; }
+    const WashMode& operator[](size_t index) const { return first[index]; }
+};
+
+// Starts on BUILTIN_WASH_MODES, the modes of config/wash_modes.json compiled
+// in at build time, without parsing or allocating. loadConfig() replaces
+// them with a file read at run time; the loaded names are owned here, so a
+// manager is not copyable.
 class ConfigManager {
 private:
-    std::vector<WashMode> modes;
+    const WashMode* modes;
+    size_t modeCount;
+    std::vector<WashMode> loaded;
+    std::string loadedNames;
     std::string configPath;
 
     bool parseJsonFile(const std::string& path);
 
 public:
     ConfigManager();
+    ConfigManager(const ConfigManager&) = delete;
+    ConfigManager& operator=(const ConfigManager&) = delete;
 
     bool loadConfig(const std::string& path);
     void loadDefaultConfig();
 
     const WashMode& getMode(int index) const;
     int getModeCount() const;
-    const std::vector<WashMode>& getAllModes() const;
+    WashModeList getAllModes() const;
+    bool isBuiltin() const;
+    // Heap held by a loaded table; zero on the built-in catalog.
+    size_t getHeapBytes() const;
 
     void printModes() const;
+    void printModes(std::ostream& out) const;
 };
 
 #endif
\ No newline at end of file
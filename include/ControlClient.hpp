@@ -0,0 +1,45 @@
+#ifndef CONTROL_CLIENT_HPP
+#define CONTROL_CLIENT_HPP
+
+#ifdef __linux__
+
+#include "ControlProtocol.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Blocking client for the control socket. queue() only buffers, so a caller
+// pipelines by queueing a window of requests, flushing once and then
+// receiving the responses in order.
+class ControlClient {
+private:
+    int fd;
+    std::vector<uint8_t> outgoing;
+    std::vector<uint8_t> incoming;
+    size_t incomingStart;
+
+public:
+    ControlClient();
+    ~ControlClient();
+
+    ControlClient(const ControlClient&) = delete;
+    ControlClient& operator=(const ControlClient&) = delete;
+
+    bool connect(const std::string& path);
+    void close();
+    bool isConnected() const;
+    int getFd() const;
+
+    void queue(const ControlRequest& request);
+    bool flush();
+    bool receive(ControlResponse& response);
+
+    // One round trip: queue, flush and wait for the matching response.
+    // Status batches that arrive in between are skipped.
+    bool call(const ControlRequest& request, ControlResponse& response);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef CONTROL_PROTOCOL_HPP
+#define CONTROL_PROTOCOL_HPP
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Binary protocol of the control socket. Every frame is a uint32 payload
+// length followed by the payload, all in host byte order (the socket is
+// local). Requests carry a client-chosen sequence number that is echoed in
+// the response, so clients may pipeline any number of requests.
+//
+//   request:  op u8 | seq u32 | machine u32 | arg u32
+//   ack:      kind u8 | seq u32 | result u8 | state u8
+//   status:   kind u8 | seq u32 | result u8 | StatusRecord
+//   batch:    kind u8 | seq u32 | tick u32 | count u32 | StatusRecord * count
+//
+// arg is a mode index for SelectMode, a float load for SetLoad, and the
+// machine count for Subscribe (0 = every machine from the first). Batches
+// are pushed after every simulation tick and echo the Subscribe sequence.
+
+enum class ControlOp : uint8_t {
+    Ping,
+    OpenDoor,
+    CloseDoor,
+    SelectMode,
+    SetLoad,
+    Start,
+    Pause,
+    Resume,
+    Stop,
+    EmergencyStop,
+    ClearFault,
+    GetStatus,
+    Subscribe,
+    Unsubscribe
+};
+
+constexpr size_t CONTROL_OP_COUNT = static_cast<size_t>(ControlOp::Unsubscribe) + 1;
+
+enum class ControlResult : uint8_t {
+    Ok,
+    UnknownMachine,
+    UnknownOp,
+    Malformed
+};
+
+enum class ControlFrameKind : uint8_t {
+    Ack,
+    Status,
+    StatusBatch
+};
+
+struct StatusRecord {
+    uint32_t machineId;
+    uint8_t state;
+    uint8_t door;
+    uint8_t mode;
+    uint8_t fault;
+    float waterLevel;
+    float targetWaterLevel;
+    float loadKg;
+    float progressPercent;
+    int32_t motorRPM;
+    int32_t remainingSeconds;
+};
+
+static_assert(sizeof(StatusRecord) == 32, "StatusRecord is part of the wire format");
+
+struct ControlRequest {
+    ControlOp op;
+    uint32_t seq;
+    uint32_t machineId;
+    uint32_t arg;
+
+    int intArg() const;
+    float floatArg() const;
+};
+
+struct ControlResponse {
+    ControlFrameKind kind;
+    uint32_t seq;
+    ControlResult result;
+    State state;
+    uint32_t tick;
+    std::vector<StatusRecord> records;
+};
+
+constexpr size_t CONTROL_LENGTH_SIZE = sizeof(uint32_t);
+constexpr size_t CONTROL_REQUEST_SIZE = 13;
+constexpr size_t CONTROL_MAX_FRAME = 1u << 24;
+constexpr size_t CONTROL_BATCH_HEADER_SIZE = 13;
+// Records that fit in one StatusBatch frame. A larger subscription is
+// published as consecutive batches with the same seq and tick.
+constexpr size_t CONTROL_MAX_BATCH_RECORDS = (CONTROL_MAX_FRAME - CONTROL_BATCH_HEADER_SIZE) / sizeof(StatusRecord);
+
+StatusRecord makeStatusRecord(uint32_t machineId, const SystemStatus& status);
+
+ControlRequest makeRequest(ControlOp op, uint32_t seq, uint32_t machineId, uint32_t arg = 0);
+ControlRequest makeRequest(ControlOp op, uint32_t seq, uint32_t machineId, float arg);
+
+void encodeRequest(std::vector<uint8_t>& out, const ControlRequest& request);
+void encodeAck(std::vector<uint8_t>& out, uint32_t seq, ControlResult result, State state);
+void encodeStatus(std::vector<uint8_t>& out, uint32_t seq, ControlResult result, const StatusRecord& record);
+
+// Batches are written in two steps so the server can append records in
+// place: begin reserves the header, end patches length and count.
+size_t beginStatusBatch(std::vector<uint8_t>& out, uint32_t seq, uint32_t tick);
+void endStatusBatch(std::vector<uint8_t>& out, size_t start, uint32_t count);
+void appendStatusRecord(std::vector<uint8_t>& out, const StatusRecord& record);
+
+// Returns the size of the complete frame at data (length prefix included),
+// 0 if more bytes are needed, or -1 if the length is out of range.
+long frameSize(const uint8_t* data, size_t size);
+
+// Payload-only decoders; extra trailing bytes are ignored so fields can be
+// appended in later versions.
+bool decodeRequest(const uint8_t* payload, size_t size, ControlRequest& request);
+bool decodeResponse(const uint8_t* payload, size_t size, ControlResponse& response);
+
+#endif
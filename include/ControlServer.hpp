@@ -0,0 +1,85 @@
+#ifndef CONTROL_SERVER_HPP
+#define CONTROL_SERVER_HPP
+
+#ifdef __linux__
+
+#include "ControlProtocol.hpp"
+#include "Fleet.hpp"
+#include "Reactor.hpp"
+#include "WashingMachine.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Unix domain socket front end for one machine or a fleet, served from a
+// Reactor. Each readable event is parsed as a run of pipelined frames whose
+// responses are written back with one send; a client whose unsent output
+// passes the backlog limit is not read again until it drains. Commands are
+// applied immediately (the machine's queued events are processed before the
+// ack), so the state in an ack already reflects the command.
+class ControlServer {
+private:
+    struct Subscription {
+        uint32_t seq;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    struct Client {
+        int fd;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputStart;
+        bool throttled;
+        uint32_t interest;
+        std::vector<Subscription> subscriptions;
+    };
+
+    static constexpr size_t READ_CHUNK = 64 * 1024;
+    static constexpr size_t OUTPUT_BACKLOG_LIMIT = 4 * 1024 * 1024;
+
+    Reactor& reactor;
+    Fleet* fleet;
+    WashingMachine* machine;
+    int listenFd;
+    std::string socketPath;
+    std::unordered_map<int, std::unique_ptr<Client>> clients;
+    uint32_t tickCount;
+    uint64_t requestCount;
+
+    size_t machineCount() const;
+    WashingMachine* machineFor(uint32_t id);
+
+    void onAccept();
+    void onClient(int fd, uint32_t events);
+    bool readInput(Client& client);
+    bool parseInput(Client& client);
+    void handleRequest(Client& client, const ControlRequest& request);
+    bool flush(Client& client);
+    void updateInterest(Client& client);
+    void closeClient(int fd);
+
+public:
+    ControlServer(Reactor& reactor, WashingMachine& machine);
+    ControlServer(Reactor& reactor, Fleet& fleet);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    bool listen(const std::string& path);
+    void close();
+
+    // Call after each simulation tick to push subscribed status batches.
+    void publishStatus();
+
+    size_t getClientCount() const;
+    uint64_t getRequestCount() const;
+};
+
+#endif
+
+#endif
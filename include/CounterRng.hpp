@@ -0,0 +1,97 @@
+#ifndef COUNTER_RNG_HPP
+#define COUNTER_RNG_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2,
+// 3"). The output is a pure function of (key, counter), so any number of
+// independent streams can be drawn in any order, on any thread, without
+// shared state: draw n of stream s under seed k is always the same value.
+class Philox4x32 {
+private:
+    static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53u;
+    static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57u;
+    static constexpr uint32_t WEYL_0 = 0x9E3779B9u;
+    static constexpr uint32_t WEYL_1 = 0xBB67AE85u;
+
+    static void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        hi = static_cast<uint32_t>(product >> 32);
+        lo = static_cast<uint32_t>(product);
+    }
+
+public:
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key) {
+        for (int round = 0; round < 10; round++) {
+            uint32_t hi0, lo0, hi1, lo1;
+            mulhilo(MULTIPLIER_0, counter[0], hi0, lo0);
+            mulhilo(MULTIPLIER_1, counter[2], hi1, lo1);
+            counter = {hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0};
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+        }
+        return counter;
+    }
+};
+
+// One Philox stream: the key is the seed, the counter's upper half names the
+// stream and its lower half is the draw index. Copying a CounterRng forks it;
+// setPosition() rewinds or skips ahead in O(1).
+class CounterRng {
+private:
+    Philox4x32::Key key;
+    uint64_t stream;
+    uint64_t position;
+
+public:
+    CounterRng(uint64_t seed, uint64_t streamId, uint64_t start = 0)
+        : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          stream(streamId),
+          position(start) {}
+
+    static uint64_t at(uint64_t seed, uint64_t streamId, uint64_t index) {
+        Philox4x32::Counter block = Philox4x32::generate(
+            {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+             static_cast<uint32_t>(streamId), static_cast<uint32_t>(streamId >> 32)},
+            {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)});
+        return (static_cast<uint64_t>(block[1]) << 32) | block[0];
+    }
+
+    uint64_t next() {
+        Philox4x32::Counter block = Philox4x32::generate(
+            {static_cast<uint32_t>(position), static_cast<uint32_t>(position >> 32),
+             static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)},
+            key);
+        position++;
+        return (static_cast<uint64_t>(block[1]) << 32) | block[0];
+    }
+
+    // Uniform on (0, 1]; never zero, so it is safe to take the log of.
+    double nextUniform() {
+        return (static_cast<double>(next() >> 11) + 1.0) * 0x1.0p-53;
+    }
+
+    // Exponentially distributed with the given rate (events per unit time).
+    double nextExponential(double rate) {
+        return -std::log(nextUniform()) / rate;
+    }
+
+    uint64_t getStream() const {
+        return stream;
+    }
+
+    uint64_t getPosition() const {
+        return position;
+    }
+
+    void setPosition(uint64_t index) {
+        position = index;
+    }
+};
+
+#endif
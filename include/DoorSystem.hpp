@@ -2,6 +2,7 @@
 #define DOOR_SYSTEM_HPP
 
 #include "Types.hpp"
+#include "Checkpoint.hpp"
 #include <functional>
 
 class DoorSystem {
@@ -26,6 +27,11 @@ public:
     DoorStatus getStatus() const;
 
     std::string getStatusString() const;
+    // Bytes written by saveState().
+    static constexpr size_t CHECKPOINT_BYTES = 2;
+    void saveState(CheckpointWriter& writer) const;
+    bool restoreState(CheckpointReader& reader);
+
     void reset();
 };
 
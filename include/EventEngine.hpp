@@ -2,30 +2,117 @@
 #define EVENT_ENGINE_HPP
 
 #include "Event.hpp"
-#include <queue>
+#include "BoundedQueue.hpp"
+#include <array>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 #include <atomic>
 #include <functional>
 #include <optional>
+#include <thread>
+#include <cstdint>
+
+enum class OverflowPolicy {
+    Block,
+    DropOldest,
+    DropNewest,
+    Reject
+};
+
+enum class PushResult {
+    Accepted,
+    Coalesced,
+    DroppedOldest,
+    DroppedNewest,
+    Rejected
+};
+
+struct EventLaneStats {
+    size_t depth;
+    size_t capacity;
+    OverflowPolicy policy;
+    uint64_t pushed;
+    uint64_t popped;
+    uint64_t coalesced;
+    uint64_t dropped;
+    uint64_t rejected;
+    uint64_t blocked;
+    uint64_t spilled;
+    double blockedMicros;
+    double averageWaitMicros;
+    double maxWaitMicros;
+};
 
 class EventEngine {
 private:
-    std::queue<Event> eventQueue;
-    mutable std::mutex queueMutex;
+    struct Lane {
+        std::unique_ptr<BoundedQueue<Event>> queue;
+        // Overflow for Block pushes that cannot wait, as large as the queue.
+        std::unique_ptr<BoundedQueue<Event>> spill;
+        // Safety events that found the spill full. Only the Safety lane has
+        // one, so it never rejects a push; spillCount covers both.
+        std::unique_ptr<std::deque<Event>> overflow;
+        std::mutex overflowMutex;
+        std::atomic<size_t> overflowCount{0};
+        std::atomic<size_t> spillCount{0};
+        std::atomic<OverflowPolicy> policy{OverflowPolicy::Block};
+        std::atomic<size_t> depth{0};
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> popped{0};
+        std::atomic<uint64_t> coalesced{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> blocked{0};
+        std::atomic<uint64_t> spilled{0};
+        std::atomic<uint64_t> blockedNanos{0};
+        std::atomic<uint64_t> totalWaitNanos{0};
+        std::atomic<uint64_t> maxWaitNanos{0};
+    };
+
+    std::array<Lane, EVENT_PRIORITY_COUNT> lanes;
+    std::array<std::atomic<bool>, EVENT_TYPE_COUNT> coalesceEnabled;
+    std::array<std::atomic<bool>, EVENT_TYPE_COUNT> coalescePending;
+
+    std::mutex waitMutex;
     std::condition_variable cv;
+    std::atomic<int> waiters;
+    // Producers blocked on a full lane wait here for the consumer to pop.
+    std::mutex spaceMutex;
+    std::condition_variable spaceCv;
+    std::atomic<int> spaceWaiters;
     std::atomic<bool> running;
+    std::atomic<std::thread::id> consumerThread;
     std::function<void(const Event&)> eventHandler;
+    std::function<void()> wakeHandler;
+
+    PushResult enqueue(Lane& lane, const Event& event);
+    bool tryPushInOrder(Lane& lane, const Event& event);
+    bool blockUntilPushed(Lane& lane, const Event& event);
+    bool spillEvent(Lane& lane, const Event& event);
+    std::optional<Event> popOldest(Lane& lane);
+    std::optional<Event> popFromLanes();
+    void recordPop(Lane& lane, const Event& event);
+    void notifyWaiters();
+    void notifySpaceWaiters();
 
 public:
+    static constexpr size_t DEFAULT_SAFETY_CAPACITY = 16;
+    static constexpr size_t DEFAULT_COMMAND_CAPACITY = 64;
+    static constexpr size_t DEFAULT_SYSTEM_CAPACITY = 32;
+    static constexpr size_t DEFAULT_TELEMETRY_CAPACITY = 32;
+
     EventEngine();
+    explicit EventEngine(const std::array<size_t, EVENT_PRIORITY_COUNT>& laneCapacities);
     ~EventEngine();
 
     void setEventHandler(std::function<void(const Event&)> handler);
-    void pushEvent(const Event& event);
-    void pushEvent(EventType type);
-    void pushEvent(EventType type, int data);
-    void pushEvent(EventType type, float data);
+    void setWakeHandler(std::function<void()> handler);
+    PushResult pushEvent(const Event& event);
+    PushResult pushEvent(EventType type);
+    PushResult pushEvent(EventType type, int data);
+    PushResult pushEvent(EventType type, float data);
 
     std::optional<Event> popEvent();
     std::optional<Event> waitForEvent();
@@ -33,9 +120,30 @@ public:
     size_t getQueueSize() const;
     void clear();
 
+    void setCoalescing(EventType type, bool enabled);
+    bool isCoalescing(EventType type) const;
+
+    bool setOverflowPolicy(EventPriority priority, OverflowPolicy policy);
+    OverflowPolicy getOverflowPolicy(EventPriority priority) const;
+    size_t getLaneCapacity(EventPriority priority) const;
+
+    size_t getLaneDepth(EventPriority priority) const;
+    EventLaneStats getLaneStats(EventPriority priority) const;
+    void resetLaneStats();
+
     void start();
     void stop();
     bool isRunning() const;
 };
 
-#endif
\ No newline at end of file
+inline std::string overflowPolicyToString(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::Block: return "Block";
+        case OverflowPolicy::DropOldest: return "DropOldest";
+        case OverflowPolicy::DropNewest: return "DropNewest";
+        case OverflowPolicy::Reject: return "Reject";
+        default: return "Unknown";
+    }
+}
+
+#endif
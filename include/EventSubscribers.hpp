@@ -0,0 +1,117 @@
+#ifndef EVENT_SUBSCRIBERS_HPP
+#define EVENT_SUBSCRIBERS_HPP
+
+#include "Event.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+// One bit per EventType.
+using EventMask = uint32_t;
+static_assert(EVENT_TYPE_COUNT < 32, "EventMask has one bit per event type");
+
+constexpr EventMask eventBit(EventType type) {
+    return EventMask(1) << static_cast<unsigned>(type);
+}
+
+template<typename... Types>
+constexpr EventMask eventMask(Types... types) {
+    return (EventMask(0) | ... | eventBit(types));
+}
+
+// Run-time subscribers, one array per event type. A core publishes every
+// event after handling it; publish() tests the type's bit and returns, so
+// types nobody subscribed to cost one branch, and the rest cost one call
+// per subscriber of that type. The source is whatever id the publisher was
+// connected with, so one set can serve a whole fleet.
+//
+// Subscribe and unsubscribe before events flow, or from the thread that
+// publishes; not from inside a handler. publish() only reads, so machines
+// on different threads may publish into one set at once, and their handlers
+// then run concurrently.
+class EventSubscribers {
+public:
+    using MachineId = uint32_t;
+    using Handler = std::function<void(MachineId, const Event&)>;
+    using SubscriptionId = uint32_t;
+    static constexpr SubscriptionId NO_SUBSCRIPTION = 0;
+
+private:
+    struct Entry {
+        SubscriptionId id;
+        Handler handler;
+    };
+
+    std::array<std::vector<Entry>, EVENT_TYPE_COUNT> lists;
+    EventMask active;
+    SubscriptionId nextId;
+
+    void deliver(MachineId source, const Event& event) const;
+
+public:
+    EventSubscribers();
+
+    SubscriptionId subscribe(EventType type, Handler handler);
+    // One subscription for several types; unsubscribe() removes all of them.
+    SubscriptionId subscribe(EventMask types, Handler handler);
+    bool unsubscribe(SubscriptionId id);
+    void clear();
+
+    bool hasSubscribers(EventType type) const {
+        return (active & eventBit(type)) != 0;
+    }
+    EventMask getSubscribedTypes() const { return active; }
+    size_t getSubscriberCount(EventType type) const;
+
+    void publish(MachineId source, const Event& event) const {
+        if (hasSubscribers(event.getType())) {
+            deliver(source, event);
+        }
+    }
+};
+
+// Subscribers fixed at compile time, as a machine's SubscriberPolicy. Each
+// type provides `static constexpr EventMask events` and
+// `void onEvent(const Event&)`, and is held by value in the core. The
+// union of their masks is a constant, so a type none of them listens to is
+// rejected by one test, and NoSubscribers compiles to nothing.
+template<typename... Subscribers>
+class StaticSubscribers {
+private:
+    std::tuple<Subscribers...> members;
+
+    template<typename Subscriber>
+    static void deliverTo(Subscriber& subscriber, const Event& event) {
+        if ((Subscriber::events & eventBit(event.getType())) != 0) {
+            subscriber.onEvent(event);
+        }
+    }
+
+public:
+    static constexpr EventMask events = (EventMask(0) | ... | Subscribers::events);
+
+    void publish(const Event& event) {
+        if ((events & eventBit(event.getType())) == 0) {
+            return;
+        }
+        std::apply([&event](Subscribers&... subscriber) { (deliverTo(subscriber, event), ...); }, members);
+    }
+
+    template<typename Subscriber>
+    Subscriber& get() {
+        return std::get<Subscriber>(members);
+    }
+
+    template<typename Subscriber>
+    const Subscriber& get() const {
+        return std::get<Subscriber>(members);
+    }
+};
+
+using NoSubscribers = StaticSubscribers<>;
+
+#endif
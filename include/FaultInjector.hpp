@@ -0,0 +1,126 @@
+#ifndef FAULT_INJECTOR_HPP
+#define FAULT_INJECTOR_HPP
+
+#include "Types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+class Fleet;
+
+// FaultCode::WaterUnavailable .. FaultCode::Timeout.
+constexpr size_t INJECTABLE_FAULT_COUNT = static_cast<size_t>(FaultCode::Timeout);
+
+inline size_t faultSlot(FaultCode fault) {
+    return static_cast<size_t>(fault) - 1;
+}
+
+inline FaultCode faultFromSlot(size_t slot) {
+    return static_cast<FaultCode>(slot + 1);
+}
+
+struct FaultInjectorStats {
+    std::array<uint64_t, INJECTABLE_FAULT_COUNT> injected;
+    uint64_t scheduled;
+    uint64_t rejected;
+
+    uint64_t total() const {
+        uint64_t sum = 0;
+        for (uint64_t count : injected) {
+            sum += count;
+        }
+        return sum;
+    }
+};
+
+// Drives FAULT_* (and TIMER_TIMEOUT) events into a fleet, either at fixed
+// times or as independent Poisson processes per machine and fault code.
+//
+// Each machine owns a counter-based random stream (seed, machine id), so the
+// faults a machine sees depend only on the seed, its rates and how far
+// simulated time has advanced: not on fleet size, thread count or the order
+// machines are visited in. Arrival times are drawn ahead, so a tick costs one
+// comparison per machine and random numbers are only generated when a fault
+// fires. advance() splits the fleet into contiguous ranges, one per thread;
+// nothing is shared between ranges, so there is no locking.
+class FaultInjector {
+public:
+    // Returns false if the machine did not accept the event.
+    using FaultSink = std::function<bool(size_t machine, FaultCode fault)>;
+
+private:
+    struct MachineFaults {
+        std::array<double, INJECTABLE_FAULT_COUNT> nextAt;
+        std::array<double, INJECTABLE_FAULT_COUNT> ratePerSecond;
+        double earliest;
+        uint64_t draws;
+    };
+
+    struct ScheduledFault {
+        double at;
+        uint64_t order;
+        size_t machine;
+        FaultCode fault;
+
+        bool operator>(const ScheduledFault& other) const {
+            return at != other.at ? at > other.at : order > other.order;
+        }
+    };
+
+    struct RangeCounts {
+        std::array<uint64_t, INJECTABLE_FAULT_COUNT> injected{};
+        uint64_t rejected = 0;
+    };
+
+    uint64_t seed;
+    double now;
+    std::array<double, INJECTABLE_FAULT_COUNT> defaultRates;
+    std::vector<MachineFaults> machines;
+    std::priority_queue<ScheduledFault, std::vector<ScheduledFault>, std::greater<ScheduledFault>> scheduled;
+    uint64_t scheduleOrder;
+    unsigned threadCount;
+    FaultInjectorStats stats;
+
+    void drawArrival(size_t machine, size_t slot, double from);
+    void initMachine(size_t machine);
+    void fireRange(size_t begin, size_t end, const FaultSink& sink, RangeCounts& counts);
+
+public:
+    explicit FaultInjector(uint64_t seed = 0, size_t machineCount = 0);
+
+    void resize(size_t machineCount);
+    size_t size() const;
+    uint64_t getSeed() const;
+
+    // Rates are in faults per simulated hour; zero disables. The fleet-wide
+    // setter overrides any per-machine rate for that fault.
+    void setRate(FaultCode fault, double perHour);
+    void setRate(size_t machine, FaultCode fault, double perHour);
+    double getRate(size_t machine, FaultCode fault) const;
+
+    // Fires once when simulated time reaches `atSeconds`, before any random
+    // fault of the same tick.
+    void schedule(size_t machine, FaultCode fault, double atSeconds);
+    size_t getScheduledCount() const;
+
+    void setThreadCount(unsigned threads);
+    double getTime() const;
+
+    // Advances simulated time and delivers every fault due by then, in
+    // arrival order per machine. With several threads, `sink` is called
+    // concurrently for different machines. Returns the number delivered.
+    size_t advance(double deltaSeconds, const FaultSink& sink);
+
+    // Pushes each fault into the matching machine's event queue. Faults for
+    // machines beyond the fleet's size count as rejected.
+    size_t advance(Fleet& fleet, double deltaSeconds);
+
+    FaultInjectorStats getStats() const;
+    void resetStats();
+};
+
+#endif
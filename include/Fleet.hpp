@@ -0,0 +1,125 @@
+#ifndef FLEET_HPP
+#define FLEET_HPP
+
+#include "WashingMachine.hpp"
+#include "WaterSupply.hpp"
+#include "PowerAdmissionController.hpp"
+#include "TimingWheel.hpp"
+#include "Checkpoint.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Fleet {
+private:
+    std::vector<std::unique_ptr<WashingMachine>> machines;
+    WaterSupply* waterSupply;
+    PowerAdmissionController* powerController;
+    TimingWheel* timingWheel;
+    EventSubscribers* subscribers;
+
+    // The snapshot being taken, if any. Each record is written once, by
+    // whichever thread claims it first.
+    static constexpr uint8_t RECORD_MISSING = 0;
+    static constexpr uint8_t RECORD_WRITING = 1;
+    static constexpr uint8_t RECORD_WRITTEN = 2;
+    std::mutex snapshotMutex;
+    std::atomic<bool> snapshotting;
+    std::vector<uint8_t>* snapshotBuffer;
+    size_t snapshotHeader;
+    size_t snapshotCount;
+    std::unique_ptr<std::atomic<uint8_t>[]> snapshotTaken;
+    size_t snapshotCapacity;
+
+    void preserve(size_t id);
+
+public:
+    Fleet();
+    explicit Fleet(size_t count);
+    ~Fleet();
+
+    Fleet(const Fleet&) = delete;
+    Fleet& operator=(const Fleet&) = delete;
+
+    size_t addMachine();
+    void resize(size_t count);
+    size_t size() const;
+
+    WashingMachine& getMachine(size_t id);
+    const WashingMachine& getMachine(size_t id) const;
+
+    void connectWaterSupply(WaterSupply* supply);
+    void connectPowerController(PowerAdmissionController* controller);
+    // One wheel for every machine's watchdog, advanced by tick(); nullptr
+    // gives each machine back its own.
+    void connectTimingWheel(TimingWheel* wheel);
+    // One subscriber set for every machine; events arrive with the machine's
+    // id as their source.
+    void connectSubscribers(EventSubscribers* eventSubscribers);
+
+    void tick(float deltaTime);
+
+    void saveCheckpoint(std::vector<uint8_t>& buffer) const;
+    bool restoreCheckpoint(const std::vector<uint8_t>& buffer);
+
+    // Copy-on-write form of saveCheckpoint(). beginSnapshot() writes the
+    // header and sizes the buffer; finishSnapshot() writes the records still
+    // missing and may run on another thread. Until then tick(), getMachine()
+    // and resizing first save each machine they are about to touch, so the
+    // buffer ends up holding the fleet as it was at beginSnapshot(). Starting
+    // a snapshot into the buffer of an unfinished one abandons it; into any
+    // other buffer, it finishes it first.
+    void beginSnapshot(std::vector<uint8_t>& buffer);
+    void finishSnapshot();
+};
+
+// Double-buffered fleet snapshots. capture() starts a copy-on-write snapshot
+// into whichever buffer is not being written and returns; a worker thread
+// then serialises the machines the simulation has not touched since and
+// persists the result. A capture that lands while another is still queued
+// replaces it (latest wins). The fleet must outlive the pending work: call
+// waitIdle() before destroying it.
+class BackgroundCheckpointer {
+private:
+    std::array<std::vector<uint8_t>, 2> buffers;
+    int writingIndex;
+    int pendingIndex;
+    std::string pendingPath;
+    Fleet* pendingFleet;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+    bool stopping;
+
+    std::atomic<uint64_t> completed;
+    std::atomic<uint64_t> failed;
+    std::atomic<uint64_t> superseded;
+    std::atomic<uint64_t> lastCaptureNanos;
+
+    void workerLoop();
+
+public:
+    BackgroundCheckpointer();
+    ~BackgroundCheckpointer();
+
+    BackgroundCheckpointer(const BackgroundCheckpointer&) = delete;
+    BackgroundCheckpointer& operator=(const BackgroundCheckpointer&) = delete;
+
+    void capture(Fleet& fleet, const std::string& path);
+    void waitIdle();
+
+    uint64_t getCompletedCount() const;
+    uint64_t getFailedCount() const;
+    uint64_t getSupersededCount() const;
+    double getLastCaptureMicros() const;
+};
+
+#endif
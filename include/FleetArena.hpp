@@ -0,0 +1,85 @@
+#ifndef FLEET_ARENA_HPP
+#define FLEET_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+// One cache-line-aligned block carved into typed arrays by bumping an offset.
+// Arrays are never freed on their own; the whole block goes with the arena,
+// so only trivially copyable, trivially destructible records belong here.
+class FleetArena {
+private:
+    uint8_t* block;
+    size_t capacity;
+    size_t used;
+
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    explicit FleetArena(size_t bytes = 0)
+        : block(nullptr), capacity(roundUp(bytes)), used(0) {
+        if (capacity > 0) {
+            block = static_cast<uint8_t*>(std::aligned_alloc(ALIGNMENT, capacity));
+            if (!block) {
+                throw std::bad_alloc();
+            }
+        }
+    }
+
+    FleetArena(const FleetArena&) = delete;
+    FleetArena& operator=(const FleetArena&) = delete;
+
+    FleetArena(FleetArena&& other) noexcept
+        : block(other.block), capacity(other.capacity), used(other.used) {
+        other.block = nullptr;
+        other.capacity = 0;
+        other.used = 0;
+    }
+
+    FleetArena& operator=(FleetArena&& other) noexcept {
+        if (this != &other) {
+            std::free(block);
+            block = other.block;
+            capacity = other.capacity;
+            used = other.used;
+            other.block = nullptr;
+            other.capacity = 0;
+            other.used = 0;
+        }
+        return *this;
+    }
+
+    ~FleetArena() {
+        std::free(block);
+    }
+
+    static constexpr size_t roundUp(size_t bytes) {
+        return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // Each array starts on its own cache line. Throws std::bad_alloc when
+    // the block is exhausted rather than falling back to the heap.
+    template<typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                      "arena records must be plain data");
+        size_t bytes = roundUp(sizeof(T) * count);
+        if (bytes > capacity - used) {
+            throw std::bad_alloc();
+        }
+        T* array = reinterpret_cast<T*>(block + used);
+        used += bytes;
+        for (size_t i = 0; i < count; i++) {
+            new (&array[i]) T();
+        }
+        return array;
+    }
+
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FLEET_EVENT_BUS_HPP
+#define FLEET_EVENT_BUS_HPP
+
+#include "Event.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// One event queue per shard for a whole fleet, in place of an EventEngine per
+// machine. Machine id % shard count picks the shard, so all events for a
+// machine share one queue and keep the order they were posted in; nothing is
+// ordered across machines. Any thread may post. Each shard is drained by one
+// thread at a time, which hands events to the handler grouped by machine in
+// id order, so a machine's state is touched once per round instead of once
+// per event interleaved with everyone else's.
+//
+// There are no priority lanes, coalescing or capacity limits: a shard queue
+// behaves like a detached MachineCore's pending list.
+class FleetEventBus {
+public:
+    using MachineId = uint32_t;
+    using Handler = std::function<void(MachineId, const Event&)>;
+
+private:
+    struct Entry {
+        MachineId machine;
+        Event event;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> queue;
+        // Used by the draining thread only.
+        std::vector<Entry> batch;
+        std::vector<uint64_t> order;
+        std::atomic<uint64_t> posted{0};
+        std::atomic<uint64_t> handled{0};
+        std::atomic<uint64_t> rounds{0};
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    void append(Shard& shard, MachineId machine, const Event& event);
+
+public:
+    explicit FleetEventBus(size_t shardCount = 1);
+
+    FleetEventBus(const FleetEventBus&) = delete;
+    FleetEventBus& operator=(const FleetEventBus&) = delete;
+
+    size_t getShardCount() const;
+    size_t shardOf(MachineId machine) const;
+
+    void post(MachineId machine, const Event& event);
+
+    // Batch submission: the same event to many machines, taking each shard's
+    // lock once per batch rather than once per machine.
+    void submit(const MachineId* machines, size_t count, const Event& event);
+    void submit(const std::vector<MachineId>& machines, const Event& event);
+    void submitRange(MachineId first, MachineId last, const Event& event);
+
+    // Hands every queued event of the shard to the handler, grouped by
+    // machine in id order. Events posted to the shard meanwhile (by the
+    // handler included) are handled in further rounds before this returns.
+    // Returns the number of events handled.
+    size_t drain(size_t shard, const Handler& handler);
+
+    // Drops queued events for machines at or above the given id.
+    void discardFrom(MachineId machine);
+
+    size_t getPendingCount(size_t shard) const;
+    size_t getPendingCount() const;
+    uint64_t getPostedCount(size_t shard) const;
+    uint64_t getHandledCount(size_t shard) const;
+    uint64_t getRoundCount(size_t shard) const;
+};
+
+#endif
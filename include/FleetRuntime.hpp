@@ -0,0 +1,170 @@
+#ifndef FLEET_RUNTIME_HPP
+#define FLEET_RUNTIME_HPP
+
+#include "ShardedFleet.hpp"
+#include "SpscRing.hpp"
+#include "Types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct RuntimeCommand {
+    enum class Kind : uint8_t {
+        OpenDoor,
+        CloseDoor,
+        SelectMode,
+        SetLoad,
+        Start,
+        Pause,
+        Resume,
+        Stop,
+        EmergencyStop,
+        ClearFault,
+        InjectFault
+    };
+
+    static constexpr uint32_t ALL_MACHINES = 0xFFFFFFFF;
+
+    Kind kind = Kind::Stop;
+    uint32_t machine = ALL_MACHINES;
+    // Mode index, load in kg or FaultCode, depending on the kind.
+    float value = 0.0f;
+};
+
+// What one worker saw in its last tick. getTotals() sums them over workers.
+struct ShardReport {
+    static constexpr size_t STATE_COUNT = static_cast<size_t>(State::Fault) + 1;
+
+    uint64_t tick = 0;
+    size_t machines = 0;
+    std::array<uint32_t, STATE_COUNT> stateCounts{};
+    float waterDemand = 0.0f;
+    float waterFlow = 0.0f;
+    float powerCommitted = 0.0f;
+    size_t powerWaiting = 0;
+    // Wall time of the tick; in totals, the slowest worker's.
+    double tickSeconds = 0.0;
+};
+
+struct RuntimeOptions {
+    // 0 means one worker per CPU the process may run on.
+    size_t workers = 0;
+    // Pin worker i to the i-th allowed CPU (Linux only; ignored elsewhere).
+    bool pin = true;
+    size_t ringCapacity = 1024;
+    // Fleet-wide limits split between workers; 0 means none.
+    float waterFlowLimit = 0.0f;
+    float powerLimitWatts = 0.0f;
+    // Give each worker a timing wheel for its machines' watchdog deadlines.
+    bool watchdog = false;
+};
+
+// A fleet split across worker threads, one per core. Worker w owns machines
+// w, w + n, w + 2n, ... (n workers) as its own ShardedFleet, which it builds
+// on its own thread after pinning itself, so the machines' memory is first
+// touched on that core's node. Nothing is shared between workers: the
+// controlling thread talks to each over a pair of single-producer /
+// single-consumer rings, one for commands and ticks, one for reports.
+//
+// tick() sends every worker a tick and waits for all reports, so workers run
+// in lock step. Shared limits are split into per-worker shares. Each worker
+// enforces its share with its own WaterSupply and PowerAdmissionController,
+// and the controller rebalances the shares from each tick's reports
+// (demand, committed and waiting power). The fleet-wide total never exceeds
+// the limit, but shares follow demand one tick late.
+class FleetRuntime {
+public:
+    using MachineId = uint32_t;
+    // Runs on the worker's thread at the start of each of its ticks. Local id
+    // i in the shard is machine i * workers + worker.
+    using ShardHook = std::function<void(size_t worker, ShardedFleet& shard)>;
+
+private:
+    struct Message {
+        enum class Kind : uint8_t {
+            Command,
+            Tick,
+            Status,
+            Stop
+        };
+        Kind kind = Kind::Stop;
+        RuntimeCommand command;
+        float deltaTime = 0.0f;
+        float waterShare = 0.0f;
+        float powerShare = 0.0f;
+    };
+
+    struct Reply {
+        enum class Kind : uint8_t {
+            Ready,
+            Tick,
+            Status
+        };
+        Kind kind = Kind::Ready;
+        ShardReport report;
+        SystemStatus status{};
+    };
+
+    struct Worker {
+        SpscRing<Message> inbox;
+        SpscRing<Reply> outbox;
+        std::thread thread;
+        int cpu = -1;
+        ShardReport report;
+        float waterShare = 0.0f;
+        float powerShare = 0.0f;
+
+        explicit Worker(size_t ringCapacity) : inbox(ringCapacity), outbox(ringCapacity) {}
+    };
+
+    size_t machineCount;
+    RuntimeOptions options;
+    ShardHook hook;
+    std::vector<std::unique_ptr<Worker>> workers;
+    uint64_t tickCount;
+
+    void workerLoop(size_t index, int cpu);
+    void sendTo(size_t worker, const Message& message);
+    Reply receiveFrom(size_t worker);
+    void rebalance();
+
+public:
+    explicit FleetRuntime(size_t machines, RuntimeOptions runtimeOptions = RuntimeOptions(), ShardHook shardHook = nullptr);
+    ~FleetRuntime();
+
+    FleetRuntime(const FleetRuntime&) = delete;
+    FleetRuntime& operator=(const FleetRuntime&) = delete;
+
+    // CPUs this process may run on, in order.
+    static std::vector<int> allowedCpus();
+
+    size_t size() const;
+    size_t getWorkerCount() const;
+    size_t workerOf(MachineId id) const;
+    // CPU the worker reported after pinning; -1 when not pinned or unknown.
+    int getWorkerCpu(size_t worker) const;
+
+    // Queued on the owning worker's ring and applied before its next tick,
+    // in the order sent.
+    void send(MachineId id, RuntimeCommand::Kind kind, float value = 0.0f);
+    void broadcast(RuntimeCommand::Kind kind, float value = 0.0f);
+
+    void tick(float deltaTime);
+    void run(long ticks, float deltaTime);
+    uint64_t getTickCount() const;
+
+    // A round trip to the owning worker; commands sent earlier apply first.
+    SystemStatus getStatus(MachineId id);
+
+    const ShardReport& getShardReport(size_t worker) const;
+    ShardReport getTotals() const;
+    float getWaterShare(size_t worker) const;
+    float getPowerShare(size_t worker) const;
+};
+
+#endif
@@ -0,0 +1,1225 @@
+#ifndef MACHINE_CORE_HPP
+#define MACHINE_CORE_HPP
+
+#include "StateMachine.hpp"
+#include "EventEngine.hpp"
+#include "DoorSystem.hpp"
+#include "WaterSystem.hpp"
+#include "MotorSystem.hpp"
+#include "WaterSupply.hpp"
+#include "PowerAdmissionController.hpp"
+#include "TimingWheel.hpp"
+#include "ConfigManager.hpp"
+#include "EventSubscribers.hpp"
+#include "WashMode.hpp"
+#include "Types.hpp"
+#include "Checkpoint.hpp"
+#include "SimTime.hpp"
+
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Phase durations for one cycle, fixed when the cycle starts. Clones of a
+// running core share the plan instead of recomputing it.
+struct CyclePlan {
+    int modeIndex;
+    float loadKg;
+    float targetWaterLiters;
+    float fillTime;
+    float washTime;
+    float rinseTime;
+    float spinTime;
+    int washRPM;
+    int spinRPM;
+};
+
+// Which deadline a core's watchdog is currently holding. Phase covers
+// washing, rinsing and spinning; DoorLock covers the door staying locked
+// after a cycle has ended.
+enum class WatchdogKind : uint8_t {
+    None,
+    Fill,
+    Phase,
+    Drain,
+    DoorLock
+};
+
+// Fill and drain deadlines are the expected time times the factor plus the
+// grace; phase deadlines are the phase time plus the grace.
+struct WatchdogLimits {
+    float fillFactor = 3.0f;
+    float drainFactor = 3.0f;
+    float graceSeconds = 60.0f;
+    float doorLockSeconds = 120.0f;
+};
+
+class CoreEventSink {
+public:
+    virtual ~CoreEventSink() = default;
+    virtual PushResult post(const Event& event) = 0;
+};
+
+// Where a core's messages go. Without a stream nothing is formatted, so a
+// silent core costs a branch per message and shares no state with others.
+class CoreLog {
+private:
+    std::ostream* stream;
+
+public:
+    explicit CoreLog(std::ostream* stream) : stream(stream) {}
+
+    template<typename T>
+    CoreLog& operator<<(const T& value) {
+        if (stream) {
+            *stream << value;
+        }
+        return *this;
+    }
+
+    CoreLog& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+        if (stream) {
+            manipulator(*stream);
+        }
+        return *this;
+    }
+};
+
+// The built-in mode table, created once and shared by every core.
+std::shared_ptr<const ConfigManager> defaultWashModes();
+
+// The simulation state of one machine without its thread or event engine.
+// Events raised by the subsystems go to the attached sink; a detached core
+// keeps them in its own pending list and drains them in step(). Copying a
+// core is O(state size): the mode table and cycle plan are shared, and the
+// copy is never registered with a water supply, power controller or
+// timing wheel.
+//
+// With a timing wheel connected, the core keeps one watchdog deadline for
+// its current phase. An expired deadline raises TIMER_TIMEOUT, which moves
+// the machine to Fault with FaultCode::Timeout. Deadlines are requested on
+// state entry and armed on the wheel in the next update(), so every wheel
+// call happens on the thread that updates the core.
+//
+// The door, water and motor models are template parameters, bound at
+// compile time; MachineCore is the build with DoorSystem, WaterSystem and
+// MotorSystem. A replacement model needs the same public interface as the
+// class it replaces. The water model raises its events through the functor
+// passed to update() and startFilling(), which the core resolves statically
+// to post().
+//
+// Every event the core handles is then published, with the state already
+// updated: first to the SubscriberPolicy (StaticSubscribers, fixed at
+// compile time and free when empty), then to an EventSubscribers set if one
+// is connected. Commands applied directly, such as openDoor(), are not
+// events and are not published.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy = NoSubscribers>
+class BasicMachineCore : private TimerListener {
+private:
+    StateMachine stateMachine;
+    DoorPolicy door;
+    WaterPolicy water;
+    MotorPolicy motor;
+    std::shared_ptr<const ConfigManager> modes;
+    std::shared_ptr<const CyclePlan> plan;
+
+    int currentModeIndex;
+    float loadWeight;
+    float cycleProgress;
+    SimTime cycleTimeElapsed;
+    SimTime totalCycleTime;
+    SimTime phaseTimeElapsed;
+    SimTime currentPhaseTime;
+    FaultCode currentFault;
+
+    PowerAdmissionController* powerController;
+    size_t powerSlot;
+
+    TimingWheel* timerWheel;
+    TimingWheel::TimerId watchdogTimer;
+    WatchdogLimits watchdogLimits;
+    WatchdogKind watchdogKind;
+    float watchdogSeconds;
+    uint32_t watchdogSerial;
+    bool watchdogDirty;
+
+    CoreEventSink* sink;
+    std::vector<Event> pending;
+    std::ostream* output;
+
+    SubscriberPolicy subscriberPolicy;
+    EventSubscribers* subscribers;
+    EventSubscribers::MachineId subscriberSource;
+
+    PushResult post(const Event& event);
+    auto eventRaiser() {
+        return [this](EventType type) { post(Event(type)); };
+    }
+    CoreLog log() const;
+
+    void applyEvent(const Event& event);
+    void enterState(State newState, State oldState);
+    void forceState(State state);
+    void onStateEnter(State newState, State oldState);
+    void onStateExit(State oldState, State newState);
+
+    const CyclePlan& currentPlan();
+    std::shared_ptr<const CyclePlan> buildPlan() const;
+
+    void setWatchdog(WatchdogKind kind, float seconds);
+    void scheduleWatchdog(State state);
+    void syncWatchdog();
+    void onTimerExpired(uint32_t tag) override;
+
+    void beginCycle();
+    void startFillPhase();
+    void startWashPhase();
+    void startRinsePhase();
+    void startSpinPhase();
+    void admitHeldSpin();
+    // In Spinning with the drum not yet started, waiting for power.
+    bool spinHeld() const {
+        return stateMachine.getCurrentState() == State::Spinning && motor.getTargetRPM() == 0;
+    }
+    void startDrainPhase();
+
+    void executeEmergencyStop();
+    void unlockDoorWhenSafe();
+    bool validateStart() const;
+    bool commandAccepted(PushResult result) const;
+
+    float calculateDrainTime() const;
+
+public:
+    using Door = DoorPolicy;
+    using Water = WaterPolicy;
+    using Motor = MotorPolicy;
+    using Subscribers = SubscriberPolicy;
+
+    // Bytes written by saveState(): the subsystems, then mode, load,
+    // progress, four times and the fault code.
+    static constexpr size_t CHECKPOINT_BYTES =
+        StateMachine::CHECKPOINT_BYTES + DoorPolicy::CHECKPOINT_BYTES + WaterPolicy::CHECKPOINT_BYTES +
+        MotorPolicy::CHECKPOINT_BYTES + sizeof(int32_t) + 2 * sizeof(float) + 4 * sizeof(int64_t) + sizeof(uint8_t);
+
+    BasicMachineCore();
+    explicit BasicMachineCore(std::shared_ptr<const ConfigManager> modeTable);
+    BasicMachineCore(const BasicMachineCore& other);
+    BasicMachineCore& operator=(const BasicMachineCore& other);
+    ~BasicMachineCore();
+
+    static std::shared_ptr<const ConfigManager> defaultModes() {
+        return defaultWashModes();
+    }
+
+    void setModeTable(std::shared_ptr<const ConfigManager> modeTable);
+    const ConfigManager& getModeTable() const;
+    std::shared_ptr<const CyclePlan> getCyclePlan() const;
+
+    void setEventSink(CoreEventSink* eventSink);
+    void setOutput(std::ostream* stream);
+
+    void handleEvent(const Event& event);
+    void update(float deltaTime);
+    void update(SimTime deltaTime);
+    void processPendingEvents();
+    size_t getPendingCount() const;
+    void clearPending();
+    void step(float deltaTime);
+    void step(SimTime deltaTime);
+
+    void openDoor();
+    void closeDoor();
+    void selectMode(int modeIndex);
+    void setLoad(float kg);
+    void start();
+    void pause();
+    void resume();
+    void stop();
+    void emergencyStop();
+    void clearFault();
+    PushResult injectFault(FaultCode fault);
+
+    void connectWaterSupply(WaterSupply* supply);
+    void connectPowerController(PowerAdmissionController* controller);
+    void connectTimingWheel(TimingWheel* wheel);
+    // Events are published with source as their machine id; nullptr
+    // disconnects.
+    void connectSubscribers(EventSubscribers* eventSubscribers, EventSubscribers::MachineId source = 0);
+    SubscriberPolicy& getSubscriberPolicy();
+    const SubscriberPolicy& getSubscriberPolicy() const;
+
+    void setWatchdogLimits(const WatchdogLimits& limits);
+    const WatchdogLimits& getWatchdogLimits() const;
+    WatchdogKind getWatchdogKind() const;
+    // Time left on the armed deadline; 0 when none is armed.
+    float getWatchdogRemaining() const;
+
+    SystemStatus getStatus() const;
+    SensorSample getSensorSample() const;
+    const WashMode& getCurrentMode() const;
+    State getCurrentState() const;
+    State getPausedFromState() const;
+
+    void saveState(CheckpointWriter& writer) const;
+    bool restoreState(CheckpointReader& reader);
+};
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::BasicMachineCore() : BasicMachineCore(defaultModes()) {}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::BasicMachineCore(std::shared_ptr<const ConfigManager> modeTable)
+    : modes(modeTable ? std::move(modeTable) : defaultModes()),
+      currentModeIndex(0),
+      loadWeight(0.0f),
+      cycleProgress(0.0f),
+      cycleTimeElapsed(0),
+      totalCycleTime(0),
+      phaseTimeElapsed(0),
+      currentPhaseTime(0),
+      currentFault(FaultCode::None),
+      powerController(nullptr),
+      powerSlot(0),
+      timerWheel(nullptr),
+      watchdogTimer(TimingWheel::NO_TIMER),
+      watchdogKind(WatchdogKind::None),
+      watchdogSeconds(0.0f),
+      watchdogSerial(0),
+      watchdogDirty(false),
+      sink(nullptr),
+      output(&std::cout),
+      subscribers(nullptr),
+      subscriberSource(0) {}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::BasicMachineCore(const BasicMachineCore& other)
+    : stateMachine(other.stateMachine),
+      door(other.door),
+      water(other.water),
+      motor(other.motor),
+      modes(other.modes),
+      plan(other.plan),
+      currentModeIndex(other.currentModeIndex),
+      loadWeight(other.loadWeight),
+      cycleProgress(other.cycleProgress),
+      cycleTimeElapsed(other.cycleTimeElapsed),
+      totalCycleTime(other.totalCycleTime),
+      phaseTimeElapsed(other.phaseTimeElapsed),
+      currentPhaseTime(other.currentPhaseTime),
+      currentFault(other.currentFault),
+      powerController(nullptr),
+      powerSlot(0),
+      timerWheel(nullptr),
+      watchdogTimer(TimingWheel::NO_TIMER),
+      watchdogLimits(other.watchdogLimits),
+      watchdogKind(other.watchdogKind),
+      watchdogSeconds(other.getWatchdogRemaining()),
+      watchdogSerial(other.watchdogSerial),
+      watchdogDirty(false),
+      sink(nullptr),
+      pending(other.pending),
+      output(other.output),
+      subscriberPolicy(other.subscriberPolicy),
+      subscribers(nullptr),
+      subscriberSource(0) {}
+
+// Assignment takes the other core's simulation state but keeps this core's
+// sink, subscribers and its supply, power and timer registrations,
+// re-syncing the latter.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::operator=(const BasicMachineCore& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    stateMachine = other.stateMachine;
+    door = other.door;
+    water = other.water;
+    motor = other.motor;
+    modes = other.modes;
+    plan = other.plan;
+    currentModeIndex = other.currentModeIndex;
+    loadWeight = other.loadWeight;
+    cycleProgress = other.cycleProgress;
+    cycleTimeElapsed = other.cycleTimeElapsed;
+    totalCycleTime = other.totalCycleTime;
+    phaseTimeElapsed = other.phaseTimeElapsed;
+    currentPhaseTime = other.currentPhaseTime;
+    currentFault = other.currentFault;
+    pending = other.pending;
+
+    watchdogLimits = other.watchdogLimits;
+    watchdogSerial = other.watchdogSerial;
+    if (other.watchdogKind == WatchdogKind::None) {
+        setWatchdog(WatchdogKind::None, 0.0f);
+    } else {
+        scheduleWatchdog(stateMachine.getCurrentState());
+    }
+
+    if (powerController) {
+        // Loading a spinning core is a restore; see restoreState().
+        if (stateMachine.getCurrentState() == State::Spinning) {
+            powerController->forceAdmit(powerSlot, getCurrentMode().spinSpeedRPM);
+        } else {
+            powerController->endSpin(powerSlot);
+        }
+    }
+    return *this;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::~BasicMachineCore() {
+    water.detachSupply();
+    connectPowerController(nullptr);
+    connectTimingWheel(nullptr);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+PushResult BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::post(const Event& event) {
+    if (sink) {
+        return sink->post(event);
+    }
+    pending.push_back(event);
+    return PushResult::Accepted;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+CoreLog BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::log() const {
+    return CoreLog(output);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::setModeTable(std::shared_ptr<const ConfigManager> modeTable) {
+    modes = modeTable ? std::move(modeTable) : defaultModes();
+    if (currentModeIndex >= modes->getModeCount()) {
+        currentModeIndex = 0;
+    }
+    plan.reset();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+const ConfigManager& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getModeTable() const {
+    return *modes;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+std::shared_ptr<const CyclePlan> BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getCyclePlan() const {
+    return plan;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::setEventSink(CoreEventSink* eventSink) {
+    sink = eventSink;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::setOutput(std::ostream* stream) {
+    output = stream;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::enterState(State newState, State oldState) {
+    onStateExit(oldState, newState);
+    onStateEnter(newState, oldState);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::forceState(State state) {
+    State oldState = stateMachine.getCurrentState();
+    stateMachine.forceState(state);
+    enterState(state, oldState);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::onStateEnter(State newState, State oldState) {
+    switch (newState) {
+        case State::Filling:
+            startFillPhase();
+            break;
+        case State::Washing:
+            startWashPhase();
+            break;
+        case State::Rinsing:
+            startRinsePhase();
+            break;
+        case State::Spinning:
+            startSpinPhase();
+            break;
+        case State::Draining:
+            startDrainPhase();
+            break;
+        case State::Completed:
+            motor.stop();
+            unlockDoorWhenSafe();
+            log() << "\n*** CYCLE COMPLETE ***\n" << std::endl;
+            break;
+        case State::EmergencyStop:
+            executeEmergencyStop();
+            break;
+        case State::Fault:
+            motor.emergencyStop();
+            water.stopFilling();
+            water.startDraining();
+            break;
+        case State::Paused:
+            stateMachine.setPausedFromState(oldState);
+            motor.stop();
+            water.stopFilling();
+            break;
+        default:
+            break;
+    }
+    scheduleWatchdog(newState);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::onStateExit(State oldState, State newState) {
+    if (!powerController) {
+        return;
+    }
+
+    if (oldState == State::Spinning ||
+        (oldState == State::Rinsing && newState != State::Spinning)) {
+        powerController->endSpin(powerSlot);
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+std::shared_ptr<const CyclePlan> BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::buildPlan() const {
+    const WashMode& mode = getCurrentMode();
+    float duration = mode.getAdjustedDuration(loadWeight);
+
+    auto cycle = std::make_shared<CyclePlan>();
+    cycle->modeIndex = currentModeIndex;
+    cycle->loadKg = loadWeight;
+    cycle->targetWaterLiters = mode.getAdjustedWaterLevel(loadWeight);
+    cycle->fillTime = cycle->targetWaterLiters / 10.0f;
+    cycle->washTime = duration * 0.5f * 60.0f;
+    cycle->rinseTime = duration * 0.25f * 60.0f;
+    cycle->spinTime = duration * 0.15f * 60.0f;
+    cycle->washRPM = mode.spinSpeedRPM / 2;
+    cycle->spinRPM = mode.spinSpeedRPM;
+    return cycle;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+const CyclePlan& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::currentPlan() {
+    if (!plan || plan->modeIndex != currentModeIndex || plan->loadKg != loadWeight) {
+        plan = buildPlan();
+    }
+    return *plan;
+}
+
+// Every request bumps the serial, so a TIMER_TIMEOUT from an earlier
+// deadline that is still queued no longer matches and is dropped.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::setWatchdog(WatchdogKind kind, float seconds) {
+    watchdogKind = kind;
+    watchdogSeconds = seconds > 0.0f ? seconds : 0.0f;
+    watchdogSerial++;
+    watchdogDirty = true;
+}
+
+// Deadlines count from the start of the phase, so rescheduling part way
+// through (after a restore or a reconnect) keeps the original deadline.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::scheduleWatchdog(State state) {
+    switch (state) {
+        case State::Filling:
+            setWatchdog(WatchdogKind::Fill, toSeconds(currentPhaseTime) * watchdogLimits.fillFactor +
+                                                watchdogLimits.graceSeconds - toSeconds(phaseTimeElapsed));
+            break;
+        case State::Washing:
+        case State::Rinsing:
+        case State::Spinning:
+            if (spinHeld()) {
+                // As in Rinsing, the power queue bounds the wait.
+                setWatchdog(WatchdogKind::None, 0.0f);
+            } else {
+                setWatchdog(WatchdogKind::Phase, toSeconds(currentPhaseTime - phaseTimeElapsed) +
+                                                     watchdogLimits.graceSeconds);
+            }
+            break;
+        case State::Draining:
+            setWatchdog(WatchdogKind::Drain, toSeconds(currentPhaseTime) * watchdogLimits.drainFactor +
+                                                 watchdogLimits.graceSeconds - toSeconds(phaseTimeElapsed));
+            break;
+        case State::Paused:
+        case State::Fault:
+            setWatchdog(WatchdogKind::None, 0.0f);
+            break;
+        default:
+            // Out of a cycle with the door still locked while the drum
+            // drains or spins down; the deadline runs from when that began.
+            if (!door.isLocked()) {
+                setWatchdog(WatchdogKind::None, 0.0f);
+            } else if (watchdogKind != WatchdogKind::DoorLock) {
+                setWatchdog(WatchdogKind::DoorLock, watchdogLimits.doorLockSeconds);
+            }
+            break;
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::syncWatchdog() {
+    watchdogDirty = false;
+    if (!timerWheel) {
+        return;
+    }
+    if (watchdogTimer != TimingWheel::NO_TIMER) {
+        timerWheel->cancel(watchdogTimer);
+        watchdogTimer = TimingWheel::NO_TIMER;
+    }
+    if (watchdogKind != WatchdogKind::None) {
+        watchdogTimer = timerWheel->arm(watchdogSeconds, this, watchdogSerial);
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::onTimerExpired(uint32_t tag) {
+    if (tag != watchdogSerial) {
+        return;
+    }
+    watchdogTimer = TimingWheel::NO_TIMER;
+    log() << "Watchdog deadline passed.\n";
+    post(Event(EventType::TIMER_TIMEOUT, static_cast<int>(tag)));
+}
+
+// Runs where CMD_START is handled, so the plan and the cycle clock are only
+// ever written by the thread that updates the core.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::beginCycle() {
+    const CyclePlan& cycle = currentPlan();
+    totalCycleTime = toSimTime(cycle.fillTime) + toSimTime(cycle.washTime) + toSimTime(cycle.rinseTime) +
+                     toSimTime(cycle.spinTime) + toSimTime(calculateDrainTime());
+    cycleTimeElapsed = 0;
+    cycleProgress = 0.0f;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::startFillPhase() {
+    const CyclePlan& cycle = currentPlan();
+    water.startFilling(cycle.targetWaterLiters, eventRaiser());
+    currentPhaseTime = toSimTime(cycle.fillTime);
+    phaseTimeElapsed = 0;
+    door.lock();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::startWashPhase() {
+    const CyclePlan& cycle = currentPlan();
+    motor.start(cycle.washRPM, Direction::Clockwise);
+    currentPhaseTime = toSimTime(cycle.washTime);
+    phaseTimeElapsed = 0;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::startRinsePhase() {
+    motor.start(400, Direction::CounterClockwise);
+    currentPhaseTime = toSimTime(currentPlan().rinseTime);
+    phaseTimeElapsed = 0;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::startSpinPhase() {
+    const CyclePlan& cycle = currentPlan();
+    currentPhaseTime = toSimTime(cycle.spinTime);
+    phaseTimeElapsed = 0;
+    // Coming from Rinsing the spin is already admitted. Resuming a paused
+    // spin is a fresh request: the drum stays still until the queue admits
+    // it, and update() starts it then.
+    if (powerController && !powerController->requestSpin(powerSlot, cycle.spinRPM)) {
+        return;
+    }
+    motor.start(cycle.spinRPM, Direction::Clockwise);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::admitHeldSpin() {
+    const CyclePlan& cycle = currentPlan();
+    if (!powerController || powerController->requestSpin(powerSlot, cycle.spinRPM)) {
+        motor.start(cycle.spinRPM, Direction::Clockwise);
+        scheduleWatchdog(State::Spinning);
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::startDrainPhase() {
+    motor.stop();
+    water.startDraining();
+    currentPhaseTime = toSimTime(calculateDrainTime());
+    phaseTimeElapsed = 0;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::unlockDoorWhenSafe() {
+    if (water.getCurrentLevel() <= 0 && motor.getCurrentRPM() == 0) {
+        door.unlock();
+        if (watchdogKind == WatchdogKind::DoorLock) {
+            setWatchdog(WatchdogKind::None, 0.0f);
+        }
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::executeEmergencyStop() {
+    motor.emergencyStop();
+    water.stopFilling();
+    water.startDraining();
+    log() << "\n!!! EMERGENCY STOP ACTIVATED !!!\n" << std::endl;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+bool BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::commandAccepted(PushResult result) const {
+    if (result == PushResult::Rejected || result == PushResult::DroppedNewest) {
+        log() << "Command rejected: event queue is full.\n";
+        return false;
+    }
+    return true;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+bool BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::validateStart() const {
+    if (door.isOpen()) {
+        log() << "Error: Door is open. Please close the door.\n";
+        return false;
+    }
+
+    if (loadWeight <= 0) {
+        log() << "Error: No load set. Use 'load <kg>' command.\n";
+        return false;
+    }
+
+    if (loadWeight > 6.0f) {
+        log() << "Error: Load exceeds maximum capacity (6 kg).\n";
+        return false;
+    }
+
+    if (!water.checkReservoir()) {
+        log() << "Error: Water reservoir is low.\n";
+        return false;
+    }
+
+    return true;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+float BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::calculateDrainTime() const {
+    return water.getCurrentLevel() / 15.0f;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::handleEvent(const Event& event) {
+    applyEvent(event);
+    subscriberPolicy.publish(event);
+    if (subscribers) {
+        subscribers->publish(subscriberSource, event);
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::applyEvent(const Event& event) {
+    EventType type = event.getType();
+
+    // Watchdog timeouts carry the serial of the deadline that raised them.
+    // A live one faults the machine whatever its state; one raised before
+    // the machine moved on is stale. Raw TIMER_TIMEOUTs follow the table.
+    if (type == EventType::TIMER_TIMEOUT && event.hasData()) {
+        if (event.getData<int>() == static_cast<int>(watchdogSerial) &&
+            stateMachine.getCurrentState() != State::Fault) {
+            forceState(State::Fault);
+            currentFault = FaultCode::Timeout;
+        }
+        return;
+    }
+
+    if (type == EventType::CMD_SELECT_MODE && event.hasData()) {
+        currentModeIndex = event.getData<int>();
+    }
+
+    if (type == EventType::CMD_SET_LOAD && event.hasData()) {
+        loadWeight = event.getData<float>();
+    }
+
+    // start() validates before posting, but CMD_START can also arrive as a
+    // raw event; the interlocks must hold on that path too.
+    if (type == EventType::CMD_START && !validateStart()) {
+        return;
+    }
+
+    State oldState = stateMachine.getCurrentState();
+    if (!stateMachine.transition(type)) {
+        return;
+    }
+    State newState = stateMachine.getCurrentState();
+    if (type == EventType::CMD_START) {
+        beginCycle();
+    }
+    enterState(newState, oldState);
+
+    if (newState == State::Fault) {
+        currentFault = eventToFaultCode(type);
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::update(float deltaTime) {
+    update(toSimTime(deltaTime));
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::update(SimTime deltaTime) {
+    State state = stateMachine.getCurrentState();
+
+    if (watchdogDirty) {
+        syncWatchdog();
+    }
+
+    if (stateMachine.isActiveState()) {
+        water.update(deltaTime, eventRaiser());
+        motor.update(deltaTime);
+
+        bool held = spinHeld();
+        cycleTimeElapsed += deltaTime;
+        if (!held) {
+            phaseTimeElapsed += deltaTime;
+        }
+
+        if (totalCycleTime > 0) {
+            cycleProgress = percentOf(cycleTimeElapsed, totalCycleTime);
+        }
+
+        switch (state) {
+            case State::Washing:
+                if (phaseTimeElapsed >= currentPhaseTime) {
+                    post(Event(EventType::SYS_WASH_COMPLETE));
+                }
+                break;
+            case State::Rinsing:
+                if (phaseTimeElapsed >= currentPhaseTime) {
+                    if (!powerController || powerController->requestSpin(powerSlot, currentPlan().spinRPM)) {
+                        post(Event(EventType::SYS_RINSE_COMPLETE));
+                    } else if (watchdogKind == WatchdogKind::Phase) {
+                        // Queued for power: the controller's queue, not the
+                        // watchdog, bounds the wait.
+                        setWatchdog(WatchdogKind::None, 0.0f);
+                    }
+                }
+                break;
+            case State::Spinning:
+                if (held) {
+                    admitHeldSpin();
+                } else if (phaseTimeElapsed >= currentPhaseTime) {
+                    post(Event(EventType::SYS_SPIN_COMPLETE));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (state == State::Paused) {
+        motor.update(deltaTime);
+    }
+
+    // Outside a cycle the drum may still be draining or spinning down (after
+    // an emergency stop, a stop with an empty drum, or an early
+    // drain-complete signal); the door stays locked until both have finished.
+    if (!stateMachine.isActiveState() && state != State::Paused) {
+        water.update(deltaTime, eventRaiser());
+        motor.update(deltaTime);
+        unlockDoorWhenSafe();
+    }
+}
+
+// Handling an event may post further events; they are appended and handled
+// in the same pass, matching how the engine-backed machine drains its queue.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::processPendingEvents() {
+    for (size_t i = 0; i < pending.size(); i++) {
+        Event event = pending[i];
+        handleEvent(event);
+    }
+    pending.clear();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+size_t BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getPendingCount() const {
+    return pending.size();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::clearPending() {
+    pending.clear();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::step(float deltaTime) {
+    step(toSimTime(deltaTime));
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::step(SimTime deltaTime) {
+    processPendingEvents();
+    update(deltaTime);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::openDoor() {
+    if (door.canOpen()) {
+        door.openDoor();
+        stateMachine.transition(EventType::CMD_OPEN_DOOR);
+    } else {
+        log() << "Cannot open door: Machine is locked during operation.\n";
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::closeDoor() {
+    door.closeDoor();
+    stateMachine.transition(EventType::CMD_CLOSE_DOOR);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::selectMode(int modeIndex) {
+    if (modeIndex < 0 || modeIndex >= modes->getModeCount()) {
+        log() << "Invalid mode. Please select 1-" << modes->getModeCount() << ".\n";
+        return;
+    }
+
+    if (stateMachine.isActiveState()) {
+        log() << "Cannot change mode during active cycle.\n";
+        return;
+    }
+
+    if (!commandAccepted(post(Event(EventType::CMD_SELECT_MODE, modeIndex)))) {
+        return;
+    }
+    currentModeIndex = modeIndex;
+
+    const WashMode& mode = modes->getMode(modeIndex);
+    log() << "Mode selected: " << mode.name << "\n";
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::setLoad(float kg) {
+    if (stateMachine.isActiveState()) {
+        log() << "Cannot change load during active cycle.\n";
+        return;
+    }
+
+    if (kg < 0) {
+        log() << "Load cannot be negative.\n";
+        return;
+    }
+
+    if (kg > 6.0f) {
+        log() << "Warning: Maximum capacity is 6 kg.\n";
+    }
+
+    if (!commandAccepted(post(Event(EventType::CMD_SET_LOAD, kg)))) {
+        return;
+    }
+    loadWeight = kg;
+    log() << "Load set to " << kg << " kg.\n";
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::start() {
+    if (!validateStart()) {
+        return;
+    }
+
+    if (!commandAccepted(post(Event(EventType::CMD_START)))) {
+        return;
+    }
+    log() << "Starting wash cycle...\n";
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::pause() {
+    if (stateMachine.isActiveState()) {
+        if (commandAccepted(post(Event(EventType::CMD_PAUSE)))) {
+            log() << "Cycle paused.\n";
+        }
+    } else {
+        log() << "No active cycle to pause.\n";
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::resume() {
+    if (stateMachine.getCurrentState() == State::Paused) {
+        forceState(stateMachine.getPausedFromState());
+        log() << "Cycle resumed.\n";
+    } else {
+        log() << "No paused cycle to resume.\n";
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::stop() {
+    State state = stateMachine.getCurrentState();
+
+    if (state == State::Idle || state == State::DoorOpen) {
+        log() << "Machine is already stopped.\n";
+        return;
+    }
+
+    if (stateMachine.isActiveState() || state == State::Paused) {
+        motor.stop();
+        water.stopFilling();
+        if (water.getCurrentLevel() > 0) {
+            water.startDraining();
+            forceState(State::Draining);
+            log() << "Stopping... Draining water.\n";
+        } else {
+            unlockDoorWhenSafe();
+            forceState(State::Idle);
+            log() << "Machine stopped.\n";
+        }
+    } else {
+        commandAccepted(post(Event(EventType::CMD_STOP)));
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::emergencyStop() {
+    post(Event(EventType::CMD_EMERGENCY));
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::clearFault() {
+    if (stateMachine.getCurrentState() == State::Fault) {
+        if (commandAccepted(post(Event(EventType::FAULT_CLEARED)))) {
+            currentFault = FaultCode::None;
+            log() << "Fault cleared.\n";
+        }
+    }
+}
+
+// Raises a fault as if a subsystem had detected it. Faults that do not apply
+// to the current state are dropped by the transition table.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+PushResult BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::injectFault(FaultCode fault) {
+    if (fault == FaultCode::None) {
+        return PushResult::Rejected;
+    }
+    return post(Event(faultCodeToEvent(fault)));
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::connectWaterSupply(WaterSupply* supply) {
+    if (supply) {
+        water.attachSupply(supply);
+    } else {
+        water.detachSupply();
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::connectPowerController(PowerAdmissionController* controller) {
+    if (powerController) {
+        powerController->releaseMachine(powerSlot);
+        powerController = nullptr;
+        powerSlot = 0;
+    }
+    if (controller) {
+        powerController = controller;
+        powerSlot = controller->registerMachine();
+    }
+}
+
+// Wheel calls made through the old connection are cancelled here; the new
+// wheel gets the current phase's deadline on the next update().
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::connectTimingWheel(TimingWheel* wheel) {
+    if (timerWheel && watchdogTimer != TimingWheel::NO_TIMER) {
+        timerWheel->cancel(watchdogTimer);
+    }
+    watchdogTimer = TimingWheel::NO_TIMER;
+    timerWheel = wheel;
+    if (wheel) {
+        scheduleWatchdog(stateMachine.getCurrentState());
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::connectSubscribers(
+    EventSubscribers* eventSubscribers, EventSubscribers::MachineId source) {
+    subscribers = eventSubscribers;
+    subscriberSource = source;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+SubscriberPolicy& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getSubscriberPolicy() {
+    return subscriberPolicy;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+const SubscriberPolicy& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getSubscriberPolicy() const {
+    return subscriberPolicy;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::setWatchdogLimits(const WatchdogLimits& limits) {
+    watchdogLimits = limits;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+const WatchdogLimits& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getWatchdogLimits() const {
+    return watchdogLimits;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+WatchdogKind BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getWatchdogKind() const {
+    return watchdogKind;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+float BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getWatchdogRemaining() const {
+    if (watchdogKind == WatchdogKind::None) {
+        return 0.0f;
+    }
+    if (watchdogDirty || !timerWheel) {
+        return watchdogSeconds;
+    }
+    return timerWheel->getRemaining(watchdogTimer);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+SystemStatus BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getStatus() const {
+    SystemStatus status;
+    status.state = stateMachine.getCurrentState();
+    status.doorStatus = door.getStatus();
+    status.waterLevel = water.getCurrentLevel();
+    status.targetWaterLevel = water.getTargetLevel();
+    status.motorRPM = motor.getCurrentRPM();
+    status.loadKg = loadWeight;
+    status.modeIndex = currentModeIndex;
+    status.modeName = modes->getMode(currentModeIndex).name;
+    status.progressPercent = cycleProgress;
+
+    SimTime remaining = totalCycleTime - cycleTimeElapsed;
+    status.remainingSeconds = (remaining > 0) ? static_cast<int>(remaining / SIM_TIME_PER_SECOND) : 0;
+
+    status.fault = currentFault;
+    return status;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+SensorSample BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getSensorSample() const {
+    SensorSample sample;
+    sample.state = stateMachine.getCurrentState();
+    sample.doorStatus = door.getStatus();
+    sample.direction = motor.getDirection();
+    sample.fillValveOpen = water.isFilling();
+    sample.drainValveOpen = water.isDraining();
+    sample.waterLevel = water.getCurrentLevel();
+    sample.motorRPM = motor.getCurrentRPM();
+    return sample;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+const WashMode& BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getCurrentMode() const {
+    return modes->getMode(currentModeIndex);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+State BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getCurrentState() const {
+    return stateMachine.getCurrentState();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+State BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::getPausedFromState() const {
+    return stateMachine.getPausedFromState();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+void BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::saveState(CheckpointWriter& writer) const {
+    stateMachine.saveState(writer);
+    door.saveState(writer);
+    water.saveState(writer);
+    motor.saveState(writer);
+    writer.write<int32_t>(currentModeIndex);
+    writer.write<float>(loadWeight);
+    writer.write<float>(cycleProgress);
+    writer.write<int64_t>(cycleTimeElapsed);
+    writer.write<int64_t>(totalCycleTime);
+    writer.write<int64_t>(phaseTimeElapsed);
+    writer.write<int64_t>(currentPhaseTime);
+    writer.write<uint8_t>(static_cast<uint8_t>(currentFault));
+}
+
+// Pending events are not part of the record: checkpoints are taken between
+// ticks, and whatever is still queued at restore time is discarded. The
+// cycle plan is derived from mode and load and is rebuilt on demand. The
+// whole record is decoded into a per-thread scratch set of subsystems first,
+// so a bad one leaves the core as it was and a good one costs no copies of
+// the subsystems' callbacks.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename SubscriberPolicy>
+bool BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>::restoreState(CheckpointReader& reader) {
+    static thread_local StateMachine checkMachine;
+    static thread_local DoorPolicy checkDoor;
+    static thread_local WaterPolicy checkWater;
+    static thread_local MotorPolicy checkMotor;
+    CheckpointReader check = reader;
+    if (!checkMachine.restoreState(check) || !checkDoor.restoreState(check) ||
+        !checkWater.restoreState(check) || !checkMotor.restoreState(check)) {
+        return false;
+    }
+
+    int32_t modeIndex = 0;
+    float load = 0.0f;
+    float progress = 0.0f;
+    SimTime cycleElapsed = 0;
+    SimTime cycleTotal = 0;
+    SimTime phaseElapsed = 0;
+    SimTime phaseTime = 0;
+    uint8_t fault = 0;
+    if (!check.read(modeIndex) || !check.read(load) || !check.read(progress) ||
+        !check.read(cycleElapsed) || !check.read(cycleTotal) ||
+        !check.read(phaseElapsed) || !check.read(phaseTime) || !check.read(fault)) {
+        return false;
+    }
+    if (fault > static_cast<uint8_t>(FaultCode::Timeout)) {
+        return false;
+    }
+
+    stateMachine.restoreState(reader);
+    door.restoreState(reader);
+    water.restoreState(reader);
+    motor.restoreState(reader);
+    reader = check;
+    loadWeight = load;
+    cycleProgress = progress;
+    cycleTimeElapsed = cycleElapsed;
+    totalCycleTime = cycleTotal;
+    phaseTimeElapsed = phaseElapsed;
+    currentPhaseTime = phaseTime;
+    currentModeIndex = (modeIndex >= 0 && modeIndex < modes->getModeCount()) ? modeIndex : 0;
+    currentFault = static_cast<FaultCode>(fault);
+    plan.reset();
+
+    pending.clear();
+    scheduleWatchdog(stateMachine.getCurrentState());
+
+    if (powerController) {
+        // Restoring puts back a spin that was already under way, so it is
+        // admitted outright; this is the only use of forceAdmit.
+        if (stateMachine.getCurrentState() == State::Spinning) {
+            powerController->forceAdmit(powerSlot, getCurrentMode().spinSpeedRPM);
+        } else {
+            powerController->endSpin(powerSlot);
+        }
+    }
+    return true;
+}
+
+using MachineCore = BasicMachineCore<DoorSystem, WaterSystem, MotorSystem>;
+
+extern template class BasicMachineCore<DoorSystem, WaterSystem, MotorSystem>;
+
+#endif
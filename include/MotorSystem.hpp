@@ -2,6 +2,8 @@
 #define MOTOR_SYSTEM_HPP
 
 #include "Types.hpp"
+#include "Checkpoint.hpp"
+#include "SimTime.hpp"
 #include <functional>
 
 class MotorSystem {
@@ -24,6 +26,7 @@ public:
     void setDirection(Direction dir);
 
     void update(float deltaTimeSeconds);
+    void update(SimTime deltaTime);
 
     int getCurrentRPM() const;
     int getTargetRPM() const;
@@ -31,6 +34,11 @@ public:
     Direction getDirection() const;
 
     void emergencyStop();
+    // Bytes written by saveState().
+    static constexpr size_t CHECKPOINT_BYTES = 10;
+    void saveState(CheckpointWriter& writer) const;
+    bool restoreState(CheckpointReader& reader);
+
     void reset();
 };
 
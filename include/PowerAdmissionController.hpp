@@ -0,0 +1,80 @@
+#ifndef POWER_ADMISSION_CONTROLLER_HPP
+#define POWER_ADMISSION_CONTROLLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Fleet-level gate on the Rinsing -> Spinning transition. The committed draw
+// is kept as a running total, so each request, release and tick is O(1)
+// amortised regardless of how many machines share the building cap.
+//
+// Nothing here is locked: requests, releases and update() must all come from
+// the thread that ticks the machines, as in Fleet and ShardedFleet::tick().
+// Machines on their own simulation threads cannot share a controller; see
+// BasicWashingMachine::run().
+class PowerAdmissionController {
+public:
+    enum class SlotState : uint8_t {
+        Unused,
+        Idle,
+        Waiting,
+        Admitted
+    };
+
+private:
+    float powerLimitWatts;
+    float committedWatts;
+    float peakWatts;
+    double simTime;
+
+    std::vector<SlotState> slotState;
+    std::vector<float> slotWatts;
+    std::vector<double> waitStart;
+    std::vector<uint8_t> queued;
+    std::vector<size_t> freeSlots;
+    std::deque<size_t> waitQueue;
+    size_t waitingCount;
+
+    double totalDelaySeconds;
+    uint64_t admissions;
+    uint64_t delayedAdmissions;
+    uint64_t forcedAdmissions;
+
+    void admit(size_t slot, float watts);
+    void drainQueue();
+
+public:
+    explicit PowerAdmissionController(float powerLimitWatts);
+
+    size_t registerMachine();
+    void releaseMachine(size_t slot);
+
+    bool requestSpin(size_t slot, int rpm);
+    // Admits past the cap and the queue; only for restoring a core that was
+    // already spinning.
+    void forceAdmit(size_t slot, int rpm);
+    void endSpin(size_t slot);
+
+    void update(float deltaTimeSeconds);
+
+    static float estimateSpinPower(int rpm);
+
+    SlotState getSlotState(size_t slot) const;
+    float getPowerLimit() const;
+    void setPowerLimit(float watts);
+    float getCommittedPower() const;
+    float getPeakPower() const;
+    size_t getWaitingCount() const;
+
+    // Admissions through requestSpin(), immediate or queued. Forced ones
+    // (restores) are counted apart and left out of the per-cycle delay.
+    uint64_t getAdmissionCount() const;
+    uint64_t getDelayedAdmissionCount() const;
+    uint64_t getForcedAdmissionCount() const;
+    double getTotalDelaySeconds() const;
+    double getAddedMinutesPerCycle() const;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+// Single-threaded epoll loop. Handlers run on the thread that calls run();
+// stop() may be called from any thread.
+class Reactor {
+public:
+    using Handler = std::function<void(uint32_t events)>;
+
+private:
+    int epollFd;
+    int stopFd;
+    std::atomic<bool> running;
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers;
+
+public:
+    Reactor();
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    bool isOpen() const;
+
+    bool add(int fd, uint32_t events, Handler handler);
+    bool modify(int fd, uint32_t events);
+    void remove(int fd);
+
+    int runOnce(int timeoutMillis);
+    void run();
+    void stop();
+    bool isRunning() const;
+};
+
+// timerfd armed on an absolute CLOCK_MONOTONIC schedule, so processing time
+// in the handler never shifts later ticks.
+class PeriodicTimer {
+private:
+    int fd;
+    std::chrono::nanoseconds period;
+
+public:
+    explicit PeriodicTimer(std::chrono::nanoseconds period);
+    ~PeriodicTimer();
+
+    PeriodicTimer(const PeriodicTimer&) = delete;
+    PeriodicTimer& operator=(const PeriodicTimer&) = delete;
+
+    bool isOpen() const;
+    int getFd() const;
+    std::chrono::nanoseconds getPeriod() const;
+    uint64_t readExpirations();
+};
+
+// eventfd wake-up for the reactor. notify() only writes when the previous
+// wake-up has been drained, so bursts of notifications cost one syscall.
+class EventNotifier {
+private:
+    int fd;
+    std::atomic<bool> armed;
+
+public:
+    EventNotifier();
+    ~EventNotifier();
+
+    EventNotifier(const EventNotifier&) = delete;
+    EventNotifier& operator=(const EventNotifier&) = delete;
+
+    bool isOpen() const;
+    int getFd() const;
+    void notify();
+    void drain();
+};
+
+#endif
+
+#endif
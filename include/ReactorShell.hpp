@@ -0,0 +1,50 @@
+#ifndef REACTOR_SHELL_HPP
+#define REACTOR_SHELL_HPP
+
+#ifdef __linux__
+
+#include "WashingMachine.hpp"
+#include "CLI.hpp"
+#include "Reactor.hpp"
+#include "TickTimingStats.hpp"
+
+#include <chrono>
+#include <string>
+
+// Runs the interactive simulator on one thread: an epoll loop multiplexing
+// command input, a timerfd simulation tick and an eventfd signalled whenever
+// the machine's event engine receives an event. The machine must not be
+// running its own simulation thread. With inputFd < 0 the shell only ticks,
+// which is what the jitter benchmark uses.
+class ReactorShell {
+private:
+    WashingMachine& machine;
+    CLI& cli;
+    int inputFd;
+    Reactor reactor;
+    PeriodicTimer timer;
+    EventNotifier notifier;
+    TickTimingStats tickStats;
+    std::string pendingInput;
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline;
+
+    void onInput();
+    void onTimer();
+    void onNotify();
+
+public:
+    ReactorShell(WashingMachine& machine, CLI& cli, int inputFd,
+                 std::chrono::nanoseconds tickPeriod = std::chrono::milliseconds(50));
+    ~ReactorShell();
+
+    bool run();
+    void runFor(std::chrono::nanoseconds duration);
+    void stop();
+
+    const TickTimingStats& getTickStats() const;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SCRIPT_RUNNER_HPP
+#define SCRIPT_RUNNER_HPP
+
+#include "WashingMachine.hpp"
+#include "CLI.hpp"
+#include "TelemetryRecorder.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+struct ScriptResult {
+    size_t commands;
+    size_t expectations;
+    size_t failures;
+    size_t errors;
+    double simulatedSeconds;
+
+    bool passed() const {
+        return failures == 0 && errors == 0;
+    }
+};
+
+// Runs a command script against a virtual clock. Each line is a CLI command,
+// optionally prefixed with an absolute time (@HH:MM:SS, @MM:SS, @SS) or an
+// offset from the previous line (+HH:MM:SS); '#' starts a comment. Besides
+// the CLI commands a script may use 'expect <field> <value>' to assert on
+// state, door, fault, mode, rpm or water. Output is one JSON object per line.
+//
+// Time between commands is simulated in fixed steps, and skipped outright
+// while the machine is in a state where nothing evolves (Idle, Ready, ...).
+// The machine must not be running its own simulation thread.
+class ScriptRunner {
+private:
+    WashingMachine& machine;
+    std::ostream& out;
+    std::ostringstream captured;
+    CLI cli;
+    TelemetryRecorder* telemetry;
+
+    double clock;
+    float step;
+    size_t lineNumber;
+    State lastState;
+    ScriptResult result;
+
+    void advanceTo(double target);
+    void observe();
+    bool dispatch(const std::string& command);
+    void runCommand(const std::string& command);
+    void checkExpectation(const std::string& field, const std::string& expected);
+    void emitStatus();
+    void emitError(const std::string& message);
+    void emitSummary();
+    void beginRecord(const char* type, bool withLine);
+    std::string takeCaptured();
+
+public:
+    ScriptRunner(WashingMachine& machine, std::ostream& out);
+
+    void setStep(float seconds);
+    // Records a sensor sample after every simulated step.
+    void setTelemetry(TelemetryRecorder* recorder);
+
+    ScriptResult run(std::istream& script);
+    ScriptResult runFile(const std::string& path);
+
+    static bool parseTimestamp(const std::string& text, double& seconds);
+};
+
+#endif
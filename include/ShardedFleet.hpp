@@ -0,0 +1,75 @@
+#ifndef SHARDED_FLEET_HPP
+#define SHARDED_FLEET_HPP
+
+#include "FleetEventBus.hpp"
+#include "MachineCore.hpp"
+#include "WaterSupply.hpp"
+#include "PowerAdmissionController.hpp"
+#include "TimingWheel.hpp"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+// MachineCores whose events all go through one FleetEventBus instead of an
+// EventEngine each. A machine here behaves exactly like a detached
+// MachineCore stepped with the same commands: tick() drains every shard,
+// then updates every machine, and events raised during the update are
+// handled at the start of the next tick. Commands go through getMachine(id)
+// as usual; events aimed at many machines at once go through the bus's
+// batch submission.
+class ShardedFleet {
+public:
+    using MachineId = FleetEventBus::MachineId;
+
+private:
+    struct Slot final : CoreEventSink {
+        MachineCore core;
+        FleetEventBus* bus;
+        MachineId id;
+
+        Slot(std::shared_ptr<const ConfigManager> modes, FleetEventBus* owner, MachineId machine);
+        PushResult post(const Event& event) override;
+    };
+
+    std::shared_ptr<const ConfigManager> modes;
+    FleetEventBus bus;
+    std::deque<Slot> slots;
+    WaterSupply* waterSupply;
+    PowerAdmissionController* powerController;
+    TimingWheel* timingWheel;
+
+public:
+    explicit ShardedFleet(size_t machineCount = 0, size_t shardCount = 1,
+                          std::shared_ptr<const ConfigManager> modeTable = nullptr);
+
+    ShardedFleet(const ShardedFleet&) = delete;
+    ShardedFleet& operator=(const ShardedFleet&) = delete;
+
+    // Shrinking drops the highest ids along with their queued events.
+    void resize(size_t machineCount);
+    size_t size() const;
+
+    MachineCore& getMachine(MachineId id);
+    const MachineCore& getMachine(MachineId id) const;
+    FleetEventBus& getBus();
+
+    void connectWaterSupply(WaterSupply* supply);
+    void connectPowerController(PowerAdmissionController* controller);
+    // Watchdog deadlines for every machine, advanced by tick(). Machines arm
+    // their deadlines in update(), so with a wheel connected updateShard()
+    // must not run on several threads at once.
+    void connectTimingWheel(TimingWheel* wheel);
+
+    // Handles a shard's queued events, then updates the shard's machines.
+    // Shards share nothing but the supply, power controller and timing
+    // wheel, if any. Machines publish supply demand into their own slots, but
+    // spin requests go through the controller's shared wait queue, so with a
+    // power controller connected shards must not update concurrently either.
+    size_t drainShard(size_t shard);
+    void updateShard(size_t shard, float deltaTime);
+
+    void tick(float deltaTime);
+};
+
+#endif
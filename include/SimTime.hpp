@@ -0,0 +1,46 @@
+#ifndef SIM_TIME_HPP
+#define SIM_TIME_HPP
+
+#include <cmath>
+#include <cstdint>
+
+// Simulated time in integer nanoseconds. Elapsed and phase times are summed
+// as integers, so a phase ends on the same tick however long a run has been
+// going and on every platform. Floats only appear where a duration comes in
+// (a tick length, a mode's phase time) and where a reading goes out.
+using SimTime = int64_t;
+
+constexpr SimTime SIM_TIME_PER_SECOND = 1000000000;
+// About 292 years; longer durations are clamped.
+constexpr SimTime SIM_TIME_MAX = INT64_MAX;
+
+// Nearest nanosecond. The float is widened to double first, so the result
+// depends only on its bits.
+inline SimTime toSimTime(float seconds) {
+    double nanos = static_cast<double>(seconds) * 1e9;
+    if (std::isnan(nanos)) {
+        return 0;
+    }
+    if (nanos <= -9.2e18) {
+        return -SIM_TIME_MAX;
+    }
+    if (nanos >= 9.2e18) {
+        return SIM_TIME_MAX;
+    }
+    return static_cast<SimTime>(std::llround(nanos));
+}
+
+inline float toSeconds(SimTime time) {
+    return static_cast<float>(static_cast<double>(time) / 1e9);
+}
+
+// Share of whole covered by part, in percent and capped at 100.
+inline float percentOf(SimTime part, SimTime whole) {
+    if (whole <= 0) {
+        return 0.0f;
+    }
+    float percent = static_cast<float>(static_cast<double>(part) / static_cast<double>(whole) * 100.0);
+    return percent > 100.0f ? 100.0f : percent;
+}
+
+#endif
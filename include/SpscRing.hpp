@@ -0,0 +1,80 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Fixed-capacity single-producer / single-consumer ring. Each side owns one
+// index and keeps a cached copy of the other's, so a push or pop touches the
+// shared cache line only when the cached view says the ring looks full or
+// empty. Exactly one thread may push and one thread may pop.
+template<typename T>
+class SpscRing {
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head;
+    size_t cachedTail;
+    alignas(64) std::atomic<size_t> tail;
+    size_t cachedHead;
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t p = 2;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+public:
+    explicit SpscRing(size_t requestedCapacity)
+        : slots(new T[roundUpPowerOfTwo(requestedCapacity)]),
+          mask(roundUpPowerOfTwo(requestedCapacity) - 1),
+          head(0),
+          cachedTail(0),
+          tail(0),
+          cachedHead(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    bool tryPush(T value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead > mask) {
+                return false;
+            }
+        }
+        slots[position & mask] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position == cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(slots[position & mask]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate unless called from one of the two owning threads.
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef STATE_EXPLORER_HPP
+#define STATE_EXPLORER_HPP
+
+#include "MachineCore.hpp"
+#include "Types.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One step the explorer may take from a state: a MachineCore command, a raw
+// event handed straight to handleEvent() (including events the subsystems
+// would normally raise themselves), or a jump of simulated time.
+struct ExplorerAction {
+    enum class Kind : uint8_t {
+        Command,
+        Event,
+        Advance
+    };
+
+    enum class Command : uint8_t {
+        OpenDoor,
+        CloseDoor,
+        SelectMode,
+        SetLoad,
+        Start,
+        Pause,
+        Resume,
+        Stop,
+        EmergencyStop,
+        ClearFault
+    };
+
+    Kind kind;
+    uint8_t code;
+    float value;
+
+    void apply(MachineCore& core) const;
+    std::string describe() const;
+};
+
+// Abstract state the explorer deduplicates on: state, door/lock, water and
+// RPM buckets, plus the bookkeeping that changes which actions are enabled
+// (paused-from state, fault, mode, load bucket).
+using ExplorerKey = uint64_t;
+
+ExplorerKey explorerKey(const SystemStatus& status, State pausedFrom);
+std::string describeExplorerKey(ExplorerKey key);
+
+struct ExplorerInvariant {
+    std::string name;
+    std::function<bool(const SystemStatus&)> holds;
+};
+
+// "From every reachable state matching `from`, some path reaches a state
+// matching `to`". Checked on the abstract graph once exploration completes.
+struct ExplorerReachability {
+    std::string name;
+    std::function<bool(const SystemStatus&)> from;
+    std::function<bool(const SystemStatus&)> to;
+};
+
+// Counterexample: replaying `trace` on the initial core reaches a state whose
+// abstraction is `finalState`.
+struct ExplorerViolation {
+    std::string property;
+    std::vector<ExplorerAction> trace;
+    std::string finalState;
+};
+
+struct ExplorationResult {
+    size_t states;
+    size_t transitions;
+    int depth;
+    bool complete;
+    double seconds;
+    std::vector<ExplorerViolation> violations;
+
+    bool passed() const {
+        return complete && violations.empty();
+    }
+};
+
+// Concurrent insert-only set of explorer keys. Each key also carries the
+// smallest tag offered for it, so when several threads reach the same
+// abstract state the winner does not depend on scheduling.
+class ExplorerVisitedSet {
+private:
+    size_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> keys;
+    std::unique_ptr<std::atomic<uint64_t>[]> tags;
+    std::atomic<size_t> count;
+
+public:
+    explicit ExplorerVisitedSet(size_t capacityPow2);
+
+    // Returns false only when the table is full. `lowered` is set when
+    // `tag` became the key's smallest tag.
+    bool offer(ExplorerKey key, uint64_t tag, bool& lowered);
+    uint64_t tagOf(ExplorerKey key) const;
+    size_t size() const;
+};
+
+// Breadth-first model checker over MachineCore. Every level of the frontier
+// is expanded by a pool of threads; each abstract state keeps one concrete
+// representative core (the first reached in BFS order), so the search is an
+// under-approximation of the concrete machine, exact on the abstraction.
+// Queued events are drained after every action, i.e. delivered at once;
+// injected raw events cover the reorderings that would otherwise miss.
+class StateExplorer {
+private:
+    std::shared_ptr<const ConfigManager> modes;
+    std::vector<ExplorerAction> actions;
+    std::vector<ExplorerInvariant> invariants;
+    std::vector<ExplorerReachability> reachabilities;
+    unsigned threadCount;
+    size_t maxStates;
+    int maxDepth;
+
+public:
+    explicit StateExplorer(std::shared_ptr<const ConfigManager> modeTable = MachineCore::defaultModes());
+
+    void setThreadCount(unsigned threads);
+    void setMaxStates(size_t states);
+    void setMaxDepth(int depth);
+
+    void addInvariant(ExplorerInvariant invariant);
+    void addReachability(ExplorerReachability reachability);
+    void addDefaultProperties();
+
+    const std::vector<ExplorerAction>& getActions() const;
+
+    ExplorationResult explore(const MachineCore& initial) const;
+    ExplorationResult explore() const;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define STATE_MACHINE_HPP
 
 #include "Types.hpp"
+#include "Checkpoint.hpp"
 #include <map>
 #include <functional>
 #include <vector>
@@ -9,20 +10,23 @@
 class StateMachine {
 public:
     using StateCallback = std::function<void(State, State)>;
+    using TransitionTable = std::map<State, std::map<EventType, State>>;
 
 private:
     State currentState;
     State previousState;
     State pausedFromState;
-    std::map<State, std::map<EventType, State>> transitionTable;
     std::map<State, std::vector<StateCallback>> onEnterCallbacks;
     std::map<State, std::vector<StateCallback>> onExitCallbacks;
 
-    void initializeTransitions();
+    static TransitionTable buildTransitions();
 
 public:
     StateMachine();
 
+    static const TransitionTable& transitions();
+    static bool lookup(State state, EventType event, State& next);
+
     State getCurrentState() const;
     State getPreviousState() const;
     State getPausedFromState() const;
@@ -38,6 +42,11 @@ public:
     bool isActiveState() const;
     bool isSafeToOpenDoor() const;
 
+    // Bytes written by saveState().
+    static constexpr size_t CHECKPOINT_BYTES = 3;
+    void saveState(CheckpointWriter& writer) const;
+    bool restoreState(CheckpointReader& reader);
+
     void reset();
 };
 
@@ -0,0 +1,112 @@
+#ifndef STATUS_BOARD_HPP
+#define STATUS_BOARD_HPP
+
+#ifdef __linux__
+
+#include "ControlProtocol.hpp"
+#include "Types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Fleet;
+
+constexpr uint32_t STATUS_BOARD_MAGIC = 0x42534D57;
+constexpr uint16_t STATUS_BOARD_VERSION = 1;
+
+// Shared-memory layout: one header line followed by `capacity` slots, each
+// on its own cache line so publishing one machine never invalidates a
+// neighbour. A slot's sequence is odd while it is being written and even
+// (and non-zero) once a record is in place; readers retry on a change.
+struct alignas(64) StatusBoardHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t slotSize;
+    uint32_t capacity;
+    std::atomic<uint32_t> count;
+    std::atomic<uint64_t> publishCount;
+    std::atomic<uint64_t> tick;
+};
+
+struct alignas(64) StatusSlot {
+    std::atomic<uint32_t> sequence;
+    uint32_t reserved;
+    uint64_t tick;
+    StatusRecord record;
+};
+
+static_assert(sizeof(StatusBoardHeader) == 64, "header must fill one cache line");
+static_assert(sizeof(StatusSlot) == 64, "slots must be one cache line");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "slot sequence must be lock-free in shared memory");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "header counters must be lock-free in shared memory");
+
+// Writer side, owned by the simulation. The region is created with
+// shm_open() under `name` (which must start with '/') and unlinked again on
+// close().
+class StatusBoard {
+private:
+    std::string name;
+    StatusBoardHeader* header;
+    StatusSlot* slots;
+    size_t mappedBytes;
+
+public:
+    StatusBoard();
+    ~StatusBoard();
+
+    StatusBoard(const StatusBoard&) = delete;
+    StatusBoard& operator=(const StatusBoard&) = delete;
+
+    bool create(const std::string& name, uint32_t capacity);
+    void close();
+    bool isOpen() const;
+
+    uint32_t getCapacity() const;
+
+    // Slots past the capacity are ignored. commit() marks the end of a
+    // publishing round; the fleet overload commits by itself.
+    void publish(uint32_t slot, const SystemStatus& status, uint64_t tick);
+    void publish(const Fleet& fleet, uint64_t tick);
+    void commit(uint64_t tick);
+
+    static size_t regionSize(uint32_t capacity);
+};
+
+// Reader side for monitoring processes. Maps the region read-only; reads are
+// plain loads with no syscalls and never block the writer.
+class StatusBoardReader {
+private:
+    const StatusBoardHeader* header;
+    const StatusSlot* slots;
+    size_t mappedBytes;
+
+public:
+    StatusBoardReader();
+    ~StatusBoardReader();
+
+    StatusBoardReader(const StatusBoardReader&) = delete;
+    StatusBoardReader& operator=(const StatusBoardReader&) = delete;
+
+    bool open(const std::string& name);
+    void close();
+    bool isOpen() const;
+
+    uint32_t getCapacity() const;
+    uint32_t getCount() const;
+    uint64_t getPublishCount() const;
+    uint64_t getTick() const;
+
+    // False if the slot was never published or stayed mid-write for every
+    // retry.
+    bool read(uint32_t slot, StatusRecord& record, uint64_t* tick = nullptr) const;
+
+    // Copies every published slot below getCount(); returns how many.
+    size_t scan(std::vector<StatusRecord>& records) const;
+};
+
+#endif
+
+#endif
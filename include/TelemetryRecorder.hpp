@@ -0,0 +1,99 @@
+#ifndef TELEMETRY_RECORDER_HPP
+#define TELEMETRY_RECORDER_HPP
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+struct TelemetryRow {
+    double time;
+    SensorSample sample;
+};
+
+struct TelemetryChunk {
+    uint32_t samples;
+    std::vector<uint8_t> bytes;
+};
+
+// Per-tick sensor trace for post-mortem analysis. record() only stores into
+// fixed-size column buffers; when a chunk fills, each column is compressed
+// into its own run of bits:
+//
+//   time         microseconds, delta-of-delta in variable-width buckets
+//   water level  Gorilla XOR float encoding (lossless)
+//   RPM          delta-of-delta in variable-width buckets
+//   state        run-length
+//   flags        run-length over door, direction and both valves
+//
+// A steady phase costs about three bits per sample. With a retention limit the
+// oldest chunks are dropped, so memory stays bounded however long the
+// recorder runs.
+class TelemetryRecorder {
+private:
+    uint32_t chunkSamples;
+    size_t retentionBytes;
+
+    std::vector<double> timeColumn;
+    std::vector<float> waterColumn;
+    std::vector<int32_t> rpmColumn;
+    std::vector<uint8_t> stateColumn;
+    std::vector<uint8_t> flagsColumn;
+    uint32_t open;
+
+    std::deque<TelemetryChunk> chunks;
+    size_t sealedBytes;
+    uint64_t sealedSamples;
+    uint64_t droppedSamples;
+
+    TelemetryChunk encodeOpen() const;
+    void seal();
+    void enforceRetention();
+
+public:
+    static constexpr uint32_t DEFAULT_CHUNK_SAMPLES = 256;
+
+    explicit TelemetryRecorder(uint32_t chunkSamples = DEFAULT_CHUNK_SAMPLES);
+
+    void record(double timeSeconds, const SensorSample& sample) {
+        timeColumn[open] = timeSeconds;
+        waterColumn[open] = sample.waterLevel;
+        rpmColumn[open] = sample.motorRPM;
+        stateColumn[open] = static_cast<uint8_t>(sample.state);
+        flagsColumn[open] = static_cast<uint8_t>(
+            static_cast<unsigned>(sample.doorStatus) | (static_cast<unsigned>(sample.direction) << 2) |
+            (sample.fillValveOpen ? 0x10u : 0u) | (sample.drainValveOpen ? 0x20u : 0u));
+        if (++open == chunkSamples) {
+            seal();
+        }
+    }
+
+    // Compresses the partially filled chunk, if any.
+    void flush();
+    void clear();
+
+    // Upper bound on compressed bytes kept; 0 keeps everything.
+    void setRetentionBytes(size_t bytes);
+
+    uint32_t getChunkSamples() const;
+    size_t getChunkCount() const;
+    uint64_t getSampleCount() const;
+    uint64_t getDroppedSamples() const;
+    size_t getCompressedBytes() const;
+    size_t getMemoryBytes() const;
+
+    bool decode(std::vector<TelemetryRow>& rows) const;
+    bool writeCsv(std::ostream& out) const;
+
+    // Checkpoint-style container (kind Telemetry): the chunk size, then each
+    // chunk's sample count, byte count and bits. The open chunk is included.
+    void saveBinary(std::vector<uint8_t>& buffer) const;
+    bool loadBinary(const std::vector<uint8_t>& buffer);
+
+    static bool decodeChunk(const TelemetryChunk& chunk, std::vector<TelemetryRow>& rows);
+};
+
+#endif
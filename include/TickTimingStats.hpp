@@ -0,0 +1,44 @@
+#ifndef TICK_TIMING_STATS_HPP
+#define TICK_TIMING_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Timing quality of a periodic simulation loop. Jitter is how far each
+// wake-up interval strays from the nominal period (times the number of
+// periods it covers); drift is how far the loop has fallen behind an ideal
+// clock started at the first tick. Not synchronised: record from the loop
+// thread and read once it has stopped.
+class TickTimingStats {
+private:
+    static constexpr size_t BUCKET_COUNT = 2000;
+    static constexpr double BUCKET_MICROS = 5.0;
+
+    std::chrono::nanoseconds period;
+    std::chrono::steady_clock::time_point firstTick;
+    std::chrono::steady_clock::time_point lastTick;
+    uint64_t ticks;
+    uint64_t periods;
+    uint64_t samples;
+    double totalJitterMicros;
+    double maxJitterMicros;
+    std::array<uint32_t, BUCKET_COUNT + 1> histogram;
+
+public:
+    explicit TickTimingStats(std::chrono::nanoseconds period);
+
+    void recordTick(std::chrono::steady_clock::time_point now, uint64_t elapsedPeriods = 1);
+    void reset();
+
+    std::chrono::nanoseconds getPeriod() const;
+    uint64_t getTickCount() const;
+    uint64_t getPeriodCount() const;
+    double getMeanJitterMicros() const;
+    double getMaxJitterMicros() const;
+    double getPercentileJitterMicros(double percentile) const;
+    double getDriftMicros() const;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class TimerListener {
+public:
+    virtual ~TimerListener() = default;
+    virtual void onTimerExpired(uint32_t tag) = 0;
+};
+
+// Hierarchical timing wheel (four levels of 256 slots) for large numbers of
+// deadlines. Time advances in whole ticks of a fixed resolution; a timer
+// lands in the lowest level whose span covers its distance and is cascaded
+// down as the wheel turns, so arming and cancelling are O(1) and a tick costs
+// O(1) plus the timers that expire or cascade in it. Timers live in one pooled
+// array linked by index, so millions of them cost no per-timer allocation.
+//
+// Not thread-safe: arm, cancel and advance must come from one thread. A
+// listener may arm or cancel timers (including ones due in the same tick)
+// from onTimerExpired.
+class TimingWheel {
+public:
+    using TimerId = uint64_t;
+    static constexpr TimerId NO_TIMER = 0;
+    static constexpr size_t LEVELS = 4;
+    static constexpr size_t SLOT_BITS = 8;
+    static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+    // Longer delays are clamped to this many ticks.
+    static constexpr uint64_t MAX_TICKS = (uint64_t(1) << (LEVELS * SLOT_BITS)) - 1;
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+    static constexpr uint16_t EXPIRING = LEVELS * SLOTS;
+    static constexpr uint16_t UNUSED = 0xFFFF;
+
+    struct Node {
+        uint64_t expiry;
+        TimerListener* listener;
+        uint32_t next;
+        uint32_t prev;
+        uint32_t generation;
+        uint32_t tag;
+        uint16_t list;
+    };
+
+    float resolution;
+    double carry;
+    uint64_t now;
+    std::vector<Node> nodes;
+    std::array<uint32_t, LEVELS * SLOTS + 1> heads;
+    uint32_t freeHead;
+    size_t armedCount;
+    uint64_t expiredCount;
+
+    void link(uint32_t index, uint16_t list);
+    void unlink(uint32_t index);
+    void place(uint32_t index);
+    void cascade(size_t level);
+    void advanceTick();
+
+public:
+    explicit TimingWheel(float resolutionSeconds = 0.1f);
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // Fires on the first tick boundary at least delaySeconds from now
+    // (never in the current tick).
+    TimerId arm(float delaySeconds, TimerListener* listener, uint32_t tag = 0);
+    TimerId armTicks(uint64_t ticks, TimerListener* listener, uint32_t tag = 0);
+    // False if the timer already fired or was cancelled.
+    bool cancel(TimerId id);
+    bool isArmed(TimerId id) const;
+    float getRemaining(TimerId id) const;
+
+    // Returns the number of timers that fired.
+    size_t advance(float deltaSeconds);
+    size_t advanceTicks(uint64_t ticks);
+
+    void reserve(size_t timers);
+    size_t getArmedCount() const;
+    uint64_t getExpiredCount() const;
+    uint64_t getNowTicks() const;
+    float getResolution() const;
+    size_t getMemoryBytes() const;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <chrono>
+#include <cstddef>
 
 enum class State {
     Idle,
@@ -47,6 +48,17 @@ enum class EventType {
     FAULT_CLEARED
 };
 
+constexpr size_t EVENT_TYPE_COUNT = static_cast<size_t>(EventType::FAULT_CLEARED) + 1;
+
+enum class EventPriority {
+    Safety,
+    Command,
+    System,
+    Telemetry
+};
+
+constexpr size_t EVENT_PRIORITY_COUNT = static_cast<size_t>(EventPriority::Telemetry) + 1;
+
 enum class DoorStatus {
     Open,
     ClosedUnlocked,
@@ -82,6 +94,18 @@ struct SystemStatus {
     FaultCode fault;
 };
 
+// Raw readings for per-tick traces; unlike SystemStatus it has no strings, so
+// taking one every tick costs a few loads.
+struct SensorSample {
+    State state;
+    DoorStatus doorStatus;
+    Direction direction;
+    bool fillValveOpen;
+    bool drainValveOpen;
+    float waterLevel;
+    int motorRPM;
+};
+
 inline std::string stateToString(State state) {
     switch (state) {
         case State::Idle: return "Idle";
@@ -137,6 +161,70 @@ inline std::string doorStatusToString(DoorStatus status) {
     }
 }
 
+inline EventPriority eventPriority(EventType type) {
+    switch (type) {
+        case EventType::CMD_EMERGENCY:
+        case EventType::TIMER_TIMEOUT:
+        case EventType::FAULT_WATER_UNAVAILABLE:
+        case EventType::FAULT_OVERLOAD:
+        case EventType::FAULT_DOOR:
+        case EventType::FAULT_MOTOR:
+            return EventPriority::Safety;
+        case EventType::SYS_WATER_LEVEL_REACHED:
+        case EventType::SYS_WASH_COMPLETE:
+        case EventType::SYS_RINSE_COMPLETE:
+        case EventType::SYS_SPIN_COMPLETE:
+        case EventType::SYS_DRAIN_COMPLETE:
+        case EventType::SYS_CYCLE_COMPLETE:
+            return EventPriority::System;
+        case EventType::TIMER_TICK:
+            return EventPriority::Telemetry;
+        default:
+            return EventPriority::Command;
+    }
+}
+
+inline std::string eventPriorityToString(EventPriority priority) {
+    switch (priority) {
+        case EventPriority::Safety: return "Safety";
+        case EventPriority::Command: return "Command";
+        case EventPriority::System: return "System";
+        case EventPriority::Telemetry: return "Telemetry";
+        default: return "Unknown";
+    }
+}
+
+inline std::string directionToString(Direction direction) {
+    switch (direction) {
+        case Direction::Clockwise: return "Clockwise";
+        case Direction::CounterClockwise: return "CounterClockwise";
+        case Direction::Stopped: return "Stopped";
+        default: return "Unknown";
+    }
+}
+
+inline FaultCode eventToFaultCode(EventType type) {
+    switch (type) {
+        case EventType::FAULT_WATER_UNAVAILABLE: return FaultCode::WaterUnavailable;
+        case EventType::FAULT_OVERLOAD: return FaultCode::Overload;
+        case EventType::FAULT_DOOR: return FaultCode::DoorFault;
+        case EventType::FAULT_MOTOR: return FaultCode::MotorFault;
+        case EventType::TIMER_TIMEOUT: return FaultCode::Timeout;
+        default: return FaultCode::None;
+    }
+}
+
+inline EventType faultCodeToEvent(FaultCode fault) {
+    switch (fault) {
+        case FaultCode::WaterUnavailable: return EventType::FAULT_WATER_UNAVAILABLE;
+        case FaultCode::Overload: return EventType::FAULT_OVERLOAD;
+        case FaultCode::DoorFault: return EventType::FAULT_DOOR;
+        case FaultCode::MotorFault: return EventType::FAULT_MOTOR;
+        case FaultCode::Timeout: return EventType::TIMER_TIMEOUT;
+        default: return EventType::FAULT_CLEARED;
+    }
+}
+
 inline std::string faultCodeToString(FaultCode fault) {
     switch (fault) {
         case FaultCode::None: return "None";
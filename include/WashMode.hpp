@@ -1,21 +1,23 @@
 #ifndef WASH_MODE_HPP
 #define WASH_MODE_HPP
 
-#include <string>
+#include <string_view>
 
+// The name is a view: built-in modes point into the generated catalog,
+// loaded ones into the ConfigManager that parsed them.
 struct WashMode {
-    std::string name;
+    std::string_view name;
     int durationMinutes;
     int spinSpeedRPM;
     float waterLevelLiters;
     int temperatureCelsius;
 
-    WashMode()
+    constexpr WashMode()
         : name("Default"), durationMinutes(30), spinSpeedRPM(800),
           waterLevelLiters(30.0f), temperatureCelsius(40) {}
 
-    WashMode(const std::string& name, int duration, int spinSpeed,
-             float waterLevel, int temperature)
+    constexpr WashMode(std::string_view name, int duration, int spinSpeed,
+                       float waterLevel, int temperature)
         : name(name), durationMinutes(duration), spinSpeedRPM(spinSpeed),
           waterLevelLiters(waterLevel), temperatureCelsius(temperature) {}
 
@@ -1,71 +1,142 @@
 #ifndef WASHING_MACHINE_HPP
 #define WASHING_MACHINE_HPP
 
-#include "StateMachine.hpp"
+#include "MachineCore.hpp"
 #include "EventEngine.hpp"
-#include "DoorSystem.hpp"
-#include "WaterSystem.hpp"
-#include "MotorSystem.hpp"
+#include "WaterSupply.hpp"
+#include "PowerAdmissionController.hpp"
+#include "TimingWheel.hpp"
 #include "ConfigManager.hpp"
 #include "WashMode.hpp"
 #include "Types.hpp"
+#include "Checkpoint.hpp"
+#include "TickTimingStats.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
 #include <thread>
 #include <string>
+#include <vector>
 
-class WashingMachine {
+// Where a BasicWashingMachine's core posts its events.
+//
+// EngineEventSink queues them on an EventEngine. Commands may then come from
+// any thread while the simulation thread runs, at the cost of a virtual call
+// and a lock per event.
+class EngineEventSink : public CoreEventSink {
 private:
-    StateMachine stateMachine;
-    EventEngine eventEngine;
-    DoorSystem door;
-    WaterSystem water;
-    MotorSystem motor;
-    ConfigManager config;
-
-    int currentModeIndex;
-    float loadWeight;
-    float cycleProgress;
-    float cycleTimeElapsed;
-    float totalCycleTime;
-    float phaseTimeElapsed;
-    float currentPhaseTime;
-    FaultCode currentFault;
+    EventEngine engine;
 
-    std::atomic<bool> running;
-    std::atomic<bool> simulationRunning;
-    std::thread simulationThread;
+public:
+    static constexpr bool THREAD_SAFE = true;
 
-    void setupCallbacks();
-    void handleEvent(const Event& event);
-    void simulationLoop();
-    void updateSimulation(float deltaTime);
+    EngineEventSink() {
+        engine.setCoalescing(EventType::SYS_WASH_COMPLETE, true);
+        engine.setCoalescing(EventType::SYS_RINSE_COMPLETE, true);
+        engine.setCoalescing(EventType::SYS_SPIN_COMPLETE, true);
+    }
 
-    void onStateEnter(State newState, State oldState);
-    void onStateExit(State oldState, State newState);
+    PushResult post(const Event& event) override {
+        return engine.pushEvent(event);
+    }
+
+    CoreEventSink* coreSink() { return this; }
+    void start() { engine.start(); }
+    void stop() { engine.stop(); }
+    void clear() { engine.clear(); }
+    void setWakeHandler(std::function<void()> handler) { engine.setWakeHandler(std::move(handler)); }
+    EventLaneStats getLaneStats(EventPriority priority) const { return engine.getLaneStats(priority); }
+
+    template<typename Core>
+    void deliver(Core& core) {
+        while (engine.hasEvents()) {
+            auto event = engine.popEvent();
+            if (event) {
+                core.handleEvent(*event);
+            }
+        }
+    }
+};
+
+// InlineEventSink leaves events on the core's own pending list. They are
+// handled at the start of the next tick, with no lock and no virtual call,
+// in the order they were posted, as in a detached MachineCore. (The engine
+// handles commands ahead of queued system events, so a command posted in
+// the same tick as a phase completion can land differently.) The machine
+// must then be used from one thread, driven through tick(); run() does not
+// compile with this sink. It has no lane statistics.
+class InlineEventSink {
+public:
+    static constexpr bool THREAD_SAFE = false;
 
-    void startFillPhase();
-    void startWashPhase();
-    void startRinsePhase();
-    void startSpinPhase();
-    void startDrainPhase();
+    CoreEventSink* coreSink() { return nullptr; }
+    void start() {}
+    void stop() {}
+    void clear() {}
+    void setWakeHandler(std::function<void()>) {}
+    EventLaneStats getLaneStats(EventPriority) const { return EventLaneStats{}; }
 
-    void executeEmergencyStop();
-    bool validateStart() const;
+    template<typename Core>
+    void deliver(Core& core) {
+        core.processPendingEvents();
+    }
+};
+
+// A machine core driven by its own event sink and simulation thread. The
+// core can be detached as a standalone copy for what-if branches and loaded
+// back; the thread, sink and output stay with the machine. A machine ticked
+// with no shared timing wheel connected creates a wheel of its own on the
+// first tick() and advances it there; a machine in a fleet never has one.
+//
+// A water supply connected with advanceOnTick is advanced by tick() after the
+// core, for a machine ticked on its own; a fleet connects without it and
+// advances the supply once for all of its machines. Neither the supply nor a
+// power controller has a lock, so a machine with either connected cannot
+// run() its own simulation thread.
+//
+// The subsystem models, the event sink and the compile-time subscribers are
+// bound at compile time. WashingMachine is the build with the standard
+// models, an EngineEventSink and no static subscribers.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink,
+         typename SubscriberPolicy = NoSubscribers>
+class BasicWashingMachine {
+public:
+    using Core = BasicMachineCore<DoorPolicy, WaterPolicy, MotorPolicy, SubscriberPolicy>;
+    static constexpr size_t CHECKPOINT_BYTES = Core::CHECKPOINT_BYTES;
+
+private:
+    std::unique_ptr<TimingWheel> ownWheel;
+    TimingWheel* timingWheel;
+    WaterSupply* waterSupply;
+    bool advanceWaterSupply;
+    PowerAdmissionController* powerController;
+    EventSink events;
+    Core core;
+
+    static constexpr std::chrono::milliseconds LOOP_PERIOD{50};
+
+    std::atomic<bool> running;
+    std::atomic<bool> simulationRunning;
+    std::thread simulationThread;
+    // Only a machine that has run() its own loop has timing to record.
+    std::unique_ptr<TickTimingStats> tickStats;
 
-    float calculateFillTime() const;
-    float calculateWashTime() const;
-    float calculateRinseTime() const;
-    float calculateSpinTime() const;
-    float calculateDrainTime() const;
-    float calculateTotalCycleTime() const;
+    void simulationLoop();
 
 public:
-    WashingMachine();
-    ~WashingMachine();
+    BasicWashingMachine();
+    ~BasicWashingMachine();
+
+    BasicWashingMachine(const BasicWashingMachine&) = delete;
+    BasicWashingMachine& operator=(const BasicWashingMachine&) = delete;
 
     bool initialize(const std::string& configPath = "");
-    void run();
+    // Fails while a water supply or power controller is connected.
+    bool run();
     void shutdown();
 
     void openDoor();
@@ -78,14 +149,342 @@ public:
     void stop();
     void emergencyStop();
     void clearFault();
+    PushResult injectFault(FaultCode fault);
+
+    // Both fail while the simulation thread runs.
+    bool connectWaterSupply(WaterSupply* supply, bool advanceOnTick = true);
+    bool connectPowerController(PowerAdmissionController* controller);
+    // With nullptr the machine creates its own wheel on the next tick().
+    void connectTimingWheel(TimingWheel* wheel);
+    // Handlers run on the thread that handles events: the engine's thread
+    // under run(), the caller's under tick().
+    void connectSubscribers(EventSubscribers* subscribers, EventSubscribers::MachineId source = 0);
+    SubscriberPolicy& getSubscriberPolicy();
 
     SystemStatus getStatus() const;
+    SensorSample getSensorSample() const;
     const WashMode& getCurrentMode() const;
     State getCurrentState() const;
     const ConfigManager& getConfigManager() const;
+    EventLaneStats getEventLaneStats(EventPriority priority) const;
+
+    void setEventNotifier(std::function<void()> notifier);
+    TickTimingStats getTickStats() const;
 
     void processEvents();
+    void tick(float deltaTime);
+    void tick(SimTime deltaTime);
     bool isRunning() const;
+
+    void setOutput(std::ostream* stream);
+
+    void saveState(CheckpointWriter& writer) const;
+    bool restoreState(CheckpointReader& reader);
+    std::vector<uint8_t> saveCheckpoint() const;
+    bool restoreCheckpoint(const std::vector<uint8_t>& buffer);
+
+    Core detachCore() const;
+    void loadCore(const Core& source);
 };
 
-#endif
\ No newline at end of file
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::BasicWashingMachine()
+    : timingWheel(nullptr),
+      waterSupply(nullptr),
+      advanceWaterSupply(false),
+      powerController(nullptr),
+      running(false),
+      simulationRunning(false) {
+    core.setEventSink(events.coreSink());
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::~BasicWashingMachine() {
+    shutdown();
+    core.connectWaterSupply(nullptr);
+    core.connectPowerController(nullptr);
+    core.connectTimingWheel(nullptr);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::initialize(const std::string& configPath) {
+    if (!configPath.empty()) {
+        auto modes = std::make_shared<ConfigManager>();
+        modes->loadConfig(configPath);
+        core.setModeTable(modes);
+    }
+
+    events.start();
+    running = true;
+
+    return true;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::run() {
+    static_assert(EventSink::THREAD_SAFE, "run() needs an event sink that other threads may post to");
+    if (waterSupply || powerController || simulationRunning) {
+        return false;
+    }
+    tickStats = std::make_unique<TickTimingStats>(LOOP_PERIOD);
+    simulationRunning = true;
+    simulationThread = std::thread(&BasicWashingMachine::simulationLoop, this);
+    return true;
+}
+
+// Sleeps a fixed 50 ms after each tick, so processing time accumulates as
+// drift; tickStats records it. The reactor shell uses a timerfd instead.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::simulationLoop() {
+    auto lastTime = std::chrono::steady_clock::now();
+
+    while (simulationRunning) {
+        auto currentTime = std::chrono::steady_clock::now();
+        SimTime deltaTime = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - lastTime).count();
+        lastTime = currentTime;
+        tickStats->recordTick(currentTime);
+
+        tick(deltaTime);
+
+        std::this_thread::sleep_for(LOOP_PERIOD);
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::setEventNotifier(std::function<void()> notifier) {
+    events.setWakeHandler(notifier);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+TickTimingStats BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getTickStats() const {
+    return tickStats ? *tickStats : TickTimingStats(LOOP_PERIOD);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::processEvents() {
+    events.deliver(core);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::tick(float deltaTime) {
+    tick(toSimTime(deltaTime));
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::tick(SimTime deltaTime) {
+    if (!timingWheel) {
+        ownWheel = std::make_unique<TimingWheel>();
+        timingWheel = ownWheel.get();
+        core.connectTimingWheel(timingWheel);
+    }
+    processEvents();
+    core.update(deltaTime);
+    if (waterSupply && advanceWaterSupply) {
+        waterSupply->update(toSeconds(deltaTime));
+    }
+    if (ownWheel) {
+        ownWheel->advance(toSeconds(deltaTime));
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::shutdown() {
+    simulationRunning = false;
+    running = false;
+    events.stop();
+
+    if (simulationThread.joinable()) {
+        simulationThread.join();
+    }
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::openDoor() {
+    core.openDoor();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::closeDoor() {
+    core.closeDoor();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::selectMode(int modeIndex) {
+    core.selectMode(modeIndex);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::setLoad(float kg) {
+    core.setLoad(kg);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::start() {
+    core.start();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::pause() {
+    core.pause();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::resume() {
+    core.resume();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::stop() {
+    core.stop();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::emergencyStop() {
+    core.emergencyStop();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::clearFault() {
+    core.clearFault();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+PushResult BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::injectFault(FaultCode fault) {
+    return core.injectFault(fault);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::connectWaterSupply(
+    WaterSupply* supply, bool advanceOnTick) {
+    if (simulationRunning) {
+        return false;
+    }
+    waterSupply = supply;
+    advanceWaterSupply = supply && advanceOnTick;
+    core.connectWaterSupply(supply);
+    return true;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::connectPowerController(
+    PowerAdmissionController* controller) {
+    if (simulationRunning) {
+        return false;
+    }
+    powerController = controller;
+    core.connectPowerController(controller);
+    return true;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::connectTimingWheel(TimingWheel* wheel) {
+    timingWheel = wheel;
+    core.connectTimingWheel(timingWheel);
+    ownWheel.reset();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::connectSubscribers(
+    EventSubscribers* subscribers, EventSubscribers::MachineId source) {
+    core.connectSubscribers(subscribers, source);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+SubscriberPolicy& BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getSubscriberPolicy() {
+    return core.getSubscriberPolicy();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+SystemStatus BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getStatus() const {
+    return core.getStatus();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+SensorSample BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getSensorSample() const {
+    return core.getSensorSample();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+const WashMode& BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getCurrentMode() const {
+    return core.getCurrentMode();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+State BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getCurrentState() const {
+    return core.getCurrentState();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+const ConfigManager& BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getConfigManager() const {
+    return core.getModeTable();
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+EventLaneStats BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::getEventLaneStats(EventPriority priority) const {
+    return events.getLaneStats(priority);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::isRunning() const {
+    return running;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::setOutput(std::ostream* stream) {
+    core.setOutput(stream);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::saveState(CheckpointWriter& writer) const {
+    core.saveState(writer);
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::restoreState(CheckpointReader& reader) {
+    if (!core.restoreState(reader)) {
+        return false;
+    }
+    events.clear();
+    return true;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+std::vector<uint8_t> BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::saveCheckpoint() const {
+    std::vector<uint8_t> buffer;
+    CheckpointWriter writer(buffer);
+    writer.writeHeader(CheckpointKind::Machine, 1);
+    saveState(writer);
+    return buffer;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+bool BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::restoreCheckpoint(const std::vector<uint8_t>& buffer) {
+    CheckpointReader reader(buffer);
+    uint32_t count = 0;
+    if (!reader.readHeader(CheckpointKind::Machine, count) || count != 1) {
+        return false;
+    }
+    return restoreState(reader);
+}
+
+// Events still queued in the engine are not carried over, so detach between
+// ticks. The copy is silent and unregistered from any shared supply.
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+typename BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::Core BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::detachCore() const {
+    Core detached(core);
+    detached.setOutput(nullptr);
+    return detached;
+}
+
+template<typename DoorPolicy, typename WaterPolicy, typename MotorPolicy, typename EventSink, typename SubscriberPolicy>
+void BasicWashingMachine<DoorPolicy, WaterPolicy, MotorPolicy, EventSink, SubscriberPolicy>::loadCore(const Core& source) {
+    events.clear();
+    core = source;
+    core.clearPending();
+}
+
+using WashingMachine = BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, EngineEventSink>;
+
+extern template class BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, EngineEventSink>;
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef WATER_SUPPLY_HPP
+#define WATER_SUPPLY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Building supply line shared by many WaterSystem inlets. Consumers publish
+// their demand during their own update; update() then resolves flow and
+// pressure for every consumer in one pass, so no per-machine locking is needed.
+//
+// There is no locking at all: the supply belongs to whoever ticks its
+// consumers, and update() must not overlap any consumer's update. Fleet and
+// ShardedFleet call it once per tick after every machine has published (shards
+// publish into their own slots concurrently, then join); a machine ticked on
+// its own advances the supply it was connected to. Register and release
+// consumers from that same thread. A machine running its own simulation
+// thread cannot be connected; see BasicWashingMachine::run().
+class WaterSupply {
+private:
+    float maxFlowRate;
+    float staticPressure;
+    float nominalPressure;
+    float pipeResistance;
+    float minPressure;
+    float starvationTimeout;
+
+    std::vector<float> demand;
+    std::vector<float> granted;
+    std::vector<float> starvedTime;
+    std::vector<uint8_t> starved;
+    std::vector<uint8_t> inUse;
+    std::vector<size_t> freeSlots;
+
+    float currentPressure;
+    float totalDemand;
+    float totalFlow;
+    size_t activeConsumers;
+
+public:
+    WaterSupply(float maxFlowRate = 100.0f, float staticPressure = 3.0f,
+                float pipeResistance = 0.0001f, float minPressure = 0.3f,
+                float starvationTimeout = 5.0f);
+
+    size_t registerConsumer();
+    void releaseConsumer(size_t slot);
+
+    void setDemand(size_t slot, float litersPerSecond);
+    float getGrantedRate(size_t slot) const;
+    bool isStarved(size_t slot) const;
+
+    void update(float deltaTimeSeconds);
+
+    float getPressure() const;
+    float getMinPressure() const;
+    float getTotalDemand() const;
+    float getTotalFlow() const;
+    float getMaxFlowRate() const;
+    size_t getActiveConsumers() const;
+    size_t getConsumerCount() const;
+    bool hasPressure() const;
+
+    void setMaxFlowRate(float litersPerSecond);
+};
+
+#endif
@@ -2,6 +2,10 @@
 #define WATER_SYSTEM_HPP
 
 #include "Types.hpp"
+#include "Checkpoint.hpp"
+#include "SimTime.hpp"
+#include "WaterSupply.hpp"
+#include <cstddef>
 #include <functional>
 
 class WaterSystem {
@@ -15,19 +19,36 @@ private:
     bool inletValveOpen;
     bool drainValveOpen;
     float lowThreshold;
+    WaterSupply* supply;
+    size_t supplySlot;
     std::function<void(EventType)> eventCallback;
 
+    void publishDemand();
+
 public:
     WaterSystem();
+    WaterSystem(const WaterSystem& other);
+    WaterSystem& operator=(const WaterSystem& other);
 
     void setEventCallback(std::function<void(EventType)> callback);
 
+    void attachSupply(WaterSupply* sharedSupply);
+    void detachSupply();
+    bool hasSupply() const;
+
     void startFilling(float targetLiters);
+    // Raise is called with each event instead of the callback, so an owner
+    // that knows its handler at compile time pays no indirect call.
+    template<typename Raise>
+    void startFilling(float targetLiters, Raise&& raise);
     void stopFilling();
     void startDraining();
     void stopDraining();
 
     void update(float deltaTimeSeconds);
+    void update(SimTime deltaTime);
+    template<typename Raise>
+    void update(SimTime deltaTime, Raise&& raise);
 
     bool checkReservoir() const;
     bool autoReplenish();
@@ -40,7 +61,84 @@ public:
     bool isDraining() const;
 
     void setReservoirLevel(float level);
+    // Bytes written by saveState().
+    static constexpr size_t CHECKPOINT_BYTES = 14;
+    void saveState(CheckpointWriter& writer) const;
+    bool restoreState(CheckpointReader& reader);
+
     void reset();
 };
 
-#endif
\ No newline at end of file
+template<typename Raise>
+void WaterSystem::startFilling(float targetLiters, Raise&& raise) {
+    if (supply) {
+        targetLevel = targetLiters;
+        inletValveOpen = true;
+        drainValveOpen = false;
+        publishDemand();
+        return;
+    }
+
+    if (reservoirLevel < lowThreshold) {
+        if (!autoReplenish()) {
+            raise(EventType::FAULT_WATER_UNAVAILABLE);
+            return;
+        }
+    }
+    targetLevel = targetLiters;
+    inletValveOpen = true;
+    drainValveOpen = false;
+}
+
+// Flows are rates, so the step is turned back into seconds here; the
+// elapsed time itself is only ever summed as an integer by the caller.
+template<typename Raise>
+void WaterSystem::update(SimTime deltaTime, Raise&& raise) {
+    float deltaTimeSeconds = toSeconds(deltaTime);
+
+    if (inletValveOpen && supply && supply->isStarved(supplySlot)) {
+        inletValveOpen = false;
+        publishDemand();
+        raise(EventType::FAULT_WATER_UNAVAILABLE);
+    }
+
+    if (inletValveOpen && currentLevel < targetLevel) {
+        if (supply) {
+            currentLevel += supply->getGrantedRate(supplySlot) * deltaTimeSeconds;
+        } else {
+            float fillAmount = fillRate * deltaTimeSeconds;
+            float available = reservoirLevel;
+
+            if (fillAmount > available) {
+                fillAmount = available;
+            }
+
+            currentLevel += fillAmount;
+            reservoirLevel -= fillAmount;
+        }
+
+        if (currentLevel >= targetLevel) {
+            currentLevel = targetLevel;
+            inletValveOpen = false;
+            publishDemand();
+            raise(EventType::SYS_WATER_LEVEL_REACHED);
+        }
+
+        if (!supply && reservoirLevel < lowThreshold) {
+            autoReplenish();
+        }
+    }
+
+    if (drainValveOpen && currentLevel > 0) {
+        float drainAmount = drainRate * deltaTimeSeconds;
+        currentLevel -= drainAmount;
+
+        if (currentLevel <= 0) {
+            currentLevel = 0;
+            drainValveOpen = false;
+            raise(EventType::SYS_DRAIN_COMPLETE);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,260 @@
+#include "BatchStateMachine.hpp"
+#include "StateMachine.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BATCH_STATE_MACHINE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using MachineId = BatchStateMachine::MachineId;
+
+constexpr size_t STATE_COUNT = BatchStateMachine::STATE_COUNT;
+constexpr size_t ROW_SIZE = BatchStateMachine::ROW_SIZE;
+constexpr uint8_t NO_EVENT = BatchStateMachine::NO_EVENT;
+constexpr uint8_t NO_TRANSITION = BatchStateMachine::NO_TRANSITION;
+
+static_assert(ROW_SIZE == 32, "the AVX2 kernel shifts states by 5 to index rows");
+
+// StateMachine's table as one byte per (state, event), rows padded to 32 so
+// NO_EVENT masked to a column lands in an empty one. The widened copy is what
+// the AVX2 gather reads.
+struct Tables {
+    alignas(64) uint8_t bytes[STATE_COUNT * ROW_SIZE];
+    alignas(64) int32_t wide[STATE_COUNT * ROW_SIZE];
+};
+
+const Tables& tables() {
+    static const Tables built = [] {
+        Tables t;
+        for (size_t i = 0; i < STATE_COUNT * ROW_SIZE; i++) {
+            t.bytes[i] = NO_TRANSITION;
+        }
+        for (const auto& [from, events] : StateMachine::transitions()) {
+            for (const auto& [event, to] : events) {
+                t.bytes[static_cast<size_t>(from) * ROW_SIZE + static_cast<size_t>(event)] = static_cast<uint8_t>(to);
+            }
+        }
+        for (size_t i = 0; i < STATE_COUNT * ROW_SIZE; i++) {
+            t.wide[i] = t.bytes[i];
+        }
+        return t;
+    }();
+    return built;
+}
+
+inline size_t stepOne(const uint8_t* table, uint8_t* states, uint8_t* events, size_t i,
+                      MachineId* changed, uint8_t* previous, size_t n) {
+    uint8_t event = events[i];
+    if (event == NO_EVENT) {
+        return n;
+    }
+    events[i] = NO_EVENT;
+    uint8_t old = states[i];
+    uint8_t next = table[old * ROW_SIZE + (event & (ROW_SIZE - 1))];
+    if (next == NO_TRANSITION) {
+        return n;
+    }
+    states[i] = next;
+    changed[n] = static_cast<MachineId>(i);
+    previous[n] = old;
+    return n + 1;
+}
+
+size_t scalarLoop(uint8_t* states, uint8_t* events, size_t begin, size_t count,
+                  MachineId* changed, uint8_t* previous, size_t n) {
+    const uint8_t* table = tables().bytes;
+    for (size_t i = begin; i < count; i++) {
+        n = stepOne(table, states, events, i, changed, previous, n);
+    }
+    return n;
+}
+
+#ifdef BATCH_STATE_MACHINE_X86
+
+// Any x86-64 has SSE2: skip runs of 16 machines without events and step the
+// rest one by one.
+size_t transitionSse2(uint8_t* states, uint8_t* events, size_t count, MachineId* changed, uint8_t* previous) {
+    const uint8_t* table = tables().bytes;
+    const __m128i none = _mm_set1_epi8(static_cast<char>(NO_EVENT));
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i pending = _mm_loadu_si128(reinterpret_cast<const __m128i*>(events + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(pending, none)) == 0xFFFF) {
+            continue;
+        }
+        for (size_t j = i; j < i + 16; j++) {
+            n = stepOne(table, states, events, j, changed, previous, n);
+        }
+    }
+    return scalarLoop(states, events, i, count, changed, previous, n);
+}
+
+// 32 machines per iteration: four 8-lane gathers of the next state, packed
+// back to bytes, blended with the old state where no transition applies, and
+// the fired lanes compacted with a bit scan over the byte mask.
+__attribute__((target("avx2")))
+size_t transitionAvx2(uint8_t* states, uint8_t* events, size_t count, MachineId* changed, uint8_t* previous) {
+    const Tables& t = tables();
+    const __m256i none = _mm256_set1_epi8(static_cast<char>(NO_EVENT));
+    const __m256i column = _mm256_set1_epi32(static_cast<int>(ROW_SIZE - 1));
+    // packus interleaves 128-bit lanes; this puts the four groups of eight
+    // back in machine order.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i pending = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(events + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(pending, none)) == -1) {
+            continue;
+        }
+
+        __m256i next[4];
+        for (int k = 0; k < 4; k++) {
+            __m256i state = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(states + i + 8 * k)));
+            __m256i event = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(events + i + 8 * k)));
+            __m256i index = _mm256_add_epi32(_mm256_slli_epi32(state, 5), _mm256_and_si256(event, column));
+            next[k] = _mm256_i32gather_epi32(t.wide, index, 4);
+        }
+        __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(next[0], next[1]),
+                                             _mm256_packus_epi32(next[2], next[3]));
+        packed = _mm256_permutevar8x32_epi32(packed, order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(events + i), none);
+
+        __m256i stay = _mm256_cmpeq_epi8(packed, none);
+        uint32_t fired = ~static_cast<uint32_t>(_mm256_movemask_epi8(stay));
+        if (fired == 0) {
+            continue;
+        }
+        alignas(32) uint8_t old[32];
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(old), current);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + i), _mm256_blendv_epi8(packed, current, stay));
+        while (fired != 0) {
+            unsigned lane = static_cast<unsigned>(__builtin_ctz(fired));
+            changed[n] = static_cast<MachineId>(i + lane);
+            previous[n] = old[lane];
+            n++;
+            fired &= fired - 1;
+        }
+    }
+    return scalarLoop(states, events, i, count, changed, previous, n);
+}
+
+#endif
+
+using Kernel = size_t (*)(uint8_t*, uint8_t*, size_t, MachineId*, uint8_t*);
+
+struct SelectedKernel {
+    Kernel kernel;
+    const char* name;
+};
+
+const SelectedKernel& selectedKernel() {
+    static const SelectedKernel selected = []() -> SelectedKernel {
+#ifdef BATCH_STATE_MACHINE_X86
+        if (__builtin_cpu_supports("avx2")) {
+            return {transitionAvx2, "avx2"};
+        }
+        return {transitionSse2, "sse2"};
+#else
+        return {BatchStateMachine::transitionScalar, "scalar"};
+#endif
+    }();
+    return selected;
+}
+
+}
+
+size_t BatchStateMachine::transitionKernel(uint8_t* states, uint8_t* events, size_t count,
+                                           MachineId* changed, uint8_t* previous) {
+    return selectedKernel().kernel(states, events, count, changed, previous);
+}
+
+size_t BatchStateMachine::transitionScalar(uint8_t* states, uint8_t* events, size_t count,
+                                           MachineId* changed, uint8_t* previous) {
+    return scalarLoop(states, events, 0, count, changed, previous, 0);
+}
+
+const char* BatchStateMachine::kernelName() {
+    return selectedKernel().name;
+}
+
+BatchStateMachine::BatchStateMachine(size_t machineCount) : changedCount(0) {
+    tables();
+    resize(machineCount);
+}
+
+void BatchStateMachine::resize(size_t machineCount) {
+    states.resize(machineCount, static_cast<uint8_t>(State::Idle));
+    events.resize(machineCount, NO_EVENT);
+    changed.resize(machineCount);
+    previous.resize(machineCount);
+    changedCount = 0;
+}
+
+size_t BatchStateMachine::size() const {
+    return states.size();
+}
+
+State BatchStateMachine::getState(MachineId id) const {
+    return static_cast<State>(states[id]);
+}
+
+void BatchStateMachine::setState(MachineId id, State state) {
+    states[id] = static_cast<uint8_t>(state);
+}
+
+bool BatchStateMachine::post(MachineId id, EventType event) {
+    if (events[id] != NO_EVENT) {
+        return false;
+    }
+    events[id] = static_cast<uint8_t>(event);
+    return true;
+}
+
+bool BatchStateMachine::hasEvent(MachineId id) const {
+    return events[id] != NO_EVENT;
+}
+
+void BatchStateMachine::registerOnEnter(State state, Action action) {
+    onEnter[static_cast<size_t>(state)].push_back(std::move(action));
+}
+
+void BatchStateMachine::registerOnExit(State state, Action action) {
+    onExit[static_cast<size_t>(state)].push_back(std::move(action));
+}
+
+size_t BatchStateMachine::step() {
+    changedCount = transitionKernel(states.data(), events.data(), states.size(), changed.data(), previous.data());
+    for (size_t k = 0; k < changedCount; k++) {
+        MachineId id = changed[k];
+        State oldState = static_cast<State>(previous[k]);
+        State newState = static_cast<State>(states[id]);
+        for (const Action& action : onExit[static_cast<size_t>(oldState)]) {
+            action(id, oldState, newState);
+        }
+        for (const Action& action : onEnter[static_cast<size_t>(newState)]) {
+            action(id, newState, oldState);
+        }
+    }
+    return changedCount;
+}
+
+size_t BatchStateMachine::getChangedCount() const {
+    return changedCount;
+}
+
+BatchStateMachine::MachineId BatchStateMachine::getChanged(size_t index) const {
+    return changed[index];
+}
+
+State BatchStateMachine::getPrevious(size_t index) const {
+    return static_cast<State>(previous[index]);
+}
+
+const uint8_t* BatchStateMachine::stateData() const {
+    return states.data();
+}
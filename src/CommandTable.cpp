@@ -0,0 +1,119 @@
+#include "CommandTable.hpp"
+#include <charconv>
+
+namespace {
+
+constexpr size_t countKeys() {
+    size_t count = 0;
+    for (const CommandSpec& spec : COMMAND_SPECS) {
+        count += spec.alias.empty() ? 1 : 2;
+    }
+    return count;
+}
+
+constexpr size_t KEY_COUNT = countKeys();
+constexpr size_t SLOT_COUNT = 64;
+constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+struct Key {
+    std::string_view name;
+    uint8_t spec;
+};
+
+constexpr std::array<Key, KEY_COUNT> collectKeys() {
+    std::array<Key, KEY_COUNT> keys{};
+    size_t next = 0;
+    for (size_t i = 0; i < COMMAND_SPECS.size(); i++) {
+        keys[next++] = {COMMAND_SPECS[i].name, static_cast<uint8_t>(i)};
+        if (!COMMAND_SPECS[i].alias.empty()) {
+            keys[next++] = {COMMAND_SPECS[i].alias, static_cast<uint8_t>(i)};
+        }
+    }
+    return keys;
+}
+
+struct PerfectHash {
+    uint32_t seed;
+    bool found;
+    std::array<uint8_t, SLOT_COUNT> slots;
+};
+
+// Tries seeds until every key lands in its own slot. Runs at compile time;
+// a lookup is then one hash, one slot read and one string compare.
+constexpr PerfectHash buildPerfectHash(const std::array<Key, KEY_COUNT>& keys) {
+    PerfectHash table{0, false, {}};
+    for (uint32_t seed = 0; seed < 4096; seed++) {
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            table.slots[i] = EMPTY_SLOT;
+        }
+        bool collision = false;
+        for (size_t i = 0; i < keys.size() && !collision; i++) {
+            size_t slot = commandHash(keys[i].name, seed) % SLOT_COUNT;
+            if (table.slots[slot] != EMPTY_SLOT) {
+                collision = true;
+            } else {
+                table.slots[slot] = static_cast<uint8_t>(i);
+            }
+        }
+        if (!collision) {
+            table.seed = seed;
+            table.found = true;
+            return table;
+        }
+    }
+    return table;
+}
+
+constexpr std::array<Key, KEY_COUNT> KEYS = collectKeys();
+constexpr PerfectHash COMMAND_HASH = buildPerfectHash(KEYS);
+
+static_assert(COMMAND_HASH.found, "no collision-free seed for the command table");
+static_assert(KEY_COUNT < EMPTY_SLOT, "command table too large for 8-bit slots");
+
+}
+
+const CommandSpec* findCommand(std::string_view name) {
+    uint8_t key = COMMAND_HASH.slots[commandHash(name, COMMAND_HASH.seed) % SLOT_COUNT];
+    if (key == EMPTY_SLOT || !equalsIgnoreCase(KEYS[key].name, name)) {
+        return nullptr;
+    }
+    return &COMMAND_SPECS[KEYS[key].spec];
+}
+
+CommandTokens tokenizeCommand(std::string_view input) {
+    CommandTokens result{{}, 0};
+    size_t pos = 0;
+    while (pos < input.size()) {
+        while (pos < input.size() && (input[pos] == ' ' || input[pos] == '\t' ||
+                                      input[pos] == '\r' || input[pos] == '\n')) {
+            pos++;
+        }
+        size_t start = pos;
+        while (pos < input.size() && input[pos] != ' ' && input[pos] != '\t' &&
+               input[pos] != '\r' && input[pos] != '\n') {
+            pos++;
+        }
+        if (pos > start && result.count < CommandTokens::MAX_TOKENS) {
+            result.tokens[result.count++] = input.substr(start, pos - start);
+        }
+    }
+    return result;
+}
+
+bool parseNumber(std::string_view text, int& value) {
+    if (text.empty()) {
+        return false;
+    }
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+bool parseNumber(std::string_view text, float& value) {
+    if (text.empty()) {
+        return false;
+    }
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    return ec == std::errc() && ptr == end;
+}
@@ -0,0 +1,1052 @@
+#include "CompactFleet.hpp"
+#include "MachineCore.hpp"
+#include "StateMachine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t STATE_COUNT = static_cast<size_t>(State::Fault) + 1;
+constexpr uint8_t NO_TRANSITION = 0xFF;
+
+// The same constants a default WaterSystem and MotorSystem use.
+constexpr float FILL_RATE = 10.0f;
+constexpr float DRAIN_RATE = 15.0f;
+constexpr float MAX_RESERVOIR = 100.0f;
+constexpr float LOW_RESERVOIR = 10.0f;
+constexpr int RAMP_RATE = 200;
+
+using TransitionArray = std::array<std::array<uint8_t, EVENT_TYPE_COUNT>, STATE_COUNT>;
+
+// StateMachine's table flattened to one byte per (state, event).
+const TransitionArray& transitionArray() {
+    static const TransitionArray table = [] {
+        TransitionArray flat;
+        for (auto& row : flat) {
+            row.fill(NO_TRANSITION);
+        }
+        for (const auto& [from, events] : StateMachine::transitions()) {
+            for (const auto& [event, to] : events) {
+                flat[static_cast<size_t>(from)][static_cast<size_t>(event)] = static_cast<uint8_t>(to);
+            }
+        }
+        return flat;
+    }();
+    return table;
+}
+
+bool isActive(uint8_t state) {
+    State s = static_cast<State>(state);
+    return s == State::Filling || s == State::Washing || s == State::Rinsing ||
+           s == State::Spinning || s == State::Draining;
+}
+
+bool has(const CompactMachineHot& machine, uint8_t flag) {
+    return (machine.flags & flag) != 0;
+}
+
+void set(CompactMachineHot& machine, uint8_t flag, bool on) {
+    machine.flags = static_cast<uint8_t>(on ? (machine.flags | flag) : (machine.flags & ~flag));
+}
+
+EventType completionEvent(State state) {
+    switch (state) {
+        case State::Filling: return EventType::SYS_WATER_LEVEL_REACHED;
+        case State::Washing: return EventType::SYS_WASH_COMPLETE;
+        case State::Rinsing: return EventType::SYS_RINSE_COMPLETE;
+        case State::Spinning: return EventType::SYS_SPIN_COMPLETE;
+        default: return EventType::SYS_DRAIN_COMPLETE;
+    }
+}
+
+// Time left in the current phase if nothing interrupts it.
+SimTime phaseRemaining(const CompactMachineHot& machine) {
+    switch (static_cast<State>(machine.state)) {
+        case State::Filling:
+            return std::max<SimTime>(0, toSimTime((machine.targetWaterLevel - machine.waterLevel) / FILL_RATE));
+        case State::Draining:
+            return std::max<SimTime>(0, toSimTime(machine.waterLevel / DRAIN_RATE));
+        default:
+            return std::max<SimTime>(0, machine.currentPhaseTime - machine.phaseTimeElapsed);
+    }
+}
+
+// Reservoir after drawing some liters, refilled to the top whenever it
+// drops below the low threshold as the per-tick model does.
+float drawReservoir(float reservoir, float liters) {
+    float left = reservoir - liters;
+    if (left < LOW_RESERVOIR) {
+        left = MAX_RESERVOIR - std::fmod(LOW_RESERVOIR - left, MAX_RESERVOIR - LOW_RESERVOIR);
+    }
+    return left;
+}
+
+DoorStatus doorStatus(const CompactMachineHot& machine) {
+    if (has(machine, CompactMachineHot::DOOR_OPEN)) {
+        return DoorStatus::Open;
+    }
+    return has(machine, CompactMachineHot::DOOR_LOCKED) ? DoorStatus::ClosedLocked : DoorStatus::ClosedUnlocked;
+}
+
+}
+
+static_assert(sizeof(CompactMachineHot) <= 64, "hot record must fit a cache line");
+static_assert(sizeof(CompactMachineHot) + sizeof(CompactMachineCold) <= 128, "machine record grew");
+static_assert(sizeof(CompactMachineCold::deadlineGeneration) == sizeof(CompactDeadline::generation),
+              "deadline generation width");
+
+CompactFleet::CompactFleet(size_t machineCount, std::shared_ptr<const ConfigManager> modeTable)
+    : modes(modeTable ? std::move(modeTable) : MachineCore::defaultModes()),
+      hot(nullptr),
+      cold(nullptr),
+      count(0),
+      capacity(0),
+      tracking(true),
+      clock(0) {
+    if (modes->getModeCount() > MAX_MODES) {
+        throw std::invalid_argument("compact fleet supports at most 255 wash modes");
+    }
+    transitionArray();
+    resize(machineCount);
+}
+
+void CompactFleet::reserve(size_t machines) {
+    if (machines <= capacity) {
+        return;
+    }
+    size_t grown = std::max(machines, capacity * 2);
+    FleetArena next(FleetArena::roundUp(sizeof(CompactMachineHot) * grown) +
+                    FleetArena::roundUp(sizeof(CompactMachineCold) * grown));
+    CompactMachineHot* nextHot = next.allocate<CompactMachineHot>(grown);
+    CompactMachineCold* nextCold = next.allocate<CompactMachineCold>(grown);
+    if (count > 0) {
+        std::memcpy(static_cast<void*>(nextHot), hot, sizeof(CompactMachineHot) * count);
+        std::memcpy(static_cast<void*>(nextCold), cold, sizeof(CompactMachineCold) * count);
+    }
+    arena = std::move(next);
+    hot = nextHot;
+    cold = nextCold;
+    capacity = grown;
+}
+
+void CompactFleet::resize(size_t machineCount) {
+    if (machineCount > UINT32_MAX) {
+        throw std::length_error("compact fleet ids are 32-bit");
+    }
+    reserve(machineCount);
+    for (size_t id = count; id < machineCount; id++) {
+        hot[id] = CompactMachineHot();
+        cold[id] = CompactMachineCold();
+    }
+    if (machineCount < count) {
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                     [machineCount](const CompactEvent& event) {
+                                         return event.machine >= machineCount;
+                                     }),
+                      pending.end());
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [machineCount](MachineId id) { return id >= machineCount; }),
+                     active.end());
+        deadlines.erase(std::remove_if(deadlines.begin(), deadlines.end(),
+                                       [machineCount](const CompactDeadline& deadline) {
+                                           return deadline.machine >= machineCount;
+                                       }),
+                        deadlines.end());
+        std::make_heap(deadlines.begin(), deadlines.end(), std::greater<>());
+    }
+    count = machineCount;
+}
+
+size_t CompactFleet::size() const {
+    return count;
+}
+
+size_t CompactFleet::getCapacity() const {
+    return capacity;
+}
+
+void CompactFleet::wake(MachineId id) {
+    if (tracking && !cold[id].listed && !isDeadlineDriven(id)) {
+        cold[id].listed = true;
+        active.push_back(id);
+    }
+}
+
+// True when update() would leave the machine exactly as it is.
+bool CompactFleet::isQuiescent(MachineId id) const {
+    const CompactMachineHot& m = hot[id];
+    if (isActive(m.state)) {
+        return false;
+    }
+    bool motorSettled = !has(m, CompactMachineHot::MOTOR_RUNNING) && m.motorRPM == 0 &&
+                        static_cast<Direction>(m.direction) == Direction::Stopped;
+    if (static_cast<State>(m.state) == State::Paused) {
+        return motorSettled;
+    }
+    bool filling = has(m, CompactMachineHot::INLET_OPEN) && m.waterLevel < m.targetWaterLevel;
+    bool draining = has(m, CompactMachineHot::DRAIN_OPEN) && m.waterLevel > 0;
+    bool unlockDue = has(m, CompactMachineHot::DOOR_LOCKED) && m.waterLevel <= 0 && m.motorRPM == 0;
+    return motorSettled && !filling && !draining && !unlockDue;
+}
+
+void CompactFleet::rebuildActive() {
+    active.clear();
+    for (size_t id = 0; id < count; id++) {
+        cold[id].listed = false;
+        if (tracking && !isQuiescent(static_cast<MachineId>(id))) {
+            cold[id].listed = true;
+            active.push_back(static_cast<MachineId>(id));
+        }
+    }
+}
+
+void CompactFleet::setActiveTracking(bool enabled) {
+    tracking = enabled;
+    rebuildActive();
+}
+
+bool CompactFleet::getActiveTracking() const {
+    return tracking;
+}
+
+size_t CompactFleet::getActiveCount() const {
+    return tracking ? active.size() : count;
+}
+
+bool CompactFleet::isDeadlineDriven(MachineId id) const {
+    return cold[id].effective != Fidelity::Full && isActive(hot[id].state);
+}
+
+// The machine as the per-tick model would have it now, integrated in closed
+// form from the start of the phase. Ramps and fills are linear, so this only
+// differs from Full by the per-tick rounding of the motor ramp.
+CompactMachineHot CompactFleet::estimate(MachineId id) const {
+    CompactMachineHot m = hot[id];
+    SimTime elapsed = clock - cold[id].phaseStart;
+    if (elapsed <= 0) {
+        return m;
+    }
+    float t = toSeconds(elapsed);
+
+    if (has(m, CompactMachineHot::INLET_OPEN) && m.waterLevel < m.targetWaterLevel) {
+        float filled = std::min(FILL_RATE * t, m.targetWaterLevel - m.waterLevel);
+        m.waterLevel += filled;
+        m.reservoirLevel = drawReservoir(m.reservoirLevel, filled);
+        if (m.waterLevel >= m.targetWaterLevel) {
+            m.waterLevel = m.targetWaterLevel;
+            set(m, CompactMachineHot::INLET_OPEN, false);
+        }
+    }
+    if (has(m, CompactMachineHot::DRAIN_OPEN) && m.waterLevel > 0) {
+        m.waterLevel -= DRAIN_RATE * t;
+        if (m.waterLevel <= 0) {
+            m.waterLevel = 0;
+            set(m, CompactMachineHot::DRAIN_OPEN, false);
+        }
+    }
+
+    bool running = has(m, CompactMachineHot::MOTOR_RUNNING);
+    if (running || m.motorRPM != 0) {
+        int ramp = static_cast<int>(RAMP_RATE * std::min<SimTime>(elapsed, 1000000 * SIM_TIME_PER_SECOND) /
+                                    SIM_TIME_PER_SECOND);
+        if (m.motorRPM < m.targetRPM) {
+            m.motorRPM = std::min(m.targetRPM, m.motorRPM + ramp);
+        } else if (m.motorRPM > m.targetRPM) {
+            m.motorRPM = std::max(m.targetRPM, m.motorRPM - ramp);
+        }
+    }
+    if (!running && m.motorRPM == 0) {
+        m.direction = static_cast<uint8_t>(Direction::Stopped);
+    }
+
+    m.phaseTimeElapsed += elapsed;
+    m.cycleTimeElapsed += elapsed;
+    return m;
+}
+
+// Statistical machines skip the ramp: the drum is at the phase's speed from
+// the start.
+void CompactFleet::scheduleBoundary(MachineId id) {
+    CompactMachineHot& m = hot[id];
+    CompactMachineCold& c = cold[id];
+    if (c.effective == Fidelity::Statistical) {
+        m.motorRPM = m.targetRPM;
+        if (!has(m, CompactMachineHot::MOTOR_RUNNING) && m.motorRPM == 0) {
+            m.direction = static_cast<uint8_t>(Direction::Stopped);
+        }
+    }
+    c.phaseStart = clock;
+    c.deadlineGeneration++;
+    deadlines.push_back({clock + phaseRemaining(m), id, c.deadlineGeneration});
+    std::push_heap(deadlines.begin(), deadlines.end(), std::greater<>());
+}
+
+// A Coarse boundary posts the completion event, so the next phase starts on
+// the following tick exactly as it would at Full. A Statistical boundary
+// handles it on the spot.
+void CompactFleet::fireDeadlines() {
+    while (!deadlines.empty() && deadlines.front().at <= clock) {
+        std::pop_heap(deadlines.begin(), deadlines.end(), std::greater<>());
+        CompactDeadline deadline = deadlines.back();
+        deadlines.pop_back();
+
+        MachineId id = deadline.machine;
+        if (id >= count || cold[id].deadlineGeneration != deadline.generation || !isDeadlineDriven(id)) {
+            continue;
+        }
+
+        CompactMachineHot& m = hot[id];
+        EventType done = completionEvent(static_cast<State>(m.state));
+        if (cold[id].effective == Fidelity::Coarse) {
+            m = estimate(id);
+            cold[id].phaseStart = clock;
+            post(id, done);
+            continue;
+        }
+
+        SimTime duration = phaseRemaining(m);
+        if (static_cast<State>(m.state) == State::Filling) {
+            m.reservoirLevel = drawReservoir(m.reservoirLevel, m.targetWaterLevel - m.waterLevel);
+            m.waterLevel = m.targetWaterLevel;
+            set(m, CompactMachineHot::INLET_OPEN, false);
+        } else if (static_cast<State>(m.state) == State::Draining) {
+            m.waterLevel = 0.0f;
+            set(m, CompactMachineHot::DRAIN_OPEN, false);
+        }
+        m.phaseTimeElapsed += duration;
+        m.cycleTimeElapsed += duration;
+
+        CompactEvent event;
+        event.machine = id;
+        event.type = static_cast<uint8_t>(done);
+        event.hasData = false;
+        event.intValue = 0;
+        handleEvent(event);
+    }
+}
+
+// Brings a machine to Full at the current time.
+void CompactFleet::promote(MachineId id) {
+    CompactMachineCold& c = cold[id];
+    if (c.effective == Fidelity::Full) {
+        return;
+    }
+    if (isDeadlineDriven(id)) {
+        hot[id] = estimate(id);
+        c.deadlineGeneration++;
+    }
+    c.effective = Fidelity::Full;
+    wake(id);
+}
+
+void CompactFleet::applyFidelity(MachineId id) {
+    CompactMachineCold& c = cold[id];
+    Fidelity desired = c.monitored ? Fidelity::Full : c.fidelity;
+    if (desired == c.effective) {
+        return;
+    }
+    promote(id);
+    c.effective = desired;
+    if (isDeadlineDriven(id)) {
+        scheduleBoundary(id);
+    }
+}
+
+void CompactFleet::setFidelity(MachineId id, Fidelity level) {
+    cold[id].fidelity = level;
+    applyFidelity(id);
+}
+
+Fidelity CompactFleet::getFidelity(MachineId id) const {
+    return cold[id].fidelity;
+}
+
+Fidelity CompactFleet::getEffectiveFidelity(MachineId id) const {
+    return cold[id].effective;
+}
+
+void CompactFleet::setMonitored(MachineId id, bool monitored) {
+    cold[id].monitored = monitored;
+    applyFidelity(id);
+}
+
+bool CompactFleet::isMonitored(MachineId id) const {
+    return cold[id].monitored;
+}
+
+double CompactFleet::getTime() const {
+    return static_cast<double>(clock) / SIM_TIME_PER_SECOND;
+}
+
+void CompactFleet::post(MachineId id, EventType type) {
+    wake(id);
+    CompactEvent event;
+    event.machine = id;
+    event.type = static_cast<uint8_t>(type);
+    event.hasData = false;
+    event.intValue = 0;
+    pending.push_back(event);
+}
+
+void CompactFleet::post(MachineId id, EventType type, int32_t value) {
+    wake(id);
+    CompactEvent event;
+    event.machine = id;
+    event.type = static_cast<uint8_t>(type);
+    event.hasData = true;
+    event.intValue = value;
+    pending.push_back(event);
+}
+
+void CompactFleet::post(MachineId id, EventType type, float value) {
+    wake(id);
+    CompactEvent event;
+    event.machine = id;
+    event.type = static_cast<uint8_t>(type);
+    event.hasData = true;
+    event.floatValue = value;
+    pending.push_back(event);
+}
+
+// The plan is cached per machine in the cold record and rebuilt when mode or
+// load changed, as MachineCore does with its shared plan.
+void CompactFleet::currentPlan(MachineId id) {
+    CompactMachineCold& c = cold[id];
+    if (c.planModeIndex == c.modeIndex && c.planLoadKg == c.loadKg) {
+        return;
+    }
+    const WashMode& mode = modes->getMode(c.modeIndex);
+    float duration = mode.getAdjustedDuration(c.loadKg);
+
+    c.planModeIndex = c.modeIndex;
+    c.planLoadKg = c.loadKg;
+    c.planTargetWater = mode.getAdjustedWaterLevel(c.loadKg);
+    c.planFillTime = c.planTargetWater / 10.0f;
+    c.planWashTime = duration * 0.5f * 60.0f;
+    c.planRinseTime = duration * 0.25f * 60.0f;
+    c.planSpinTime = duration * 0.15f * 60.0f;
+    c.planWashRPM = mode.spinSpeedRPM / 2;
+    c.planSpinRPM = mode.spinSpeedRPM;
+}
+
+void CompactFleet::startFilling(MachineId id, float target) {
+    CompactMachineHot& m = hot[id];
+    if (m.reservoirLevel < LOW_RESERVOIR) {
+        m.reservoirLevel = MAX_RESERVOIR;
+    }
+    m.targetWaterLevel = target;
+    set(m, CompactMachineHot::INLET_OPEN, true);
+    set(m, CompactMachineHot::DRAIN_OPEN, false);
+}
+
+void CompactFleet::stopFilling(MachineId id) {
+    set(hot[id], CompactMachineHot::INLET_OPEN, false);
+}
+
+void CompactFleet::startDraining(MachineId id) {
+    set(hot[id], CompactMachineHot::DRAIN_OPEN, true);
+    set(hot[id], CompactMachineHot::INLET_OPEN, false);
+}
+
+void CompactFleet::startMotor(MachineId id, int rpm, Direction direction) {
+    CompactMachineHot& m = hot[id];
+    m.targetRPM = rpm;
+    m.direction = static_cast<uint8_t>(direction);
+    set(m, CompactMachineHot::MOTOR_RUNNING, true);
+}
+
+void CompactFleet::stopMotor(MachineId id) {
+    hot[id].targetRPM = 0;
+    set(hot[id], CompactMachineHot::MOTOR_RUNNING, false);
+}
+
+void CompactFleet::emergencyStopMotor(MachineId id) {
+    CompactMachineHot& m = hot[id];
+    set(m, CompactMachineHot::MOTOR_RUNNING, false);
+    m.targetRPM = 0;
+    m.motorRPM = 0;
+    m.direction = static_cast<uint8_t>(Direction::Stopped);
+}
+
+void CompactFleet::unlockDoorWhenSafe(MachineId id) {
+    CompactMachineHot& m = hot[id];
+    if (m.waterLevel <= 0 && m.motorRPM == 0) {
+        set(m, CompactMachineHot::DOOR_LOCKED, false);
+    }
+}
+
+void CompactFleet::enterState(MachineId id, State newState, State oldState) {
+    CompactMachineHot& m = hot[id];
+    const CompactMachineCold& c = cold[id];
+    switch (newState) {
+        case State::Filling:
+            currentPlan(id);
+            startFilling(id, c.planTargetWater);
+            m.currentPhaseTime = toSimTime(c.planFillTime);
+            m.phaseTimeElapsed = 0;
+            if (!has(m, CompactMachineHot::DOOR_OPEN)) {
+                set(m, CompactMachineHot::DOOR_LOCKED, true);
+            }
+            break;
+        case State::Washing:
+            currentPlan(id);
+            startMotor(id, c.planWashRPM, Direction::Clockwise);
+            m.currentPhaseTime = toSimTime(c.planWashTime);
+            m.phaseTimeElapsed = 0;
+            break;
+        case State::Rinsing:
+            startMotor(id, 400, Direction::CounterClockwise);
+            currentPlan(id);
+            m.currentPhaseTime = toSimTime(c.planRinseTime);
+            m.phaseTimeElapsed = 0;
+            break;
+        case State::Spinning:
+            currentPlan(id);
+            startMotor(id, c.planSpinRPM, Direction::Clockwise);
+            m.currentPhaseTime = toSimTime(c.planSpinTime);
+            m.phaseTimeElapsed = 0;
+            break;
+        case State::Draining:
+            stopMotor(id);
+            startDraining(id);
+            m.currentPhaseTime = toSimTime(m.waterLevel / 15.0f);
+            m.phaseTimeElapsed = 0;
+            break;
+        case State::Completed:
+            stopMotor(id);
+            unlockDoorWhenSafe(id);
+            break;
+        case State::EmergencyStop:
+        case State::Fault:
+            emergencyStopMotor(id);
+            stopFilling(id);
+            startDraining(id);
+            break;
+        case State::Paused:
+            m.pausedFrom = static_cast<uint8_t>(oldState);
+            stopMotor(id);
+            stopFilling(id);
+            break;
+        default:
+            break;
+    }
+}
+
+void CompactFleet::forceState(MachineId id, State state) {
+    State oldState = static_cast<State>(hot[id].state);
+    hot[id].state = static_cast<uint8_t>(state);
+    enterState(id, state, oldState);
+}
+
+bool CompactFleet::validateStart(MachineId id) const {
+    const CompactMachineHot& m = hot[id];
+    float load = cold[id].loadKg;
+    if (has(m, CompactMachineHot::DOOR_OPEN) || load <= 0 || load > 6.0f) {
+        return false;
+    }
+    return m.reservoirLevel >= LOW_RESERVOIR;
+}
+
+void CompactFleet::handleEvent(const CompactEvent& event) {
+    MachineId id = event.machine;
+    EventType type = static_cast<EventType>(event.type);
+    wake(id);
+
+    if (type == EventType::CMD_SELECT_MODE && event.hasData) {
+        cold[id].modeIndex = static_cast<uint8_t>(event.intValue);
+    }
+    if (type == EventType::CMD_SET_LOAD && event.hasData) {
+        cold[id].loadKg = event.floatValue;
+    }
+    if (type == EventType::CMD_START && !validateStart(id)) {
+        return;
+    }
+
+    uint8_t oldState = hot[id].state;
+    uint8_t newState = transitionArray()[oldState][event.type];
+    if (newState == NO_TRANSITION) {
+        return;
+    }
+    hot[id].state = newState;
+    if (type == EventType::CMD_START) {
+        cold[id].effective = cold[id].monitored ? Fidelity::Full : cold[id].fidelity;
+        // As in MachineCore, the cycle clock starts when CMD_START is handled.
+        currentPlan(id);
+        const CompactMachineCold& c = cold[id];
+        CompactMachineHot& m = hot[id];
+        m.totalCycleTime = toSimTime(c.planFillTime) + toSimTime(c.planWashTime) + toSimTime(c.planRinseTime) +
+                           toSimTime(c.planSpinTime) + toSimTime(m.waterLevel / 15.0f);
+        m.cycleTimeElapsed = 0;
+    }
+    enterState(id, static_cast<State>(newState), static_cast<State>(oldState));
+
+    if (static_cast<State>(newState) == State::Fault) {
+        cold[id].fault = static_cast<uint8_t>(eventToFaultCode(type));
+    }
+
+    if (isDeadlineDriven(id)) {
+        scheduleBoundary(id);
+    } else {
+        wake(id);
+    }
+}
+
+void CompactFleet::processPendingEvents() {
+    for (size_t i = 0; i < pending.size(); i++) {
+        CompactEvent event = pending[i];
+        handleEvent(event);
+    }
+    pending.clear();
+}
+
+void CompactFleet::updateWater(MachineId id, SimTime deltaTime) {
+    CompactMachineHot& m = hot[id];
+    float seconds = toSeconds(deltaTime);
+    if (has(m, CompactMachineHot::INLET_OPEN) && m.waterLevel < m.targetWaterLevel) {
+        float fillAmount = FILL_RATE * seconds;
+        float available = m.reservoirLevel;
+        if (fillAmount > available) {
+            fillAmount = available;
+        }
+        m.waterLevel += fillAmount;
+        m.reservoirLevel -= fillAmount;
+
+        if (m.waterLevel >= m.targetWaterLevel) {
+            m.waterLevel = m.targetWaterLevel;
+            set(m, CompactMachineHot::INLET_OPEN, false);
+            post(id, EventType::SYS_WATER_LEVEL_REACHED);
+        }
+        if (m.reservoirLevel < LOW_RESERVOIR) {
+            m.reservoirLevel = MAX_RESERVOIR;
+        }
+    }
+
+    if (has(m, CompactMachineHot::DRAIN_OPEN) && m.waterLevel > 0) {
+        float drainAmount = DRAIN_RATE * seconds;
+        m.waterLevel -= drainAmount;
+        if (m.waterLevel <= 0) {
+            m.waterLevel = 0;
+            set(m, CompactMachineHot::DRAIN_OPEN, false);
+            post(id, EventType::SYS_DRAIN_COMPLETE);
+        }
+    }
+}
+
+void CompactFleet::updateMotor(MachineId id, SimTime deltaTime) {
+    CompactMachineHot& m = hot[id];
+    bool running = has(m, CompactMachineHot::MOTOR_RUNNING);
+    if (!running && m.motorRPM == 0) {
+        m.direction = static_cast<uint8_t>(Direction::Stopped);
+        return;
+    }
+
+    int rampAmount = static_cast<int>(RAMP_RATE * deltaTime / SIM_TIME_PER_SECOND);
+    if (m.motorRPM < m.targetRPM) {
+        m.motorRPM += rampAmount;
+        if (m.motorRPM > m.targetRPM) {
+            m.motorRPM = m.targetRPM;
+        }
+    } else if (m.motorRPM > m.targetRPM) {
+        m.motorRPM -= rampAmount;
+        if (m.motorRPM < m.targetRPM) {
+            m.motorRPM = m.targetRPM;
+        }
+    }
+
+    if (!running && m.motorRPM == 0) {
+        m.direction = static_cast<uint8_t>(Direction::Stopped);
+    }
+}
+
+void CompactFleet::updateMachine(MachineId id, SimTime deltaTime) {
+    CompactMachineHot& m = hot[id];
+    State state = static_cast<State>(m.state);
+
+    if (isActive(m.state)) {
+        updateWater(id, deltaTime);
+        updateMotor(id, deltaTime);
+
+        m.cycleTimeElapsed += deltaTime;
+        m.phaseTimeElapsed += deltaTime;
+
+        if (m.phaseTimeElapsed >= m.currentPhaseTime) {
+            switch (state) {
+                case State::Washing:
+                    post(id, EventType::SYS_WASH_COMPLETE);
+                    break;
+                case State::Rinsing:
+                    post(id, EventType::SYS_RINSE_COMPLETE);
+                    break;
+                case State::Spinning:
+                    post(id, EventType::SYS_SPIN_COMPLETE);
+                    break;
+                default:
+                    break;
+            }
+        }
+    } else if (state == State::Paused) {
+        updateMotor(id, deltaTime);
+    } else {
+        updateWater(id, deltaTime);
+        updateMotor(id, deltaTime);
+        unlockDoorWhenSafe(id);
+    }
+}
+
+// Machines that settle are swapped out of the list as they are visited, so
+// the order of the list changes but each machine is updated once.
+void CompactFleet::update(float deltaTime) {
+    update(toSimTime(deltaTime));
+}
+
+void CompactFleet::update(SimTime deltaTime) {
+    clock += deltaTime;
+    if (!tracking) {
+        for (size_t id = 0; id < count; id++) {
+            if (!isDeadlineDriven(static_cast<MachineId>(id))) {
+                updateMachine(static_cast<MachineId>(id), deltaTime);
+            }
+        }
+        fireDeadlines();
+        return;
+    }
+
+    size_t i = 0;
+    while (i < active.size()) {
+        MachineId id = active[i];
+        if (!isDeadlineDriven(id)) {
+            updateMachine(id, deltaTime);
+        }
+        if (isDeadlineDriven(id) || isQuiescent(id)) {
+            cold[id].listed = false;
+            active[i] = active.back();
+            active.pop_back();
+        } else {
+            i++;
+        }
+    }
+    fireDeadlines();
+}
+
+void CompactFleet::tick(float deltaTime) {
+    tick(toSimTime(deltaTime));
+}
+
+void CompactFleet::tick(SimTime deltaTime) {
+    processPendingEvents();
+    update(deltaTime);
+}
+
+size_t CompactFleet::getPendingCount() const {
+    return pending.size();
+}
+
+void CompactFleet::openDoor(MachineId id) {
+    promote(id);
+    wake(id);
+    CompactMachineHot& m = hot[id];
+    if (has(m, CompactMachineHot::DOOR_LOCKED)) {
+        return;
+    }
+    set(m, CompactMachineHot::DOOR_OPEN, true);
+    uint8_t next = transitionArray()[m.state][static_cast<size_t>(EventType::CMD_OPEN_DOOR)];
+    if (next != NO_TRANSITION) {
+        m.state = next;
+    }
+}
+
+void CompactFleet::closeDoor(MachineId id) {
+    promote(id);
+    wake(id);
+    CompactMachineHot& m = hot[id];
+    set(m, CompactMachineHot::DOOR_OPEN, false);
+    uint8_t next = transitionArray()[m.state][static_cast<size_t>(EventType::CMD_CLOSE_DOOR)];
+    if (next != NO_TRANSITION) {
+        m.state = next;
+    }
+}
+
+void CompactFleet::selectMode(MachineId id, int modeIndex) {
+    promote(id);
+    if (modeIndex < 0 || modeIndex >= modes->getModeCount() || isActive(hot[id].state)) {
+        return;
+    }
+    post(id, EventType::CMD_SELECT_MODE, static_cast<int32_t>(modeIndex));
+    cold[id].modeIndex = static_cast<uint8_t>(modeIndex);
+}
+
+void CompactFleet::setLoad(MachineId id, float kg) {
+    promote(id);
+    if (isActive(hot[id].state) || kg < 0) {
+        return;
+    }
+    post(id, EventType::CMD_SET_LOAD, kg);
+    cold[id].loadKg = kg;
+}
+
+void CompactFleet::start(MachineId id) {
+    promote(id);
+    if (!validateStart(id)) {
+        return;
+    }
+    post(id, EventType::CMD_START);
+}
+
+void CompactFleet::pause(MachineId id) {
+    promote(id);
+    if (isActive(hot[id].state)) {
+        post(id, EventType::CMD_PAUSE);
+    }
+}
+
+void CompactFleet::resume(MachineId id) {
+    promote(id);
+    wake(id);
+    if (static_cast<State>(hot[id].state) == State::Paused) {
+        forceState(id, static_cast<State>(hot[id].pausedFrom));
+    }
+}
+
+void CompactFleet::stop(MachineId id) {
+    promote(id);
+    wake(id);
+    State state = static_cast<State>(hot[id].state);
+    if (state == State::Idle || state == State::DoorOpen) {
+        return;
+    }
+
+    if (isActive(hot[id].state) || state == State::Paused) {
+        stopMotor(id);
+        stopFilling(id);
+        if (hot[id].waterLevel > 0) {
+            startDraining(id);
+            forceState(id, State::Draining);
+        } else {
+            unlockDoorWhenSafe(id);
+            forceState(id, State::Idle);
+        }
+    } else {
+        post(id, EventType::CMD_STOP);
+    }
+}
+
+void CompactFleet::emergencyStop(MachineId id) {
+    promote(id);
+    post(id, EventType::CMD_EMERGENCY);
+}
+
+void CompactFleet::clearFault(MachineId id) {
+    promote(id);
+    if (static_cast<State>(hot[id].state) == State::Fault) {
+        post(id, EventType::FAULT_CLEARED);
+        cold[id].fault = static_cast<uint8_t>(FaultCode::None);
+    }
+}
+
+PushResult CompactFleet::injectFault(MachineId id, FaultCode fault) {
+    if (fault == FaultCode::None) {
+        return PushResult::Rejected;
+    }
+    promote(id);
+    post(id, faultCodeToEvent(fault));
+    return PushResult::Accepted;
+}
+
+State CompactFleet::getCurrentState(MachineId id) const {
+    return static_cast<State>(hot[id].state);
+}
+
+State CompactFleet::getPausedFromState(MachineId id) const {
+    return static_cast<State>(hot[id].pausedFrom);
+}
+
+CompactMachineHot CompactFleet::reading(MachineId id) const {
+    if (cold[id].effective == Fidelity::Coarse && isDeadlineDriven(id)) {
+        return estimate(id);
+    }
+    return hot[id];
+}
+
+// Progress is not stored: MachineCore only recomputes it from elapsed and
+// total time, and both change together, so deriving it here gives the same
+// value.
+SystemStatus CompactFleet::getStatus(MachineId id) const {
+    const CompactMachineHot m = reading(id);
+    const CompactMachineCold& c = cold[id];
+
+    SystemStatus status;
+    status.state = static_cast<State>(m.state);
+    status.doorStatus = doorStatus(m);
+    status.waterLevel = m.waterLevel;
+    status.targetWaterLevel = m.targetWaterLevel;
+    status.motorRPM = m.motorRPM;
+    status.loadKg = c.loadKg;
+    status.modeIndex = c.modeIndex;
+    status.modeName = modes->getMode(c.modeIndex).name;
+
+    status.progressPercent = percentOf(m.cycleTimeElapsed, m.totalCycleTime);
+
+    SimTime remaining = m.totalCycleTime - m.cycleTimeElapsed;
+    status.remainingSeconds = (remaining > 0) ? static_cast<int>(remaining / SIM_TIME_PER_SECOND) : 0;
+
+    status.fault = static_cast<FaultCode>(c.fault);
+    return status;
+}
+
+SensorSample CompactFleet::getSensorSample(MachineId id) const {
+    const CompactMachineHot m = reading(id);
+    SensorSample sample;
+    sample.state = static_cast<State>(m.state);
+    sample.doorStatus = doorStatus(m);
+    sample.direction = static_cast<Direction>(m.direction);
+    sample.fillValveOpen = has(m, CompactMachineHot::INLET_OPEN);
+    sample.drainValveOpen = has(m, CompactMachineHot::DRAIN_OPEN);
+    sample.waterLevel = m.waterLevel;
+    sample.motorRPM = m.motorRPM;
+    return sample;
+}
+
+const ConfigManager& CompactFleet::getModeTable() const {
+    return *modes;
+}
+
+// Shared bytes are the transition array and the mode table. The built-in
+// table is read-only data and counts only the manager itself; a loaded one
+// adds its modes and names on the heap.
+FleetMemoryReport CompactFleet::getMemoryReport() const {
+    FleetMemoryReport report;
+    report.machines = count;
+    report.capacity = capacity;
+    report.hotBytes = sizeof(CompactMachineHot);
+    report.coldBytes = sizeof(CompactMachineCold);
+    report.arenaBytes = arena.getCapacity();
+    report.eventQueueBytes = pending.capacity() * sizeof(CompactEvent);
+    report.activeListBytes = active.capacity() * sizeof(MachineId);
+    report.deadlineBytes = deadlines.capacity() * sizeof(CompactDeadline);
+
+    report.sharedBytes = sizeof(TransitionArray) + sizeof(ConfigManager) + modes->getHeapBytes();
+    return report;
+}
+
+// Field for field what MachineCore::saveState() writes.
+void CompactFleet::saveState(MachineId id, CheckpointWriter& writer) const {
+    const CompactMachineHot m = reading(id);
+    const CompactMachineCold& c = cold[id];
+    writer.write<uint8_t>(m.state);
+    writer.write<uint8_t>(m.state);
+    writer.write<uint8_t>(m.pausedFrom);
+    writer.write<uint8_t>(has(m, CompactMachineHot::DOOR_OPEN) ? 1 : 0);
+    writer.write<uint8_t>(has(m, CompactMachineHot::DOOR_LOCKED) ? 1 : 0);
+    writer.write<float>(m.waterLevel);
+    writer.write<float>(m.targetWaterLevel);
+    writer.write<float>(m.reservoirLevel);
+    writer.write<uint8_t>(has(m, CompactMachineHot::INLET_OPEN) ? 1 : 0);
+    writer.write<uint8_t>(has(m, CompactMachineHot::DRAIN_OPEN) ? 1 : 0);
+    writer.write<int32_t>(m.motorRPM);
+    writer.write<int32_t>(m.targetRPM);
+    writer.write<uint8_t>(has(m, CompactMachineHot::MOTOR_RUNNING) ? 1 : 0);
+    writer.write<uint8_t>(m.direction);
+    writer.write<int32_t>(c.modeIndex);
+    writer.write<float>(c.loadKg);
+    writer.write<float>(percentOf(m.cycleTimeElapsed, m.totalCycleTime));
+    writer.write<int64_t>(m.cycleTimeElapsed);
+    writer.write<int64_t>(m.totalCycleTime);
+    writer.write<int64_t>(m.phaseTimeElapsed);
+    writer.write<int64_t>(m.currentPhaseTime);
+    writer.write<uint8_t>(c.fault);
+}
+
+// Checks what MachineCore::restoreState() checks and fills in the recorded
+// fields only; the caller keeps the rest of the cold record.
+bool CompactFleet::decodeState(CheckpointReader& reader, CompactMachineHot& m, CompactMachineCold& c) const {
+    uint8_t state = 0;
+    uint8_t previous = 0;
+    uint8_t pausedFrom = 0;
+    uint8_t doorOpen = 0;
+    uint8_t doorLocked = 0;
+    uint8_t inlet = 0;
+    uint8_t drain = 0;
+    uint8_t running = 0;
+    uint8_t direction = 0;
+    int32_t modeIndex = 0;
+    float progress = 0.0f;
+    uint8_t fault = 0;
+    if (!reader.read(state) || !reader.read(previous) || !reader.read(pausedFrom) ||
+        !reader.read(doorOpen) || !reader.read(doorLocked) ||
+        !reader.read(m.waterLevel) || !reader.read(m.targetWaterLevel) || !reader.read(m.reservoirLevel) ||
+        !reader.read(inlet) || !reader.read(drain) ||
+        !reader.read(m.motorRPM) || !reader.read(m.targetRPM) || !reader.read(running) || !reader.read(direction) ||
+        !reader.read(modeIndex) || !reader.read(c.loadKg) || !reader.read(progress) ||
+        !reader.read(m.cycleTimeElapsed) || !reader.read(m.totalCycleTime) ||
+        !reader.read(m.phaseTimeElapsed) || !reader.read(m.currentPhaseTime) || !reader.read(fault)) {
+        return false;
+    }
+    const uint8_t lastState = static_cast<uint8_t>(State::Fault);
+    if (state > lastState || previous > lastState || pausedFrom > lastState ||
+        direction > static_cast<uint8_t>(Direction::Stopped) || fault > static_cast<uint8_t>(FaultCode::Timeout)) {
+        return false;
+    }
+
+    m.state = state;
+    m.pausedFrom = pausedFrom;
+    m.direction = direction;
+    m.flags = 0;
+    set(m, CompactMachineHot::DOOR_OPEN, doorOpen != 0);
+    set(m, CompactMachineHot::DOOR_LOCKED, doorLocked != 0);
+    set(m, CompactMachineHot::INLET_OPEN, inlet != 0);
+    set(m, CompactMachineHot::DRAIN_OPEN, drain != 0);
+    set(m, CompactMachineHot::MOTOR_RUNNING, running != 0);
+    c.modeIndex = static_cast<uint8_t>((modeIndex >= 0 && modeIndex < modes->getModeCount()) ? modeIndex : 0);
+    c.fault = fault;
+    return true;
+}
+
+void CompactFleet::saveCheckpoint(std::vector<uint8_t>& buffer) const {
+    buffer.clear();
+    CheckpointWriter writer(buffer);
+    writer.writeHeader(CheckpointKind::Fleet, static_cast<uint32_t>(count));
+    writer.reserve(MachineCore::CHECKPOINT_BYTES * count);
+    for (size_t id = 0; id < count; id++) {
+        saveState(static_cast<MachineId>(id), writer);
+    }
+}
+
+bool CompactFleet::restoreCheckpoint(const std::vector<uint8_t>& buffer) {
+    CheckpointReader reader(buffer);
+    uint32_t records = 0;
+    if (!reader.readHeader(CheckpointKind::Fleet, records)) {
+        return false;
+    }
+    if (reader.remaining() != MachineCore::CHECKPOINT_BYTES * records) {
+        return false;
+    }
+
+    CheckpointReader check = reader;
+    CompactMachineHot scratchHot;
+    CompactMachineCold scratchCold;
+    for (uint32_t i = 0; i < records; i++) {
+        if (!decodeState(check, scratchHot, scratchCold)) {
+            return false;
+        }
+    }
+
+    resize(records);
+    pending.clear();
+    deadlines.clear();
+    for (size_t id = 0; id < count; id++) {
+        CompactMachineHot& m = hot[id];
+        CompactMachineCold& c = cold[id];
+        decodeState(reader, m, c);
+        c.phaseStart = clock;
+        c.planModeIndex = CompactMachineCold::NO_PLAN;
+        c.deadlineGeneration++;
+        c.effective = Fidelity::Full;
+    }
+    rebuildActive();
+    return true;
+}
@@ -1,12 +1,12 @@
 #include "ConfigManager.hpp"
+#include "WashModeCatalog.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
 
-ConfigManager::ConfigManager() {
-    loadDefaultConfig();
-}
+ConfigManager::ConfigManager()
+    : modes(BUILTIN_WASH_MODES.data()), modeCount(BUILTIN_WASH_MODES.size()) {}
 
 bool ConfigManager::parseJsonFile(const std::string& path) {
     std::ifstream file(path);
@@ -19,7 +19,9 @@ bool ConfigManager::parseJsonFile(const std::string& path) {
     std::string content = buffer.str();
     file.close();
 
-    modes.clear();
+    std::vector<WashMode> parsed;
+    std::string names;
+    std::vector<size_t> nameEnds;
 
     size_t pos = 0;
     while ((pos = content.find("\"name\"", pos)) != std::string::npos) {
@@ -27,7 +29,8 @@ bool ConfigManager::parseJsonFile(const std::string& path) {
 
         size_t nameStart = content.find("\"", pos + 6) + 1;
         size_t nameEnd = content.find("\"", nameStart);
-        mode.name = content.substr(nameStart, nameEnd - nameStart);
+        names.append(content, nameStart, nameEnd - nameStart);
+        nameEnds.push_back(names.size());
 
         size_t durationPos = content.find("\"duration_minutes\"", pos);
         if (durationPos != std::string::npos) {
@@ -61,11 +64,25 @@ bool ConfigManager::parseJsonFile(const std::string& path) {
             mode.temperatureCelsius = std::stoi(value);
         }
 
-        modes.push_back(mode);
+        parsed.push_back(mode);
         pos = nameEnd;
     }
 
-    return !modes.empty();
+    if (parsed.empty()) {
+        return false;
+    }
+
+    // Names are pointed at only once their buffer has stopped growing.
+    loaded = std::move(parsed);
+    loadedNames = std::move(names);
+    size_t nameStart = 0;
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        loaded[i].name = std::string_view(loadedNames).substr(nameStart, nameEnds[i] - nameStart);
+        nameStart = nameEnds[i];
+    }
+    modes = loaded.data();
+    modeCount = loaded.size();
+    return true;
 }
 
 bool ConfigManager::loadConfig(const std::string& path) {
@@ -78,38 +95,53 @@ bool ConfigManager::loadConfig(const std::string& path) {
 }
 
 void ConfigManager::loadDefaultConfig() {
-    modes.clear();
-    modes.push_back(WashMode("Quick Wash", 15, 800, 20.0f, 30));
-    modes.push_back(WashMode("Normal", 45, 1000, 35.0f, 40));
-    modes.push_back(WashMode("Heavy", 60, 1200, 45.0f, 60));
-    modes.push_back(WashMode("Delicate", 30, 400, 30.0f, 30));
+    modes = BUILTIN_WASH_MODES.data();
+    modeCount = BUILTIN_WASH_MODES.size();
+    loaded = std::vector<WashMode>();
+    loadedNames = std::string();
 }
 
 const WashMode& ConfigManager::getMode(int index) const {
-    if (index < 0 || index >= static_cast<int>(modes.size())) {
+    if (index < 0 || index >= static_cast<int>(modeCount)) {
         return modes[0];
     }
     return modes[index];
 }
 
 int ConfigManager::getModeCount() const {
-    return static_cast<int>(modes.size());
+    return static_cast<int>(modeCount);
 }
 
-const std::vector<WashMode>& ConfigManager::getAllModes() const {
-    return modes;
+WashModeList ConfigManager::getAllModes() const {
+    return WashModeList(modes, modeCount);
+}
+
+bool ConfigManager::isBuiltin() const {
+    return modes == BUILTIN_WASH_MODES.data();
+}
+
+size_t ConfigManager::getHeapBytes() const {
+    size_t bytes = loaded.capacity() * sizeof(WashMode);
+    if (loadedNames.capacity() >= sizeof(std::string)) {
+        bytes += loadedNames.capacity() + 1;
+    }
+    return bytes;
 }
 
 void ConfigManager::printModes() const {
-    std::cout << "\nAvailable Wash Modes:\n";
-    std::cout << "---------------------\n";
-    for (int i = 0; i < static_cast<int>(modes.size()); ++i) {
+    printModes(std::cout);
+}
+
+void ConfigManager::printModes(std::ostream& out) const {
+    out << "\nAvailable Wash Modes:\n";
+    out << "---------------------\n";
+    for (int i = 0; i < static_cast<int>(modeCount); ++i) {
         const auto& mode = modes[i];
-        std::cout << "  " << (i + 1) << ". " << mode.name << "\n";
-        std::cout << "     Duration: " << mode.durationMinutes << " min\n";
-        std::cout << "     Spin: " << mode.spinSpeedRPM << " RPM\n";
-        std::cout << "     Water: " << mode.waterLevelLiters << " L\n";
-        std::cout << "     Temp: " << mode.temperatureCelsius << " C\n";
+        out << "  " << (i + 1) << ". " << mode.name << "\n";
+        out << "     Duration: " << mode.durationMinutes << " min\n";
+        out << "     Spin: " << mode.spinSpeedRPM << " RPM\n";
+        out << "     Water: " << mode.waterLevelLiters << " L\n";
+        out << "     Temp: " << mode.temperatureCelsius << " C\n";
     }
-    std::cout << std::endl;
+    out << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "ControlClient.hpp"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ControlClient::ControlClient() : fd(-1), incomingStart(0) {}
+
+ControlClient::~ControlClient() {
+    close();
+}
+
+bool ControlClient::connect(const std::string& path) {
+    sockaddr_un address{};
+    if (fd >= 0 || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ControlClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    outgoing.clear();
+    incoming.clear();
+    incomingStart = 0;
+}
+
+bool ControlClient::isConnected() const {
+    return fd >= 0;
+}
+
+int ControlClient::getFd() const {
+    return fd;
+}
+
+void ControlClient::queue(const ControlRequest& request) {
+    encodeRequest(outgoing, request);
+}
+
+bool ControlClient::flush() {
+    size_t offset = 0;
+    while (offset < outgoing.size()) {
+        ssize_t sent = send(fd, outgoing.data() + offset, outgoing.size() - offset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += static_cast<size_t>(sent);
+    }
+    outgoing.clear();
+    return true;
+}
+
+bool ControlClient::receive(ControlResponse& response) {
+    while (true) {
+        long frame = frameSize(incoming.data() + incomingStart, incoming.size() - incomingStart);
+        if (frame < 0) {
+            return false;
+        }
+        if (frame > 0) {
+            const uint8_t* payload = incoming.data() + incomingStart + CONTROL_LENGTH_SIZE;
+            bool decoded = decodeResponse(payload, static_cast<size_t>(frame) - CONTROL_LENGTH_SIZE, response);
+            incomingStart += static_cast<size_t>(frame);
+            return decoded;
+        }
+
+        if (incomingStart > 0) {
+            incoming.erase(incoming.begin(), incoming.begin() + static_cast<long>(incomingStart));
+            incomingStart = 0;
+        }
+        size_t used = incoming.size();
+        incoming.resize(used + 64 * 1024);
+        ssize_t count = read(fd, incoming.data() + used, 64 * 1024);
+        if (count < 0 && errno == EINTR) {
+            incoming.resize(used);
+            continue;
+        }
+        if (count <= 0) {
+            incoming.resize(used);
+            return false;
+        }
+        incoming.resize(used + static_cast<size_t>(count));
+    }
+}
+
+bool ControlClient::call(const ControlRequest& request, ControlResponse& response) {
+    queue(request);
+    if (!flush()) {
+        return false;
+    }
+    while (receive(response)) {
+        if (response.kind != ControlFrameKind::StatusBatch && response.seq == request.seq) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
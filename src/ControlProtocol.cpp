@@ -0,0 +1,174 @@
+#include "ControlProtocol.hpp"
+#include <cstring>
+
+namespace {
+
+template<typename T>
+void put(std::vector<uint8_t>& out, T value) {
+    size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+T get(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void putHeader(std::vector<uint8_t>& out, uint32_t payloadSize, ControlFrameKind kind, uint32_t seq) {
+    put<uint32_t>(out, payloadSize);
+    put<uint8_t>(out, static_cast<uint8_t>(kind));
+    put<uint32_t>(out, seq);
+}
+
+constexpr size_t RESPONSE_HEADER_SIZE = 5;
+constexpr size_t BATCH_HEADER_SIZE = RESPONSE_HEADER_SIZE + 8;
+static_assert(BATCH_HEADER_SIZE == CONTROL_BATCH_HEADER_SIZE, "batch header layout");
+
+}
+
+int ControlRequest::intArg() const {
+    return static_cast<int32_t>(arg);
+}
+
+float ControlRequest::floatArg() const {
+    float value;
+    std::memcpy(&value, &arg, sizeof(value));
+    return value;
+}
+
+StatusRecord makeStatusRecord(uint32_t machineId, const SystemStatus& status) {
+    StatusRecord record;
+    record.machineId = machineId;
+    record.state = static_cast<uint8_t>(status.state);
+    record.door = static_cast<uint8_t>(status.doorStatus);
+    record.mode = static_cast<uint8_t>(status.modeIndex);
+    record.fault = static_cast<uint8_t>(status.fault);
+    record.waterLevel = status.waterLevel;
+    record.targetWaterLevel = status.targetWaterLevel;
+    record.loadKg = status.loadKg;
+    record.progressPercent = status.progressPercent;
+    record.motorRPM = status.motorRPM;
+    record.remainingSeconds = status.remainingSeconds;
+    return record;
+}
+
+ControlRequest makeRequest(ControlOp op, uint32_t seq, uint32_t machineId, uint32_t arg) {
+    return ControlRequest{op, seq, machineId, arg};
+}
+
+ControlRequest makeRequest(ControlOp op, uint32_t seq, uint32_t machineId, float arg) {
+    uint32_t bits;
+    std::memcpy(&bits, &arg, sizeof(bits));
+    return ControlRequest{op, seq, machineId, bits};
+}
+
+void encodeRequest(std::vector<uint8_t>& out, const ControlRequest& request) {
+    put<uint32_t>(out, CONTROL_REQUEST_SIZE);
+    put<uint8_t>(out, static_cast<uint8_t>(request.op));
+    put<uint32_t>(out, request.seq);
+    put<uint32_t>(out, request.machineId);
+    put<uint32_t>(out, request.arg);
+}
+
+void encodeAck(std::vector<uint8_t>& out, uint32_t seq, ControlResult result, State state) {
+    putHeader(out, RESPONSE_HEADER_SIZE + 2, ControlFrameKind::Ack, seq);
+    put<uint8_t>(out, static_cast<uint8_t>(result));
+    put<uint8_t>(out, static_cast<uint8_t>(state));
+}
+
+void encodeStatus(std::vector<uint8_t>& out, uint32_t seq, ControlResult result, const StatusRecord& record) {
+    putHeader(out, RESPONSE_HEADER_SIZE + 1 + sizeof(StatusRecord), ControlFrameKind::Status, seq);
+    put<uint8_t>(out, static_cast<uint8_t>(result));
+    put(out, record);
+}
+
+size_t beginStatusBatch(std::vector<uint8_t>& out, uint32_t seq, uint32_t tick) {
+    size_t start = out.size();
+    putHeader(out, 0, ControlFrameKind::StatusBatch, seq);
+    put<uint32_t>(out, tick);
+    put<uint32_t>(out, 0);
+    return start;
+}
+
+void endStatusBatch(std::vector<uint8_t>& out, size_t start, uint32_t count) {
+    uint32_t payloadSize = static_cast<uint32_t>(out.size() - start - CONTROL_LENGTH_SIZE);
+    std::memcpy(out.data() + start, &payloadSize, sizeof(payloadSize));
+    std::memcpy(out.data() + start + CONTROL_LENGTH_SIZE + BATCH_HEADER_SIZE - sizeof(uint32_t),
+                &count, sizeof(count));
+}
+
+void appendStatusRecord(std::vector<uint8_t>& out, const StatusRecord& record) {
+    put(out, record);
+}
+
+long frameSize(const uint8_t* data, size_t size) {
+    if (size < CONTROL_LENGTH_SIZE) {
+        return 0;
+    }
+    uint32_t payloadSize = get<uint32_t>(data);
+    if (payloadSize == 0 || payloadSize > CONTROL_MAX_FRAME) {
+        return -1;
+    }
+    size_t total = CONTROL_LENGTH_SIZE + payloadSize;
+    return size < total ? 0 : static_cast<long>(total);
+}
+
+bool decodeRequest(const uint8_t* payload, size_t size, ControlRequest& request) {
+    if (size < CONTROL_REQUEST_SIZE) {
+        return false;
+    }
+    request.op = static_cast<ControlOp>(payload[0]);
+    request.seq = get<uint32_t>(payload + 1);
+    request.machineId = get<uint32_t>(payload + 5);
+    request.arg = get<uint32_t>(payload + 9);
+    return true;
+}
+
+bool decodeResponse(const uint8_t* payload, size_t size, ControlResponse& response) {
+    if (size < RESPONSE_HEADER_SIZE) {
+        return false;
+    }
+    response.kind = static_cast<ControlFrameKind>(payload[0]);
+    response.seq = get<uint32_t>(payload + 1);
+    response.result = ControlResult::Ok;
+    response.state = State::Idle;
+    response.tick = 0;
+    response.records.clear();
+
+    const uint8_t* body = payload + RESPONSE_HEADER_SIZE;
+    size_t bodySize = size - RESPONSE_HEADER_SIZE;
+    switch (response.kind) {
+        case ControlFrameKind::Ack:
+            if (bodySize < 2) {
+                return false;
+            }
+            response.result = static_cast<ControlResult>(body[0]);
+            response.state = static_cast<State>(body[1]);
+            return true;
+        case ControlFrameKind::Status:
+            if (bodySize < 1 + sizeof(StatusRecord)) {
+                return false;
+            }
+            response.result = static_cast<ControlResult>(body[0]);
+            response.records.push_back(get<StatusRecord>(body + 1));
+            response.state = static_cast<State>(response.records[0].state);
+            return true;
+        case ControlFrameKind::StatusBatch: {
+            if (bodySize < 8) {
+                return false;
+            }
+            response.tick = get<uint32_t>(body);
+            uint32_t count = get<uint32_t>(body + 4);
+            if ((bodySize - 8) / sizeof(StatusRecord) < count) {
+                return false;
+            }
+            response.records.resize(count);
+            std::memcpy(response.records.data(), body + 8, count * sizeof(StatusRecord));
+            return true;
+        }
+    }
+    return false;
+}
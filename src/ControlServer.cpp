@@ -0,0 +1,324 @@
+#include "ControlServer.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+ControlServer::ControlServer(Reactor& reactor, WashingMachine& machine)
+    : reactor(reactor),
+      fleet(nullptr),
+      machine(&machine),
+      listenFd(-1),
+      tickCount(0),
+      requestCount(0) {}
+
+ControlServer::ControlServer(Reactor& reactor, Fleet& fleet)
+    : reactor(reactor),
+      fleet(&fleet),
+      machine(nullptr),
+      listenFd(-1),
+      tickCount(0),
+      requestCount(0) {}
+
+ControlServer::~ControlServer() {
+    close();
+}
+
+bool ControlServer::listen(const std::string& path) {
+    sockaddr_un address{};
+    if (listenFd >= 0 || path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0 ||
+        !reactor.add(fd, EPOLLIN, [this](uint32_t) { onAccept(); })) {
+        ::close(fd);
+        return false;
+    }
+
+    listenFd = fd;
+    socketPath = path;
+    return true;
+}
+
+void ControlServer::close() {
+    while (!clients.empty()) {
+        closeClient(clients.begin()->first);
+    }
+    if (listenFd >= 0) {
+        reactor.remove(listenFd);
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+        listenFd = -1;
+    }
+}
+
+size_t ControlServer::machineCount() const {
+    return fleet ? fleet->size() : 1;
+}
+
+WashingMachine* ControlServer::machineFor(uint32_t id) {
+    if (id >= machineCount()) {
+        return nullptr;
+    }
+    return fleet ? &fleet->getMachine(id) : machine;
+}
+
+size_t ControlServer::getClientCount() const {
+    return clients.size();
+}
+
+uint64_t ControlServer::getRequestCount() const {
+    return requestCount;
+}
+
+void ControlServer::onAccept() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        auto client = std::make_unique<Client>();
+        client->fd = fd;
+        client->outputStart = 0;
+        client->throttled = false;
+        client->interest = EPOLLIN;
+        if (!reactor.add(fd, EPOLLIN, [this, fd](uint32_t events) { onClient(fd, events); })) {
+            ::close(fd);
+            continue;
+        }
+        clients[fd] = std::move(client);
+    }
+}
+
+void ControlServer::onClient(int fd, uint32_t events) {
+    auto it = clients.find(fd);
+    if (it == clients.end()) {
+        return;
+    }
+    Client& client = *it->second;
+
+    if (events & EPOLLERR) {
+        closeClient(fd);
+        return;
+    }
+    if ((events & EPOLLOUT) && !flush(client)) {
+        closeClient(fd);
+        return;
+    }
+    if ((events & (EPOLLIN | EPOLLHUP)) && !client.throttled) {
+        if (!readInput(client) || !parseInput(client) || !flush(client)) {
+            closeClient(fd);
+            return;
+        }
+    }
+    updateInterest(client);
+}
+
+bool ControlServer::readInput(Client& client) {
+    size_t used = client.input.size();
+    client.input.resize(used + READ_CHUNK);
+    ssize_t count = read(client.fd, client.input.data() + used, READ_CHUNK);
+    if (count <= 0) {
+        client.input.resize(used);
+        return count < 0 && (errno == EAGAIN || errno == EINTR);
+    }
+    client.input.resize(used + static_cast<size_t>(count));
+    return true;
+}
+
+// A malformed length closes the connection, since framing cannot recover.
+// A well-framed but undecodable request is answered with Malformed.
+bool ControlServer::parseInput(Client& client) {
+    const uint8_t* data = client.input.data();
+    size_t size = client.input.size();
+    size_t offset = 0;
+
+    while (offset < size) {
+        long frame = frameSize(data + offset, size - offset);
+        if (frame < 0) {
+            return false;
+        }
+        if (frame == 0) {
+            break;
+        }
+
+        ControlRequest request;
+        const uint8_t* payload = data + offset + CONTROL_LENGTH_SIZE;
+        size_t payloadSize = static_cast<size_t>(frame) - CONTROL_LENGTH_SIZE;
+        if (decodeRequest(payload, payloadSize, request)) {
+            handleRequest(client, request);
+        } else {
+            uint32_t seq = 0;
+            if (payloadSize >= 5) {
+                std::memcpy(&seq, payload + 1, sizeof(seq));
+            }
+            encodeAck(client.output, seq, ControlResult::Malformed, State::Idle);
+        }
+        offset += static_cast<size_t>(frame);
+    }
+
+    client.input.erase(client.input.begin(), client.input.begin() + static_cast<long>(offset));
+    return true;
+}
+
+void ControlServer::handleRequest(Client& client, const ControlRequest& request) {
+    requestCount++;
+
+    switch (request.op) {
+        case ControlOp::Ping:
+            encodeAck(client.output, request.seq, ControlResult::Ok, State::Idle);
+            return;
+        case ControlOp::Subscribe: {
+            size_t total = machineCount();
+            if (request.machineId >= total) {
+                encodeAck(client.output, request.seq, ControlResult::UnknownMachine, State::Idle);
+                return;
+            }
+            size_t available = total - request.machineId;
+            size_t count = request.arg == 0 ? available : std::min<size_t>(request.arg, available);
+            client.subscriptions.push_back({request.seq, request.machineId, static_cast<uint32_t>(count)});
+            encodeAck(client.output, request.seq, ControlResult::Ok, State::Idle);
+            return;
+        }
+        case ControlOp::Unsubscribe: {
+            auto& subscriptions = client.subscriptions;
+            subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                               [&](const Subscription& s) { return s.seq == request.arg; }),
+                                subscriptions.end());
+            encodeAck(client.output, request.seq, ControlResult::Ok, State::Idle);
+            return;
+        }
+        default:
+            break;
+    }
+
+    if (static_cast<size_t>(request.op) >= CONTROL_OP_COUNT) {
+        encodeAck(client.output, request.seq, ControlResult::UnknownOp, State::Idle);
+        return;
+    }
+
+    WashingMachine* target = machineFor(request.machineId);
+    if (!target) {
+        encodeAck(client.output, request.seq, ControlResult::UnknownMachine, State::Idle);
+        return;
+    }
+
+    switch (request.op) {
+        case ControlOp::OpenDoor: target->openDoor(); break;
+        case ControlOp::CloseDoor: target->closeDoor(); break;
+        case ControlOp::SelectMode: target->selectMode(request.intArg()); break;
+        case ControlOp::SetLoad: target->setLoad(request.floatArg()); break;
+        case ControlOp::Start: target->start(); break;
+        case ControlOp::Pause: target->pause(); break;
+        case ControlOp::Resume: target->resume(); break;
+        case ControlOp::Stop: target->stop(); break;
+        case ControlOp::EmergencyStop: target->emergencyStop(); break;
+        case ControlOp::ClearFault: target->clearFault(); break;
+        case ControlOp::GetStatus:
+            encodeStatus(client.output, request.seq, ControlResult::Ok,
+                         makeStatusRecord(request.machineId, target->getStatus()));
+            return;
+        default:
+            break;
+    }
+
+    target->processEvents();
+    encodeAck(client.output, request.seq, ControlResult::Ok, target->getCurrentState());
+}
+
+// Returns false only on a hard socket error. Anything the kernel does not
+// take now stays queued for EPOLLOUT.
+bool ControlServer::flush(Client& client) {
+    while (client.outputStart < client.output.size()) {
+        ssize_t sent = send(client.fd, client.output.data() + client.outputStart,
+                            client.output.size() - client.outputStart, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN;
+        }
+        client.outputStart += static_cast<size_t>(sent);
+    }
+    client.output.clear();
+    client.outputStart = 0;
+    return true;
+}
+
+void ControlServer::updateInterest(Client& client) {
+    size_t backlog = client.output.size() - client.outputStart;
+    bool throttled = backlog > OUTPUT_BACKLOG_LIMIT;
+    uint32_t events = throttled ? 0u : static_cast<uint32_t>(EPOLLIN);
+    if (backlog > 0) {
+        events |= EPOLLOUT;
+    }
+    client.throttled = throttled;
+    if (events != client.interest) {
+        reactor.modify(client.fd, events);
+        client.interest = events;
+    }
+}
+
+void ControlServer::closeClient(int fd) {
+    reactor.remove(fd);
+    ::close(fd);
+    clients.erase(fd);
+}
+
+// Slow subscribers that are already over the backlog limit skip the batch
+// rather than queueing it; the next tick's batch supersedes it anyway. A
+// subscription too large for one frame goes out as several batches.
+void ControlServer::publishStatus() {
+    tickCount++;
+
+    std::vector<int> failed;
+    for (auto& entry : clients) {
+        Client& client = *entry.second;
+        if (client.subscriptions.empty() || client.throttled) {
+            continue;
+        }
+        for (const Subscription& subscription : client.subscriptions) {
+            uint32_t end = std::min<uint32_t>(subscription.first + subscription.count,
+                                              static_cast<uint32_t>(machineCount()));
+            uint32_t id = subscription.first;
+            do {
+                uint32_t chunkEnd = std::min<uint32_t>(end, id + static_cast<uint32_t>(CONTROL_MAX_BATCH_RECORDS));
+                size_t start = beginStatusBatch(client.output, subscription.seq, tickCount);
+                uint32_t written = 0;
+                for (; id < chunkEnd; id++) {
+                    appendStatusRecord(client.output, makeStatusRecord(id, machineFor(id)->getStatus()));
+                    written++;
+                }
+                endStatusBatch(client.output, start, written);
+            } while (id < end);
+        }
+        if (!flush(client)) {
+            failed.push_back(entry.first);
+            continue;
+        }
+        updateInterest(client);
+    }
+
+    for (int fd : failed) {
+        closeClient(fd);
+    }
+}
+
+#endif
@@ -62,6 +62,22 @@ std::string DoorSystem::getStatusString() const {
     return doorStatusToString(getStatus());
 }
 
+void DoorSystem::saveState(CheckpointWriter& writer) const {
+    writer.write<uint8_t>(open ? 1 : 0);
+    writer.write<uint8_t>(locked ? 1 : 0);
+}
+
+bool DoorSystem::restoreState(CheckpointReader& reader) {
+    uint8_t isOpenFlag = 0;
+    uint8_t isLockedFlag = 0;
+    if (!reader.read(isOpenFlag) || !reader.read(isLockedFlag)) {
+        return false;
+    }
+    open = isOpenFlag != 0;
+    locked = isLockedFlag != 0;
+    return true;
+}
+
 void DoorSystem::reset() {
     open = true;
     locked = false;
@@ -1,6 +1,26 @@
 #include "EventEngine.hpp"
 
-EventEngine::EventEngine() : running(false), eventHandler(nullptr) {}
+EventEngine::EventEngine()
+    : EventEngine({DEFAULT_SAFETY_CAPACITY, DEFAULT_COMMAND_CAPACITY,
+                   DEFAULT_SYSTEM_CAPACITY, DEFAULT_TELEMETRY_CAPACITY}) {}
+
+EventEngine::EventEngine(const std::array<size_t, EVENT_PRIORITY_COUNT>& laneCapacities)
+    : waiters(0), spaceWaiters(0), running(false), consumerThread(std::thread::id()), eventHandler(nullptr) {
+    for (size_t i = 0; i < EVENT_PRIORITY_COUNT; ++i) {
+        lanes[i].queue = std::make_unique<BoundedQueue<Event>>(laneCapacities[i]);
+        lanes[i].spill = std::make_unique<BoundedQueue<Event>>(laneCapacities[i]);
+    }
+    lanes[static_cast<size_t>(EventPriority::Safety)].overflow = std::make_unique<std::deque<Event>>();
+    lanes[static_cast<size_t>(EventPriority::Safety)].policy = OverflowPolicy::Block;
+    lanes[static_cast<size_t>(EventPriority::Command)].policy = OverflowPolicy::Reject;
+    lanes[static_cast<size_t>(EventPriority::System)].policy = OverflowPolicy::Block;
+    lanes[static_cast<size_t>(EventPriority::Telemetry)].policy = OverflowPolicy::DropOldest;
+
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i) {
+        coalesceEnabled[i].store(false, std::memory_order_relaxed);
+        coalescePending[i].store(false, std::memory_order_relaxed);
+    }
+}
 
 EventEngine::~EventEngine() {
     stop();
@@ -10,61 +30,332 @@ void EventEngine::setEventHandler(std::function<void(const Event&)> handler) {
     eventHandler = handler;
 }
 
-void EventEngine::pushEvent(const Event& event) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    eventQueue.push(event);
-    cv.notify_one();
+// Called after every successful push, on the pushing thread. Install it
+// before producers start; it lets an external loop (e.g. epoll on an eventfd)
+// wait for events instead of polling.
+void EventEngine::setWakeHandler(std::function<void()> handler) {
+    wakeHandler = handler;
 }
 
-void EventEngine::pushEvent(EventType type) {
-    pushEvent(Event(type));
+void EventEngine::notifyWaiters() {
+    if (wakeHandler) {
+        wakeHandler();
+    }
+    if (waiters.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        cv.notify_one();
+    }
 }
 
-void EventEngine::pushEvent(EventType type, int data) {
-    pushEvent(Event(type, data));
+void EventEngine::notifySpaceWaiters() {
+    if (spaceWaiters.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(spaceMutex);
+        spaceCv.notify_all();
+    }
 }
 
-void EventEngine::pushEvent(EventType type, float data) {
-    pushEvent(Event(type, data));
+// Once anything is in the overflow, spilled events queue behind it too.
+bool EventEngine::spillEvent(Lane& lane, const Event& event) {
+    bool overflowing = lane.overflowCount.load(std::memory_order_acquire) > 0;
+    if (overflowing || !lane.spill->tryPush(event)) {
+        if (!lane.overflow) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(lane.overflowMutex);
+        lane.overflow->push_back(event);
+        lane.overflowCount.fetch_add(1, std::memory_order_release);
+    }
+    lane.spillCount.fetch_add(1, std::memory_order_release);
+    lane.spilled.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-std::optional<Event> EventEngine::popEvent() {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    if (eventQueue.empty()) {
-        return std::nullopt;
+// The queue is drained before the spill, so while anything is spilled every
+// push goes behind it; otherwise a newer event could overtake it.
+bool EventEngine::tryPushInOrder(Lane& lane, const Event& event) {
+    if (lane.spillCount.load(std::memory_order_acquire) > 0) {
+        return spillEvent(lane, event);
+    }
+    return lane.queue->tryPush(event);
+}
+
+// The oldest event is in the queue, then the spill, then the overflow.
+std::optional<Event> EventEngine::popOldest(Lane& lane) {
+    std::optional<Event> event = lane.queue->tryPop();
+    if (event || lane.spillCount.load(std::memory_order_acquire) == 0) {
+        return event;
+    }
+    event = lane.spill->tryPop();
+    if (!event && lane.overflowCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(lane.overflowMutex);
+        if (!lane.overflow->empty()) {
+            event = lane.overflow->front();
+            lane.overflow->pop_front();
+            lane.overflowCount.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    if (event) {
+        lane.spillCount.fetch_sub(1, std::memory_order_release);
     }
-    Event event = eventQueue.front();
-    eventQueue.pop();
     return event;
 }
 
+// Block drops nothing. Waiting is only safe when some other thread is
+// draining the lane; a push from the consumer itself (a subsystem callback
+// fired inside processEvents), before anyone consumes, or after the engine
+// stopped goes to the lane's spill instead so it cannot deadlock. The spill
+// is bounded, so on the System lane such a push is rejected once it is full.
+// The Safety lane's overflow takes the rest: its pushes are never rejected,
+// and memory grows instead while the consumer is not draining it.
+bool EventEngine::blockUntilPushed(Lane& lane, const Event& event) {
+    std::thread::id consumer = consumerThread.load(std::memory_order_acquire);
+    if (consumer == std::this_thread::get_id() || consumer == std::thread::id() || !running) {
+        return spillEvent(lane, event);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    lane.blocked.fetch_add(1, std::memory_order_relaxed);
+    bool pushed = true;
+    spaceWaiters.fetch_add(1, std::memory_order_seq_cst);
+    {
+        // The timeout only covers a pop that raced the waiter count.
+        std::unique_lock<std::mutex> lock(spaceMutex);
+        while (!tryPushInOrder(lane, event)) {
+            if (!running) {
+                pushed = spillEvent(lane, event);
+                break;
+            }
+            spaceCv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+    spaceWaiters.fetch_sub(1, std::memory_order_seq_cst);
+    auto waited = std::chrono::steady_clock::now() - begin;
+    lane.blockedNanos.fetch_add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()),
+        std::memory_order_relaxed);
+    return pushed;
+}
+
+PushResult EventEngine::enqueue(Lane& lane, const Event& event) {
+    if (tryPushInOrder(lane, event)) {
+        return PushResult::Accepted;
+    }
+
+    switch (lane.policy.load(std::memory_order_relaxed)) {
+        case OverflowPolicy::Block:
+            if (blockUntilPushed(lane, event)) {
+                return PushResult::Accepted;
+            }
+            lane.rejected.fetch_add(1, std::memory_order_relaxed);
+            return PushResult::Rejected;
+
+        case OverflowPolicy::DropOldest:
+            while (!tryPushInOrder(lane, event)) {
+                if (std::optional<Event> evicted = popOldest(lane)) {
+                    lane.depth.fetch_sub(1, std::memory_order_relaxed);
+                    lane.dropped.fetch_add(1, std::memory_order_relaxed);
+                    coalescePending[static_cast<size_t>(evicted->getType())].store(false, std::memory_order_release);
+                }
+            }
+            return PushResult::DroppedOldest;
+
+        case OverflowPolicy::DropNewest:
+            lane.dropped.fetch_add(1, std::memory_order_relaxed);
+            return PushResult::DroppedNewest;
+
+        case OverflowPolicy::Reject:
+        default:
+            lane.rejected.fetch_add(1, std::memory_order_relaxed);
+            return PushResult::Rejected;
+    }
+}
+
+PushResult EventEngine::pushEvent(const Event& event) {
+    size_t typeIndex = static_cast<size_t>(event.getType());
+    Lane& lane = lanes[static_cast<size_t>(eventPriority(event.getType()))];
+
+    bool coalescing = coalesceEnabled[typeIndex].load(std::memory_order_relaxed) && !event.hasData();
+    if (coalescing && coalescePending[typeIndex].exchange(true, std::memory_order_acq_rel)) {
+        lane.coalesced.fetch_add(1, std::memory_order_relaxed);
+        return PushResult::Coalesced;
+    }
+
+    lane.depth.fetch_add(1, std::memory_order_seq_cst);
+    PushResult result = enqueue(lane, event);
+
+    if (result == PushResult::DroppedNewest || result == PushResult::Rejected) {
+        lane.depth.fetch_sub(1, std::memory_order_relaxed);
+        if (coalescing) {
+            coalescePending[typeIndex].store(false, std::memory_order_release);
+        }
+        return result;
+    }
+
+    lane.pushed.fetch_add(1, std::memory_order_relaxed);
+    notifyWaiters();
+    return result;
+}
+
+PushResult EventEngine::pushEvent(EventType type) {
+    return pushEvent(Event(type));
+}
+
+PushResult EventEngine::pushEvent(EventType type, int data) {
+    return pushEvent(Event(type, data));
+}
+
+PushResult EventEngine::pushEvent(EventType type, float data) {
+    return pushEvent(Event(type, data));
+}
+
+void EventEngine::recordPop(Lane& lane, const Event& event) {
+    lane.depth.fetch_sub(1, std::memory_order_relaxed);
+    lane.popped.fetch_add(1, std::memory_order_relaxed);
+
+    coalescePending[static_cast<size_t>(event.getType())].store(false, std::memory_order_release);
+
+    auto waited = std::chrono::steady_clock::now() - event.getTimestamp();
+    uint64_t nanos = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+    lane.totalWaitNanos.fetch_add(nanos, std::memory_order_relaxed);
+    if (nanos > lane.maxWaitNanos.load(std::memory_order_relaxed)) {
+        lane.maxWaitNanos.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+std::optional<Event> EventEngine::popFromLanes() {
+    consumerThread.store(std::this_thread::get_id(), std::memory_order_release);
+
+    for (auto& lane : lanes) {
+        if (lane.depth.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        std::optional<Event> event = popOldest(lane);
+        if (event) {
+            recordPop(lane, *event);
+            notifySpaceWaiters();
+            return event;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Event> EventEngine::popEvent() {
+    return popFromLanes();
+}
+
 std::optional<Event> EventEngine::waitForEvent() {
-    std::unique_lock<std::mutex> lock(queueMutex);
-    cv.wait(lock, [this] { return !eventQueue.empty() || !running; });
+    std::optional<Event> event = popFromLanes();
+    if (event) {
+        return event;
+    }
 
-    if (!running && eventQueue.empty()) {
-        return std::nullopt;
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(waitMutex);
+        cv.wait(lock, [this] { return hasEvents() || !running; });
     }
+    waiters.fetch_sub(1, std::memory_order_seq_cst);
 
-    Event event = eventQueue.front();
-    eventQueue.pop();
-    return event;
+    while (hasEvents()) {
+        event = popFromLanes();
+        if (event) {
+            return event;
+        }
+    }
+    return std::nullopt;
 }
 
 bool EventEngine::hasEvents() const {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    return !eventQueue.empty();
+    for (const auto& lane : lanes) {
+        if (lane.depth.load(std::memory_order_seq_cst) > 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
 size_t EventEngine::getQueueSize() const {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    return eventQueue.size();
+    size_t total = 0;
+    for (const auto& lane : lanes) {
+        total += lane.depth.load(std::memory_order_relaxed);
+    }
+    return total;
 }
 
 void EventEngine::clear() {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    while (!eventQueue.empty()) {
-        eventQueue.pop();
+    for (auto& lane : lanes) {
+        while (auto event = popOldest(lane)) {
+            lane.depth.fetch_sub(1, std::memory_order_relaxed);
+            coalescePending[static_cast<size_t>(event->getType())].store(false, std::memory_order_release);
+        }
+    }
+    notifySpaceWaiters();
+}
+
+void EventEngine::setCoalescing(EventType type, bool enabled) {
+    coalesceEnabled[static_cast<size_t>(type)].store(enabled, std::memory_order_relaxed);
+}
+
+bool EventEngine::isCoalescing(EventType type) const {
+    return coalesceEnabled[static_cast<size_t>(type)].load(std::memory_order_relaxed);
+}
+
+bool EventEngine::setOverflowPolicy(EventPriority priority, OverflowPolicy policy) {
+    if (priority == EventPriority::Safety && policy != OverflowPolicy::Block) {
+        return false;
+    }
+    lanes[static_cast<size_t>(priority)].policy.store(policy, std::memory_order_relaxed);
+    return true;
+}
+
+OverflowPolicy EventEngine::getOverflowPolicy(EventPriority priority) const {
+    return lanes[static_cast<size_t>(priority)].policy.load(std::memory_order_relaxed);
+}
+
+size_t EventEngine::getLaneCapacity(EventPriority priority) const {
+    return lanes[static_cast<size_t>(priority)].queue->capacity();
+}
+
+size_t EventEngine::getLaneDepth(EventPriority priority) const {
+    return lanes[static_cast<size_t>(priority)].depth.load(std::memory_order_relaxed);
+}
+
+EventLaneStats EventEngine::getLaneStats(EventPriority priority) const {
+    const Lane& lane = lanes[static_cast<size_t>(priority)];
+    EventLaneStats stats;
+    stats.depth = lane.depth.load(std::memory_order_relaxed);
+    stats.capacity = lane.queue->capacity();
+    stats.policy = lane.policy.load(std::memory_order_relaxed);
+    stats.pushed = lane.pushed.load(std::memory_order_relaxed);
+    stats.popped = lane.popped.load(std::memory_order_relaxed);
+    stats.coalesced = lane.coalesced.load(std::memory_order_relaxed);
+    stats.dropped = lane.dropped.load(std::memory_order_relaxed);
+    stats.rejected = lane.rejected.load(std::memory_order_relaxed);
+    stats.blocked = lane.blocked.load(std::memory_order_relaxed);
+    stats.spilled = lane.spilled.load(std::memory_order_relaxed);
+    stats.blockedMicros = static_cast<double>(lane.blockedNanos.load(std::memory_order_relaxed)) / 1000.0;
+
+    uint64_t total = lane.totalWaitNanos.load(std::memory_order_relaxed);
+    stats.averageWaitMicros = (stats.popped > 0)
+        ? static_cast<double>(total) / static_cast<double>(stats.popped) / 1000.0
+        : 0.0;
+    stats.maxWaitMicros = static_cast<double>(lane.maxWaitNanos.load(std::memory_order_relaxed)) / 1000.0;
+    return stats;
+}
+
+void EventEngine::resetLaneStats() {
+    for (auto& lane : lanes) {
+        lane.pushed.store(0, std::memory_order_relaxed);
+        lane.popped.store(0, std::memory_order_relaxed);
+        lane.coalesced.store(0, std::memory_order_relaxed);
+        lane.dropped.store(0, std::memory_order_relaxed);
+        lane.rejected.store(0, std::memory_order_relaxed);
+        lane.blocked.store(0, std::memory_order_relaxed);
+        lane.spilled.store(0, std::memory_order_relaxed);
+        lane.blockedNanos.store(0, std::memory_order_relaxed);
+        lane.totalWaitNanos.store(0, std::memory_order_relaxed);
+        lane.maxWaitNanos.store(0, std::memory_order_relaxed);
     }
 }
 
@@ -74,9 +365,14 @@ void EventEngine::start() {
 
 void EventEngine::stop() {
     running = false;
-    cv.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        cv.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(spaceMutex);
+    spaceCv.notify_all();
 }
 
 bool EventEngine::isRunning() const {
     return running;
-}
\ No newline at end of file
+}
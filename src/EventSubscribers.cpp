@@ -0,0 +1,59 @@
+#include "EventSubscribers.hpp"
+
+#include <algorithm>
+
+EventSubscribers::EventSubscribers() : active(0), nextId(1) {}
+
+EventSubscribers::SubscriptionId EventSubscribers::subscribe(EventType type, Handler handler) {
+    return subscribe(eventBit(type), std::move(handler));
+}
+
+EventSubscribers::SubscriptionId EventSubscribers::subscribe(EventMask types, Handler handler) {
+    types &= (EventMask(1) << EVENT_TYPE_COUNT) - 1;
+    if (types == 0 || !handler) {
+        return NO_SUBSCRIPTION;
+    }
+
+    SubscriptionId id = nextId++;
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; i++) {
+        if ((types & (EventMask(1) << i)) != 0) {
+            lists[i].push_back({id, handler});
+        }
+    }
+    active |= types;
+    return id;
+}
+
+bool EventSubscribers::unsubscribe(SubscriptionId id) {
+    bool found = false;
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; i++) {
+        auto& list = lists[i];
+        auto removed = std::remove_if(list.begin(), list.end(), [id](const Entry& entry) { return entry.id == id; });
+        if (removed == list.end()) {
+            continue;
+        }
+        list.erase(removed, list.end());
+        found = true;
+        if (list.empty()) {
+            active &= ~(EventMask(1) << i);
+        }
+    }
+    return found;
+}
+
+void EventSubscribers::clear() {
+    for (auto& list : lists) {
+        list.clear();
+    }
+    active = 0;
+}
+
+size_t EventSubscribers::getSubscriberCount(EventType type) const {
+    return lists[static_cast<size_t>(type)].size();
+}
+
+void EventSubscribers::deliver(MachineId source, const Event& event) const {
+    for (const Entry& entry : lists[static_cast<size_t>(event.getType())]) {
+        entry.handler(source, event);
+    }
+}
@@ -0,0 +1,194 @@
+#include "FaultInjector.hpp"
+#include "CounterRng.hpp"
+#include "Fleet.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace {
+
+constexpr double NEVER = std::numeric_limits<double>::infinity();
+constexpr size_t MIN_MACHINES_PER_THREAD = 4096;
+
+}
+
+FaultInjector::FaultInjector(uint64_t seedValue, size_t machineCount)
+    : seed(seedValue),
+      now(0.0),
+      defaultRates{},
+      scheduleOrder(0),
+      threadCount(1),
+      stats{} {
+    resize(machineCount);
+}
+
+void FaultInjector::drawArrival(size_t machine, size_t slot, double from) {
+    MachineFaults& faults = machines[machine];
+    double rate = faults.ratePerSecond[slot];
+    if (rate <= 0.0) {
+        faults.nextAt[slot] = NEVER;
+        return;
+    }
+    CounterRng rng(seed, machine, faults.draws++);
+    faults.nextAt[slot] = from + rng.nextExponential(rate);
+}
+
+void FaultInjector::initMachine(size_t machine) {
+    MachineFaults& faults = machines[machine];
+    faults.ratePerSecond = defaultRates;
+    faults.draws = 0;
+    for (size_t slot = 0; slot < INJECTABLE_FAULT_COUNT; slot++) {
+        drawArrival(machine, slot, now);
+    }
+    faults.earliest = *std::min_element(faults.nextAt.begin(), faults.nextAt.end());
+}
+
+void FaultInjector::resize(size_t machineCount) {
+    size_t previous = machines.size();
+    machines.resize(machineCount);
+    for (size_t machine = previous; machine < machineCount; machine++) {
+        initMachine(machine);
+    }
+}
+
+size_t FaultInjector::size() const {
+    return machines.size();
+}
+
+uint64_t FaultInjector::getSeed() const {
+    return seed;
+}
+
+void FaultInjector::setRate(FaultCode fault, double perHour) {
+    if (fault == FaultCode::None) {
+        return;
+    }
+    defaultRates[faultSlot(fault)] = std::max(0.0, perHour) / 3600.0;
+    for (size_t machine = 0; machine < machines.size(); machine++) {
+        setRate(machine, fault, perHour);
+    }
+}
+
+// Exponential gaps are memoryless, so redrawing from the current time gives
+// the same process as if the new rate had always applied.
+void FaultInjector::setRate(size_t machine, FaultCode fault, double perHour) {
+    if (fault == FaultCode::None || machine >= machines.size()) {
+        return;
+    }
+    MachineFaults& faults = machines[machine];
+    size_t slot = faultSlot(fault);
+    faults.ratePerSecond[slot] = std::max(0.0, perHour) / 3600.0;
+    drawArrival(machine, slot, now);
+    faults.earliest = *std::min_element(faults.nextAt.begin(), faults.nextAt.end());
+}
+
+double FaultInjector::getRate(size_t machine, FaultCode fault) const {
+    if (fault == FaultCode::None || machine >= machines.size()) {
+        return 0.0;
+    }
+    return machines[machine].ratePerSecond[faultSlot(fault)] * 3600.0;
+}
+
+void FaultInjector::schedule(size_t machine, FaultCode fault, double atSeconds) {
+    if (fault == FaultCode::None) {
+        return;
+    }
+    scheduled.push({atSeconds, scheduleOrder++, machine, fault});
+}
+
+size_t FaultInjector::getScheduledCount() const {
+    return scheduled.size();
+}
+
+void FaultInjector::setThreadCount(unsigned threads) {
+    threadCount = std::max(1u, threads);
+}
+
+double FaultInjector::getTime() const {
+    return now;
+}
+
+void FaultInjector::fireRange(size_t begin, size_t end, const FaultSink& sink, RangeCounts& counts) {
+    for (size_t machine = begin; machine < end; machine++) {
+        MachineFaults& faults = machines[machine];
+        while (faults.earliest <= now) {
+            size_t slot = static_cast<size_t>(
+                std::min_element(faults.nextAt.begin(), faults.nextAt.end()) - faults.nextAt.begin());
+            if (sink(machine, faultFromSlot(slot))) {
+                counts.injected[slot]++;
+            } else {
+                counts.rejected++;
+            }
+            drawArrival(machine, slot, faults.nextAt[slot]);
+            faults.earliest = *std::min_element(faults.nextAt.begin(), faults.nextAt.end());
+        }
+    }
+}
+
+size_t FaultInjector::advance(double deltaSeconds, const FaultSink& sink) {
+    now += std::max(0.0, deltaSeconds);
+    size_t delivered = 0;
+
+    while (!scheduled.empty() && scheduled.top().at <= now) {
+        ScheduledFault due = scheduled.top();
+        scheduled.pop();
+        delivered++;
+        if (due.machine < machines.size() && sink(due.machine, due.fault)) {
+            stats.injected[faultSlot(due.fault)]++;
+            stats.scheduled++;
+        } else {
+            stats.rejected++;
+        }
+    }
+
+    size_t count = machines.size();
+    unsigned workers = static_cast<unsigned>(
+        std::min<size_t>(threadCount, std::max<size_t>(1, count / MIN_MACHINES_PER_THREAD)));
+    std::vector<RangeCounts> counts(workers);
+    if (workers == 1) {
+        fireRange(0, count, sink, counts[0]);
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (unsigned worker = 0; worker < workers; worker++) {
+            size_t begin = count * worker / workers;
+            size_t end = count * (worker + 1) / workers;
+            pool.emplace_back([this, begin, end, &sink, &counts, worker] {
+                fireRange(begin, end, sink, counts[worker]);
+            });
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    for (const RangeCounts& range : counts) {
+        for (size_t slot = 0; slot < INJECTABLE_FAULT_COUNT; slot++) {
+            stats.injected[slot] += range.injected[slot];
+            delivered += range.injected[slot];
+        }
+        stats.rejected += range.rejected;
+        delivered += range.rejected;
+    }
+    return delivered;
+}
+
+size_t FaultInjector::advance(Fleet& fleet, double deltaSeconds) {
+    size_t fleetSize = fleet.size();
+    return advance(deltaSeconds, [&fleet, fleetSize](size_t machine, FaultCode fault) {
+        if (machine >= fleetSize) {
+            return false;
+        }
+        PushResult result = fleet.getMachine(machine).injectFault(fault);
+        return result != PushResult::Rejected && result != PushResult::DroppedNewest;
+    });
+}
+
+FaultInjectorStats FaultInjector::getStats() const {
+    return stats;
+}
+
+void FaultInjector::resetStats() {
+    stats = FaultInjectorStats{};
+}
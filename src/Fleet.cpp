@@ -0,0 +1,320 @@
+#include "Fleet.hpp"
+#include <chrono>
+#include <cstring>
+
+Fleet::Fleet()
+    : waterSupply(nullptr),
+      powerController(nullptr),
+      timingWheel(nullptr),
+      subscribers(nullptr),
+      snapshotting(false),
+      snapshotBuffer(nullptr),
+      snapshotHeader(0),
+      snapshotCount(0),
+      snapshotCapacity(0) {}
+
+Fleet::Fleet(size_t count) : Fleet() {
+    resize(count);
+}
+
+Fleet::~Fleet() {
+    finishSnapshot();
+}
+
+size_t Fleet::addMachine() {
+    finishSnapshot();
+    auto machine = std::make_unique<WashingMachine>();
+    machine->initialize();
+    machine->setOutput(nullptr);
+    machine->connectWaterSupply(waterSupply, false);
+    machine->connectPowerController(powerController);
+    machine->connectTimingWheel(timingWheel);
+    machine->connectSubscribers(subscribers, static_cast<EventSubscribers::MachineId>(machines.size()));
+    machines.push_back(std::move(machine));
+    return machines.size() - 1;
+}
+
+void Fleet::resize(size_t count) {
+    finishSnapshot();
+    if (count < machines.size()) {
+        machines.resize(count);
+        return;
+    }
+    machines.reserve(count);
+    while (machines.size() < count) {
+        addMachine();
+    }
+}
+
+size_t Fleet::size() const {
+    return machines.size();
+}
+
+// The caller may be about to change the machine.
+WashingMachine& Fleet::getMachine(size_t id) {
+    preserve(id);
+    return *machines[id];
+}
+
+const WashingMachine& Fleet::getMachine(size_t id) const {
+    return *machines[id];
+}
+
+void Fleet::connectWaterSupply(WaterSupply* supply) {
+    waterSupply = supply;
+    for (auto& machine : machines) {
+        machine->connectWaterSupply(supply, false);
+    }
+}
+
+void Fleet::connectPowerController(PowerAdmissionController* controller) {
+    powerController = controller;
+    for (auto& machine : machines) {
+        machine->connectPowerController(controller);
+    }
+}
+
+void Fleet::connectTimingWheel(TimingWheel* wheel) {
+    timingWheel = wheel;
+    for (auto& machine : machines) {
+        machine->connectTimingWheel(wheel);
+    }
+}
+
+void Fleet::connectSubscribers(EventSubscribers* eventSubscribers) {
+    subscribers = eventSubscribers;
+    for (size_t id = 0; id < machines.size(); id++) {
+        machines[id]->connectSubscribers(eventSubscribers, static_cast<EventSubscribers::MachineId>(id));
+    }
+}
+
+// Machines publish their inlet demand while ticking; the shared supply,
+// power cap and timing wheel are then resolved once for the whole fleet.
+void Fleet::tick(float deltaTime) {
+    if (snapshotting.load(std::memory_order_acquire)) {
+        for (size_t id = 0; id < machines.size(); ++id) {
+            preserve(id);
+            machines[id]->tick(deltaTime);
+        }
+    } else {
+        for (auto& machine : machines) {
+            machine->tick(deltaTime);
+        }
+    }
+    if (waterSupply) {
+        waterSupply->update(deltaTime);
+    }
+    if (powerController) {
+        powerController->update(deltaTime);
+    }
+    if (timingWheel) {
+        timingWheel->advance(deltaTime);
+    }
+}
+
+void Fleet::saveCheckpoint(std::vector<uint8_t>& buffer) const {
+    buffer.clear();
+    CheckpointWriter writer(buffer);
+    writer.writeHeader(CheckpointKind::Fleet, static_cast<uint32_t>(machines.size()));
+    if (!machines.empty()) {
+        size_t headerSize = buffer.size();
+        machines[0]->saveState(writer);
+        writer.reserve((buffer.size() - headerSize) * (machines.size() - 1));
+        for (size_t i = 1; i < machines.size(); ++i) {
+            machines[i]->saveState(writer);
+        }
+    }
+}
+
+bool Fleet::restoreCheckpoint(const std::vector<uint8_t>& buffer) {
+    CheckpointReader reader(buffer);
+    uint32_t count = 0;
+    if (!reader.readHeader(CheckpointKind::Fleet, count)) {
+        return false;
+    }
+
+    if (reader.remaining() != WashingMachine::CHECKPOINT_BYTES * count) {
+        return false;
+    }
+
+    // Every record is checked on a scratch core before the fleet is touched,
+    // so a bad one anywhere leaves the fleet as it was.
+    CheckpointReader check = reader;
+    WashingMachine::Core scratch;
+    scratch.setOutput(nullptr);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!scratch.restoreState(check)) {
+            return false;
+        }
+    }
+
+    resize(count);
+    for (auto& machine : machines) {
+        machine->restoreState(reader);
+    }
+    return true;
+}
+
+// A machine another thread is saving is waited for, since the caller is
+// about to change it.
+void Fleet::preserve(size_t id) {
+    if (!snapshotting.load(std::memory_order_acquire) || id >= snapshotCount) {
+        return;
+    }
+    std::atomic<uint8_t>& taken = snapshotTaken[id];
+    uint8_t expected = RECORD_MISSING;
+    if (!taken.compare_exchange_strong(expected, RECORD_WRITING, std::memory_order_acq_rel)) {
+        while (taken.load(std::memory_order_acquire) != RECORD_WRITTEN) {
+            std::this_thread::yield();
+        }
+        return;
+    }
+    thread_local std::vector<uint8_t> record;
+    record.clear();
+    CheckpointWriter writer(record);
+    machines[id]->saveState(writer);
+    std::memcpy(snapshotBuffer->data() + snapshotHeader + id * WashingMachine::CHECKPOINT_BYTES,
+                record.data(), record.size());
+    taken.store(RECORD_WRITTEN, std::memory_order_release);
+}
+
+void Fleet::beginSnapshot(std::vector<uint8_t>& buffer) {
+    if (snapshotBuffer == &buffer) {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        snapshotting.store(false, std::memory_order_release);
+    } else {
+        finishSnapshot();
+    }
+
+    // A buffer reused for a fleet of the same size is not cleared; every
+    // record in it will be overwritten.
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    std::vector<uint8_t> header;
+    CheckpointWriter writer(header);
+    writer.writeHeader(CheckpointKind::Fleet, static_cast<uint32_t>(machines.size()));
+    snapshotHeader = header.size();
+    snapshotCount = machines.size();
+    buffer.resize(snapshotHeader + snapshotCount * WashingMachine::CHECKPOINT_BYTES);
+    std::memcpy(buffer.data(), header.data(), snapshotHeader);
+    if (snapshotCapacity < snapshotCount) {
+        snapshotTaken.reset(new std::atomic<uint8_t>[snapshotCount]);
+        snapshotCapacity = snapshotCount;
+    }
+    for (size_t id = 0; id < snapshotCount; ++id) {
+        snapshotTaken[id].store(RECORD_MISSING, std::memory_order_relaxed);
+    }
+    snapshotBuffer = &buffer;
+    snapshotting.store(snapshotCount > 0, std::memory_order_release);
+}
+
+void Fleet::finishSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (!snapshotting.load(std::memory_order_acquire)) {
+        return;
+    }
+    for (size_t id = 0; id < snapshotCount; ++id) {
+        preserve(id);
+    }
+    snapshotting.store(false, std::memory_order_release);
+}
+
+BackgroundCheckpointer::BackgroundCheckpointer()
+    : writingIndex(-1),
+      pendingIndex(-1),
+      pendingFleet(nullptr),
+      stopping(false),
+      completed(0),
+      failed(0),
+      superseded(0),
+      lastCaptureNanos(0) {
+    worker = std::thread(&BackgroundCheckpointer::workerLoop, this);
+}
+
+BackgroundCheckpointer::~BackgroundCheckpointer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void BackgroundCheckpointer::capture(Fleet& fleet, const std::string& path) {
+    auto begin = std::chrono::steady_clock::now();
+
+    int target;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pendingIndex >= 0) {
+            target = pendingIndex;
+            pendingIndex = -1;
+            superseded++;
+        } else {
+            target = (writingIndex == 0) ? 1 : 0;
+        }
+    }
+
+    fleet.beginSnapshot(buffers[target]);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingIndex = target;
+        pendingPath = path;
+        pendingFleet = &fleet;
+    }
+    cv.notify_all();
+
+    lastCaptureNanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count());
+}
+
+void BackgroundCheckpointer::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return pendingIndex >= 0 || stopping; });
+        if (pendingIndex < 0) {
+            return;
+        }
+
+        writingIndex = pendingIndex;
+        pendingIndex = -1;
+        std::string path = pendingPath;
+        Fleet* fleet = pendingFleet;
+        lock.unlock();
+
+        fleet->finishSnapshot();
+        bool ok = writeCheckpointFile(path, buffers[writingIndex]);
+
+        lock.lock();
+        writingIndex = -1;
+        if (ok) {
+            completed++;
+        } else {
+            failed++;
+        }
+        cv.notify_all();
+    }
+}
+
+void BackgroundCheckpointer::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return pendingIndex < 0 && writingIndex < 0; });
+}
+
+uint64_t BackgroundCheckpointer::getCompletedCount() const {
+    return completed;
+}
+
+uint64_t BackgroundCheckpointer::getFailedCount() const {
+    return failed;
+}
+
+uint64_t BackgroundCheckpointer::getSupersededCount() const {
+    return superseded;
+}
+
+double BackgroundCheckpointer::getLastCaptureMicros() const {
+    return static_cast<double>(lastCaptureNanos.load()) / 1000.0;
+}
@@ -0,0 +1,187 @@
+#include "FleetEventBus.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+FleetEventBus::FleetEventBus(size_t shardCount) {
+    if (shardCount == 0) {
+        throw std::invalid_argument("event bus needs at least one shard");
+    }
+    shards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; i++) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+size_t FleetEventBus::getShardCount() const {
+    return shards.size();
+}
+
+size_t FleetEventBus::shardOf(MachineId machine) const {
+    return machine % shards.size();
+}
+
+void FleetEventBus::append(Shard& shard, MachineId machine, const Event& event) {
+    shard.queue.push_back(Entry{machine, event});
+}
+
+void FleetEventBus::post(MachineId machine, const Event& event) {
+    Shard& shard = *shards[shardOf(machine)];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        append(shard, machine, event);
+    }
+    shard.posted.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Buckets the ids by shard first (a counting sort that keeps the caller's
+// order within each shard), then appends each bucket under one lock.
+void FleetEventBus::submit(const MachineId* machines, size_t count, const Event& event) {
+    if (count == 0) {
+        return;
+    }
+    if (shards.size() == 1) {
+        Shard& shard = *shards[0];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.queue.reserve(shard.queue.size() + count);
+            for (size_t i = 0; i < count; i++) {
+                append(shard, machines[i], event);
+            }
+        }
+        shard.posted.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    std::vector<size_t> offsets(shards.size() + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        offsets[shardOf(machines[i]) + 1]++;
+    }
+    for (size_t s = 0; s < shards.size(); s++) {
+        offsets[s + 1] += offsets[s];
+    }
+    std::vector<MachineId> bucketed(count);
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        bucketed[next[shardOf(machines[i])]++] = machines[i];
+    }
+
+    for (size_t s = 0; s < shards.size(); s++) {
+        size_t begin = offsets[s];
+        size_t end = offsets[s + 1];
+        if (begin == end) {
+            continue;
+        }
+        Shard& shard = *shards[s];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.queue.reserve(shard.queue.size() + (end - begin));
+            for (size_t i = begin; i < end; i++) {
+                append(shard, bucketed[i], event);
+            }
+        }
+        shard.posted.fetch_add(end - begin, std::memory_order_relaxed);
+    }
+}
+
+void FleetEventBus::submit(const std::vector<MachineId>& machines, const Event& event) {
+    submit(machines.data(), machines.size(), event);
+}
+
+void FleetEventBus::submitRange(MachineId first, MachineId last, const Event& event) {
+    if (first >= last) {
+        return;
+    }
+    size_t shardCount = shards.size();
+    for (size_t s = 0; s < shardCount; s++) {
+        MachineId start = first + static_cast<MachineId>((s + shardCount - first % shardCount) % shardCount);
+        if (start >= last) {
+            continue;
+        }
+        size_t count = (last - start - 1) / shardCount + 1;
+        Shard& shard = *shards[s];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.queue.reserve(shard.queue.size() + count);
+            for (size_t i = 0; i < count; i++) {
+                append(shard, start + static_cast<MachineId>(i * shardCount), event);
+            }
+        }
+        shard.posted.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+// Each round takes the whole queue. Sorting on (machine, position) groups a
+// machine's events together and keeps them in posting order; a round that
+// arrives sorted, as batch submissions in id order do, skips the sort.
+size_t FleetEventBus::drain(size_t index, const Handler& handler) {
+    Shard& shard = *shards[index];
+    size_t handled = 0;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.queue.empty()) {
+                break;
+            }
+            shard.batch.swap(shard.queue);
+        }
+
+        size_t count = shard.batch.size();
+        shard.order.resize(count);
+        bool sorted = true;
+        for (size_t i = 0; i < count; i++) {
+            shard.order[i] = (static_cast<uint64_t>(shard.batch[i].machine) << 32) | i;
+            if (i > 0 && shard.order[i] < shard.order[i - 1]) {
+                sorted = false;
+            }
+        }
+        if (!sorted) {
+            std::sort(shard.order.begin(), shard.order.end());
+        }
+
+        for (uint64_t key : shard.order) {
+            const Entry& entry = shard.batch[static_cast<uint32_t>(key)];
+            handler(entry.machine, entry.event);
+        }
+        handled += count;
+        shard.batch.clear();
+        shard.rounds.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.handled.fetch_add(handled, std::memory_order_relaxed);
+    return handled;
+}
+
+void FleetEventBus::discardFrom(MachineId machine) {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        auto& queue = shard->queue;
+        queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                   [machine](const Entry& entry) { return entry.machine >= machine; }),
+                    queue.end());
+    }
+}
+
+size_t FleetEventBus::getPendingCount(size_t shard) const {
+    std::lock_guard<std::mutex> lock(shards[shard]->mutex);
+    return shards[shard]->queue.size();
+}
+
+size_t FleetEventBus::getPendingCount() const {
+    size_t total = 0;
+    for (size_t s = 0; s < shards.size(); s++) {
+        total += getPendingCount(s);
+    }
+    return total;
+}
+
+uint64_t FleetEventBus::getPostedCount(size_t shard) const {
+    return shards[shard]->posted.load(std::memory_order_relaxed);
+}
+
+uint64_t FleetEventBus::getHandledCount(size_t shard) const {
+    return shards[shard]->handled.load(std::memory_order_relaxed);
+}
+
+uint64_t FleetEventBus::getRoundCount(size_t shard) const {
+    return shards[shard]->rounds.load(std::memory_order_relaxed);
+}
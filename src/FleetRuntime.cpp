@@ -0,0 +1,361 @@
+#include "FleetRuntime.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Spins briefly, then yields, then naps, so an idle worker does not hold a
+// core the controlling thread needs when there are more threads than cores.
+template<typename Ready>
+void waitUntil(Ready ready) {
+    for (int spin = 0; !ready(); spin++) {
+        if (spin < 64) {
+            continue;
+        }
+        if (spin < 4096) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    }
+}
+
+int pinCurrentThread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return -1;
+    }
+    return sched_getcpu();
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+void apply(MachineCore& core, const RuntimeCommand& command) {
+    switch (command.kind) {
+        case RuntimeCommand::Kind::OpenDoor: core.openDoor(); break;
+        case RuntimeCommand::Kind::CloseDoor: core.closeDoor(); break;
+        case RuntimeCommand::Kind::SelectMode: core.selectMode(static_cast<int>(command.value)); break;
+        case RuntimeCommand::Kind::SetLoad: core.setLoad(command.value); break;
+        case RuntimeCommand::Kind::Start: core.start(); break;
+        case RuntimeCommand::Kind::Pause: core.pause(); break;
+        case RuntimeCommand::Kind::Resume: core.resume(); break;
+        case RuntimeCommand::Kind::Stop: core.stop(); break;
+        case RuntimeCommand::Kind::EmergencyStop: core.emergencyStop(); break;
+        case RuntimeCommand::Kind::ClearFault: core.clearFault(); break;
+        case RuntimeCommand::Kind::InjectFault: core.injectFault(static_cast<FaultCode>(static_cast<int>(command.value))); break;
+    }
+}
+
+}
+
+std::vector<int> FleetRuntime::allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < count; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+FleetRuntime::FleetRuntime(size_t machines, RuntimeOptions runtimeOptions, ShardHook shardHook)
+    : machineCount(machines),
+      options(runtimeOptions),
+      hook(std::move(shardHook)),
+      tickCount(0) {
+    std::vector<int> cpus = allowedCpus();
+    size_t count = options.workers ? options.workers : cpus.size();
+    workers.reserve(count);
+    for (size_t w = 0; w < count; w++) {
+        workers.push_back(std::make_unique<Worker>(options.ringCapacity));
+        workers[w]->waterShare = options.waterFlowLimit / static_cast<float>(count);
+        workers[w]->powerShare = options.powerLimitWatts / static_cast<float>(count);
+    }
+    for (size_t w = 0; w < count; w++) {
+        int cpu = options.pin ? cpus[w % cpus.size()] : -1;
+        workers[w]->thread = std::thread(&FleetRuntime::workerLoop, this, w, cpu);
+    }
+    for (size_t w = 0; w < count; w++) {
+        Reply ready = receiveFrom(w);
+        workers[w]->report = ready.report;
+    }
+}
+
+FleetRuntime::~FleetRuntime() {
+    Message stop;
+    stop.kind = Message::Kind::Stop;
+    for (size_t w = 0; w < workers.size(); w++) {
+        sendTo(w, stop);
+    }
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+// Everything the shard owns is created here, after pinning, and destroyed
+// before the thread exits.
+void FleetRuntime::workerLoop(size_t index, int cpu) {
+    Worker& self = *workers[index];
+    self.cpu = cpu >= 0 ? pinCurrentThread(cpu) : -1;
+
+    size_t stride = workers.size();
+    size_t local = machineCount > index ? (machineCount - index - 1) / stride + 1 : 0;
+    // Declared before the shard so its machines detach from them first.
+    std::unique_ptr<WaterSupply> supply;
+    std::unique_ptr<PowerAdmissionController> power;
+    std::unique_ptr<TimingWheel> wheel;
+    ShardedFleet shard(local);
+    if (options.waterFlowLimit > 0.0f) {
+        supply = std::make_unique<WaterSupply>(self.waterShare);
+        shard.connectWaterSupply(supply.get());
+    }
+    if (options.powerLimitWatts > 0.0f) {
+        power = std::make_unique<PowerAdmissionController>(self.powerShare);
+        shard.connectPowerController(power.get());
+    }
+    if (options.watchdog) {
+        wheel = std::make_unique<TimingWheel>();
+        shard.connectTimingWheel(wheel.get());
+    }
+
+    Reply reply;
+    reply.kind = Reply::Kind::Ready;
+    reply.report.machines = local;
+    reply.report.stateCounts[static_cast<size_t>(State::Idle)] = static_cast<uint32_t>(local);
+    waitUntil([&] { return self.outbox.tryPush(reply); });
+
+    Message message;
+    for (;;) {
+        waitUntil([&] { return self.inbox.tryPop(message); });
+        switch (message.kind) {
+            case Message::Kind::Command:
+                if (message.command.machine == RuntimeCommand::ALL_MACHINES) {
+                    for (size_t id = 0; id < local; id++) {
+                        apply(shard.getMachine(static_cast<ShardedFleet::MachineId>(id)), message.command);
+                    }
+                } else {
+                    apply(shard.getMachine(static_cast<ShardedFleet::MachineId>(message.command.machine / stride)),
+                          message.command);
+                }
+                break;
+
+            case Message::Kind::Status:
+                reply.kind = Reply::Kind::Status;
+                reply.status = shard.getMachine(static_cast<ShardedFleet::MachineId>(message.command.machine / stride)).getStatus();
+                waitUntil([&] { return self.outbox.tryPush(reply); });
+                break;
+
+            case Message::Kind::Tick: {
+                auto begin = std::chrono::steady_clock::now();
+                if (supply) {
+                    supply->setMaxFlowRate(message.waterShare);
+                }
+                if (power) {
+                    power->setPowerLimit(message.powerShare);
+                }
+                if (hook) {
+                    hook(index, shard);
+                }
+                shard.tick(message.deltaTime);
+
+                ShardReport& report = reply.report;
+                report.tick++;
+                report.stateCounts.fill(0);
+                for (size_t id = 0; id < local; id++) {
+                    report.stateCounts[static_cast<size_t>(shard.getMachine(static_cast<ShardedFleet::MachineId>(id)).getCurrentState())]++;
+                }
+                report.waterDemand = supply ? supply->getTotalDemand() : 0.0f;
+                report.waterFlow = supply ? supply->getTotalFlow() : 0.0f;
+                report.powerCommitted = power ? power->getCommittedPower() : 0.0f;
+                report.powerWaiting = power ? power->getWaitingCount() : 0;
+                report.tickSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                reply.kind = Reply::Kind::Tick;
+                waitUntil([&] { return self.outbox.tryPush(reply); });
+                break;
+            }
+
+            case Message::Kind::Stop:
+                return;
+        }
+    }
+}
+
+void FleetRuntime::sendTo(size_t worker, const Message& message) {
+    SpscRing<Message>& inbox = workers[worker]->inbox;
+    waitUntil([&] { return inbox.tryPush(message); });
+}
+
+FleetRuntime::Reply FleetRuntime::receiveFrom(size_t worker) {
+    SpscRing<Reply>& outbox = workers[worker]->outbox;
+    Reply reply;
+    waitUntil([&] { return outbox.tryPop(reply); });
+    return reply;
+}
+
+// Water: workers get their demand while the line can carry it all, with the
+// spare split evenly; past that, the limit is split in proportion to demand.
+// Power: each keeps what it has committed, and the headroom goes to workers
+// with machines waiting to spin (evenly if none are).
+void FleetRuntime::rebalance() {
+    size_t count = workers.size();
+    if (options.waterFlowLimit > 0.0f) {
+        float demand = 0.0f;
+        for (auto& worker : workers) {
+            demand += worker->report.waterDemand;
+        }
+        for (auto& worker : workers) {
+            if (demand <= options.waterFlowLimit) {
+                worker->waterShare = worker->report.waterDemand +
+                                     (options.waterFlowLimit - demand) / static_cast<float>(count);
+            } else {
+                worker->waterShare = options.waterFlowLimit * worker->report.waterDemand / demand;
+            }
+        }
+    }
+    if (options.powerLimitWatts > 0.0f) {
+        float committed = 0.0f;
+        size_t waiting = 0;
+        for (auto& worker : workers) {
+            committed += worker->report.powerCommitted;
+            waiting += worker->report.powerWaiting;
+        }
+        float headroom = std::max(0.0f, options.powerLimitWatts - committed);
+        for (auto& worker : workers) {
+            float weight = waiting > 0 ? static_cast<float>(worker->report.powerWaiting) / static_cast<float>(waiting)
+                                       : 1.0f / static_cast<float>(count);
+            worker->powerShare = worker->report.powerCommitted + headroom * weight;
+        }
+    }
+}
+
+size_t FleetRuntime::size() const {
+    return machineCount;
+}
+
+size_t FleetRuntime::getWorkerCount() const {
+    return workers.size();
+}
+
+size_t FleetRuntime::workerOf(MachineId id) const {
+    return id % workers.size();
+}
+
+int FleetRuntime::getWorkerCpu(size_t worker) const {
+    return workers[worker]->cpu;
+}
+
+void FleetRuntime::send(MachineId id, RuntimeCommand::Kind kind, float value) {
+    if (id >= machineCount) {
+        return;
+    }
+    Message message;
+    message.kind = Message::Kind::Command;
+    message.command.kind = kind;
+    message.command.machine = id;
+    message.command.value = value;
+    sendTo(workerOf(id), message);
+}
+
+void FleetRuntime::broadcast(RuntimeCommand::Kind kind, float value) {
+    Message message;
+    message.kind = Message::Kind::Command;
+    message.command.kind = kind;
+    message.command.machine = RuntimeCommand::ALL_MACHINES;
+    message.command.value = value;
+    for (size_t w = 0; w < workers.size(); w++) {
+        sendTo(w, message);
+    }
+}
+
+void FleetRuntime::tick(float deltaTime) {
+    for (size_t w = 0; w < workers.size(); w++) {
+        Message message;
+        message.kind = Message::Kind::Tick;
+        message.deltaTime = deltaTime;
+        message.waterShare = workers[w]->waterShare;
+        message.powerShare = workers[w]->powerShare;
+        sendTo(w, message);
+    }
+    for (size_t w = 0; w < workers.size(); w++) {
+        workers[w]->report = receiveFrom(w).report;
+    }
+    tickCount++;
+    rebalance();
+}
+
+void FleetRuntime::run(long ticks, float deltaTime) {
+    for (long t = 0; t < ticks; t++) {
+        tick(deltaTime);
+    }
+}
+
+uint64_t FleetRuntime::getTickCount() const {
+    return tickCount;
+}
+
+SystemStatus FleetRuntime::getStatus(MachineId id) {
+    if (id >= machineCount) {
+        return SystemStatus{};
+    }
+    Message message;
+    message.kind = Message::Kind::Status;
+    message.command.machine = id;
+    size_t worker = workerOf(id);
+    sendTo(worker, message);
+    return receiveFrom(worker).status;
+}
+
+const ShardReport& FleetRuntime::getShardReport(size_t worker) const {
+    return workers[worker]->report;
+}
+
+ShardReport FleetRuntime::getTotals() const {
+    ShardReport totals;
+    totals.tick = tickCount;
+    for (const auto& worker : workers) {
+        const ShardReport& report = worker->report;
+        totals.machines += report.machines;
+        for (size_t s = 0; s < ShardReport::STATE_COUNT; s++) {
+            totals.stateCounts[s] += report.stateCounts[s];
+        }
+        totals.waterDemand += report.waterDemand;
+        totals.waterFlow += report.waterFlow;
+        totals.powerCommitted += report.powerCommitted;
+        totals.powerWaiting += report.powerWaiting;
+        totals.tickSeconds = std::max(totals.tickSeconds, report.tickSeconds);
+    }
+    return totals;
+}
+
+float FleetRuntime::getWaterShare(size_t worker) const {
+    return workers[worker]->waterShare;
+}
+
+float FleetRuntime::getPowerShare(size_t worker) const {
+    return workers[worker]->powerShare;
+}
@@ -0,0 +1,10 @@
+#include "MachineCore.hpp"
+
+std::shared_ptr<const ConfigManager> defaultWashModes() {
+    // A static manager on the built-in catalog, handed out without an owner,
+    // so the default table allocates nothing.
+    static const ConfigManager defaults;
+    return std::shared_ptr<const ConfigManager>(std::shared_ptr<const ConfigManager>(), &defaults);
+}
+
+template class BasicMachineCore<DoorSystem, WaterSystem, MotorSystem>;
@@ -36,12 +36,16 @@ void MotorSystem::setDirection(Direction dir) {
 }
 
 void MotorSystem::update(float deltaTimeSeconds) {
+    update(toSimTime(deltaTimeSeconds));
+}
+
+void MotorSystem::update(SimTime deltaTime) {
     if (!running && currentRPM == 0) {
         direction = Direction::Stopped;
         return;
     }
 
-    int rampAmount = static_cast<int>(rampRate * deltaTimeSeconds);
+    int rampAmount = static_cast<int>(rampRate * deltaTime / SIM_TIME_PER_SECOND);
 
     if (currentRPM < targetRPM) {
         currentRPM += rampAmount;
@@ -83,6 +87,31 @@ void MotorSystem::emergencyStop() {
     direction = Direction::Stopped;
 }
 
+void MotorSystem::saveState(CheckpointWriter& writer) const {
+    writer.write<int32_t>(currentRPM);
+    writer.write<int32_t>(targetRPM);
+    writer.write<uint8_t>(running ? 1 : 0);
+    writer.write<uint8_t>(static_cast<uint8_t>(direction));
+}
+
+bool MotorSystem::restoreState(CheckpointReader& reader) {
+    int32_t current = 0;
+    int32_t target = 0;
+    uint8_t isRunning = 0;
+    uint8_t dir = 0;
+    if (!reader.read(current) || !reader.read(target) || !reader.read(isRunning) || !reader.read(dir)) {
+        return false;
+    }
+    if (dir > static_cast<uint8_t>(Direction::Stopped)) {
+        return false;
+    }
+    currentRPM = current;
+    targetRPM = target;
+    running = isRunning != 0;
+    direction = static_cast<Direction>(dir);
+    return true;
+}
+
 void MotorSystem::reset() {
     currentRPM = 0;
     targetRPM = 0;
@@ -0,0 +1,191 @@
+#include "PowerAdmissionController.hpp"
+
+PowerAdmissionController::PowerAdmissionController(float powerLimitWatts)
+    : powerLimitWatts(powerLimitWatts),
+      committedWatts(0.0f),
+      peakWatts(0.0f),
+      simTime(0.0),
+      waitingCount(0),
+      totalDelaySeconds(0.0),
+      admissions(0),
+      delayedAdmissions(0),
+      forcedAdmissions(0) {}
+
+size_t PowerAdmissionController::registerMachine() {
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = slotState.size();
+        slotState.push_back(SlotState::Unused);
+        slotWatts.push_back(0.0f);
+        waitStart.push_back(0.0);
+        queued.push_back(0);
+    }
+    slotState[slot] = SlotState::Idle;
+    slotWatts[slot] = 0.0f;
+    return slot;
+}
+
+void PowerAdmissionController::releaseMachine(size_t slot) {
+    if (slot >= slotState.size() || slotState[slot] == SlotState::Unused) {
+        return;
+    }
+    endSpin(slot);
+    slotState[slot] = SlotState::Unused;
+    if (!queued[slot]) {
+        freeSlots.push_back(slot);
+    }
+}
+
+float PowerAdmissionController::estimateSpinPower(int rpm) {
+    float r = static_cast<float>(rpm);
+    return 150.0f + 0.0012f * r * r;
+}
+
+void PowerAdmissionController::admit(size_t slot, float watts) {
+    slotState[slot] = SlotState::Admitted;
+    slotWatts[slot] = watts;
+    committedWatts += watts;
+    if (committedWatts > peakWatts) {
+        peakWatts = committedWatts;
+    }
+}
+
+bool PowerAdmissionController::requestSpin(size_t slot, int rpm) {
+    SlotState current = slotState[slot];
+    if (current == SlotState::Admitted) {
+        return true;
+    }
+    if (current == SlotState::Waiting) {
+        return false;
+    }
+
+    float watts = estimateSpinPower(rpm);
+    if (waitQueue.empty() && committedWatts + watts <= powerLimitWatts) {
+        admit(slot, watts);
+        admissions++;
+        return true;
+    }
+
+    slotState[slot] = SlotState::Waiting;
+    slotWatts[slot] = watts;
+    waitStart[slot] = simTime;
+    waitingCount++;
+    if (!queued[slot]) {
+        queued[slot] = 1;
+        waitQueue.push_back(slot);
+    }
+    return false;
+}
+
+void PowerAdmissionController::forceAdmit(size_t slot, int rpm) {
+    if (slotState[slot] == SlotState::Admitted) {
+        return;
+    }
+    if (slotState[slot] == SlotState::Waiting) {
+        waitingCount--;
+    }
+    admit(slot, estimateSpinPower(rpm));
+    forcedAdmissions++;
+}
+
+void PowerAdmissionController::endSpin(size_t slot) {
+    SlotState current = slotState[slot];
+    if (current == SlotState::Admitted) {
+        committedWatts -= slotWatts[slot];
+        if (committedWatts < 0.0f) {
+            committedWatts = 0.0f;
+        }
+        slotState[slot] = SlotState::Idle;
+        slotWatts[slot] = 0.0f;
+        drainQueue();
+    } else if (current == SlotState::Waiting) {
+        slotState[slot] = SlotState::Idle;
+        slotWatts[slot] = 0.0f;
+        waitingCount--;
+    }
+}
+
+// Strict FIFO: a large request at the head is not bypassed by smaller ones
+// behind it, so no machine can be starved by a stream of lighter spins.
+void PowerAdmissionController::drainQueue() {
+    while (!waitQueue.empty()) {
+        size_t slot = waitQueue.front();
+
+        if (slotState[slot] != SlotState::Waiting) {
+            waitQueue.pop_front();
+            queued[slot] = 0;
+            if (slotState[slot] == SlotState::Unused) {
+                freeSlots.push_back(slot);
+            }
+            continue;
+        }
+
+        if (committedWatts + slotWatts[slot] > powerLimitWatts && committedWatts > 0.0f) {
+            break;
+        }
+
+        waitQueue.pop_front();
+        queued[slot] = 0;
+        waitingCount--;
+        totalDelaySeconds += simTime - waitStart[slot];
+        admissions++;
+        delayedAdmissions++;
+        admit(slot, slotWatts[slot]);
+    }
+}
+
+void PowerAdmissionController::update(float deltaTimeSeconds) {
+    simTime += deltaTimeSeconds;
+    drainQueue();
+}
+
+PowerAdmissionController::SlotState PowerAdmissionController::getSlotState(size_t slot) const {
+    return slotState[slot];
+}
+
+float PowerAdmissionController::getPowerLimit() const {
+    return powerLimitWatts;
+}
+
+void PowerAdmissionController::setPowerLimit(float watts) {
+    powerLimitWatts = watts;
+    drainQueue();
+}
+
+float PowerAdmissionController::getCommittedPower() const {
+    return committedWatts;
+}
+
+float PowerAdmissionController::getPeakPower() const {
+    return peakWatts;
+}
+
+size_t PowerAdmissionController::getWaitingCount() const {
+    return waitingCount;
+}
+
+uint64_t PowerAdmissionController::getAdmissionCount() const {
+    return admissions;
+}
+
+uint64_t PowerAdmissionController::getDelayedAdmissionCount() const {
+    return delayedAdmissions;
+}
+
+uint64_t PowerAdmissionController::getForcedAdmissionCount() const {
+    return forcedAdmissions;
+}
+
+double PowerAdmissionController::getTotalDelaySeconds() const {
+    return totalDelaySeconds;
+}
+
+double PowerAdmissionController::getAddedMinutesPerCycle() const {
+    if (admissions == 0) {
+        return 0.0;
+    }
+    return totalDelaySeconds / 60.0 / static_cast<double>(admissions);
+}
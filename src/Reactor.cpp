@@ -0,0 +1,196 @@
+#include "Reactor.hpp"
+
+#ifdef __linux__
+
+#include <array>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+Reactor::Reactor()
+    : epollFd(epoll_create1(EPOLL_CLOEXEC)),
+      stopFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      running(false) {
+    if (epollFd >= 0 && stopFd >= 0) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = stopFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event);
+    }
+}
+
+Reactor::~Reactor() {
+    if (stopFd >= 0) {
+        close(stopFd);
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+}
+
+bool Reactor::isOpen() const {
+    return epollFd >= 0 && stopFd >= 0;
+}
+
+bool Reactor::add(int fd, uint32_t events, Handler handler) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        return false;
+    }
+    handlers[fd] = std::make_shared<Handler>(std::move(handler));
+    return true;
+}
+
+bool Reactor::modify(int fd, uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+void Reactor::remove(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    handlers.erase(fd);
+}
+
+// Returns the number of handlers run, or -1 if epoll_wait failed. A handler
+// may add or remove descriptors, including its own.
+int Reactor::runOnce(int timeoutMillis) {
+    std::array<epoll_event, 64> events;
+    int ready = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeoutMillis);
+    if (ready < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+
+    int dispatched = 0;
+    for (int i = 0; i < ready; i++) {
+        int fd = events[i].data.fd;
+        if (fd == stopFd) {
+            uint64_t value = 0;
+            ssize_t ignored = read(stopFd, &value, sizeof(value));
+            (void)ignored;
+            continue;
+        }
+        auto it = handlers.find(fd);
+        if (it == handlers.end()) {
+            continue;
+        }
+        std::shared_ptr<Handler> handler = it->second;
+        (*handler)(events[i].events);
+        dispatched++;
+    }
+    return dispatched;
+}
+
+void Reactor::run() {
+    running = true;
+    while (running) {
+        if (runOnce(-1) < 0) {
+            break;
+        }
+    }
+    running = false;
+}
+
+void Reactor::stop() {
+    running = false;
+    uint64_t one = 1;
+    ssize_t ignored = write(stopFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+bool Reactor::isRunning() const {
+    return running;
+}
+
+PeriodicTimer::PeriodicTimer(std::chrono::nanoseconds period)
+    : fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+      period(period) {
+    if (fd < 0) {
+        return;
+    }
+
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    auto toTimespec = [](std::chrono::nanoseconds value) {
+        timespec spec{};
+        spec.tv_sec = static_cast<time_t>(value.count() / 1000000000);
+        spec.tv_nsec = static_cast<long>(value.count() % 1000000000);
+        return spec;
+    };
+
+    std::chrono::nanoseconds first = std::chrono::seconds(now.tv_sec) +
+                                     std::chrono::nanoseconds(now.tv_nsec) + period;
+    itimerspec spec{};
+    spec.it_value = toTimespec(first);
+    spec.it_interval = toTimespec(period);
+    timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+PeriodicTimer::~PeriodicTimer() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool PeriodicTimer::isOpen() const {
+    return fd >= 0;
+}
+
+int PeriodicTimer::getFd() const {
+    return fd;
+}
+
+std::chrono::nanoseconds PeriodicTimer::getPeriod() const {
+    return period;
+}
+
+uint64_t PeriodicTimer::readExpirations() {
+    uint64_t expirations = 0;
+    if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return 0;
+    }
+    return expirations;
+}
+
+EventNotifier::EventNotifier()
+    : fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      armed(false) {}
+
+EventNotifier::~EventNotifier() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool EventNotifier::isOpen() const {
+    return fd >= 0;
+}
+
+int EventNotifier::getFd() const {
+    return fd;
+}
+
+void EventNotifier::notify() {
+    if (!armed.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        ssize_t ignored = write(fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+// Read before disarming: a notify() racing with the read either sees the
+// flag still set (and its event is handled by the caller's drain pass) or
+// sees it cleared and writes a fresh wake-up.
+void EventNotifier::drain() {
+    uint64_t value = 0;
+    ssize_t ignored = read(fd, &value, sizeof(value));
+    (void)ignored;
+    armed.store(false, std::memory_order_release);
+}
+
+#endif
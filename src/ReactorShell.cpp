@@ -0,0 +1,110 @@
+#include "ReactorShell.hpp"
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+ReactorShell::ReactorShell(WashingMachine& machine, CLI& cli, int inputFd,
+                           std::chrono::nanoseconds tickPeriod)
+    : machine(machine),
+      cli(cli),
+      inputFd(inputFd),
+      timer(tickPeriod),
+      tickStats(tickPeriod),
+      hasDeadline(false) {}
+
+ReactorShell::~ReactorShell() {
+    machine.setEventNotifier(nullptr);
+}
+
+bool ReactorShell::run() {
+    if (!reactor.isOpen() || !timer.isOpen() || !notifier.isOpen()) {
+        return false;
+    }
+
+    reactor.add(timer.getFd(), EPOLLIN, [this](uint32_t) { onTimer(); });
+    reactor.add(notifier.getFd(), EPOLLIN, [this](uint32_t) { onNotify(); });
+    if (inputFd >= 0) {
+        if (!reactor.add(inputFd, EPOLLIN, [this](uint32_t) { onInput(); })) {
+            return false;
+        }
+        cli.printPrompt();
+    }
+    machine.setEventNotifier([this] { notifier.notify(); });
+
+    tickStats.reset();
+    reactor.run();
+
+    machine.setEventNotifier(nullptr);
+    reactor.remove(timer.getFd());
+    reactor.remove(notifier.getFd());
+    if (inputFd >= 0) {
+        reactor.remove(inputFd);
+    }
+    return true;
+}
+
+void ReactorShell::runFor(std::chrono::nanoseconds duration) {
+    deadline = std::chrono::steady_clock::now() + duration;
+    hasDeadline = true;
+    run();
+    hasDeadline = false;
+}
+
+void ReactorShell::stop() {
+    reactor.stop();
+}
+
+const TickTimingStats& ReactorShell::getTickStats() const {
+    return tickStats;
+}
+
+// Missed expirations are folded into one larger step, so simulated time
+// stays locked to the timer even if a tick overruns.
+void ReactorShell::onTimer() {
+    uint64_t expirations = timer.readExpirations();
+    if (expirations == 0) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    tickStats.recordTick(now, expirations);
+
+    std::chrono::duration<float> step = timer.getPeriod() * expirations;
+    machine.tick(step.count());
+
+    if (hasDeadline && now >= deadline) {
+        stop();
+    }
+}
+
+void ReactorShell::onNotify() {
+    notifier.drain();
+    machine.processEvents();
+}
+
+void ReactorShell::onInput() {
+    char buffer[4096];
+    ssize_t count = read(inputFd, buffer, sizeof(buffer));
+    if (count <= 0) {
+        stop();
+        return;
+    }
+    pendingInput.append(buffer, static_cast<size_t>(count));
+
+    size_t start = 0;
+    size_t newline;
+    while ((newline = pendingInput.find('\n', start)) != std::string::npos) {
+        std::string_view line(pendingInput.data() + start, newline - start);
+        start = newline + 1;
+        if (!cli.execute(line)) {
+            stop();
+            return;
+        }
+        cli.printPrompt();
+    }
+    pendingInput.erase(0, start);
+}
+
+#endif
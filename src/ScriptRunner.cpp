@@ -0,0 +1,378 @@
+#include "ScriptRunner.hpp"
+#include "CommandTable.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string normalize(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    return result;
+}
+
+std::string jsonString(const std::string& text) {
+    std::ostringstream oss;
+    oss << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\n': oss << "\\n"; break;
+            case '\t': oss << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(c) << std::dec;
+                } else {
+                    oss << c;
+                }
+        }
+    }
+    oss << '"';
+    return oss.str();
+}
+
+std::string formatNumber(double value, int precision) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(precision) << value;
+    return oss.str();
+}
+
+std::string formatClock(double seconds) {
+    long total = static_cast<long>(std::floor(seconds));
+    std::ostringstream oss;
+    oss << std::setfill('0') << std::setw(2) << total / 3600 << ":"
+        << std::setw(2) << (total / 60) % 60 << ":"
+        << std::setw(2) << total % 60;
+    return oss.str();
+}
+
+// Machines in which update() changes nothing, so the clock can jump: a
+// resting state with the drum stopped and the door no longer held locked.
+bool isQuiescent(const SystemStatus& status) {
+    State state = status.state;
+    bool resting = state == State::Idle || state == State::DoorOpen || state == State::Ready ||
+                   state == State::Completed || state == State::Fault;
+    return resting && status.motorRPM == 0 && status.doorStatus != DoorStatus::ClosedLocked;
+}
+
+}
+
+ScriptRunner::ScriptRunner(WashingMachine& machine, std::ostream& out)
+    : machine(machine),
+      out(out),
+      cli(machine, captured),
+      telemetry(nullptr),
+      clock(0.0),
+      step(0.1f),
+      lineNumber(0),
+      lastState(State::Idle),
+      result{0, 0, 0, 0, 0.0} {
+    machine.setOutput(&captured);
+}
+
+void ScriptRunner::setTelemetry(TelemetryRecorder* recorder) {
+    telemetry = recorder;
+}
+
+void ScriptRunner::setStep(float seconds) {
+    if (seconds > 0.0f) {
+        step = seconds;
+    }
+}
+
+bool ScriptRunner::parseTimestamp(const std::string& text, double& seconds) {
+    if (text.empty() || text.find_first_not_of("0123456789:.") != std::string::npos) {
+        return false;
+    }
+
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+        size_t colon = text.find(':', start);
+        parts.push_back(text.substr(start, colon - start));
+        if (colon == std::string::npos) {
+            break;
+        }
+        start = colon + 1;
+    }
+    if (parts.size() > 3) {
+        return false;
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        const std::string& part = parts[i];
+        bool last = i + 1 == parts.size();
+        if (part.empty() || (!last && part.find('.') != std::string::npos)) {
+            return false;
+        }
+        double value = 0.0;
+        try {
+            value = std::stod(part);
+        } catch (...) {
+            return false;
+        }
+        if (i > 0 && value >= 60.0) {
+            return false;
+        }
+        total = total * 60.0 + value;
+    }
+    seconds = total;
+    return true;
+}
+
+std::string ScriptRunner::takeCaptured() {
+    std::string text = captured.str();
+    captured.str("");
+    captured.clear();
+
+    std::istringstream lines(text);
+    std::string line;
+    std::string joined;
+    while (std::getline(lines, line)) {
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+        if (!joined.empty()) {
+            joined += '\n';
+        }
+        joined += line;
+    }
+    return joined;
+}
+
+void ScriptRunner::beginRecord(const char* type, bool withLine) {
+    out << "{\"type\":\"" << type << "\"";
+    if (withLine) {
+        out << ",\"line\":" << lineNumber;
+    }
+    out << ",\"time\":\"" << formatClock(clock) << "\",\"seconds\":" << formatNumber(clock, 2);
+}
+
+void ScriptRunner::observe() {
+    if (captured.tellp() > 0) {
+        std::string text = takeCaptured();
+        if (!text.empty()) {
+            beginRecord("log", false);
+            out << ",\"output\":" << jsonString(text) << "}\n";
+        }
+    }
+
+    State state = machine.getCurrentState();
+    if (state != lastState) {
+        beginRecord("state", false);
+        out << ",\"from\":" << jsonString(stateToString(lastState))
+            << ",\"to\":" << jsonString(stateToString(state)) << "}\n";
+        lastState = state;
+    }
+}
+
+void ScriptRunner::advanceTo(double target) {
+    while (target - clock > 1e-9) {
+        machine.processEvents();
+        observe();
+        if (isQuiescent(machine.getStatus())) {
+            break;
+        }
+        float deltaTime = static_cast<float>(std::min<double>(step, target - clock));
+        machine.tick(deltaTime);
+        clock += deltaTime;
+        if (telemetry) {
+            telemetry->record(clock, machine.getSensorSample());
+        }
+        observe();
+    }
+    clock = target;
+}
+
+bool ScriptRunner::dispatch(const std::string& command) {
+    CommandTokens tokens = tokenizeCommand(command);
+    if (tokens.count == 0) {
+        return true;
+    }
+
+    if (equalsIgnoreCase(tokens[0], "expect")) {
+        if (tokens.count < 3) {
+            emitError("usage: expect <field> <value>");
+        } else {
+            size_t valueStart = static_cast<size_t>(tokens[2].data() - command.data());
+            checkExpectation(normalize(std::string(tokens[1])), trim(command.substr(valueStart)));
+        }
+        return true;
+    }
+
+    const CommandSpec* spec = findCommand(tokens[0]);
+    if (spec && spec->id == CommandId::Exit) {
+        return false;
+    }
+    if (spec && spec->id == CommandId::Status) {
+        emitStatus();
+    } else if (!spec || spec->id != CommandId::Clear) {
+        runCommand(command);
+    }
+    return true;
+}
+
+void ScriptRunner::runCommand(const std::string& command) {
+    result.commands++;
+    cli.execute(command);
+    machine.processEvents();
+
+    std::string output = takeCaptured();
+    beginRecord("command", true);
+    out << ",\"command\":" << jsonString(command)
+        << ",\"state\":" << jsonString(stateToString(machine.getCurrentState()))
+        << ",\"output\":" << jsonString(output) << "}\n";
+    observe();
+}
+
+void ScriptRunner::checkExpectation(const std::string& field, const std::string& expected) {
+    SystemStatus status = machine.getStatus();
+    std::string actual;
+    bool pass = false;
+
+    try {
+        if (field == "state") {
+            actual = stateToString(status.state);
+            pass = normalize(actual) == normalize(expected);
+        } else if (field == "door") {
+            actual = doorStatusToString(status.doorStatus);
+            pass = normalize(actual) == normalize(expected);
+        } else if (field == "fault") {
+            actual = faultCodeToString(status.fault);
+            pass = normalize(actual) == normalize(expected);
+        } else if (field == "mode") {
+            actual = status.modeName;
+            pass = normalize(actual) == normalize(expected);
+        } else if (field == "rpm") {
+            actual = std::to_string(status.motorRPM);
+            pass = status.motorRPM == std::stoi(expected);
+        } else if (field == "water") {
+            actual = formatNumber(status.waterLevel, 1);
+            pass = std::fabs(status.waterLevel - std::stof(expected)) <= 0.5f;
+        } else {
+            emitError("unknown expectation field '" + field + "'");
+            return;
+        }
+    } catch (...) {
+        emitError("invalid expected value '" + expected + "'");
+        return;
+    }
+
+    result.expectations++;
+    if (!pass) {
+        result.failures++;
+    }
+
+    beginRecord("expect", true);
+    out << ",\"field\":" << jsonString(field) << ",\"expected\":" << jsonString(expected)
+        << ",\"actual\":" << jsonString(actual) << ",\"pass\":" << (pass ? "true" : "false")
+        << "}\n";
+}
+
+void ScriptRunner::emitStatus() {
+    SystemStatus status = machine.getStatus();
+    beginRecord("status", true);
+    out << ",\"state\":" << jsonString(stateToString(status.state))
+        << ",\"door\":" << jsonString(doorStatusToString(status.doorStatus))
+        << ",\"mode\":" << jsonString(status.modeName)
+        << ",\"load\":" << formatNumber(status.loadKg, 1)
+        << ",\"water\":" << formatNumber(status.waterLevel, 1)
+        << ",\"targetWater\":" << formatNumber(status.targetWaterLevel, 1)
+        << ",\"rpm\":" << status.motorRPM
+        << ",\"progress\":" << formatNumber(status.progressPercent, 1)
+        << ",\"remaining\":" << status.remainingSeconds
+        << ",\"fault\":" << jsonString(faultCodeToString(status.fault)) << "}\n";
+}
+
+void ScriptRunner::emitError(const std::string& message) {
+    result.errors++;
+    beginRecord("error", true);
+    out << ",\"message\":" << jsonString(message) << "}\n";
+}
+
+void ScriptRunner::emitSummary() {
+    beginRecord("summary", false);
+    out << ",\"commands\":" << result.commands
+        << ",\"expectations\":" << result.expectations
+        << ",\"failures\":" << result.failures
+        << ",\"errors\":" << result.errors
+        << ",\"pass\":" << (result.passed() ? "true" : "false") << "}\n";
+}
+
+ScriptResult ScriptRunner::run(std::istream& script) {
+    clock = 0.0;
+    lineNumber = 0;
+    result = ScriptResult{0, 0, 0, 0, 0.0};
+    lastState = machine.getCurrentState();
+    takeCaptured();
+
+    std::string raw;
+    while (std::getline(script, raw)) {
+        lineNumber++;
+        std::string line = trim(raw.substr(0, raw.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        std::string command = line;
+        if (line[0] == '@' || line[0] == '+') {
+            size_t end = line.find_first_of(" \t");
+            std::string stamp = line.substr(1, end == std::string::npos ? std::string::npos : end - 1);
+            command = end == std::string::npos ? "" : trim(line.substr(end));
+
+            double at = 0.0;
+            if (!parseTimestamp(stamp, at)) {
+                emitError("invalid timestamp '" + stamp + "'");
+                continue;
+            }
+            if (line[0] == '+') {
+                at += clock;
+            }
+            if (at < clock) {
+                emitError("timestamp " + formatClock(at) + " is earlier than " + formatClock(clock));
+                continue;
+            }
+            advanceTo(at);
+        }
+
+        if (!command.empty() && !dispatch(command)) {
+            break;
+        }
+    }
+
+    result.simulatedSeconds = clock;
+    emitSummary();
+    return result;
+}
+
+ScriptResult ScriptRunner::runFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        result = ScriptResult{0, 0, 0, 0, 0.0};
+        emitError("cannot open script '" + path + "'");
+        emitSummary();
+        return result;
+    }
+    return run(file);
+}
@@ -0,0 +1,108 @@
+#include "ShardedFleet.hpp"
+
+ShardedFleet::Slot::Slot(std::shared_ptr<const ConfigManager> modes, FleetEventBus* owner, MachineId machine)
+    : core(std::move(modes)), bus(owner), id(machine) {
+    core.setOutput(nullptr);
+    core.setEventSink(this);
+}
+
+PushResult ShardedFleet::Slot::post(const Event& event) {
+    bus->post(id, event);
+    return PushResult::Accepted;
+}
+
+ShardedFleet::ShardedFleet(size_t machineCount, size_t shardCount, std::shared_ptr<const ConfigManager> modeTable)
+    : modes(modeTable ? std::move(modeTable) : MachineCore::defaultModes()),
+      bus(shardCount),
+      waterSupply(nullptr),
+      powerController(nullptr),
+      timingWheel(nullptr) {
+    resize(machineCount);
+}
+
+void ShardedFleet::resize(size_t machineCount) {
+    if (machineCount < slots.size()) {
+        bus.discardFrom(static_cast<MachineId>(machineCount));
+        while (slots.size() > machineCount) {
+            slots.pop_back();
+        }
+        return;
+    }
+    while (slots.size() < machineCount) {
+        slots.emplace_back(modes, &bus, static_cast<MachineId>(slots.size()));
+        slots.back().core.connectWaterSupply(waterSupply);
+        slots.back().core.connectPowerController(powerController);
+        slots.back().core.connectTimingWheel(timingWheel);
+    }
+}
+
+size_t ShardedFleet::size() const {
+    return slots.size();
+}
+
+MachineCore& ShardedFleet::getMachine(MachineId id) {
+    return slots[id].core;
+}
+
+const MachineCore& ShardedFleet::getMachine(MachineId id) const {
+    return slots[id].core;
+}
+
+FleetEventBus& ShardedFleet::getBus() {
+    return bus;
+}
+
+void ShardedFleet::connectWaterSupply(WaterSupply* supply) {
+    waterSupply = supply;
+    for (Slot& slot : slots) {
+        slot.core.connectWaterSupply(supply);
+    }
+}
+
+void ShardedFleet::connectPowerController(PowerAdmissionController* controller) {
+    powerController = controller;
+    for (Slot& slot : slots) {
+        slot.core.connectPowerController(controller);
+    }
+}
+
+void ShardedFleet::connectTimingWheel(TimingWheel* wheel) {
+    timingWheel = wheel;
+    for (Slot& slot : slots) {
+        slot.core.connectTimingWheel(wheel);
+    }
+}
+
+size_t ShardedFleet::drainShard(size_t shard) {
+    return bus.drain(shard, [this](MachineId id, const Event& event) {
+        if (id < slots.size()) {
+            slots[id].core.handleEvent(event);
+        }
+    });
+}
+
+void ShardedFleet::updateShard(size_t shard, float deltaTime) {
+    SimTime step = toSimTime(deltaTime);
+    size_t shardCount = bus.getShardCount();
+    for (size_t id = shard; id < slots.size(); id += shardCount) {
+        slots[id].core.update(step);
+    }
+}
+
+// As in Fleet, the shared supply, power cap and timing wheel are resolved
+// once per tick after every machine has published its demand.
+void ShardedFleet::tick(float deltaTime) {
+    for (size_t shard = 0; shard < bus.getShardCount(); shard++) {
+        drainShard(shard);
+        updateShard(shard, deltaTime);
+    }
+    if (waterSupply) {
+        waterSupply->update(deltaTime);
+    }
+    if (powerController) {
+        powerController->update(deltaTime);
+    }
+    if (timingWheel) {
+        timingWheel->advance(deltaTime);
+    }
+}
@@ -0,0 +1,522 @@
+#include "StateExplorer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t NO_TAG = std::numeric_limits<uint64_t>::max();
+constexpr ExplorerKey KEY_PRESENT = 1ull << 63;
+
+const float ADVANCE_STEPS[] = {0.5f, 5.0f, 60.0f, 600.0f};
+const float LOAD_VALUES[] = {0.0f, 3.0f, 7.0f};
+
+uint64_t makeTag(uint32_t parent, size_t action) {
+    return (static_cast<uint64_t>(parent) + 1) << 16 | static_cast<uint64_t>(action);
+}
+
+uint64_t mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+int waterBucket(const SystemStatus& status) {
+    if (status.waterLevel <= 0.0f) {
+        return 0;
+    }
+    if (status.targetWaterLevel > 0.0f && status.waterLevel >= status.targetWaterLevel) {
+        return 2;
+    }
+    return 1;
+}
+
+int rpmBucket(const SystemStatus& status) {
+    if (status.motorRPM <= 0) {
+        return 0;
+    }
+    return status.motorRPM <= 600 ? 1 : 2;
+}
+
+int loadBucket(const SystemStatus& status) {
+    if (status.loadKg <= 0.0f) {
+        return 0;
+    }
+    return status.loadKg <= 6.0f ? 1 : 2;
+}
+
+bool isCycleState(State state) {
+    return state == State::Filling || state == State::Washing || state == State::Rinsing ||
+           state == State::Spinning || state == State::Draining;
+}
+
+struct Node {
+    ExplorerKey key;
+    uint32_t parent;
+    uint16_t action;
+};
+
+struct Candidate {
+    ExplorerKey key;
+    uint64_t tag;
+    uint32_t parent;
+    uint16_t action;
+    MachineCore core;
+    SystemStatus status;
+};
+
+struct ViolationCandidate {
+    size_t property;
+    uint64_t tag;
+    uint32_t parent;
+    uint16_t action;
+    ExplorerKey key;
+};
+
+struct WorkerOutput {
+    std::vector<Candidate> candidates;
+    std::vector<std::pair<uint32_t, ExplorerKey>> edges;
+    std::vector<ViolationCandidate> violations;
+    bool overflow = false;
+};
+
+}
+
+void ExplorerAction::apply(MachineCore& core) const {
+    switch (kind) {
+        case Kind::Command:
+            switch (static_cast<Command>(code)) {
+                case Command::OpenDoor: core.openDoor(); break;
+                case Command::CloseDoor: core.closeDoor(); break;
+                case Command::SelectMode: core.selectMode(static_cast<int>(value)); break;
+                case Command::SetLoad: core.setLoad(value); break;
+                case Command::Start: core.start(); break;
+                case Command::Pause: core.pause(); break;
+                case Command::Resume: core.resume(); break;
+                case Command::Stop: core.stop(); break;
+                case Command::EmergencyStop: core.emergencyStop(); break;
+                case Command::ClearFault: core.clearFault(); break;
+            }
+            break;
+        case Kind::Event: {
+            EventType type = static_cast<EventType>(code);
+            if (type == EventType::CMD_SELECT_MODE) {
+                core.handleEvent(Event(type, static_cast<int>(value)));
+            } else if (type == EventType::CMD_SET_LOAD) {
+                core.handleEvent(Event(type, value));
+            } else {
+                core.handleEvent(Event(type));
+            }
+            break;
+        }
+        case Kind::Advance:
+            core.step(value);
+            break;
+    }
+    core.processPendingEvents();
+}
+
+std::string ExplorerAction::describe() const {
+    static const char* const commandNames[] = {
+        "open", "close", "mode", "load", "start", "pause", "resume", "stop", "emergency", "clear-fault"
+    };
+
+    std::ostringstream text;
+    switch (kind) {
+        case Kind::Command:
+            text << commandNames[code];
+            if (static_cast<Command>(code) == Command::SelectMode) {
+                text << " " << static_cast<int>(value) + 1;
+            } else if (static_cast<Command>(code) == Command::SetLoad) {
+                text << " " << value;
+            }
+            break;
+        case Kind::Event:
+            text << "event " << eventTypeToString(static_cast<EventType>(code));
+            break;
+        case Kind::Advance:
+            text << "advance " << value << "s";
+            break;
+    }
+    return text.str();
+}
+
+ExplorerKey explorerKey(const SystemStatus& status, State pausedFrom) {
+    uint64_t key = static_cast<uint64_t>(status.state);
+    key |= static_cast<uint64_t>(status.doorStatus) << 4;
+    key |= static_cast<uint64_t>(waterBucket(status)) << 6;
+    key |= static_cast<uint64_t>(rpmBucket(status)) << 8;
+    key |= static_cast<uint64_t>(pausedFrom) << 10;
+    key |= static_cast<uint64_t>(status.fault) << 14;
+    key |= static_cast<uint64_t>(std::min(status.modeIndex, 7)) << 17;
+    key |= static_cast<uint64_t>(loadBucket(status)) << 20;
+    return key | KEY_PRESENT;
+}
+
+std::string describeExplorerKey(ExplorerKey key) {
+    static const char* const waterNames[] = {"empty", "partial", "full"};
+    static const char* const rpmNames[] = {"0", "<=600", ">600"};
+    static const char* const loadNames[] = {"none", "ok", "over"};
+
+    std::ostringstream text;
+    State state = static_cast<State>(key & 0xF);
+    text << stateToString(state)
+         << ", door " << doorStatusToString(static_cast<DoorStatus>((key >> 4) & 0x3))
+         << ", water " << waterNames[(key >> 6) & 0x3]
+         << ", rpm " << rpmNames[(key >> 8) & 0x3]
+         << ", mode " << ((key >> 17) & 0x7) + 1
+         << ", load " << loadNames[(key >> 20) & 0x3];
+    FaultCode fault = static_cast<FaultCode>((key >> 14) & 0x7);
+    if (fault != FaultCode::None) {
+        text << ", fault " << faultCodeToString(fault);
+    }
+    if (state == State::Paused) {
+        text << ", paused from " << stateToString(static_cast<State>((key >> 10) & 0xF));
+    }
+    return text.str();
+}
+
+ExplorerVisitedSet::ExplorerVisitedSet(size_t capacityPow2)
+    : mask(capacityPow2 - 1),
+      keys(new std::atomic<uint64_t>[capacityPow2]),
+      tags(new std::atomic<uint64_t>[capacityPow2]),
+      count(0) {
+    for (size_t i = 0; i < capacityPow2; i++) {
+        keys[i].store(0, std::memory_order_relaxed);
+        tags[i].store(NO_TAG, std::memory_order_relaxed);
+    }
+}
+
+// Linear probing; a slot's key is claimed once with a CAS and never
+// changes, so readers that see a key can rely on it.
+bool ExplorerVisitedSet::offer(ExplorerKey key, uint64_t tag, bool& lowered) {
+    lowered = false;
+    size_t slot = mix(key) & mask;
+    for (size_t probe = 0; probe <= mask; probe++, slot = (slot + 1) & mask) {
+        uint64_t current = keys[slot].load(std::memory_order_acquire);
+        if (current == 0) {
+            if (count.load(std::memory_order_relaxed) >= mask) {
+                return false;
+            }
+            if (keys[slot].compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                current = key;
+            }
+        }
+        if (current != key) {
+            continue;
+        }
+
+        uint64_t best = tags[slot].load(std::memory_order_relaxed);
+        while (tag < best) {
+            if (tags[slot].compare_exchange_weak(best, tag, std::memory_order_acq_rel)) {
+                lowered = true;
+                break;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+uint64_t ExplorerVisitedSet::tagOf(ExplorerKey key) const {
+    size_t slot = mix(key) & mask;
+    for (size_t probe = 0; probe <= mask; probe++, slot = (slot + 1) & mask) {
+        uint64_t current = keys[slot].load(std::memory_order_acquire);
+        if (current == key) {
+            return tags[slot].load(std::memory_order_acquire);
+        }
+        if (current == 0) {
+            break;
+        }
+    }
+    return NO_TAG;
+}
+
+size_t ExplorerVisitedSet::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+StateExplorer::StateExplorer(std::shared_ptr<const ConfigManager> modeTable)
+    : modes(modeTable ? std::move(modeTable) : MachineCore::defaultModes()),
+      threadCount(std::max(1u, std::thread::hardware_concurrency())),
+      maxStates(1u << 20),
+      maxDepth(std::numeric_limits<int>::max()) {
+    using Command = ExplorerAction::Command;
+    auto command = [this](Command code, float value = 0.0f) {
+        actions.push_back({ExplorerAction::Kind::Command, static_cast<uint8_t>(code), value});
+    };
+
+    command(Command::OpenDoor);
+    command(Command::CloseDoor);
+    for (int mode = 0; mode < modes->getModeCount(); mode++) {
+        command(Command::SelectMode, static_cast<float>(mode));
+    }
+    for (float load : LOAD_VALUES) {
+        command(Command::SetLoad, load);
+    }
+    command(Command::Start);
+    command(Command::Pause);
+    command(Command::Resume);
+    command(Command::Stop);
+    command(Command::EmergencyStop);
+    command(Command::ClearFault);
+
+    for (size_t type = 0; type < EVENT_TYPE_COUNT; type++) {
+        float value = static_cast<EventType>(type) == EventType::CMD_SET_LOAD ? 3.0f : 0.0f;
+        actions.push_back({ExplorerAction::Kind::Event, static_cast<uint8_t>(type), value});
+    }
+    for (float step : ADVANCE_STEPS) {
+        actions.push_back({ExplorerAction::Kind::Advance, 0, step});
+    }
+}
+
+void StateExplorer::setThreadCount(unsigned threads) {
+    threadCount = std::max(1u, threads);
+}
+
+void StateExplorer::setMaxStates(size_t states) {
+    maxStates = std::max<size_t>(1, states);
+}
+
+void StateExplorer::setMaxDepth(int depth) {
+    maxDepth = depth;
+}
+
+void StateExplorer::addInvariant(ExplorerInvariant invariant) {
+    invariants.push_back(std::move(invariant));
+}
+
+void StateExplorer::addReachability(ExplorerReachability reachability) {
+    reachabilities.push_back(std::move(reachability));
+}
+
+void StateExplorer::addDefaultProperties() {
+    addInvariant({"door opens only with the drum stopped and empty", [](const SystemStatus& s) {
+        return s.doorStatus != DoorStatus::Open || (s.motorRPM == 0 && s.waterLevel <= 0.0f);
+    }});
+    addInvariant({"door locked while a cycle is active", [](const SystemStatus& s) {
+        return !isCycleState(s.state) || s.doorStatus == DoorStatus::ClosedLocked;
+    }});
+    addReachability({"EmergencyStop always reaches Idle",
+                     [](const SystemStatus& s) { return s.state == State::EmergencyStop; },
+                     [](const SystemStatus& s) { return s.state == State::Idle; }});
+    addReachability({"Fault always reaches Idle",
+                     [](const SystemStatus& s) { return s.state == State::Fault; },
+                     [](const SystemStatus& s) { return s.state == State::Idle; }});
+}
+
+const std::vector<ExplorerAction>& StateExplorer::getActions() const {
+    return actions;
+}
+
+ExplorationResult StateExplorer::explore() const {
+    MachineCore initial(modes);
+    initial.setOutput(nullptr);
+    return explore(initial);
+}
+
+ExplorationResult StateExplorer::explore(const MachineCore& initial) const {
+    auto started = std::chrono::steady_clock::now();
+
+    ExplorationResult result{};
+    size_t capacity = 1024;
+    while (capacity < maxStates * 2) {
+        capacity <<= 1;
+    }
+    ExplorerVisitedSet visited(capacity);
+
+    std::vector<Node> nodes;
+    std::vector<SystemStatus> statuses;
+    std::vector<std::vector<ExplorerKey>> successors;
+
+    MachineCore root(initial);
+    root.setOutput(nullptr);
+    root.processPendingEvents();
+    SystemStatus rootStatus = root.getStatus();
+    ExplorerKey rootKey = explorerKey(rootStatus, root.getPausedFromState());
+    bool lowered = false;
+    visited.offer(rootKey, 0, lowered);
+    nodes.push_back({rootKey, NO_PARENT, 0});
+    statuses.push_back(rootStatus);
+    successors.emplace_back();
+
+    std::vector<uint32_t> frontier{0};
+    std::vector<MachineCore> frontierCores;
+    frontierCores.push_back(root);
+
+    std::vector<ViolationCandidate> firstViolations(invariants.size(), ViolationCandidate{0, NO_TAG, 0, 0, 0});
+    for (size_t i = 0; i < invariants.size(); i++) {
+        if (!invariants[i].holds(rootStatus)) {
+            firstViolations[i] = {i, 0, NO_PARENT, 0, rootKey};
+        }
+    }
+
+    bool overflow = false;
+    int depth = 0;
+    while (!frontier.empty() && depth < maxDepth && !overflow) {
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(threadCount, frontier.size()));
+        std::vector<WorkerOutput> outputs(workers);
+        std::atomic<size_t> next{0};
+
+        auto expand = [&](WorkerOutput& output) {
+            for (size_t index = next.fetch_add(1); index < frontier.size(); index = next.fetch_add(1)) {
+                uint32_t parent = frontier[index];
+                for (size_t a = 0; a < actions.size(); a++) {
+                    MachineCore core(frontierCores[index]);
+                    actions[a].apply(core);
+                    SystemStatus status = core.getStatus();
+                    ExplorerKey key = explorerKey(status, core.getPausedFromState());
+                    uint64_t tag = makeTag(parent, a);
+                    output.edges.emplace_back(parent, key);
+
+                    for (size_t i = 0; i < invariants.size(); i++) {
+                        if (!invariants[i].holds(status)) {
+                            output.violations.push_back({i, tag, parent, static_cast<uint16_t>(a), key});
+                        }
+                    }
+
+                    bool isLowest = false;
+                    if (!visited.offer(key, tag, isLowest)) {
+                        output.overflow = true;
+                        return;
+                    }
+                    if (isLowest) {
+                        output.candidates.push_back({key, tag, parent, static_cast<uint16_t>(a),
+                                                     std::move(core), std::move(status)});
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned w = 1; w < workers; w++) {
+            pool.emplace_back(expand, std::ref(outputs[w]));
+        }
+        expand(outputs[0]);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+
+        std::vector<Candidate*> accepted;
+        for (WorkerOutput& output : outputs) {
+            overflow = overflow || output.overflow;
+            result.transitions += output.edges.size();
+            for (auto& edge : output.edges) {
+                successors[edge.first].push_back(edge.second);
+            }
+            for (const ViolationCandidate& violation : output.violations) {
+                if (violation.tag < firstViolations[violation.property].tag) {
+                    firstViolations[violation.property] = violation;
+                }
+            }
+            for (Candidate& candidate : output.candidates) {
+                if (visited.tagOf(candidate.key) == candidate.tag) {
+                    accepted.push_back(&candidate);
+                }
+            }
+        }
+        std::sort(accepted.begin(), accepted.end(),
+                  [](const Candidate* a, const Candidate* b) { return a->tag < b->tag; });
+
+        std::vector<uint32_t> nextFrontier;
+        std::vector<MachineCore> nextCores;
+        nextCores.reserve(accepted.size());
+        for (Candidate* candidate : accepted) {
+            if (nodes.size() >= maxStates) {
+                overflow = true;
+                break;
+            }
+            nextFrontier.push_back(static_cast<uint32_t>(nodes.size()));
+            nodes.push_back({candidate->key, candidate->parent, candidate->action});
+            statuses.push_back(std::move(candidate->status));
+            successors.emplace_back();
+            nextCores.push_back(std::move(candidate->core));
+        }
+
+        frontier.swap(nextFrontier);
+        frontierCores.swap(nextCores);
+        if (!frontier.empty()) {
+            depth++;
+        }
+    }
+
+    result.states = nodes.size();
+    result.depth = depth;
+    result.complete = frontier.empty() && !overflow;
+
+    auto traceTo = [&](uint32_t id) {
+        std::vector<ExplorerAction> trace;
+        for (uint32_t at = id; at != NO_PARENT && nodes[at].parent != NO_PARENT; at = nodes[at].parent) {
+            trace.push_back(actions[nodes[at].action]);
+        }
+        std::reverse(trace.begin(), trace.end());
+        return trace;
+    };
+
+    for (size_t i = 0; i < invariants.size(); i++) {
+        const ViolationCandidate& violation = firstViolations[i];
+        if (violation.tag == NO_TAG) {
+            continue;
+        }
+        ExplorerViolation reported{invariants[i].name, {}, describeExplorerKey(violation.key)};
+        if (violation.parent != NO_PARENT) {
+            reported.trace = traceTo(violation.parent);
+            reported.trace.push_back(actions[violation.action]);
+        }
+        result.violations.push_back(std::move(reported));
+    }
+
+    if (result.complete && !reachabilities.empty()) {
+        std::unordered_map<ExplorerKey, uint32_t> ids;
+        ids.reserve(nodes.size());
+        for (uint32_t id = 0; id < nodes.size(); id++) {
+            ids.emplace(nodes[id].key, id);
+        }
+        std::vector<std::vector<uint32_t>> predecessors(nodes.size());
+        for (uint32_t id = 0; id < nodes.size(); id++) {
+            for (ExplorerKey key : successors[id]) {
+                auto it = ids.find(key);
+                if (it != ids.end() && it->second != id) {
+                    predecessors[it->second].push_back(id);
+                }
+            }
+        }
+
+        for (const ExplorerReachability& property : reachabilities) {
+            std::vector<bool> reaches(nodes.size(), false);
+            std::vector<uint32_t> queue;
+            for (uint32_t id = 0; id < nodes.size(); id++) {
+                if (property.to(statuses[id])) {
+                    reaches[id] = true;
+                    queue.push_back(id);
+                }
+            }
+            for (size_t head = 0; head < queue.size(); head++) {
+                for (uint32_t previous : predecessors[queue[head]]) {
+                    if (!reaches[previous]) {
+                        reaches[previous] = true;
+                        queue.push_back(previous);
+                    }
+                }
+            }
+            for (uint32_t id = 0; id < nodes.size(); id++) {
+                if (!reaches[id] && property.from(statuses[id])) {
+                    result.violations.push_back({property.name, traceTo(id), describeExplorerKey(nodes[id].key)});
+                    break;
+                }
+            }
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
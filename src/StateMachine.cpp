@@ -3,11 +3,11 @@
 StateMachine::StateMachine()
     : currentState(State::Idle),
       previousState(State::Idle),
-      pausedFromState(State::Idle) {
-    initializeTransitions();
-}
+      pausedFromState(State::Idle) {}
+
+StateMachine::TransitionTable StateMachine::buildTransitions() {
+    TransitionTable transitionTable;
 
-void StateMachine::initializeTransitions() {
     transitionTable[State::Idle][EventType::CMD_OPEN_DOOR] = State::DoorOpen;
     transitionTable[State::Idle][EventType::CMD_SELECT_MODE] = State::Ready;
 
@@ -22,25 +22,37 @@ void StateMachine::initializeTransitions() {
     transitionTable[State::Filling][EventType::CMD_PAUSE] = State::Paused;
     transitionTable[State::Filling][EventType::CMD_EMERGENCY] = State::EmergencyStop;
     transitionTable[State::Filling][EventType::FAULT_WATER_UNAVAILABLE] = State::Fault;
+    transitionTable[State::Filling][EventType::FAULT_DOOR] = State::Fault;
+    transitionTable[State::Filling][EventType::TIMER_TIMEOUT] = State::Fault;
     transitionTable[State::Filling][EventType::CMD_STOP] = State::Draining;
 
     transitionTable[State::Washing][EventType::SYS_WASH_COMPLETE] = State::Rinsing;
     transitionTable[State::Washing][EventType::CMD_PAUSE] = State::Paused;
     transitionTable[State::Washing][EventType::CMD_EMERGENCY] = State::EmergencyStop;
     transitionTable[State::Washing][EventType::CMD_STOP] = State::Draining;
+    transitionTable[State::Washing][EventType::FAULT_OVERLOAD] = State::Fault;
+    transitionTable[State::Washing][EventType::FAULT_DOOR] = State::Fault;
+    transitionTable[State::Washing][EventType::FAULT_MOTOR] = State::Fault;
 
     transitionTable[State::Rinsing][EventType::SYS_RINSE_COMPLETE] = State::Spinning;
     transitionTable[State::Rinsing][EventType::CMD_PAUSE] = State::Paused;
     transitionTable[State::Rinsing][EventType::CMD_EMERGENCY] = State::EmergencyStop;
     transitionTable[State::Rinsing][EventType::CMD_STOP] = State::Draining;
+    transitionTable[State::Rinsing][EventType::FAULT_DOOR] = State::Fault;
+    transitionTable[State::Rinsing][EventType::FAULT_MOTOR] = State::Fault;
 
     transitionTable[State::Spinning][EventType::SYS_SPIN_COMPLETE] = State::Draining;
     transitionTable[State::Spinning][EventType::CMD_PAUSE] = State::Paused;
     transitionTable[State::Spinning][EventType::CMD_EMERGENCY] = State::EmergencyStop;
     transitionTable[State::Spinning][EventType::CMD_STOP] = State::Draining;
+    transitionTable[State::Spinning][EventType::FAULT_OVERLOAD] = State::Fault;
+    transitionTable[State::Spinning][EventType::FAULT_DOOR] = State::Fault;
+    transitionTable[State::Spinning][EventType::FAULT_MOTOR] = State::Fault;
 
     transitionTable[State::Draining][EventType::SYS_DRAIN_COMPLETE] = State::Completed;
     transitionTable[State::Draining][EventType::CMD_EMERGENCY] = State::EmergencyStop;
+    transitionTable[State::Draining][EventType::FAULT_DOOR] = State::Fault;
+    transitionTable[State::Draining][EventType::TIMER_TIMEOUT] = State::Fault;
 
     transitionTable[State::Completed][EventType::CMD_OPEN_DOOR] = State::DoorOpen;
     transitionTable[State::Completed][EventType::CMD_STOP] = State::Idle;
@@ -55,6 +67,29 @@ void StateMachine::initializeTransitions() {
 
     transitionTable[State::Fault][EventType::FAULT_CLEARED] = State::Idle;
     transitionTable[State::Fault][EventType::CMD_STOP] = State::Idle;
+
+    return transitionTable;
+}
+
+// The table is immutable and shared by every instance, so a StateMachine is
+// three enums plus whatever callbacks the owner registered.
+const StateMachine::TransitionTable& StateMachine::transitions() {
+    static const TransitionTable table = buildTransitions();
+    return table;
+}
+
+bool StateMachine::lookup(State state, EventType event, State& next) {
+    const TransitionTable& table = transitions();
+    auto stateIt = table.find(state);
+    if (stateIt == table.end()) {
+        return false;
+    }
+    auto eventIt = stateIt->second.find(event);
+    if (eventIt == stateIt->second.end()) {
+        return false;
+    }
+    next = eventIt->second;
+    return true;
 }
 
 State StateMachine::getCurrentState() const {
@@ -74,20 +109,17 @@ void StateMachine::setPausedFromState(State state) {
 }
 
 bool StateMachine::canTransition(EventType event) const {
-    auto stateIt = transitionTable.find(currentState);
-    if (stateIt == transitionTable.end()) {
-        return false;
-    }
-    return stateIt->second.find(event) != stateIt->second.end();
+    State next;
+    return lookup(currentState, event, next);
 }
 
 bool StateMachine::transition(EventType event) {
-    if (!canTransition(event)) {
+    State newState;
+    if (!lookup(currentState, event, newState)) {
         return false;
     }
 
     State oldState = currentState;
-    State newState = transitionTable.at(currentState).at(event);
 
     auto exitIt = onExitCallbacks.find(oldState);
     if (exitIt != onExitCallbacks.end()) {
@@ -153,6 +185,29 @@ bool StateMachine::isSafeToOpenDoor() const {
            currentState == State::Completed;
 }
 
+void StateMachine::saveState(CheckpointWriter& writer) const {
+    writer.write<uint8_t>(static_cast<uint8_t>(currentState));
+    writer.write<uint8_t>(static_cast<uint8_t>(previousState));
+    writer.write<uint8_t>(static_cast<uint8_t>(pausedFromState));
+}
+
+bool StateMachine::restoreState(CheckpointReader& reader) {
+    uint8_t current = 0;
+    uint8_t previous = 0;
+    uint8_t pausedFrom = 0;
+    if (!reader.read(current) || !reader.read(previous) || !reader.read(pausedFrom)) {
+        return false;
+    }
+    const uint8_t limit = static_cast<uint8_t>(State::Fault);
+    if (current > limit || previous > limit || pausedFrom > limit) {
+        return false;
+    }
+    currentState = static_cast<State>(current);
+    previousState = static_cast<State>(previous);
+    pausedFromState = static_cast<State>(pausedFrom);
+    return true;
+}
+
 void StateMachine::reset() {
     currentState = State::Idle;
     previousState = State::Idle;
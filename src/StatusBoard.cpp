@@ -0,0 +1,240 @@
+#include "StatusBoard.hpp"
+
+#ifdef __linux__
+
+#include "Fleet.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int READ_RETRIES = 64;
+
+}
+
+size_t StatusBoard::regionSize(uint32_t capacity) {
+    return sizeof(StatusBoardHeader) + sizeof(StatusSlot) * static_cast<size_t>(capacity);
+}
+
+StatusBoard::StatusBoard() : header(nullptr), slots(nullptr), mappedBytes(0) {}
+
+StatusBoard::~StatusBoard() {
+    close();
+}
+
+bool StatusBoard::create(const std::string& boardName, uint32_t capacity) {
+    if (header || capacity == 0) {
+        return false;
+    }
+
+    int fd = shm_open(boardName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    size_t bytes = regionSize(capacity);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        shm_unlink(boardName.c_str());
+        return false;
+    }
+    void* region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        shm_unlink(boardName.c_str());
+        return false;
+    }
+
+    // The magic is stored last so a reader never accepts a half-initialised
+    // header.
+    std::memset(region, 0, bytes);
+    header = static_cast<StatusBoardHeader*>(region);
+    slots = reinterpret_cast<StatusSlot*>(static_cast<uint8_t*>(region) + sizeof(StatusBoardHeader));
+    header->version = STATUS_BOARD_VERSION;
+    header->slotSize = static_cast<uint16_t>(sizeof(StatusSlot));
+    header->capacity = capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = STATUS_BOARD_MAGIC;
+
+    name = boardName;
+    mappedBytes = bytes;
+    return true;
+}
+
+void StatusBoard::close() {
+    if (!header) {
+        return;
+    }
+    munmap(header, mappedBytes);
+    shm_unlink(name.c_str());
+    header = nullptr;
+    slots = nullptr;
+    mappedBytes = 0;
+}
+
+bool StatusBoard::isOpen() const {
+    return header != nullptr;
+}
+
+uint32_t StatusBoard::getCapacity() const {
+    return header ? header->capacity : 0;
+}
+
+void StatusBoard::publish(uint32_t slot, const SystemStatus& status, uint64_t tick) {
+    if (!header || slot >= header->capacity) {
+        return;
+    }
+
+    StatusRecord record = makeStatusRecord(slot, status);
+    StatusSlot& target = slots[slot];
+    uint32_t sequence = target.sequence.load(std::memory_order_relaxed);
+    target.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    target.tick = tick;
+    target.record = record;
+    target.sequence.store(sequence + 2, std::memory_order_release);
+
+    if (slot >= header->count.load(std::memory_order_relaxed)) {
+        header->count.store(slot + 1, std::memory_order_release);
+    }
+}
+
+void StatusBoard::publish(const Fleet& fleet, uint64_t tick) {
+    if (!header) {
+        return;
+    }
+    uint32_t count = static_cast<uint32_t>(fleet.size() < header->capacity ? fleet.size() : header->capacity);
+    for (uint32_t id = 0; id < count; id++) {
+        publish(id, fleet.getMachine(id).getStatus(), tick);
+    }
+    commit(tick);
+}
+
+void StatusBoard::commit(uint64_t tick) {
+    if (!header) {
+        return;
+    }
+    header->tick.store(tick, std::memory_order_relaxed);
+    header->publishCount.fetch_add(1, std::memory_order_release);
+}
+
+StatusBoardReader::StatusBoardReader() : header(nullptr), slots(nullptr), mappedBytes(0) {}
+
+StatusBoardReader::~StatusBoardReader() {
+    close();
+}
+
+bool StatusBoardReader::open(const std::string& name) {
+    if (header) {
+        return false;
+    }
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(StatusBoardHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* region = mmap(nullptr, bytes, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (region == MAP_FAILED) {
+        return false;
+    }
+
+    const auto* mapped = static_cast<const StatusBoardHeader*>(region);
+    bool valid = mapped->magic == STATUS_BOARD_MAGIC && mapped->version == STATUS_BOARD_VERSION &&
+                 mapped->slotSize == sizeof(StatusSlot) &&
+                 StatusBoard::regionSize(mapped->capacity) <= bytes;
+    if (!valid) {
+        munmap(region, bytes);
+        return false;
+    }
+
+    header = mapped;
+    slots = reinterpret_cast<const StatusSlot*>(static_cast<const uint8_t*>(region) + sizeof(StatusBoardHeader));
+    mappedBytes = bytes;
+    return true;
+}
+
+void StatusBoardReader::close() {
+    if (!header) {
+        return;
+    }
+    munmap(const_cast<StatusBoardHeader*>(header), mappedBytes);
+    header = nullptr;
+    slots = nullptr;
+    mappedBytes = 0;
+}
+
+bool StatusBoardReader::isOpen() const {
+    return header != nullptr;
+}
+
+uint32_t StatusBoardReader::getCapacity() const {
+    return header ? header->capacity : 0;
+}
+
+uint32_t StatusBoardReader::getCount() const {
+    if (!header) {
+        return 0;
+    }
+    uint32_t count = header->count.load(std::memory_order_acquire);
+    return count < header->capacity ? count : header->capacity;
+}
+
+uint64_t StatusBoardReader::getPublishCount() const {
+    return header ? header->publishCount.load(std::memory_order_acquire) : 0;
+}
+
+uint64_t StatusBoardReader::getTick() const {
+    return header ? header->tick.load(std::memory_order_relaxed) : 0;
+}
+
+bool StatusBoardReader::read(uint32_t slot, StatusRecord& record, uint64_t* tick) const {
+    if (!header || slot >= header->capacity) {
+        return false;
+    }
+
+    const StatusSlot& source = slots[slot];
+    for (int attempt = 0; attempt < READ_RETRIES; attempt++) {
+        uint32_t before = source.sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before & 1u) {
+            continue;
+        }
+        std::memcpy(&record, &source.record, sizeof(record));
+        uint64_t slotTick = source.tick;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (source.sequence.load(std::memory_order_relaxed) == before) {
+            if (tick) {
+                *tick = slotTick;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t StatusBoardReader::scan(std::vector<StatusRecord>& records) const {
+    uint32_t count = getCount();
+    records.resize(count);
+    size_t found = 0;
+    for (uint32_t slot = 0; slot < count; slot++) {
+        if (read(slot, records[found])) {
+            found++;
+        }
+    }
+    records.resize(found);
+    return found;
+}
+
+#endif
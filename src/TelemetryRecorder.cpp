@@ -0,0 +1,517 @@
+#include "TelemetryRecorder.hpp"
+#include "Checkpoint.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Bits are appended least-significant first and spilled 64 at a time.
+class BitWriter {
+private:
+    std::vector<uint8_t>& out;
+    uint64_t accumulator;
+    int pending;
+
+    void spill(uint64_t word, int bytes) {
+        size_t offset = out.size();
+        out.resize(offset + static_cast<size_t>(bytes));
+        for (int i = 0; i < bytes; i++) {
+            out[offset + static_cast<size_t>(i)] = static_cast<uint8_t>(word >> (8 * i));
+        }
+    }
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out), accumulator(0), pending(0) {}
+
+    void write(uint64_t value, int bits) {
+        if (bits == 0) {
+            return;
+        }
+        if (bits < 64) {
+            value &= (uint64_t{1} << bits) - 1;
+        }
+        accumulator |= value << pending;
+        if (pending + bits < 64) {
+            pending += bits;
+            return;
+        }
+        spill(accumulator, 8);
+        int consumed = 64 - pending;
+        accumulator = consumed < 64 ? value >> consumed : 0;
+        pending += bits - 64;
+    }
+
+    void finish() {
+        if (pending > 0) {
+            spill(accumulator, (pending + 7) / 8);
+            accumulator = 0;
+            pending = 0;
+        }
+    }
+};
+
+class BitReader {
+private:
+    const std::vector<uint8_t>& in;
+    size_t offset;
+    uint64_t accumulator;
+    int available;
+    bool ok;
+
+    uint64_t readSmall(int bits) {
+        while (available < bits) {
+            if (offset >= in.size()) {
+                ok = false;
+                return 0;
+            }
+            accumulator |= static_cast<uint64_t>(in[offset++]) << available;
+            available += 8;
+        }
+        uint64_t value = accumulator & ((uint64_t{1} << bits) - 1);
+        accumulator >>= bits;
+        available -= bits;
+        return value;
+    }
+
+public:
+    explicit BitReader(const std::vector<uint8_t>& in) : in(in), offset(0), accumulator(0), available(0), ok(true) {}
+
+    uint64_t read(int bits) {
+        uint64_t value = 0;
+        int shift = 0;
+        while (bits > 0) {
+            int take = bits < 32 ? bits : 32;
+            value |= readSmall(take) << shift;
+            shift += take;
+            bits -= take;
+        }
+        return value;
+    }
+
+    bool good() const {
+        return ok;
+    }
+};
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int bitWidth(uint64_t value) {
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+// Delta-of-delta buckets from the Gorilla paper, widened for 64-bit values:
+// '0' for no change, then 2/3/4-bit prefixes for 7/12/20-bit zigzag values,
+// and '1111' plus the raw 64 bits for anything larger.
+void writeDeltaOfDelta(BitWriter& writer, int64_t value) {
+    uint64_t encoded = zigzag(value);
+    if (encoded == 0) {
+        writer.write(0, 1);
+    } else if (encoded < (1u << 7)) {
+        writer.write(0x1, 2);
+        writer.write(encoded, 7);
+    } else if (encoded < (1u << 12)) {
+        writer.write(0x3, 3);
+        writer.write(encoded, 12);
+    } else if (encoded < (1u << 20)) {
+        writer.write(0x7, 4);
+        writer.write(encoded, 20);
+    } else {
+        writer.write(0xF, 4);
+        writer.write(encoded, 64);
+    }
+}
+
+int64_t readDeltaOfDelta(BitReader& reader) {
+    if (reader.read(1) == 0) {
+        return 0;
+    }
+    if (reader.read(1) == 0) {
+        return unzigzag(reader.read(7));
+    }
+    if (reader.read(1) == 0) {
+        return unzigzag(reader.read(12));
+    }
+    if (reader.read(1) == 0) {
+        return unzigzag(reader.read(20));
+    }
+    return unzigzag(reader.read(64));
+}
+
+// `value(i)` yields the i-th integer of the column.
+template<typename Column>
+void writeIntColumn(BitWriter& writer, Column value, uint32_t count) {
+    int64_t previous = value(0);
+    writer.write(static_cast<uint64_t>(previous), 64);
+    int64_t previousDelta = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        int64_t current = value(i);
+        int64_t delta = current - previous;
+        writeDeltaOfDelta(writer, delta - previousDelta);
+        previous = current;
+        previousDelta = delta;
+    }
+}
+
+void readIntColumn(BitReader& reader, std::vector<int64_t>& values, uint32_t count) {
+    values.resize(count);
+    values[0] = static_cast<int64_t>(reader.read(64));
+    int64_t delta = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        delta += readDeltaOfDelta(reader);
+        values[i] = values[i - 1] + delta;
+    }
+}
+
+uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float bitsToFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int leadingZeros(uint32_t value) {
+    return 32 - bitWidth(value);
+}
+
+int trailingZeros(uint32_t value) {
+    return __builtin_ctz(value);
+}
+
+// Gorilla XOR encoding: '0' when the value repeats, '10' plus the meaningful
+// bits when they fit the previous window, otherwise '11', a 5-bit leading
+// zero count, a 5-bit length and the bits.
+void writeFloatColumn(BitWriter& writer, const float* values, uint32_t count) {
+    uint32_t previous = floatBits(values[0]);
+    writer.write(previous, 32);
+    int windowLeading = -1;
+    int windowTrailing = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t current = floatBits(values[i]);
+        uint32_t diff = current ^ previous;
+        previous = current;
+        if (diff == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+        writer.write(1, 1);
+        int leading = leadingZeros(diff);
+        int trailing = trailingZeros(diff);
+        if (windowLeading >= 0 && leading >= windowLeading && trailing >= windowTrailing) {
+            writer.write(0, 1);
+            writer.write(diff >> windowTrailing, 32 - windowLeading - windowTrailing);
+            continue;
+        }
+        int length = 32 - leading - trailing;
+        writer.write(1, 1);
+        writer.write(static_cast<uint64_t>(leading), 5);
+        writer.write(static_cast<uint64_t>(length - 1), 5);
+        writer.write(diff >> trailing, length);
+        windowLeading = leading;
+        windowTrailing = trailing;
+    }
+}
+
+bool readFloatColumn(BitReader& reader, std::vector<float>& values, uint32_t count) {
+    values.resize(count);
+    uint32_t previous = static_cast<uint32_t>(reader.read(32));
+    values[0] = bitsToFloat(previous);
+    int windowLeading = 0;
+    int windowTrailing = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        if (reader.read(1) != 0) {
+            if (reader.read(1) != 0) {
+                windowLeading = static_cast<int>(reader.read(5));
+                int length = static_cast<int>(reader.read(5)) + 1;
+                windowTrailing = 32 - windowLeading - length;
+                if (windowTrailing < 0) {
+                    return false;
+                }
+            }
+            int length = 32 - windowLeading - windowTrailing;
+            previous ^= static_cast<uint32_t>(reader.read(length)) << windowTrailing;
+        }
+        values[i] = bitsToFloat(previous);
+    }
+    return true;
+}
+
+void writeRunColumn(BitWriter& writer, const uint8_t* values, uint32_t count, int lengthBits) {
+    uint32_t start = 0;
+    for (uint32_t i = 1; i <= count; i++) {
+        if (i == count || values[i] != values[start]) {
+            writer.write(values[start], 8);
+            writer.write(i - start - 1, lengthBits);
+            start = i;
+        }
+    }
+}
+
+void readRunColumn(BitReader& reader, std::vector<uint8_t>& values, uint32_t count, int lengthBits) {
+    values.clear();
+    while (values.size() < count && reader.good()) {
+        uint8_t value = static_cast<uint8_t>(reader.read(8));
+        uint64_t length = reader.read(lengthBits) + 1;
+        if (values.size() + length > count) {
+            values.clear();
+            return;
+        }
+        values.insert(values.end(), length, value);
+    }
+}
+
+void appendNumber(std::string& line, float value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    line.append(buffer, result.ptr);
+}
+
+}
+
+TelemetryRecorder::TelemetryRecorder(uint32_t samplesPerChunk)
+    : chunkSamples(samplesPerChunk > 1 ? samplesPerChunk : 2),
+      retentionBytes(0),
+      timeColumn(chunkSamples),
+      waterColumn(chunkSamples),
+      rpmColumn(chunkSamples),
+      stateColumn(chunkSamples),
+      flagsColumn(chunkSamples),
+      open(0),
+      sealedBytes(0),
+      sealedSamples(0),
+      droppedSamples(0) {}
+
+TelemetryChunk TelemetryRecorder::encodeOpen() const {
+    TelemetryChunk chunk;
+    chunk.samples = open;
+    if (open == 0) {
+        return chunk;
+    }
+
+    chunk.bytes.reserve(64 + open);
+    BitWriter writer(chunk.bytes);
+    int lengthBits = bitWidth(open - 1);
+    const double* times = timeColumn.data();
+    const int32_t* rpms = rpmColumn.data();
+    writeIntColumn(writer, [times](uint32_t i) { return static_cast<int64_t>(std::floor(times[i] * 1e6 + 0.5)); }, open);
+    writeFloatColumn(writer, waterColumn.data(), open);
+    writeIntColumn(writer, [rpms](uint32_t i) { return static_cast<int64_t>(rpms[i]); }, open);
+    writeRunColumn(writer, stateColumn.data(), open, lengthBits);
+    writeRunColumn(writer, flagsColumn.data(), open, lengthBits);
+    writer.finish();
+    chunk.bytes.shrink_to_fit();
+    return chunk;
+}
+
+bool TelemetryRecorder::decodeChunk(const TelemetryChunk& chunk, std::vector<TelemetryRow>& rows) {
+    if (chunk.samples == 0) {
+        return true;
+    }
+    uint32_t count = chunk.samples;
+    int lengthBits = bitWidth(count - 1);
+    BitReader reader(chunk.bytes);
+
+    std::vector<int64_t> micros;
+    std::vector<float> water;
+    std::vector<int64_t> rpm;
+    std::vector<uint8_t> states;
+    std::vector<uint8_t> flags;
+    readIntColumn(reader, micros, count);
+    bool floatsValid = readFloatColumn(reader, water, count);
+    readIntColumn(reader, rpm, count);
+    readRunColumn(reader, states, count, lengthBits);
+    readRunColumn(reader, flags, count, lengthBits);
+    if (!floatsValid || !reader.good() || states.size() != count || flags.size() != count) {
+        return false;
+    }
+
+    rows.reserve(rows.size() + count);
+    for (uint32_t i = 0; i < count; i++) {
+        TelemetryRow row;
+        row.time = static_cast<double>(micros[i]) / 1e6;
+        row.sample.state = static_cast<State>(states[i]);
+        row.sample.doorStatus = static_cast<DoorStatus>(flags[i] & 0x3);
+        row.sample.direction = static_cast<Direction>((flags[i] >> 2) & 0x3);
+        row.sample.fillValveOpen = (flags[i] & 0x10) != 0;
+        row.sample.drainValveOpen = (flags[i] & 0x20) != 0;
+        row.sample.waterLevel = water[i];
+        row.sample.motorRPM = static_cast<int>(rpm[i]);
+        rows.push_back(row);
+    }
+    return true;
+}
+
+void TelemetryRecorder::seal() {
+    TelemetryChunk chunk = encodeOpen();
+    open = 0;
+    if (chunk.samples == 0) {
+        return;
+    }
+    sealedBytes += chunk.bytes.size();
+    sealedSamples += chunk.samples;
+    chunks.push_back(std::move(chunk));
+    enforceRetention();
+}
+
+void TelemetryRecorder::enforceRetention() {
+    if (retentionBytes == 0) {
+        return;
+    }
+    while (sealedBytes > retentionBytes && !chunks.empty()) {
+        sealedBytes -= chunks.front().bytes.size();
+        sealedSamples -= chunks.front().samples;
+        droppedSamples += chunks.front().samples;
+        chunks.pop_front();
+    }
+}
+
+void TelemetryRecorder::flush() {
+    seal();
+}
+
+void TelemetryRecorder::clear() {
+    chunks.clear();
+    open = 0;
+    sealedBytes = 0;
+    sealedSamples = 0;
+    droppedSamples = 0;
+}
+
+void TelemetryRecorder::setRetentionBytes(size_t bytes) {
+    retentionBytes = bytes;
+    enforceRetention();
+}
+
+uint32_t TelemetryRecorder::getChunkSamples() const {
+    return chunkSamples;
+}
+
+size_t TelemetryRecorder::getChunkCount() const {
+    return chunks.size();
+}
+
+uint64_t TelemetryRecorder::getSampleCount() const {
+    return sealedSamples + open;
+}
+
+uint64_t TelemetryRecorder::getDroppedSamples() const {
+    return droppedSamples;
+}
+
+size_t TelemetryRecorder::getCompressedBytes() const {
+    return sealedBytes;
+}
+
+size_t TelemetryRecorder::getMemoryBytes() const {
+    size_t columns = chunkSamples * (sizeof(double) + sizeof(float) + sizeof(int32_t) + 2 * sizeof(uint8_t));
+    return sealedBytes + chunks.size() * sizeof(TelemetryChunk) + columns;
+}
+
+bool TelemetryRecorder::decode(std::vector<TelemetryRow>& rows) const {
+    rows.clear();
+    for (const TelemetryChunk& chunk : chunks) {
+        if (!decodeChunk(chunk, rows)) {
+            return false;
+        }
+    }
+    return decodeChunk(encodeOpen(), rows);
+}
+
+bool TelemetryRecorder::writeCsv(std::ostream& out) const {
+    std::vector<TelemetryRow> rows;
+    if (!decode(rows)) {
+        return false;
+    }
+
+    out << "time,state,door,direction,fill_valve,drain_valve,water_level,rpm\n";
+    std::string line;
+    char time[32];
+    for (const TelemetryRow& row : rows) {
+        const SensorSample& sample = row.sample;
+        std::snprintf(time, sizeof(time), "%.6f", row.time);
+        line.assign(time);
+        line += ',';
+        line += stateToString(sample.state);
+        line += ',';
+        line += doorStatusToString(sample.doorStatus);
+        line += ',';
+        line += directionToString(sample.direction);
+        line += sample.fillValveOpen ? ",1" : ",0";
+        line += sample.drainValveOpen ? ",1," : ",0,";
+        appendNumber(line, sample.waterLevel);
+        line += ',';
+        line += std::to_string(sample.motorRPM);
+        line += '\n';
+        out << line;
+    }
+    return static_cast<bool>(out);
+}
+
+void TelemetryRecorder::saveBinary(std::vector<uint8_t>& buffer) const {
+    TelemetryChunk tail = encodeOpen();
+    uint32_t count = static_cast<uint32_t>(chunks.size() + (tail.samples > 0 ? 1 : 0));
+
+    buffer.clear();
+    buffer.reserve(sealedBytes + tail.bytes.size() + 16 + count * 8);
+    CheckpointWriter writer(buffer);
+    writer.writeHeader(CheckpointKind::Telemetry, count);
+    writer.write<uint32_t>(chunkSamples);
+    auto writeChunk = [&writer](const TelemetryChunk& chunk) {
+        writer.write<uint32_t>(chunk.samples);
+        writer.write<uint32_t>(static_cast<uint32_t>(chunk.bytes.size()));
+        writer.writeBytes(chunk.bytes.data(), chunk.bytes.size());
+    };
+    for (const TelemetryChunk& chunk : chunks) {
+        writeChunk(chunk);
+    }
+    if (tail.samples > 0) {
+        writeChunk(tail);
+    }
+}
+
+bool TelemetryRecorder::loadBinary(const std::vector<uint8_t>& buffer) {
+    CheckpointReader reader(buffer);
+    uint32_t count = 0;
+    uint32_t samplesPerChunk = 0;
+    if (!reader.readHeader(CheckpointKind::Telemetry, count) || !reader.read(samplesPerChunk) ||
+        samplesPerChunk < 2) {
+        return false;
+    }
+
+    std::deque<TelemetryChunk> loaded;
+    size_t bytes = 0;
+    uint64_t samples = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        TelemetryChunk chunk;
+        uint32_t size = 0;
+        if (!reader.read(chunk.samples) || !reader.read(size) || !reader.readBytes(chunk.bytes, size) ||
+            chunk.samples == 0 || chunk.samples > samplesPerChunk) {
+            return false;
+        }
+        bytes += size;
+        samples += chunk.samples;
+        loaded.push_back(std::move(chunk));
+    }
+
+    size_t retention = retentionBytes;
+    *this = TelemetryRecorder(samplesPerChunk);
+    retentionBytes = retention;
+    chunks = std::move(loaded);
+    sealedBytes = bytes;
+    sealedSamples = samples;
+    enforceRetention();
+    return true;
+}
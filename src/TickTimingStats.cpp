@@ -0,0 +1,92 @@
+#include "TickTimingStats.hpp"
+#include <cmath>
+
+TickTimingStats::TickTimingStats(std::chrono::nanoseconds period)
+    : period(period) {
+    reset();
+}
+
+void TickTimingStats::reset() {
+    firstTick = std::chrono::steady_clock::time_point();
+    lastTick = firstTick;
+    ticks = 0;
+    periods = 0;
+    samples = 0;
+    totalJitterMicros = 0.0;
+    maxJitterMicros = 0.0;
+    histogram.fill(0);
+}
+
+void TickTimingStats::recordTick(std::chrono::steady_clock::time_point now, uint64_t elapsedPeriods) {
+    if (ticks == 0) {
+        firstTick = now;
+        lastTick = now;
+        ticks = 1;
+        return;
+    }
+
+    double interval = std::chrono::duration<double, std::micro>(now - lastTick).count();
+    double nominal = std::chrono::duration<double, std::micro>(period).count() *
+                     static_cast<double>(elapsedPeriods);
+    double jitter = std::fabs(interval - nominal);
+
+    totalJitterMicros += jitter;
+    if (jitter > maxJitterMicros) {
+        maxJitterMicros = jitter;
+    }
+    size_t bucket = static_cast<size_t>(jitter / BUCKET_MICROS);
+    histogram[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT]++;
+
+    lastTick = now;
+    ticks++;
+    periods += elapsedPeriods;
+    samples++;
+}
+
+std::chrono::nanoseconds TickTimingStats::getPeriod() const {
+    return period;
+}
+
+uint64_t TickTimingStats::getTickCount() const {
+    return ticks;
+}
+
+uint64_t TickTimingStats::getPeriodCount() const {
+    return periods;
+}
+
+double TickTimingStats::getMeanJitterMicros() const {
+    return samples > 0 ? totalJitterMicros / static_cast<double>(samples) : 0.0;
+}
+
+double TickTimingStats::getMaxJitterMicros() const {
+    return maxJitterMicros;
+}
+
+// Resolution is one bucket; samples past the last bucket report the maximum.
+double TickTimingStats::getPercentileJitterMicros(double percentile) const {
+    if (samples == 0) {
+        return 0.0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(samples)));
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += histogram[i];
+        if (seen >= target) {
+            return std::fmin((static_cast<double>(i) + 1.0) * BUCKET_MICROS, maxJitterMicros);
+        }
+    }
+    return maxJitterMicros;
+}
+
+double TickTimingStats::getDriftMicros() const {
+    if (ticks < 2) {
+        return 0.0;
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(lastTick - firstTick).count();
+    double ideal = std::chrono::duration<double, std::micro>(period).count() * static_cast<double>(periods);
+    return elapsed - ideal;
+}
@@ -0,0 +1,217 @@
+#include "TimingWheel.hpp"
+
+#include <cmath>
+
+TimingWheel::TimingWheel(float resolutionSeconds)
+    : resolution(resolutionSeconds > 0.0f ? resolutionSeconds : 0.1f),
+      carry(0.0),
+      now(0),
+      freeHead(NIL),
+      armedCount(0),
+      expiredCount(0) {
+    heads.fill(NIL);
+}
+
+void TimingWheel::link(uint32_t index, uint16_t list) {
+    Node& node = nodes[index];
+    node.list = list;
+    node.prev = NIL;
+    node.next = heads[list];
+    if (node.next != NIL) {
+        nodes[node.next].prev = index;
+    }
+    heads[list] = index;
+}
+
+void TimingWheel::unlink(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.prev != NIL) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.list] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes[node.next].prev = node.prev;
+    }
+}
+
+// Level l holds timers due within SLOTS^(l+1) ticks, bucketed by bits
+// [l * SLOT_BITS, (l + 1) * SLOT_BITS) of their expiry.
+void TimingWheel::place(uint32_t index) {
+    uint64_t expiry = nodes[index].expiry;
+    uint64_t distance = expiry - now;
+    size_t level = 0;
+    while (level < LEVELS - 1 && distance >= (uint64_t(1) << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+    size_t slot = (expiry >> (level * SLOT_BITS)) & (SLOTS - 1);
+    link(index, static_cast<uint16_t>(level * SLOTS + slot));
+}
+
+void TimingWheel::cascade(size_t level) {
+    size_t list = level * SLOTS + ((now >> (level * SLOT_BITS)) & (SLOTS - 1));
+    uint32_t index = heads[list];
+    heads[list] = NIL;
+    while (index != NIL) {
+        uint32_t next = nodes[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+void TimingWheel::advanceTick() {
+    now++;
+    if ((now & (SLOTS - 1)) == 0) {
+        size_t top = 1;
+        while (top < LEVELS - 1 && ((now >> (top * SLOT_BITS)) & (SLOTS - 1)) == 0) {
+            top++;
+        }
+        for (size_t level = top; level >= 1; level--) {
+            cascade(level);
+        }
+    }
+
+    size_t slot = now & (SLOTS - 1);
+    uint32_t index = heads[slot];
+    if (index == NIL) {
+        return;
+    }
+    // Everything in the slot is due now. Move it to its own list first so
+    // listeners can arm and cancel while it is being fired.
+    heads[slot] = NIL;
+    heads[EXPIRING] = index;
+    for (uint32_t i = index; i != NIL; i = nodes[i].next) {
+        nodes[i].list = EXPIRING;
+    }
+    while (heads[EXPIRING] != NIL) {
+        uint32_t due = heads[EXPIRING];
+        unlink(due);
+        Node& node = nodes[due];
+        TimerListener* listener = node.listener;
+        uint32_t tag = node.tag;
+        node.generation++;
+        node.list = UNUSED;
+        node.listener = nullptr;
+        node.next = freeHead;
+        freeHead = due;
+        armedCount--;
+        expiredCount++;
+        if (listener) {
+            listener->onTimerExpired(tag);
+        }
+    }
+}
+
+TimingWheel::TimerId TimingWheel::arm(float delaySeconds, TimerListener* listener, uint32_t tag) {
+    double ticks = std::ceil((static_cast<double>(delaySeconds) + carry) / resolution);
+    return armTicks(ticks < 1.0 ? 1 : (ticks > static_cast<double>(MAX_TICKS) ? MAX_TICKS : static_cast<uint64_t>(ticks)),
+                    listener, tag);
+}
+
+TimingWheel::TimerId TimingWheel::armTicks(uint64_t ticks, TimerListener* listener, uint32_t tag) {
+    if (ticks < 1) {
+        ticks = 1;
+    }
+    if (ticks > MAX_TICKS) {
+        ticks = MAX_TICKS;
+    }
+
+    uint32_t index;
+    if (freeHead != NIL) {
+        index = freeHead;
+        freeHead = nodes[index].next;
+    } else {
+        index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{0, nullptr, NIL, NIL, 1, 0, UNUSED});
+    }
+    Node& node = nodes[index];
+    node.expiry = now + ticks;
+    node.listener = listener;
+    node.tag = tag;
+    place(index);
+    armedCount++;
+    return (static_cast<TimerId>(node.generation) << 32) | (static_cast<TimerId>(index) + 1);
+}
+
+bool TimingWheel::isArmed(TimerId id) const {
+    if (id == NO_TIMER) {
+        return false;
+    }
+    uint64_t index = (id & 0xFFFFFFFF) - 1;
+    return index < nodes.size() && nodes[index].generation == static_cast<uint32_t>(id >> 32) &&
+           nodes[index].list != UNUSED;
+}
+
+bool TimingWheel::cancel(TimerId id) {
+    if (!isArmed(id)) {
+        return false;
+    }
+    uint32_t index = static_cast<uint32_t>((id & 0xFFFFFFFF) - 1);
+    unlink(index);
+    Node& node = nodes[index];
+    node.generation++;
+    node.list = UNUSED;
+    node.listener = nullptr;
+    node.next = freeHead;
+    freeHead = index;
+    armedCount--;
+    return true;
+}
+
+float TimingWheel::getRemaining(TimerId id) const {
+    if (!isArmed(id)) {
+        return 0.0f;
+    }
+    const Node& node = nodes[(id & 0xFFFFFFFF) - 1];
+    double remaining = static_cast<double>(node.expiry - now) * resolution - carry;
+    return remaining > 0.0 ? static_cast<float>(remaining) : 0.0f;
+}
+
+size_t TimingWheel::advance(float deltaSeconds) {
+    if (deltaSeconds <= 0.0f) {
+        return 0;
+    }
+    carry += deltaSeconds;
+    double whole = std::floor(carry / resolution);
+    carry -= whole * resolution;
+    if (carry < 0.0) {
+        carry = 0.0;
+    }
+    return advanceTicks(static_cast<uint64_t>(whole));
+}
+
+size_t TimingWheel::advanceTicks(uint64_t ticks) {
+    uint64_t before = expiredCount;
+    for (uint64_t t = 0; t < ticks; t++) {
+        if (armedCount == 0) {
+            now += ticks - t;
+            break;
+        }
+        advanceTick();
+    }
+    return static_cast<size_t>(expiredCount - before);
+}
+
+void TimingWheel::reserve(size_t timers) {
+    nodes.reserve(timers);
+}
+
+size_t TimingWheel::getArmedCount() const {
+    return armedCount;
+}
+
+uint64_t TimingWheel::getExpiredCount() const {
+    return expiredCount;
+}
+
+uint64_t TimingWheel::getNowTicks() const {
+    return now;
+}
+
+float TimingWheel::getResolution() const {
+    return resolution;
+}
+
+size_t TimingWheel::getMemoryBytes() const {
+    return sizeof(*this) + nodes.capacity() * sizeof(Node);
+}
@@ -0,0 +1,145 @@
+#include "WaterSupply.hpp"
+#include <cmath>
+
+WaterSupply::WaterSupply(float maxFlowRate, float staticPressure,
+                         float pipeResistance, float minPressure,
+                         float starvationTimeout)
+    : maxFlowRate(maxFlowRate),
+      staticPressure(staticPressure),
+      nominalPressure(staticPressure),
+      pipeResistance(pipeResistance),
+      minPressure(minPressure),
+      starvationTimeout(starvationTimeout),
+      currentPressure(staticPressure),
+      totalDemand(0.0f),
+      totalFlow(0.0f),
+      activeConsumers(0) {}
+
+size_t WaterSupply::registerConsumer() {
+    size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = demand.size();
+        demand.push_back(0.0f);
+        granted.push_back(0.0f);
+        starvedTime.push_back(0.0f);
+        starved.push_back(0);
+        inUse.push_back(0);
+    }
+    demand[slot] = 0.0f;
+    granted[slot] = 0.0f;
+    starvedTime[slot] = 0.0f;
+    starved[slot] = 0;
+    inUse[slot] = 1;
+    return slot;
+}
+
+void WaterSupply::releaseConsumer(size_t slot) {
+    if (slot >= inUse.size() || !inUse[slot]) {
+        return;
+    }
+    inUse[slot] = 0;
+    demand[slot] = 0.0f;
+    granted[slot] = 0.0f;
+    freeSlots.push_back(slot);
+}
+
+void WaterSupply::setDemand(size_t slot, float litersPerSecond) {
+    demand[slot] = (litersPerSecond > 0.0f) ? litersPerSecond : 0.0f;
+}
+
+float WaterSupply::getGrantedRate(size_t slot) const {
+    return granted[slot];
+}
+
+bool WaterSupply::isStarved(size_t slot) const {
+    return starved[slot] != 0;
+}
+
+// Each open inlet behaves like an orifice: q = d * sqrt(P / Pnom), while the
+// shared pipe loses k * Q^2 of head. Solving both for the common scale gives
+// s = sqrt(Pstatic / (Pnom + k * D^2)), which is then capped by the meter.
+void WaterSupply::update(float deltaTimeSeconds) {
+    const size_t count = demand.size();
+
+    float sum = 0.0f;
+    size_t active = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += demand[i];
+        active += (demand[i] > 0.0f) ? 1 : 0;
+    }
+
+    totalDemand = sum;
+    activeConsumers = active;
+
+    float scale = 1.0f;
+    if (sum > 0.0f) {
+        scale = std::sqrt(staticPressure / (nominalPressure + pipeResistance * sum * sum));
+        if (scale > 1.0f) {
+            scale = 1.0f;
+        }
+        if (sum * scale > maxFlowRate) {
+            scale = maxFlowRate / sum;
+        }
+        currentPressure = nominalPressure * scale * scale;
+    } else {
+        currentPressure = staticPressure;
+    }
+
+    totalFlow = sum * scale;
+    const bool lowPressure = currentPressure < minPressure;
+
+    for (size_t i = 0; i < count; ++i) {
+        granted[i] = demand[i] * scale;
+
+        if (demand[i] <= 0.0f) {
+            starvedTime[i] = 0.0f;
+            starved[i] = 0;
+        } else if (lowPressure) {
+            starvedTime[i] += deltaTimeSeconds;
+            if (starvedTime[i] >= starvationTimeout) {
+                starved[i] = 1;
+            }
+        } else {
+            starvedTime[i] = 0.0f;
+        }
+    }
+}
+
+float WaterSupply::getPressure() const {
+    return currentPressure;
+}
+
+float WaterSupply::getMinPressure() const {
+    return minPressure;
+}
+
+float WaterSupply::getTotalDemand() const {
+    return totalDemand;
+}
+
+float WaterSupply::getTotalFlow() const {
+    return totalFlow;
+}
+
+float WaterSupply::getMaxFlowRate() const {
+    return maxFlowRate;
+}
+
+size_t WaterSupply::getActiveConsumers() const {
+    return activeConsumers;
+}
+
+size_t WaterSupply::getConsumerCount() const {
+    return demand.size() - freeSlots.size();
+}
+
+bool WaterSupply::hasPressure() const {
+    return currentPressure >= minPressure;
+}
+
+void WaterSupply::setMaxFlowRate(float litersPerSecond) {
+    maxFlowRate = (litersPerSecond > 0.0f) ? litersPerSecond : 0.0f;
+}
@@ -1,4 +1,5 @@
 #include "WaterSystem.hpp"
+#include "WaterSupply.hpp"
 
 WaterSystem::WaterSystem()
     : currentLevel(0.0f),
@@ -10,33 +11,93 @@ WaterSystem::WaterSystem()
       inletValveOpen(false),
       drainValveOpen(false),
       lowThreshold(10.0f),
+      supply(nullptr),
+      supplySlot(0),
       eventCallback(nullptr) {}
 
+// A copy carries the water state but not the supply registration: the slot
+// belongs to the original, so the copy starts detached. Assignment keeps the
+// target's own registration and republishes its demand.
+WaterSystem::WaterSystem(const WaterSystem& other)
+    : currentLevel(other.currentLevel),
+      targetLevel(other.targetLevel),
+      reservoirLevel(other.reservoirLevel),
+      maxReservoir(other.maxReservoir),
+      fillRate(other.fillRate),
+      drainRate(other.drainRate),
+      inletValveOpen(other.inletValveOpen),
+      drainValveOpen(other.drainValveOpen),
+      lowThreshold(other.lowThreshold),
+      supply(nullptr),
+      supplySlot(0),
+      eventCallback(other.eventCallback) {}
+
+WaterSystem& WaterSystem::operator=(const WaterSystem& other) {
+    if (this != &other) {
+        currentLevel = other.currentLevel;
+        targetLevel = other.targetLevel;
+        reservoirLevel = other.reservoirLevel;
+        maxReservoir = other.maxReservoir;
+        fillRate = other.fillRate;
+        drainRate = other.drainRate;
+        inletValveOpen = other.inletValveOpen;
+        drainValveOpen = other.drainValveOpen;
+        lowThreshold = other.lowThreshold;
+        eventCallback = other.eventCallback;
+        publishDemand();
+    }
+    return *this;
+}
+
 void WaterSystem::setEventCallback(std::function<void(EventType)> callback) {
     eventCallback = callback;
 }
 
+void WaterSystem::attachSupply(WaterSupply* sharedSupply) {
+    detachSupply();
+    if (sharedSupply) {
+        supply = sharedSupply;
+        supplySlot = supply->registerConsumer();
+        publishDemand();
+    }
+}
+
+void WaterSystem::detachSupply() {
+    if (supply) {
+        supply->releaseConsumer(supplySlot);
+        supply = nullptr;
+        supplySlot = 0;
+    }
+}
+
+bool WaterSystem::hasSupply() const {
+    return supply != nullptr;
+}
+
+void WaterSystem::publishDemand() {
+    if (supply) {
+        bool wantsWater = inletValveOpen && currentLevel < targetLevel;
+        supply->setDemand(supplySlot, wantsWater ? fillRate : 0.0f);
+    }
+}
+
 void WaterSystem::startFilling(float targetLiters) {
-    if (reservoirLevel < lowThreshold) {
-        if (!autoReplenish()) {
-            if (eventCallback) {
-                eventCallback(EventType::FAULT_WATER_UNAVAILABLE);
-            }
-            return;
+    startFilling(targetLiters, [this](EventType type) {
+        if (eventCallback) {
+            eventCallback(type);
         }
-    }
-    targetLevel = targetLiters;
-    inletValveOpen = true;
-    drainValveOpen = false;
+    });
 }
 
 void WaterSystem::stopFilling() {
     inletValveOpen = false;
+    publishDemand();
 }
 
 void WaterSystem::startDraining() {
     drainValveOpen = true;
     inletValveOpen = false;
+    publishDemand();
 }
 
 void WaterSystem::stopDraining() {
@@ -44,45 +105,21 @@ void WaterSystem::stopDraining() {
 }
 
 void WaterSystem::update(float deltaTimeSeconds) {
-    if (inletValveOpen && currentLevel < targetLevel) {
-        float fillAmount = fillRate * deltaTimeSeconds;
-        float available = reservoirLevel;
-
-        if (fillAmount > available) {
-            fillAmount = available;
-        }
-
-        currentLevel += fillAmount;
-        reservoirLevel -= fillAmount;
-
-        if (currentLevel >= targetLevel) {
-            currentLevel = targetLevel;
-            inletValveOpen = false;
-            if (eventCallback) {
-                eventCallback(EventType::SYS_WATER_LEVEL_REACHED);
-            }
-        }
-
-        if (reservoirLevel < lowThreshold) {
-            autoReplenish();
-        }
-    }
-
-    if (drainValveOpen && currentLevel > 0) {
-        float drainAmount = drainRate * deltaTimeSeconds;
-        currentLevel -= drainAmount;
+    update(toSimTime(deltaTimeSeconds));
+}
 
-        if (currentLevel <= 0) {
-            currentLevel = 0;
-            drainValveOpen = false;
-            if (eventCallback) {
-                eventCallback(EventType::SYS_DRAIN_COMPLETE);
-            }
+void WaterSystem::update(SimTime deltaTime) {
+    update(deltaTime, [this](EventType type) {
+        if (eventCallback) {
+            eventCallback(type);
         }
-    }
+    });
 }
 
 bool WaterSystem::checkReservoir() const {
+    if (supply) {
+        return supply->hasPressure();
+    }
     return reservoirLevel >= lowThreshold;
 }
 
@@ -125,10 +162,38 @@ void WaterSystem::setReservoirLevel(float level) {
     }
 }
 
+void WaterSystem::saveState(CheckpointWriter& writer) const {
+    writer.write<float>(currentLevel);
+    writer.write<float>(targetLevel);
+    writer.write<float>(reservoirLevel);
+    writer.write<uint8_t>(inletValveOpen ? 1 : 0);
+    writer.write<uint8_t>(drainValveOpen ? 1 : 0);
+}
+
+bool WaterSystem::restoreState(CheckpointReader& reader) {
+    float level = 0.0f;
+    float target = 0.0f;
+    float reservoir = 0.0f;
+    uint8_t inlet = 0;
+    uint8_t drain = 0;
+    if (!reader.read(level) || !reader.read(target) || !reader.read(reservoir) ||
+        !reader.read(inlet) || !reader.read(drain)) {
+        return false;
+    }
+    currentLevel = level;
+    targetLevel = target;
+    reservoirLevel = reservoir;
+    inletValveOpen = inlet != 0;
+    drainValveOpen = drain != 0;
+    publishDemand();
+    return true;
+}
+
 void WaterSystem::reset() {
     currentLevel = 0.0f;
     targetLevel = 0.0f;
     inletValveOpen = false;
     drainValveOpen = false;
     reservoirLevel = maxReservoir;
+    publishDemand();
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "StateExplorer.hpp"
+#include "ConfigManager.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Exhaustive safety check of the machine model.
+//
+//   explore_states [config] [--threads n] [--max-states n] [--max-depth n]
+//
+// Exits non-zero if an invariant or reachability property fails or the
+// search was cut short.
+
+int main(int argc, char* argv[]) {
+    std::string configPath;
+    unsigned threads = 0;
+    size_t maxStates = 0;
+    int maxDepth = -1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--threads" && i + 1 < argc) {
+                threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--max-states" && i + 1 < argc) {
+                maxStates = std::stoul(argv[++i]);
+            } else if (arg == "--max-depth" && i + 1 < argc) {
+                maxDepth = std::stoi(argv[++i]);
+            } else {
+                configPath = arg;
+            }
+        } catch (...) {
+            std::cerr << "Invalid value for " << arg << ".\n";
+            return 1;
+        }
+    }
+
+    std::shared_ptr<const ConfigManager> modes = MachineCore::defaultModes();
+    if (!configPath.empty()) {
+        auto loaded = std::make_shared<ConfigManager>();
+        loaded->loadConfig(configPath);
+        modes = loaded;
+    }
+
+    StateExplorer explorer(modes);
+    explorer.addDefaultProperties();
+    if (threads > 0) {
+        explorer.setThreadCount(threads);
+    }
+    if (maxStates > 0) {
+        explorer.setMaxStates(maxStates);
+    }
+    if (maxDepth >= 0) {
+        explorer.setMaxDepth(maxDepth);
+    }
+
+    ExplorationResult result = explorer.explore();
+
+    std::cout << "actions      " << explorer.getActions().size() << "\n"
+              << "states       " << result.states << "\n"
+              << "transitions  " << result.transitions << "\n"
+              << "depth        " << result.depth << "\n"
+              << "complete     " << (result.complete ? "yes" : "no (limit reached)") << "\n"
+              << "time         " << std::fixed << std::setprecision(3) << result.seconds << " s\n";
+
+    for (const ExplorerViolation& violation : result.violations) {
+        std::cout << "\nVIOLATION: " << violation.property << "\n"
+                  << "  reaches: " << violation.finalState << "\n";
+        for (size_t i = 0; i < violation.trace.size(); i++) {
+            std::cout << "  " << std::setw(3) << i + 1 << ". " << violation.trace[i].describe() << "\n";
+        }
+    }
+    if (result.violations.empty()) {
+        std::cout << "\nAll properties hold.\n";
+    }
+    return result.passed() ? 0 : 1;
+}
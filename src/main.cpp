@@ -1,13 +1,139 @@
 #include "WashingMachine.hpp"
 #include "CLI.hpp"
+#include "ScriptRunner.hpp"
+#include "ReactorShell.hpp"
+#include "ControlServer.hpp"
+#include "Fleet.hpp"
+#include "StatusBoard.hpp"
+#include "TelemetryRecorder.hpp"
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
+#ifdef __linux__
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+// Serves the control socket until SIGINT or SIGTERM, ticking the simulation
+// from the same reactor. Without --machines a single machine is exposed as
+// id 0. With a board name, every tick is also published to shared memory.
+static int runServer(WashingMachine& machine, const std::string& socketPath, size_t fleetSize,
+                     const std::string& boardName) {
+    std::unique_ptr<Fleet> fleet;
+    if (fleetSize > 0) {
+        fleet = std::make_unique<Fleet>(fleetSize);
+    } else {
+        machine.setOutput(nullptr);
+    }
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+    int signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    Reactor reactor;
+    PeriodicTimer timer(std::chrono::milliseconds(50));
+    ControlServer server = fleet ? ControlServer(reactor, *fleet) : ControlServer(reactor, machine);
+    if (signalFd < 0 || !reactor.isOpen() || !timer.isOpen() || !server.listen(socketPath)) {
+        std::cerr << "Failed to listen on " << socketPath << ".\n";
+        return 1;
+    }
+
+    StatusBoard board;
+    if (!boardName.empty() && !board.create(boardName, static_cast<uint32_t>(fleet ? fleet->size() : 1))) {
+        std::cerr << "Failed to create status board " << boardName << ".\n";
+        return 1;
+    }
+    uint64_t tickCount = 0;
+
+    reactor.add(signalFd, EPOLLIN, [&](uint32_t) { reactor.stop(); });
+    reactor.add(timer.getFd(), EPOLLIN, [&](uint32_t) {
+        uint64_t expirations = timer.readExpirations();
+        if (expirations == 0) {
+            return;
+        }
+        std::chrono::duration<float> step = timer.getPeriod() * expirations;
+        tickCount++;
+        if (fleet) {
+            fleet->tick(step.count());
+            board.publish(*fleet, tickCount);
+        } else {
+            machine.tick(step.count());
+            board.publish(0, machine.getStatus(), tickCount);
+            board.commit(tickCount);
+        }
+        server.publishStatus();
+    });
+
+    std::cout << "Serving " << (fleet ? fleet->size() : 1) << " machine(s) on " << socketPath << "\n";
+    reactor.run();
+
+    server.close();
+    reactor.remove(timer.getFd());
+    reactor.remove(signalFd);
+    close(signalFd);
+    std::cout << "Handled " << server.getRequestCount() << " requests.\n";
+    return 0;
+}
+#endif
+
+// A path ending in .csv gets a text export, anything else the compressed
+// binary trace.
+static bool saveTelemetry(const TelemetryRecorder& recorder, const std::string& path) {
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        std::ofstream file(path);
+        return file && recorder.writeCsv(file);
+    }
+    std::vector<uint8_t> buffer;
+    recorder.saveBinary(buffer);
+    return writeCheckpointFile(path, buffer);
+}
+
 int main(int argc, char* argv[]) {
-    std::string configPath = "config/wash_modes.json";
+    // Empty runs on the built-in modes; a path loads that file instead.
+    std::string configPath;
+    std::string scriptPath;
+    float step = 0.1f;
+    std::string socketPath;
+    std::string boardName;
+    std::string telemetryPath;
+    size_t fleetSize = 0;
+    bool reactorMode = false;
 
-    if (argc > 1) {
-        configPath = argv[1];
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--script" && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        } else if (arg == "--status-board" && i + 1 < argc) {
+            boardName = argv[++i];
+        } else if (arg == "--machines" && i + 1 < argc) {
+            try {
+                fleetSize = std::stoul(argv[++i]);
+            } catch (...) {
+                std::cerr << "Invalid machine count.\n";
+                return 1;
+            }
+        } else if (arg == "--reactor") {
+            reactorMode = true;
+        } else if (arg == "--step" && i + 1 < argc) {
+            try {
+                step = std::stof(argv[++i]);
+            } catch (...) {
+                std::cerr << "Invalid step value.\n";
+                return 1;
+            }
+        } else {
+            configPath = arg;
+        }
     }
 
     WashingMachine machine;
@@ -17,9 +143,53 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    machine.run();
+    if (!scriptPath.empty()) {
+        ScriptRunner runner(machine, std::cout);
+        runner.setStep(step);
+        TelemetryRecorder telemetry;
+        if (!telemetryPath.empty()) {
+            runner.setTelemetry(&telemetry);
+        }
+        ScriptResult result = runner.runFile(scriptPath);
+        machine.shutdown();
+        if (!telemetryPath.empty() && !saveTelemetry(telemetry, telemetryPath)) {
+            std::cerr << "Failed to write telemetry to " << telemetryPath << ".\n";
+            return 1;
+        }
+        return result.passed() ? 0 : 1;
+    }
+
+    if (!socketPath.empty()) {
+#ifdef __linux__
+        int status = runServer(machine, socketPath, fleetSize, boardName);
+        machine.shutdown();
+        return status;
+#else
+        std::cerr << "The control server requires Linux.\n";
+        return 1;
+#endif
+    }
 
     CLI cli(machine);
+
+    if (reactorMode) {
+#ifdef __linux__
+        cli.printWelcome();
+        ReactorShell shell(machine, cli, STDIN_FILENO);
+        if (!shell.run()) {
+            std::cerr << "Failed to start reactor.\n";
+            return 1;
+        }
+        std::cout << "Shutting down simulator...\n";
+        machine.shutdown();
+        std::cout << "Goodbye!\n";
+        return 0;
+#else
+        std::cerr << "Reactor mode requires Linux; using the threaded loop.\n";
+#endif
+    }
+
+    machine.run();
     cli.start();
 
     machine.shutdown();
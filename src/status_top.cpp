@@ -0,0 +1,140 @@
+#include "StatusBoard.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// top-style viewer for a status board published by `washing_machine --serve
+// ... --status-board <name>`.
+//
+//   status_top <name> [--interval ms] [--rows n] [--once]
+//
+// Rows list the busiest machines first: faults, then active cycles by
+// progress.
+
+namespace {
+
+constexpr size_t STATE_COUNT = static_cast<size_t>(State::Fault) + 1;
+
+int rowRank(const StatusRecord& record) {
+    State state = static_cast<State>(record.state);
+    if (state == State::Fault || state == State::EmergencyStop) {
+        return 0;
+    }
+    if (state >= State::Filling && state <= State::Draining) {
+        return 1;
+    }
+    if (state == State::Paused) {
+        return 2;
+    }
+    return 3;
+}
+
+void printFrame(const StatusBoardReader& reader, std::vector<StatusRecord>& records, size_t rows, bool clear) {
+    auto start = std::chrono::steady_clock::now();
+    size_t count = reader.scan(records);
+    double scanMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::array<size_t, STATE_COUNT> perState{};
+    for (const StatusRecord& record : records) {
+        if (record.state < STATE_COUNT) {
+            perState[record.state]++;
+        }
+    }
+
+    size_t shown = rows < count ? rows : count;
+    std::partial_sort(records.begin(), records.begin() + static_cast<long>(shown), records.end(),
+                      [](const StatusRecord& a, const StatusRecord& b) {
+                          int rankA = rowRank(a);
+                          int rankB = rowRank(b);
+                          if (rankA != rankB) {
+                              return rankA < rankB;
+                          }
+                          return a.progressPercent > b.progressPercent;
+                      });
+
+    if (clear) {
+        std::cout << "\033[H\033[2J";
+    }
+    std::cout << "machines " << count << "/" << reader.getCapacity()
+              << "  tick " << reader.getTick()
+              << "  publishes " << reader.getPublishCount()
+              << std::fixed << std::setprecision(1) << "  scan " << scanMicros << " us\n";
+    for (size_t i = 0; i < STATE_COUNT; i++) {
+        if (perState[i] > 0) {
+            std::cout << stateToString(static_cast<State>(i)) << " " << perState[i] << "  ";
+        }
+    }
+    std::cout << "\n\n";
+
+    std::cout << std::left << std::setw(8) << "ID" << std::setw(16) << "STATE" << std::setw(18) << "DOOR"
+              << std::right << std::setw(10) << "WATER L" << std::setw(8) << "RPM" << std::setw(8) << "PROG%"
+              << std::setw(8) << "LEFT" << "  FAULT\n";
+    for (size_t i = 0; i < shown; i++) {
+        const StatusRecord& record = records[i];
+        int remaining = record.remainingSeconds;
+        std::ostringstream left;
+        left << remaining / 60 << ":" << std::setw(2) << std::setfill('0') << remaining % 60;
+        std::cout << std::left << std::setw(8) << record.machineId
+                  << std::setw(16) << stateToString(static_cast<State>(record.state))
+                  << std::setw(18) << doorStatusToString(static_cast<DoorStatus>(record.door))
+                  << std::right << std::setprecision(1)
+                  << std::setw(10) << record.waterLevel
+                  << std::setw(8) << record.motorRPM
+                  << std::setw(8) << record.progressPercent
+                  << std::setw(8) << left.str()
+                  << "  " << faultCodeToString(static_cast<FaultCode>(record.fault)) << "\n";
+    }
+    std::cout << std::flush;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: status_top <name> [--interval ms] [--rows n] [--once]\n";
+        return 1;
+    }
+
+    std::string name = argv[1];
+    int intervalMillis = 1000;
+    size_t rows = 20;
+    bool once = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--interval" && i + 1 < argc) {
+                intervalMillis = std::stoi(argv[++i]);
+            } else if (arg == "--rows" && i + 1 < argc) {
+                rows = std::stoul(argv[++i]);
+            } else if (arg == "--once") {
+                once = true;
+            }
+        } catch (...) {
+            std::cerr << "Invalid value for " << arg << ".\n";
+            return 1;
+        }
+    }
+
+    StatusBoardReader reader;
+    if (!reader.open(name)) {
+        std::cerr << "No status board named " << name << ".\n";
+        return 1;
+    }
+
+    std::vector<StatusRecord> records;
+    records.reserve(reader.getCapacity());
+    do {
+        printFrame(reader, records, rows, !once);
+        if (!once) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMillis));
+        }
+    } while (!once);
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include "BatchStateMachine.hpp"
+#include "StateMachine.hpp"
+#include "CounterRng.hpp"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using MachineId = BatchStateMachine::MachineId;
+using ActionRecord = std::tuple<MachineId, bool, State, State>;
+
+constexpr size_t STATE_COUNT = BatchStateMachine::STATE_COUNT;
+
+// Every (state, event) pair plus "no event", laid out so the run crosses
+// 16- and 32-machine chunks and ends in a tail.
+void allPairs(std::vector<uint8_t>& states, std::vector<uint8_t>& events) {
+    for (int repeat = 0; repeat < 3; repeat++) {
+        for (size_t s = 0; s < STATE_COUNT; s++) {
+            for (size_t e = 0; e <= EVENT_TYPE_COUNT; e++) {
+                states.push_back(static_cast<uint8_t>(s));
+                events.push_back(e == EVENT_TYPE_COUNT ? BatchStateMachine::NO_EVENT : static_cast<uint8_t>(e));
+            }
+        }
+    }
+    states.resize(states.size() + 5, static_cast<uint8_t>(State::Washing));
+    events.resize(events.size() + 5, static_cast<uint8_t>(EventType::SYS_WASH_COMPLETE));
+}
+
+void registerRecorders(BatchStateMachine& batch, std::vector<ActionRecord>& log) {
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        batch.registerOnExit(static_cast<State>(s), [&log](MachineId id, State from, State to) {
+            log.emplace_back(id, false, from, to);
+        });
+        batch.registerOnEnter(static_cast<State>(s), [&log](MachineId id, State to, State from) {
+            log.emplace_back(id, true, to, from);
+        });
+    }
+}
+
+void registerRecorders(StateMachine& machine, MachineId id, std::vector<ActionRecord>& log) {
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        machine.registerOnExit(static_cast<State>(s), [&log, id](State from, State to) {
+            log.emplace_back(id, false, from, to);
+        });
+        machine.registerOnEnter(static_cast<State>(s), [&log, id](State to, State from) {
+            log.emplace_back(id, true, to, from);
+        });
+    }
+}
+
+}
+
+TEST(BatchStateMachineTest, KernelMatchesLookupForEveryPair) {
+    std::vector<uint8_t> states;
+    std::vector<uint8_t> events;
+    allPairs(states, events);
+    size_t count = states.size();
+
+    std::vector<uint8_t> scalarStates = states;
+    std::vector<uint8_t> scalarEvents = events;
+    std::vector<MachineId> changed(count);
+    std::vector<MachineId> scalarChanged(count);
+    std::vector<uint8_t> previous(count);
+    std::vector<uint8_t> scalarPrevious(count);
+
+    std::vector<uint8_t> kernelStates = states;
+    std::vector<uint8_t> kernelEvents = events;
+    size_t fired = BatchStateMachine::transitionKernel(kernelStates.data(), kernelEvents.data(), count,
+                                                       changed.data(), previous.data());
+    size_t scalarFired = BatchStateMachine::transitionScalar(scalarStates.data(), scalarEvents.data(), count,
+                                                             scalarChanged.data(), scalarPrevious.data());
+
+    std::vector<MachineId> expected;
+    for (size_t i = 0; i < count; i++) {
+        State next = static_cast<State>(states[i]);
+        if (events[i] != BatchStateMachine::NO_EVENT &&
+            StateMachine::lookup(static_cast<State>(states[i]), static_cast<EventType>(events[i]), next)) {
+            expected.push_back(static_cast<MachineId>(i));
+        }
+        EXPECT_EQ(kernelStates[i], static_cast<uint8_t>(next)) << "machine " << i;
+        EXPECT_EQ(scalarStates[i], static_cast<uint8_t>(next)) << "machine " << i;
+        EXPECT_EQ(kernelEvents[i], BatchStateMachine::NO_EVENT);
+        EXPECT_EQ(scalarEvents[i], BatchStateMachine::NO_EVENT);
+    }
+
+    ASSERT_EQ(fired, expected.size());
+    ASSERT_EQ(scalarFired, expected.size());
+    for (size_t k = 0; k < fired; k++) {
+        EXPECT_EQ(changed[k], expected[k]);
+        EXPECT_EQ(scalarChanged[k], expected[k]);
+        EXPECT_EQ(previous[k], states[expected[k]]);
+        EXPECT_EQ(scalarPrevious[k], states[expected[k]]);
+    }
+}
+
+TEST(BatchStateMachineTest, KernelIsKnown) {
+    std::string name = BatchStateMachine::kernelName();
+    EXPECT_TRUE(name == "avx2" || name == "sse2" || name == "scalar") << name;
+}
+
+TEST(BatchStateMachineTest, RandomFleetMatchesStateMachines) {
+    const size_t machines = 1003;
+    BatchStateMachine batch(machines);
+    std::vector<StateMachine> reference(machines);
+    std::vector<ActionRecord> batchLog;
+    std::vector<ActionRecord> referenceLog;
+    registerRecorders(batch, batchLog);
+    for (size_t id = 0; id < machines; id++) {
+        registerRecorders(reference[id], static_cast<MachineId>(id), referenceLog);
+    }
+
+    CounterRng rng(43, 0);
+    for (int tick = 0; tick < 400; tick++) {
+        // Event density sweeps from none to every machine so both the skip
+        // and the gather paths run.
+        uint64_t density = static_cast<uint64_t>(tick % 10);
+        std::vector<int> posted(machines, -1);
+        for (size_t id = 0; id < machines; id++) {
+            if (rng.next() % 10 < density) {
+                EventType event = static_cast<EventType>(rng.next() % EVENT_TYPE_COUNT);
+                ASSERT_TRUE(batch.post(static_cast<MachineId>(id), event));
+                posted[id] = static_cast<int>(event);
+            }
+        }
+
+        batchLog.clear();
+        referenceLog.clear();
+        size_t fired = batch.step();
+        size_t expected = 0;
+        for (size_t id = 0; id < machines; id++) {
+            if (posted[id] >= 0 && reference[id].transition(static_cast<EventType>(posted[id]))) {
+                ASSERT_LT(expected, fired);
+                EXPECT_EQ(batch.getChanged(expected), id);
+                EXPECT_EQ(batch.getPrevious(expected), reference[id].getPreviousState());
+                expected++;
+            }
+            ASSERT_EQ(batch.getState(static_cast<MachineId>(id)), reference[id].getCurrentState())
+                << "machine " << id << " tick " << tick;
+            EXPECT_FALSE(batch.hasEvent(static_cast<MachineId>(id)));
+        }
+        EXPECT_EQ(fired, expected);
+        EXPECT_EQ(batch.getChangedCount(), expected);
+        ASSERT_EQ(batchLog, referenceLog) << "tick " << tick;
+    }
+}
+
+TEST(BatchStateMachineTest, OneEventPerMachinePerStep) {
+    BatchStateMachine batch(4);
+    EXPECT_TRUE(batch.post(2, EventType::CMD_SELECT_MODE));
+    EXPECT_FALSE(batch.post(2, EventType::CMD_OPEN_DOOR));
+    EXPECT_TRUE(batch.hasEvent(2));
+    EXPECT_EQ(batch.step(), 1u);
+    EXPECT_EQ(batch.getState(2), State::Ready);
+    EXPECT_TRUE(batch.post(2, EventType::CMD_OPEN_DOOR));
+    EXPECT_EQ(batch.step(), 1u);
+    EXPECT_EQ(batch.getState(2), State::DoorOpen);
+}
+
+TEST(BatchStateMachineTest, ActionsRunForChangedMachinesOnlyAndPostForNextStep) {
+    BatchStateMachine batch(100);
+    int washingEntries = 0;
+    batch.registerOnEnter(State::Filling, [&batch](MachineId id, State, State) {
+        batch.post(id, EventType::SYS_WATER_LEVEL_REACHED);
+    });
+    batch.registerOnEnter(State::Washing, [&washingEntries](MachineId, State, State) {
+        washingEntries++;
+    });
+
+    batch.setState(40, State::Ready);
+    batch.setState(41, State::Ready);
+    EXPECT_EQ(batch.getState(40), State::Ready);
+    batch.post(40, EventType::CMD_START);
+    batch.post(41, EventType::CMD_RESUME);
+
+    EXPECT_EQ(batch.step(), 1u);
+    EXPECT_EQ(batch.getChanged(0), 40u);
+    EXPECT_EQ(batch.getPrevious(0), State::Ready);
+    EXPECT_EQ(batch.getState(41), State::Ready);
+    EXPECT_TRUE(batch.hasEvent(40));
+    EXPECT_EQ(washingEntries, 0);
+
+    EXPECT_EQ(batch.step(), 1u);
+    EXPECT_EQ(batch.getState(40), State::Washing);
+    EXPECT_EQ(washingEntries, 1);
+    EXPECT_EQ(batch.step(), 0u);
+}
+
+TEST(BatchStateMachineTest, ResizeKeepsStatesAndStartsNewMachinesIdle) {
+    BatchStateMachine batch(3);
+    batch.setState(1, State::Completed);
+    batch.resize(40);
+    EXPECT_EQ(batch.size(), 40u);
+    EXPECT_EQ(batch.getState(1), State::Completed);
+    EXPECT_EQ(batch.getState(39), State::Idle);
+    EXPECT_FALSE(batch.hasEvent(39));
+    batch.resize(2);
+    EXPECT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch.stateData()[1], static_cast<uint8_t>(State::Completed));
+}
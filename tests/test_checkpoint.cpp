@@ -0,0 +1,305 @@
+#include <gtest/gtest.h>
+#include "WashingMachine.hpp"
+#include "Fleet.hpp"
+#include "Checkpoint.hpp"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void prepare(WashingMachine& machine, int mode, float load) {
+        machine.initialize();
+        machine.setOutput(nullptr);
+        machine.closeDoor();
+        machine.setLoad(load);
+        machine.selectMode(mode);
+        machine.tick(0.05f);
+        machine.start();
+    }
+
+    void run(WashingMachine& machine, float seconds, float deltaTime = 0.5f) {
+        for (float t = 0.0f; t < seconds; t += deltaTime) {
+            machine.tick(deltaTime);
+        }
+    }
+
+    void expectSameStatus(const WashingMachine& a, const WashingMachine& b) {
+        SystemStatus sa = a.getStatus();
+        SystemStatus sb = b.getStatus();
+        EXPECT_EQ(sa.state, sb.state);
+        EXPECT_EQ(sa.doorStatus, sb.doorStatus);
+        EXPECT_FLOAT_EQ(sa.waterLevel, sb.waterLevel);
+        EXPECT_FLOAT_EQ(sa.targetWaterLevel, sb.targetWaterLevel);
+        EXPECT_EQ(sa.motorRPM, sb.motorRPM);
+        EXPECT_FLOAT_EQ(sa.loadKg, sb.loadKg);
+        EXPECT_EQ(sa.modeIndex, sb.modeIndex);
+        EXPECT_FLOAT_EQ(sa.progressPercent, sb.progressPercent);
+        EXPECT_EQ(sa.remainingSeconds, sb.remainingSeconds);
+        EXPECT_EQ(sa.fault, sb.fault);
+    }
+};
+
+TEST_F(CheckpointTest, MachineRoundTripMidCycle) {
+    WashingMachine original;
+    prepare(original, 1, 3.0f);
+    run(original, 120.0f);
+    ASSERT_EQ(original.getCurrentState(), State::Washing);
+
+    std::vector<uint8_t> buffer = original.saveCheckpoint();
+
+    WashingMachine restored;
+    restored.initialize();
+    restored.setOutput(nullptr);
+    ASSERT_TRUE(restored.restoreCheckpoint(buffer));
+    expectSameStatus(original, restored);
+}
+
+TEST_F(CheckpointTest, RestoredMachineContinuesIdentically) {
+    WashingMachine original;
+    prepare(original, 0, 2.0f);
+    run(original, 600.0f);
+
+    WashingMachine restored;
+    restored.initialize();
+    restored.setOutput(nullptr);
+    ASSERT_TRUE(restored.restoreCheckpoint(original.saveCheckpoint()));
+
+    run(original, 900.0f);
+    run(restored, 900.0f);
+    expectSameStatus(original, restored);
+}
+
+TEST_F(CheckpointTest, RejectsWrongMagicOrKind) {
+    WashingMachine machine;
+    machine.initialize();
+    std::vector<uint8_t> buffer = machine.saveCheckpoint();
+
+    std::vector<uint8_t> corrupted = buffer;
+    corrupted[0] ^= 0xFF;
+    EXPECT_FALSE(machine.restoreCheckpoint(corrupted));
+
+    Fleet fleet(1);
+    EXPECT_FALSE(fleet.restoreCheckpoint(buffer));
+}
+
+TEST_F(CheckpointTest, RejectsTruncatedBuffer) {
+    WashingMachine machine;
+    machine.initialize();
+    std::vector<uint8_t> buffer = machine.saveCheckpoint();
+    buffer.resize(buffer.size() - 3);
+
+    EXPECT_FALSE(machine.restoreCheckpoint(buffer));
+}
+
+TEST_F(CheckpointTest, RecordSizeMatchesSaveState) {
+    WashingMachine machine;
+    std::vector<uint8_t> buffer;
+    CheckpointWriter writer(buffer);
+    machine.saveState(writer);
+    EXPECT_EQ(buffer.size(), WashingMachine::CHECKPOINT_BYTES);
+}
+
+TEST_F(CheckpointTest, BadRecordLeavesMachineUntouched) {
+    WashingMachine source;
+    prepare(source, 1, 3.0f);
+    run(source, 120.0f);
+    std::vector<uint8_t> buffer = source.saveCheckpoint();
+    buffer.back() = 0xFF;
+
+    WashingMachine target;
+    prepare(target, 0, 2.0f);
+    run(target, 30.0f);
+    std::vector<uint8_t> before = target.saveCheckpoint();
+
+    EXPECT_FALSE(target.restoreCheckpoint(buffer));
+    EXPECT_EQ(target.saveCheckpoint(), before);
+}
+
+TEST_F(CheckpointTest, BadRecordLeavesFleetUntouched) {
+    Fleet source(3);
+    for (size_t i = 0; i < source.size(); i++) {
+        prepare(source.getMachine(i), static_cast<int>(i), 2.0f);
+    }
+    source.tick(60.0f);
+    std::vector<uint8_t> buffer;
+    source.saveCheckpoint(buffer);
+    buffer.back() = 0xFF;
+
+    Fleet target(2);
+    prepare(target.getMachine(0), 0, 1.0f);
+    target.tick(5.0f);
+    std::vector<uint8_t> before;
+    target.saveCheckpoint(before);
+
+    EXPECT_FALSE(target.restoreCheckpoint(buffer));
+    EXPECT_EQ(target.size(), 2u);
+    std::vector<uint8_t> after;
+    target.saveCheckpoint(after);
+    EXPECT_EQ(after, before);
+}
+
+TEST_F(CheckpointTest, ReaderStopsAtEnd) {
+    std::vector<uint8_t> buffer;
+    CheckpointWriter writer(buffer);
+    writer.write<uint16_t>(7);
+
+    CheckpointReader reader(buffer);
+    uint16_t small = 0;
+    uint32_t large = 0;
+    EXPECT_TRUE(reader.read(small));
+    EXPECT_EQ(small, 7);
+    EXPECT_FALSE(reader.read(large));
+    EXPECT_FALSE(reader.good());
+}
+
+TEST_F(CheckpointTest, FleetRoundTrip) {
+    Fleet fleet(8);
+    for (size_t i = 0; i < fleet.size(); i++) {
+        WashingMachine& machine = fleet.getMachine(i);
+        machine.closeDoor();
+        machine.setLoad(1.0f + static_cast<float>(i % 5));
+        machine.selectMode(static_cast<int>(i % 4));
+    }
+    fleet.tick(0.05f);
+    for (size_t i = 0; i < fleet.size(); i += 2) {
+        fleet.getMachine(i).start();
+    }
+    for (int t = 0; t < 200; t++) {
+        fleet.tick(0.5f);
+    }
+
+    std::vector<uint8_t> buffer;
+    fleet.saveCheckpoint(buffer);
+
+    Fleet restored;
+    ASSERT_TRUE(restored.restoreCheckpoint(buffer));
+    ASSERT_EQ(restored.size(), fleet.size());
+    for (size_t i = 0; i < fleet.size(); i++) {
+        expectSameStatus(fleet.getMachine(i), restored.getMachine(i));
+    }
+}
+
+TEST_F(CheckpointTest, FleetRejectsSizeMismatch) {
+    Fleet fleet(3);
+    std::vector<uint8_t> buffer;
+    fleet.saveCheckpoint(buffer);
+    buffer.pop_back();
+
+    Fleet restored;
+    EXPECT_FALSE(restored.restoreCheckpoint(buffer));
+    EXPECT_EQ(restored.size(), 0u);
+}
+
+TEST_F(CheckpointTest, BackgroundCheckpointWritesLatestSnapshot) {
+    std::string path = ::testing::TempDir() + "fleet_checkpoint.bin";
+    Fleet fleet(4);
+    fleet.getMachine(0).closeDoor();
+    fleet.getMachine(0).selectMode(2);
+    fleet.tick(0.05f);
+
+    BackgroundCheckpointer checkpointer;
+    for (int i = 0; i < 5; i++) {
+        checkpointer.capture(fleet, path);
+        fleet.tick(0.05f);
+    }
+    checkpointer.waitIdle();
+
+    EXPECT_GE(checkpointer.getCompletedCount(), 1u);
+    EXPECT_EQ(checkpointer.getFailedCount(), 0u);
+    EXPECT_EQ(checkpointer.getCompletedCount() + checkpointer.getSupersededCount(), 5u);
+
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(readCheckpointFile(path, buffer));
+    Fleet restored;
+    ASSERT_TRUE(restored.restoreCheckpoint(buffer));
+    EXPECT_EQ(restored.size(), 4u);
+    EXPECT_EQ(restored.getMachine(0).getCurrentState(), State::Ready);
+    std::remove(path.c_str());
+}
+
+TEST_F(CheckpointTest, SnapshotHoldsFleetAsItWasWhenBegun) {
+    Fleet fleet(40);
+    for (size_t i = 0; i < fleet.size(); i++) {
+        prepare(fleet.getMachine(i), static_cast<int>(i % 4), 3.0f);
+    }
+    fleet.tick(30.0f);
+    std::vector<uint8_t> expected;
+    fleet.saveCheckpoint(expected);
+
+    std::vector<uint8_t> snapshot;
+    fleet.beginSnapshot(snapshot);
+    fleet.getMachine(3).stop();
+    for (int t = 0; t < 20; t++) {
+        fleet.tick(1.0f);
+    }
+    fleet.finishSnapshot();
+    EXPECT_EQ(snapshot, expected);
+
+    std::vector<uint8_t> now;
+    fleet.saveCheckpoint(now);
+    EXPECT_NE(now, expected);
+}
+
+TEST_F(CheckpointTest, SnapshotFinishedOnAnotherThreadWhileTicking) {
+    Fleet fleet(200);
+    for (size_t i = 0; i < fleet.size(); i++) {
+        prepare(fleet.getMachine(i), static_cast<int>(i % 4), 3.0f);
+    }
+    fleet.tick(10.0f);
+
+    std::vector<uint8_t> snapshot;
+    for (int round = 0; round < 20; round++) {
+        std::vector<uint8_t> expected;
+        fleet.saveCheckpoint(expected);
+        fleet.beginSnapshot(snapshot);
+        std::thread finisher([&fleet] { fleet.finishSnapshot(); });
+        for (int t = 0; t < 5; t++) {
+            fleet.tick(0.5f);
+        }
+        finisher.join();
+        ASSERT_EQ(snapshot, expected) << "round " << round;
+    }
+}
+
+TEST_F(CheckpointTest, RestartedSnapshotReplacesUnfinishedOne) {
+    Fleet fleet(4);
+    prepare(fleet.getMachine(0), 0, 3.0f);
+    std::vector<uint8_t> snapshot;
+    fleet.beginSnapshot(snapshot);
+    fleet.tick(5.0f);
+    std::vector<uint8_t> expected;
+    fleet.saveCheckpoint(expected);
+
+    fleet.beginSnapshot(snapshot);
+    fleet.tick(5.0f);
+    fleet.finishSnapshot();
+    EXPECT_EQ(snapshot, expected);
+}
+
+TEST_F(CheckpointTest, BackgroundCheckpointKeepsTheLastCapture) {
+    std::string path = ::testing::TempDir() + "fleet_snapshot.bin";
+    Fleet fleet(100);
+    for (size_t i = 0; i < fleet.size(); i++) {
+        prepare(fleet.getMachine(i), static_cast<int>(i % 4), 3.0f);
+    }
+
+    BackgroundCheckpointer checkpointer;
+    std::vector<uint8_t> expected;
+    for (int i = 0; i < 10; i++) {
+        fleet.tick(2.0f);
+        fleet.saveCheckpoint(expected);
+        checkpointer.capture(fleet, path);
+    }
+    for (int i = 0; i < 10; i++) {
+        fleet.tick(2.0f);
+    }
+    checkpointer.waitIdle();
+
+    std::vector<uint8_t> written;
+    ASSERT_TRUE(readCheckpointFile(path, written));
+    EXPECT_EQ(written, expected);
+    std::remove(path.c_str());
+}
+
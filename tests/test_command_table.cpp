@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "CommandTable.hpp"
+#include "CLI.hpp"
+#include <sstream>
+#include <string>
+
+TEST(CommandTableTest, FindsEveryNameAndAlias) {
+    for (const CommandSpec& spec : COMMAND_SPECS) {
+        const CommandSpec* found = findCommand(spec.name);
+        ASSERT_NE(found, nullptr) << spec.name;
+        EXPECT_EQ(found->id, spec.id);
+        if (!spec.alias.empty()) {
+            const CommandSpec* alias = findCommand(spec.alias);
+            ASSERT_NE(alias, nullptr) << spec.alias;
+            EXPECT_EQ(alias->id, spec.id);
+        }
+    }
+}
+
+TEST(CommandTableTest, LookupIsCaseInsensitive) {
+    const CommandSpec* found = findCommand("EmErGeNcY");
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->id, CommandId::Emergency);
+    EXPECT_EQ(findCommand("QUIT")->id, CommandId::Exit);
+}
+
+TEST(CommandTableTest, RejectsUnknownNames) {
+    EXPECT_EQ(findCommand(""), nullptr);
+    EXPECT_EQ(findCommand("opens"), nullptr);
+    EXPECT_EQ(findCommand("star"), nullptr);
+    EXPECT_EQ(findCommand("expect"), nullptr);
+}
+
+TEST(CommandTableTest, TokenizerSplitsWithoutCopying) {
+    std::string line = "  load \t 3.5   extra\r\n";
+    CommandTokens tokens = tokenizeCommand(line);
+    ASSERT_EQ(tokens.count, 3u);
+    EXPECT_EQ(tokens[0], "load");
+    EXPECT_EQ(tokens[1], "3.5");
+    EXPECT_EQ(tokens[2], "extra");
+    EXPECT_EQ(tokens[0].data(), line.data() + 2);
+
+    EXPECT_EQ(tokenizeCommand("").count, 0u);
+    EXPECT_EQ(tokenizeCommand(" \t ").count, 0u);
+    EXPECT_EQ(tokenizeCommand("a b c d e f g h i j").count, CommandTokens::MAX_TOKENS);
+}
+
+TEST(CommandTableTest, ParsesWholeTokensOnly) {
+    int mode = 0;
+    float kg = 0.0f;
+    EXPECT_TRUE(parseNumber("3", mode));
+    EXPECT_EQ(mode, 3);
+    EXPECT_TRUE(parseNumber("2.5", kg));
+    EXPECT_FLOAT_EQ(kg, 2.5f);
+    EXPECT_TRUE(parseNumber("-1", kg));
+    EXPECT_FLOAT_EQ(kg, -1.0f);
+
+    EXPECT_FALSE(parseNumber("", mode));
+    EXPECT_FALSE(parseNumber("3kg", kg));
+    EXPECT_FALSE(parseNumber("2.5", mode));
+    EXPECT_FALSE(parseNumber("abc", kg));
+}
+
+TEST(CommandTableTest, CliDispatchesThroughTable) {
+    WashingMachine machine;
+    machine.initialize();
+    std::ostringstream out;
+    machine.setOutput(&out);
+    CLI cli(machine, out);
+
+    EXPECT_TRUE(cli.execute("CLOSE"));
+    EXPECT_TRUE(cli.execute("load 3"));
+    EXPECT_TRUE(cli.execute("Mode 2"));
+    machine.processEvents();
+    EXPECT_EQ(machine.getCurrentState(), State::Ready);
+    EXPECT_EQ(machine.getStatus().modeIndex, 1);
+    EXPECT_FLOAT_EQ(machine.getStatus().loadKg, 3.0f);
+
+    EXPECT_TRUE(cli.execute("load heavy"));
+    EXPECT_NE(out.str().find("Invalid load value."), std::string::npos);
+    EXPECT_TRUE(cli.execute("mode"));
+    EXPECT_NE(out.str().find("Usage: mode <1-4>"), std::string::npos);
+    EXPECT_TRUE(cli.execute("dance"));
+    EXPECT_NE(out.str().find("Unknown command: dance."), std::string::npos);
+    EXPECT_FALSE(cli.execute("quit"));
+}
+
+TEST(CommandTableTest, HelpListsEveryCommand) {
+    WashingMachine machine;
+    std::ostringstream out;
+    CLI cli(machine, out);
+    cli.execute("help");
+
+    std::string help = out.str();
+    for (const CommandSpec& spec : COMMAND_SPECS) {
+        EXPECT_NE(help.find(std::string(spec.help)), std::string::npos) << spec.name;
+        EXPECT_NE(help.find(std::string(spec.group) + ":"), std::string::npos);
+    }
+    EXPECT_NE(help.find("exit/quit"), std::string::npos);
+}
@@ -0,0 +1,585 @@
+#include <gtest/gtest.h>
+#include "CompactFleet.hpp"
+#include "MachineCore.hpp"
+#include "CounterRng.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+void expectSameMachine(const MachineCore& core, const CompactFleet& fleet, CompactFleet::MachineId id,
+                       int step) {
+    SystemStatus a = core.getStatus();
+    SystemStatus b = fleet.getStatus(id);
+    ASSERT_EQ(a.state, b.state) << "step " << step;
+    ASSERT_EQ(a.doorStatus, b.doorStatus) << "step " << step;
+    ASSERT_EQ(std::memcmp(&a.waterLevel, &b.waterLevel, sizeof(float)), 0) << "step " << step;
+    ASSERT_EQ(a.targetWaterLevel, b.targetWaterLevel) << "step " << step;
+    ASSERT_EQ(a.motorRPM, b.motorRPM) << "step " << step;
+    ASSERT_EQ(a.loadKg, b.loadKg) << "step " << step;
+    ASSERT_EQ(a.modeIndex, b.modeIndex) << "step " << step;
+    ASSERT_EQ(a.modeName, b.modeName) << "step " << step;
+    ASSERT_EQ(std::memcmp(&a.progressPercent, &b.progressPercent, sizeof(float)), 0) << "step " << step;
+    ASSERT_EQ(a.remainingSeconds, b.remainingSeconds) << "step " << step;
+    ASSERT_EQ(a.fault, b.fault) << "step " << step;
+
+    SensorSample x = core.getSensorSample();
+    SensorSample y = fleet.getSensorSample(id);
+    ASSERT_EQ(x.direction, y.direction) << "step " << step;
+    ASSERT_EQ(x.fillValveOpen, y.fillValveOpen) << "step " << step;
+    ASSERT_EQ(x.drainValveOpen, y.drainValveOpen) << "step " << step;
+    ASSERT_EQ(core.getPausedFromState(), fleet.getPausedFromState(id)) << "step " << step;
+}
+
+constexpr uint64_t COMMAND_CHOICES = 13;
+
+// Applies the same random command to a MachineCore and to one compact
+// machine. Door close and start are weighted up so that cycles get going.
+void applyCommand(CounterRng& rng, MachineCore& core, CompactFleet& fleet, CompactFleet::MachineId id) {
+    switch (rng.next() % COMMAND_CHOICES) {
+        case 0: core.openDoor(); fleet.openDoor(id); break;
+        case 1: case 2: core.closeDoor(); fleet.closeDoor(id); break;
+        case 3: {
+            int mode = static_cast<int>(rng.next() % 5) - 1;
+            core.selectMode(mode);
+            fleet.selectMode(id, mode);
+            break;
+        }
+        case 4: {
+            float kg = static_cast<float>(rng.next() % 80) / 10.0f - 0.5f;
+            core.setLoad(kg);
+            fleet.setLoad(id, kg);
+            break;
+        }
+        case 5: case 6: core.start(); fleet.start(id); break;
+        case 7: core.pause(); fleet.pause(id); break;
+        case 8: core.resume(); fleet.resume(id); break;
+        case 9: core.stop(); fleet.stop(id); break;
+        case 10: core.emergencyStop(); fleet.emergencyStop(id); break;
+        case 11: core.clearFault(); fleet.clearFault(id); break;
+        case 12: {
+            FaultCode fault = static_cast<FaultCode>(rng.next() % 6);
+            core.injectFault(fault);
+            fleet.injectFault(id, fault);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// A command one time in three, otherwise a time step of varying length.
+void applyRandom(CounterRng& rng, MachineCore& core, CompactFleet& fleet, CompactFleet::MachineId id) {
+    if (rng.next() % 3 == 0) {
+        applyCommand(rng, core, fleet, id);
+        return;
+    }
+    static const float steps[] = {0.05f, 0.1f, 0.5f, 7.0f, 60.0f, 300.0f};
+    float dt = steps[rng.next() % 6];
+    core.step(dt);
+    fleet.tick(dt);
+}
+
+}
+
+TEST(CompactFleetTest, FreshMachineMatchesMachineCore) {
+    MachineCore core;
+    core.setOutput(nullptr);
+    CompactFleet fleet(3);
+    for (CompactFleet::MachineId id = 0; id < 3; id++) {
+        expectSameMachine(core, fleet, id, 0);
+    }
+}
+
+TEST(CompactFleetTest, FullCycleMatchesMachineCore) {
+    MachineCore core;
+    core.setOutput(nullptr);
+    CompactFleet fleet(1);
+
+    core.closeDoor();
+    fleet.closeDoor(0);
+    core.selectMode(1);
+    fleet.selectMode(0, 1);
+    core.setLoad(4.5f);
+    fleet.setLoad(0, 4.5f);
+    core.step(0.1f);
+    fleet.tick(0.1f);
+    core.start();
+    fleet.start(0);
+
+    bool sawSpin = false;
+    for (int i = 0; i < 100000 && core.getCurrentState() != State::Completed; i++) {
+        core.step(0.1f);
+        fleet.tick(0.1f);
+        sawSpin = sawSpin || fleet.getCurrentState(0) == State::Spinning;
+        expectSameMachine(core, fleet, 0, i);
+    }
+    EXPECT_TRUE(sawSpin);
+    EXPECT_EQ(fleet.getCurrentState(0), State::Completed);
+}
+
+TEST(CompactFleetTest, RandomCommandsMatchMachineCore) {
+    const CompactFleet::MachineId machines = 8;
+    CompactFleet fleet(machines);
+    std::vector<MachineCore> cores(machines);
+    std::vector<CounterRng> streams;
+    for (CompactFleet::MachineId id = 0; id < machines; id++) {
+        cores[id].setOutput(nullptr);
+        streams.emplace_back(42, id);
+    }
+
+    // Commands for several machines are queued in one fleet-wide FIFO between
+    // ticks; each machine must still see only its own events, in order.
+    for (int round = 0; round < 4000; round++) {
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            if (streams[id].next() % 4 == 0) {
+                applyCommand(streams[id], cores[id], fleet, id);
+            }
+        }
+        float dt = (round % 7 == 0) ? 2.0f : 0.25f;
+        for (MachineCore& core : cores) {
+            core.step(dt);
+        }
+        fleet.tick(dt);
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            expectSameMachine(cores[id], fleet, id, round);
+        }
+    }
+}
+
+TEST(CompactFleetTest, SingleMachineRandomWalkMatchesMachineCore) {
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        MachineCore core;
+        core.setOutput(nullptr);
+        CompactFleet fleet(1);
+        CounterRng rng(seed, 0);
+        for (int i = 0; i < 3000; i++) {
+            applyRandom(rng, core, fleet, 0);
+            expectSameMachine(core, fleet, 0, i);
+        }
+    }
+}
+
+TEST(CompactFleetTest, ResizeKeepsExistingMachines) {
+    CompactFleet fleet(2);
+    fleet.closeDoor(1);
+    fleet.selectMode(1, 0);
+    fleet.setLoad(1, 3.0f);
+    fleet.tick(0.1f);
+    fleet.start(1);
+    fleet.tick(1.0f);
+    SensorSample before = fleet.getSensorSample(1);
+
+    fleet.resize(5000);
+    EXPECT_EQ(fleet.size(), 5000u);
+    EXPECT_GE(fleet.getCapacity(), 5000u);
+    SensorSample after = fleet.getSensorSample(1);
+    EXPECT_EQ(after.state, State::Filling);
+    EXPECT_EQ(after.waterLevel, before.waterLevel);
+    EXPECT_EQ(fleet.getCurrentState(4999), State::Idle);
+    EXPECT_EQ(fleet.getStatus(4999).doorStatus, DoorStatus::Open);
+
+    fleet.stop(1);
+    fleet.emergencyStop(1);
+    fleet.resize(1);
+    EXPECT_EQ(fleet.getPendingCount(), 0u);
+}
+
+TEST(CompactFleetTest, MemoryReportStaysUnderBudget) {
+    CompactFleet fleet(10000);
+    for (CompactFleet::MachineId id = 0; id < 10000; id++) {
+        fleet.closeDoor(id);
+        fleet.selectMode(id, 0);
+        fleet.setLoad(id, 3.0f);
+    }
+    fleet.tick(0.1f);
+    for (CompactFleet::MachineId id = 0; id < 10000; id++) {
+        fleet.start(id);
+    }
+    fleet.tick(0.1f);
+
+    FleetMemoryReport report = fleet.getMemoryReport();
+    EXPECT_EQ(report.machines, 10000u);
+    EXPECT_LE(report.hotBytes, 64u);
+    EXPECT_GE(report.arenaBytes, (report.hotBytes + report.coldBytes) * 10000);
+    EXPECT_LT(report.bytesPerMachine(), 256.0);
+}
+
+TEST(CompactFleetTest, OnlyCyclingMachinesStayActive) {
+    CompactFleet fleet(100);
+    EXPECT_EQ(fleet.getActiveCount(), 0u);
+
+    for (CompactFleet::MachineId id = 0; id < 5; id++) {
+        fleet.closeDoor(id);
+        fleet.selectMode(id, 0);
+        fleet.setLoad(id, 2.0f);
+    }
+    fleet.tick(0.1f);
+    for (CompactFleet::MachineId id = 0; id < 5; id++) {
+        fleet.start(id);
+    }
+    fleet.tick(1.0f);
+    EXPECT_EQ(fleet.getActiveCount(), 5u);
+
+    for (int i = 0; i < 10000 && fleet.getCurrentState(0) != State::Completed; i++) {
+        fleet.tick(1.0f);
+        EXPECT_EQ(fleet.getActiveCount(), 5u);
+    }
+    fleet.tick(1.0f);
+    EXPECT_EQ(fleet.getCurrentState(4), State::Completed);
+    EXPECT_EQ(fleet.getActiveCount(), 0u);
+    EXPECT_EQ(fleet.getStatus(0).doorStatus, DoorStatus::ClosedUnlocked);
+}
+
+TEST(CompactFleetTest, PausedMachineLeavesOnceDrumStops) {
+    CompactFleet fleet(1);
+    fleet.closeDoor(0);
+    fleet.selectMode(0, 0);
+    fleet.setLoad(0, 2.0f);
+    fleet.tick(0.1f);
+    fleet.start(0);
+    for (int i = 0; i < 100 && fleet.getSensorSample(0).motorRPM < 400; i++) {
+        fleet.tick(1.0f);
+    }
+    ASSERT_EQ(fleet.getCurrentState(0), State::Washing);
+
+    fleet.pause(0);
+    fleet.tick(1.0f);
+    EXPECT_EQ(fleet.getCurrentState(0), State::Paused);
+    EXPECT_EQ(fleet.getActiveCount(), 1u);
+    for (int i = 0; i < 10; i++) {
+        fleet.tick(1.0f);
+    }
+    EXPECT_EQ(fleet.getSensorSample(0).motorRPM, 0);
+    EXPECT_EQ(fleet.getActiveCount(), 0u);
+
+    fleet.resume(0);
+    EXPECT_EQ(fleet.getActiveCount(), 1u);
+    fleet.tick(1.0f);
+    EXPECT_GT(fleet.getSensorSample(0).motorRPM, 0);
+}
+
+TEST(CompactFleetTest, ActiveTrackingMatchesFullScan) {
+    const CompactFleet::MachineId machines = 64;
+    CompactFleet tracked(machines);
+    CompactFleet scanned(machines);
+    scanned.setActiveTracking(false);
+    std::vector<MachineCore> trackedCores(machines);
+    std::vector<MachineCore> scannedCores(machines);
+    for (CompactFleet::MachineId id = 0; id < machines; id++) {
+        trackedCores[id].setOutput(nullptr);
+        scannedCores[id].setOutput(nullptr);
+    }
+
+    CounterRng rng(9, 0);
+    for (int round = 0; round < 3000; round++) {
+        CompactFleet::MachineId id = static_cast<CompactFleet::MachineId>(rng.next() % machines);
+        CounterRng replay = rng;
+        applyCommand(rng, trackedCores[id], tracked, id);
+        applyCommand(replay, scannedCores[id], scanned, id);
+
+        float dt = (round % 5 == 0) ? 30.0f : 0.5f;
+        tracked.tick(dt);
+        scanned.tick(dt);
+        for (CompactFleet::MachineId m = 0; m < machines; m++) {
+            trackedCores[m].step(dt);
+            scannedCores[m].step(dt);
+            expectSameMachine(trackedCores[m], tracked, m, round);
+            expectSameMachine(scannedCores[m], scanned, m, round);
+        }
+    }
+    EXPECT_LT(tracked.getActiveCount(), static_cast<size_t>(machines));
+    EXPECT_EQ(scanned.getActiveCount(), static_cast<size_t>(machines));
+}
+
+namespace {
+
+// Runs one Heavy cycle on a Full fleet and on a fleet at the given level and
+// returns, per phase entered, the difference in entry time.
+std::vector<double> phaseEntryErrors(Fidelity level, float step) {
+    CompactFleet full(1);
+    CompactFleet lod(1);
+    lod.setFidelity(0, level);
+    for (CompactFleet* fleet : {&full, &lod}) {
+        fleet->closeDoor(0);
+        fleet->selectMode(0, 2);
+        fleet->setLoad(0, 4.5f);
+        fleet->tick(step);
+        fleet->start(0);
+    }
+
+    std::vector<double> fullEntries;
+    std::vector<double> lodEntries;
+    State fullState = State::Ready;
+    State lodState = State::Ready;
+    for (int i = 0; i < 1000000; i++) {
+        full.tick(step);
+        lod.tick(step);
+        if (full.getCurrentState(0) != fullState) {
+            fullState = full.getCurrentState(0);
+            fullEntries.push_back(full.getTime());
+        }
+        if (lod.getCurrentState(0) != lodState) {
+            lodState = lod.getCurrentState(0);
+            lodEntries.push_back(lod.getTime());
+        }
+        if (fullState == State::Completed && lodState == State::Completed) {
+            break;
+        }
+    }
+
+    std::vector<double> errors;
+    EXPECT_EQ(fullEntries.size(), 6u);
+    EXPECT_EQ(lodEntries.size(), fullEntries.size());
+    for (size_t i = 0; i < std::min(fullEntries.size(), lodEntries.size()); i++) {
+        errors.push_back(std::fabs(fullEntries[i] - lodEntries[i]));
+    }
+    return errors;
+}
+
+void startCycle(CompactFleet& fleet, CompactFleet::MachineId id) {
+    fleet.closeDoor(id);
+    fleet.selectMode(id, 0);
+    fleet.setLoad(id, 3.0f);
+    fleet.tick(0.1f);
+    fleet.start(id);
+}
+
+}
+
+// Full accumulates phase time in float, which drifts by a few tenths of a
+// second over an hour of 0.1 s ticks; the analytic levels do not.
+TEST(CompactFleetTest, CoarsePhasesTrackFull) {
+    for (double error : phaseEntryErrors(Fidelity::Coarse, 0.1f)) {
+        EXPECT_LT(error, 1.0);
+    }
+}
+
+TEST(CompactFleetTest, StatisticalPhasesTrackFull) {
+    for (double error : phaseEntryErrors(Fidelity::Statistical, 0.1f)) {
+        EXPECT_LT(error, 1.0);
+    }
+}
+
+TEST(CompactFleetTest, CoarseMachineIsOffTheActiveListAndInterpolates) {
+    CompactFleet fleet(1);
+    fleet.setFidelity(0, Fidelity::Coarse);
+    startCycle(fleet, 0);
+    fleet.tick(0.1f);
+    ASSERT_EQ(fleet.getCurrentState(0), State::Filling);
+    EXPECT_EQ(fleet.getActiveCount(), 0u);
+
+    fleet.tick(1.0f);
+    SensorSample sample = fleet.getSensorSample(0);
+    EXPECT_NEAR(sample.waterLevel, 11.0f, 0.01f);
+    EXPECT_TRUE(sample.fillValveOpen);
+    EXPECT_EQ(fleet.getStatus(0).doorStatus, DoorStatus::ClosedLocked);
+}
+
+TEST(CompactFleetTest, CommandsAndFaultsPromoteToFull) {
+    CompactFleet fleet(2);
+    fleet.setFidelity(0, Fidelity::Statistical);
+    fleet.setFidelity(1, Fidelity::Coarse);
+    startCycle(fleet, 0);
+    startCycle(fleet, 1);
+    for (int i = 0; i < 100; i++) {
+        fleet.tick(0.5f);
+    }
+    ASSERT_EQ(fleet.getCurrentState(0), State::Washing);
+    ASSERT_EQ(fleet.getCurrentState(1), State::Washing);
+    EXPECT_EQ(fleet.getActiveCount(), 0u);
+
+    fleet.pause(0);
+    EXPECT_EQ(fleet.getEffectiveFidelity(0), Fidelity::Full);
+    fleet.injectFault(1, FaultCode::MotorFault);
+    EXPECT_EQ(fleet.getEffectiveFidelity(1), Fidelity::Full);
+    fleet.tick(0.5f);
+    EXPECT_EQ(fleet.getCurrentState(0), State::Paused);
+    EXPECT_EQ(fleet.getCurrentState(1), State::Fault);
+    EXPECT_EQ(fleet.getStatus(1).fault, FaultCode::MotorFault);
+
+    fleet.resume(0);
+    for (int i = 0; i < 20000 && fleet.getCurrentState(0) != State::Completed; i++) {
+        fleet.tick(0.5f);
+    }
+    EXPECT_EQ(fleet.getCurrentState(0), State::Completed);
+    EXPECT_EQ(fleet.getFidelity(0), Fidelity::Statistical);
+
+    // The configured level is back for the next cycle.
+    fleet.openDoor(0);
+    startCycle(fleet, 0);
+    fleet.tick(0.1f);
+    EXPECT_EQ(fleet.getCurrentState(0), State::Filling);
+    EXPECT_EQ(fleet.getEffectiveFidelity(0), Fidelity::Statistical);
+}
+
+TEST(CompactFleetTest, MonitoringPromotesAndReleaseDemotes) {
+    CompactFleet fleet(1);
+    fleet.setFidelity(0, Fidelity::Coarse);
+    startCycle(fleet, 0);
+    for (int i = 0; i < 50; i++) {
+        fleet.tick(1.0f);
+    }
+    ASSERT_EQ(fleet.getCurrentState(0), State::Washing);
+    SensorSample before = fleet.getSensorSample(0);
+
+    fleet.setMonitored(0, true);
+    EXPECT_EQ(fleet.getEffectiveFidelity(0), Fidelity::Full);
+    EXPECT_EQ(fleet.getActiveCount(), 1u);
+    SensorSample promoted = fleet.getSensorSample(0);
+    EXPECT_EQ(promoted.motorRPM, before.motorRPM);
+    EXPECT_EQ(promoted.waterLevel, before.waterLevel);
+    fleet.tick(1.0f);
+
+    fleet.setMonitored(0, false);
+    EXPECT_EQ(fleet.getEffectiveFidelity(0), Fidelity::Coarse);
+    fleet.tick(1.0f);
+    EXPECT_EQ(fleet.getActiveCount(), 0u);
+    for (int i = 0; i < 20000 && fleet.getCurrentState(0) != State::Completed; i++) {
+        fleet.tick(1.0f);
+    }
+    EXPECT_EQ(fleet.getCurrentState(0), State::Completed);
+}
+
+// A compact machine keeps no previous state, so that byte is left out.
+TEST(CompactFleetTest, CheckpointRecordsMatchMachineCore) {
+    const CompactFleet::MachineId machines = 8;
+    CompactFleet fleet(machines);
+    std::vector<MachineCore> cores(machines);
+    std::vector<CounterRng> streams;
+    for (CompactFleet::MachineId id = 0; id < machines; id++) {
+        cores[id].setOutput(nullptr);
+        streams.emplace_back(7, id);
+    }
+
+    std::vector<uint8_t> buffer;
+    for (int round = 0; round < 2000; round++) {
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            if (streams[id].next() % 4 == 0) {
+                applyCommand(streams[id], cores[id], fleet, id);
+            }
+        }
+        for (MachineCore& core : cores) {
+            core.step(0.5f);
+        }
+        fleet.tick(0.5f);
+        if (round % 50 != 0) {
+            continue;
+        }
+
+        fleet.saveCheckpoint(buffer);
+        ASSERT_GE(buffer.size(), MachineCore::CHECKPOINT_BYTES * machines);
+        size_t offset = buffer.size() - MachineCore::CHECKPOINT_BYTES * machines;
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            std::vector<uint8_t> record;
+            CheckpointWriter writer(record);
+            cores[id].saveState(writer);
+            ASSERT_EQ(record.size(), MachineCore::CHECKPOINT_BYTES);
+            std::vector<uint8_t> saved(buffer.begin() + offset, buffer.begin() + offset + record.size());
+            record[1] = saved[1] = 0;
+            ASSERT_EQ(record, saved) << "round " << round << " machine " << id;
+            offset += record.size();
+        }
+    }
+}
+
+TEST(CompactFleetTest, RestoredFleetContinuesLikeRestoredCores) {
+    const CompactFleet::MachineId machines = 8;
+    CompactFleet fleet(machines);
+    std::vector<MachineCore> cores(machines);
+    std::vector<CounterRng> streams;
+    for (CompactFleet::MachineId id = 0; id < machines; id++) {
+        cores[id].setOutput(nullptr);
+        streams.emplace_back(11, id);
+    }
+    // Every machine mid-cycle, each in a different phase, one of them paused.
+    for (CompactFleet::MachineId id = 0; id < machines; id++) {
+        cores[id].closeDoor();
+        fleet.closeDoor(id);
+        cores[id].selectMode(static_cast<int>(id % 4));
+        fleet.selectMode(id, static_cast<int>(id % 4));
+        cores[id].setLoad(3.0f);
+        fleet.setLoad(id, 3.0f);
+    }
+    for (int step = 0; step < 200; step++) {
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            if (step == static_cast<int>(id) * 20) {
+                cores[id].start();
+                fleet.start(id);
+            }
+        }
+        if (step == 190) {
+            cores[3].pause();
+            fleet.pause(3);
+        }
+        for (MachineCore& core : cores) {
+            core.step(5.0f);
+        }
+        fleet.tick(5.0f);
+    }
+    std::vector<uint8_t> buffer;
+    fleet.saveCheckpoint(buffer);
+
+    CompactFleet restored(2);
+    restored.setFidelity(0, Fidelity::Coarse);
+    ASSERT_TRUE(restored.restoreCheckpoint(buffer));
+    ASSERT_EQ(restored.size(), machines);
+    EXPECT_EQ(restored.getFidelity(0), Fidelity::Coarse);
+    EXPECT_EQ(restored.getEffectiveFidelity(0), Fidelity::Full);
+    EXPECT_EQ(restored.getActiveCount(), fleet.getActiveCount());
+    EXPECT_GT(restored.getActiveCount(), 0u);
+    restored.setFidelity(0, Fidelity::Full);
+
+    std::vector<MachineCore> restoredCores(machines);
+    CheckpointReader reader(buffer.data() + buffer.size() - MachineCore::CHECKPOINT_BYTES * machines,
+                            MachineCore::CHECKPOINT_BYTES * machines);
+    for (MachineCore& core : restoredCores) {
+        core.setOutput(nullptr);
+        ASSERT_TRUE(core.restoreState(reader));
+    }
+
+    for (int round = 0; round < 2000; round++) {
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            if (streams[id].next() % 4 == 0) {
+                applyCommand(streams[id], restoredCores[id], restored, id);
+            }
+        }
+        float dt = (round % 7 == 0) ? 2.0f : 0.25f;
+        for (MachineCore& core : restoredCores) {
+            core.step(dt);
+        }
+        restored.tick(dt);
+        for (CompactFleet::MachineId id = 0; id < machines; id++) {
+            expectSameMachine(restoredCores[id], restored, id, round);
+        }
+    }
+}
+
+TEST(CompactFleetTest, BadCheckpointLeavesFleetUntouched) {
+    CompactFleet fleet(3);
+    fleet.closeDoor(1);
+    fleet.selectMode(1, 0);
+    fleet.setLoad(1, 3.0f);
+    fleet.tick(0.1f);
+    fleet.start(1);
+    fleet.tick(1.0f);
+    std::vector<uint8_t> buffer;
+    fleet.saveCheckpoint(buffer);
+
+    CompactFleet other(5);
+    std::vector<uint8_t> corrupt = buffer;
+    corrupt[corrupt.size() - 1] = 0xFF;
+    EXPECT_FALSE(other.restoreCheckpoint(corrupt));
+    corrupt.pop_back();
+    EXPECT_FALSE(other.restoreCheckpoint(corrupt));
+    EXPECT_EQ(other.size(), 5u);
+    EXPECT_EQ(other.getCurrentState(1), State::Idle);
+
+    ASSERT_TRUE(other.restoreCheckpoint(buffer));
+    EXPECT_EQ(other.size(), 3u);
+    EXPECT_EQ(other.getCurrentState(1), State::Filling);
+    EXPECT_EQ(other.getActiveCount(), 1u);
+}
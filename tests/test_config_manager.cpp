@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "ConfigManager.hpp"
+#include "MachineCore.hpp"
+#include "WashModeCatalog.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static_assert(BUILTIN_WASH_MODES.size() == 4, "config/wash_modes.json defines four modes");
+static_assert(BUILTIN_WASH_MODES[0].name == "Quick Wash", "the catalog is usable at compile time");
+
+namespace {
+
+std::string writeModes(const std::string& json) {
+    std::string path = testing::TempDir() + "config_manager_modes.json";
+    std::ofstream(path) << json;
+    return path;
+}
+
+}
+
+TEST(ConfigManagerTest, StartsOnTheBuiltinCatalog) {
+    ConfigManager config;
+    EXPECT_TRUE(config.isBuiltin());
+    EXPECT_EQ(config.getModeCount(), static_cast<int>(BUILTIN_WASH_MODES.size()));
+    EXPECT_EQ(&config.getMode(0), &BUILTIN_WASH_MODES[0]);
+    EXPECT_EQ(config.getHeapBytes(), 0u);
+}
+
+TEST(ConfigManagerTest, BuiltinCatalogMatchesTheConfigFile) {
+    ConfigManager loaded;
+    ASSERT_TRUE(loaded.loadConfig(WASH_MODES_JSON));
+    EXPECT_FALSE(loaded.isBuiltin());
+
+    ConfigManager builtin;
+    ASSERT_EQ(loaded.getModeCount(), builtin.getModeCount());
+    for (int i = 0; i < builtin.getModeCount(); i++) {
+        const WashMode& a = loaded.getMode(i);
+        const WashMode& b = builtin.getMode(i);
+        EXPECT_EQ(a.name, b.name);
+        EXPECT_EQ(a.durationMinutes, b.durationMinutes);
+        EXPECT_EQ(a.spinSpeedRPM, b.spinSpeedRPM);
+        EXPECT_EQ(a.waterLevelLiters, b.waterLevelLiters);
+        EXPECT_EQ(a.temperatureCelsius, b.temperatureCelsius);
+    }
+}
+
+TEST(ConfigManagerTest, LoadedModesOverrideAndOwnTheirNames) {
+    std::string path = writeModes(
+        "{\"modes\": [\n"
+        "  {\"name\": \"Eco Wash With A Long Name\", \"duration_minutes\": 90, \"spin_speed_rpm\": 600,"
+        " \"water_level_liters\": 25.5, \"temperature_celsius\": 20},\n"
+        "  {\"name\": \"Rinse\", \"duration_minutes\": 10, \"spin_speed_rpm\": 1400,"
+        " \"water_level_liters\": 15, \"temperature_celsius\": 20}\n"
+        "]}\n");
+
+    ConfigManager config;
+    ASSERT_TRUE(config.loadConfig(path));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(config.getModeCount(), 2);
+    EXPECT_EQ(config.getMode(0).name, "Eco Wash With A Long Name");
+    EXPECT_EQ(config.getMode(0).waterLevelLiters, 25.5f);
+    EXPECT_EQ(config.getMode(1).name, "Rinse");
+    EXPECT_EQ(config.getMode(1).spinSpeedRPM, 1400);
+    EXPECT_GT(config.getHeapBytes(), 0u);
+
+    int seen = 0;
+    for (const WashMode& mode : config.getAllModes()) {
+        EXPECT_EQ(&mode, &config.getMode(seen));
+        seen++;
+    }
+    EXPECT_EQ(seen, 2);
+}
+
+TEST(ConfigManagerTest, FailedLoadFallsBackToTheCatalog) {
+    std::string path = writeModes("{\"modes\": [{\"name\": \"Only\", \"duration_minutes\": 5}]}");
+    ConfigManager config;
+    ASSERT_TRUE(config.loadConfig(path));
+    std::remove(path.c_str());
+    ASSERT_EQ(config.getModeCount(), 1);
+
+    EXPECT_FALSE(config.loadConfig(testing::TempDir() + "no_such_modes.json"));
+    EXPECT_TRUE(config.isBuiltin());
+    EXPECT_EQ(config.getMode(0).name, "Quick Wash");
+    EXPECT_EQ(config.getHeapBytes(), 0u);
+}
+
+TEST(ConfigManagerTest, DefaultModesAreSharedWithoutAnOwner) {
+    auto first = MachineCore::defaultModes();
+    auto second = MachineCore::defaultModes();
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_TRUE(first->isBuiltin());
+    EXPECT_EQ(first.use_count(), 0);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "ControlProtocol.hpp"
+
+#include <cstring>
+
+TEST(ControlProtocolTest, RequestRoundTrip) {
+    std::vector<uint8_t> buffer;
+    encodeRequest(buffer, makeRequest(ControlOp::SetLoad, 42, 7, 3.5f));
+    encodeRequest(buffer, makeRequest(ControlOp::SelectMode, 43, 7, 2u));
+    ASSERT_EQ(buffer.size(), 2 * (CONTROL_LENGTH_SIZE + CONTROL_REQUEST_SIZE));
+
+    long frame = frameSize(buffer.data(), buffer.size());
+    ASSERT_EQ(frame, static_cast<long>(CONTROL_LENGTH_SIZE + CONTROL_REQUEST_SIZE));
+
+    ControlRequest request;
+    ASSERT_TRUE(decodeRequest(buffer.data() + CONTROL_LENGTH_SIZE, CONTROL_REQUEST_SIZE, request));
+    EXPECT_EQ(request.op, ControlOp::SetLoad);
+    EXPECT_EQ(request.seq, 42u);
+    EXPECT_EQ(request.machineId, 7u);
+    EXPECT_FLOAT_EQ(request.floatArg(), 3.5f);
+
+    ASSERT_TRUE(decodeRequest(buffer.data() + frame + CONTROL_LENGTH_SIZE, CONTROL_REQUEST_SIZE, request));
+    EXPECT_EQ(request.op, ControlOp::SelectMode);
+    EXPECT_EQ(request.intArg(), 2);
+}
+
+TEST(ControlProtocolTest, FrameSizeNeedsWholeFrame) {
+    std::vector<uint8_t> buffer;
+    encodeRequest(buffer, makeRequest(ControlOp::Ping, 1, 0));
+    EXPECT_EQ(frameSize(buffer.data(), 2), 0);
+    EXPECT_EQ(frameSize(buffer.data(), buffer.size() - 1), 0);
+
+    uint32_t zero = 0;
+    std::memcpy(buffer.data(), &zero, sizeof(zero));
+    EXPECT_EQ(frameSize(buffer.data(), buffer.size()), -1);
+}
+
+TEST(ControlProtocolTest, StatusBatchRoundTrip) {
+    SystemStatus status{};
+    status.state = State::Washing;
+    status.doorStatus = DoorStatus::ClosedLocked;
+    status.loadKg = 4.0f;
+    status.motorRPM = 800;
+
+    std::vector<uint8_t> buffer;
+    size_t start = beginStatusBatch(buffer, 9, 100);
+    for (uint32_t id = 0; id < 3; id++) {
+        appendStatusRecord(buffer, makeStatusRecord(id, status));
+    }
+    endStatusBatch(buffer, start, 3);
+
+    long frame = frameSize(buffer.data(), buffer.size());
+    ASSERT_EQ(frame, static_cast<long>(buffer.size()));
+
+    ControlResponse response;
+    ASSERT_TRUE(decodeResponse(buffer.data() + CONTROL_LENGTH_SIZE, buffer.size() - CONTROL_LENGTH_SIZE, response));
+    EXPECT_EQ(response.kind, ControlFrameKind::StatusBatch);
+    EXPECT_EQ(response.seq, 9u);
+    EXPECT_EQ(response.tick, 100u);
+    ASSERT_EQ(response.records.size(), 3u);
+    EXPECT_EQ(response.records[2].machineId, 2u);
+    EXPECT_EQ(response.records[2].state, static_cast<uint8_t>(State::Washing));
+    EXPECT_EQ(response.records[2].motorRPM, 800);
+}
+
+TEST(ControlProtocolTest, LargestBatchFitsOneFrame) {
+    std::vector<uint8_t> buffer;
+    size_t start = beginStatusBatch(buffer, 1, 1);
+    buffer.resize(buffer.size() + CONTROL_MAX_BATCH_RECORDS * sizeof(StatusRecord));
+    endStatusBatch(buffer, start, static_cast<uint32_t>(CONTROL_MAX_BATCH_RECORDS));
+    EXPECT_EQ(frameSize(buffer.data(), buffer.size()), static_cast<long>(buffer.size()));
+
+    appendStatusRecord(buffer, StatusRecord{});
+    endStatusBatch(buffer, start, static_cast<uint32_t>(CONTROL_MAX_BATCH_RECORDS + 1));
+    EXPECT_EQ(frameSize(buffer.data(), buffer.size()), -1);
+}
+
+#ifdef __linux__
+
+#include "ControlClient.hpp"
+#include "ControlServer.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+class ControlServerTest : public ::testing::Test {
+protected:
+    Fleet fleet{4};
+    Reactor reactor;
+    ControlServer server{reactor, fleet};
+    std::string socketPath;
+    std::thread serverThread;
+
+    void SetUp() override {
+        socketPath = "/tmp/washing_machine_test." + std::to_string(getpid()) + ".sock";
+        ASSERT_TRUE(server.listen(socketPath));
+        serverThread = std::thread([this] {
+            PeriodicTimer timer(std::chrono::milliseconds(5));
+            reactor.add(timer.getFd(), EPOLLIN, [&](uint32_t) {
+                uint64_t expirations = timer.readExpirations();
+                if (expirations > 0) {
+                    fleet.tick(0.005f * static_cast<float>(expirations));
+                    server.publishStatus();
+                }
+            });
+            reactor.run();
+            reactor.remove(timer.getFd());
+        });
+    }
+
+    void TearDown() override {
+        reactor.stop();
+        if (serverThread.joinable()) {
+            serverThread.join();
+        }
+        server.close();
+    }
+};
+
+TEST_F(ControlServerTest, PipelinedCommandsAreAppliedInOrder) {
+    ControlClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+
+    client.queue(makeRequest(ControlOp::CloseDoor, 1, 2));
+    client.queue(makeRequest(ControlOp::SetLoad, 2, 2, 3.0f));
+    client.queue(makeRequest(ControlOp::SelectMode, 3, 2, 0u));
+    client.queue(makeRequest(ControlOp::Start, 4, 2));
+    client.queue(makeRequest(ControlOp::GetStatus, 5, 2));
+    ASSERT_TRUE(client.flush());
+
+    ControlResponse response;
+    for (uint32_t seq = 1; seq <= 4; seq++) {
+        ASSERT_TRUE(client.receive(response));
+        EXPECT_EQ(response.kind, ControlFrameKind::Ack);
+        EXPECT_EQ(response.seq, seq);
+        EXPECT_EQ(response.result, ControlResult::Ok);
+    }
+    EXPECT_EQ(response.state, State::Filling);
+
+    ASSERT_TRUE(client.receive(response));
+    EXPECT_EQ(response.kind, ControlFrameKind::Status);
+    ASSERT_EQ(response.records.size(), 1u);
+    EXPECT_EQ(response.records[0].machineId, 2u);
+    EXPECT_FLOAT_EQ(response.records[0].loadKg, 3.0f);
+
+    ASSERT_TRUE(client.call(makeRequest(ControlOp::GetStatus, 6, 1), response));
+    EXPECT_EQ(response.records[0].state, static_cast<uint8_t>(State::Idle));
+}
+
+TEST_F(ControlServerTest, RejectsUnknownMachineAndOp) {
+    ControlClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+
+    ControlResponse response;
+    ASSERT_TRUE(client.call(makeRequest(ControlOp::Start, 1, 99), response));
+    EXPECT_EQ(response.result, ControlResult::UnknownMachine);
+
+    ASSERT_TRUE(client.call(makeRequest(static_cast<ControlOp>(200), 2, 0), response));
+    EXPECT_EQ(response.result, ControlResult::UnknownOp);
+
+    ASSERT_TRUE(client.call(makeRequest(ControlOp::Ping, 3, 0), response));
+    EXPECT_EQ(response.result, ControlResult::Ok);
+}
+
+TEST_F(ControlServerTest, SubscriptionPushesBatches) {
+    ControlClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+
+    ControlResponse response;
+    ASSERT_TRUE(client.call(makeRequest(ControlOp::Subscribe, 10, 1, 2u), response));
+    EXPECT_EQ(response.result, ControlResult::Ok);
+
+    uint32_t lastTick = 0;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(client.receive(response));
+        ASSERT_EQ(response.kind, ControlFrameKind::StatusBatch);
+        EXPECT_EQ(response.seq, 10u);
+        EXPECT_GT(response.tick, lastTick);
+        lastTick = response.tick;
+        ASSERT_EQ(response.records.size(), 2u);
+        EXPECT_EQ(response.records[0].machineId, 1u);
+        EXPECT_EQ(response.records[1].machineId, 2u);
+    }
+
+    ASSERT_TRUE(client.call(makeRequest(ControlOp::Unsubscribe, 11, 0, 10u), response));
+    EXPECT_EQ(response.result, ControlResult::Ok);
+}
+
+TEST_F(ControlServerTest, BadFrameLengthClosesConnection) {
+    ControlClient client;
+    ASSERT_TRUE(client.connect(socketPath));
+
+    uint32_t zero = 0;
+    ASSERT_EQ(send(client.getFd(), &zero, sizeof(zero), 0), static_cast<ssize_t>(sizeof(zero)));
+    ControlResponse response;
+    EXPECT_FALSE(client.receive(response));
+}
+
+#endif
@@ -0,0 +1,402 @@
+#include <gtest/gtest.h>
+#include "EventEngine.hpp"
+#include "Types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class EventEngineTest : public ::testing::Test {
+protected:
+    EventEngine engine;
+
+    void SetUp() override {
+        engine.start();
+    }
+};
+
+TEST_F(EventEngineTest, InitiallyEmpty) {
+    EXPECT_FALSE(engine.hasEvents());
+    EXPECT_EQ(engine.getQueueSize(), 0u);
+    EXPECT_FALSE(engine.popEvent().has_value());
+}
+
+TEST_F(EventEngineTest, EventsAreClassifiedIntoLanes) {
+    EXPECT_EQ(eventPriority(EventType::CMD_EMERGENCY), EventPriority::Safety);
+    EXPECT_EQ(eventPriority(EventType::FAULT_MOTOR), EventPriority::Safety);
+    EXPECT_EQ(eventPriority(EventType::CMD_START), EventPriority::Command);
+    EXPECT_EQ(eventPriority(EventType::SYS_WASH_COMPLETE), EventPriority::System);
+    EXPECT_EQ(eventPriority(EventType::TIMER_TICK), EventPriority::Telemetry);
+}
+
+TEST_F(EventEngineTest, FifoWithinLane) {
+    engine.pushEvent(EventType::CMD_SELECT_MODE, 2);
+    engine.pushEvent(EventType::CMD_START);
+
+    auto first = engine.popEvent();
+    auto second = engine.popEvent();
+    ASSERT_TRUE(first && second);
+    EXPECT_EQ(first->getType(), EventType::CMD_SELECT_MODE);
+    EXPECT_EQ(first->getData<int>(), 2);
+    EXPECT_EQ(second->getType(), EventType::CMD_START);
+}
+
+TEST_F(EventEngineTest, SafetyPreemptsRoutineTraffic) {
+    for (int i = 0; i < 100; i++) {
+        engine.pushEvent(EventType::TIMER_TICK);
+        engine.pushEvent(EventType::SYS_DRAIN_COMPLETE);
+    }
+    engine.pushEvent(EventType::CMD_PAUSE);
+    engine.pushEvent(EventType::CMD_EMERGENCY);
+
+    auto first = engine.popEvent();
+    auto second = engine.popEvent();
+    auto third = engine.popEvent();
+    ASSERT_TRUE(first && second && third);
+    EXPECT_EQ(first->getType(), EventType::CMD_EMERGENCY);
+    EXPECT_EQ(second->getType(), EventType::CMD_PAUSE);
+    EXPECT_EQ(third->getType(), EventType::SYS_DRAIN_COMPLETE);
+}
+
+TEST_F(EventEngineTest, LaneDepthIsExposed) {
+    engine.pushEvent(EventType::TIMER_TICK);
+    engine.pushEvent(EventType::TIMER_TICK);
+    engine.pushEvent(EventType::FAULT_DOOR);
+
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Telemetry), 2u);
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Safety), 1u);
+    EXPECT_EQ(engine.getQueueSize(), 3u);
+
+    engine.popEvent();
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Safety), 0u);
+}
+
+TEST_F(EventEngineTest, LaneStatsTrackWaitTime) {
+    engine.pushEvent(EventType::SYS_WASH_COMPLETE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    engine.popEvent();
+
+    EventLaneStats stats = engine.getLaneStats(EventPriority::System);
+    EXPECT_EQ(stats.pushed, 1u);
+    EXPECT_EQ(stats.popped, 1u);
+    EXPECT_GE(stats.maxWaitMicros, 1000.0);
+    EXPECT_GE(stats.averageWaitMicros, 1000.0);
+
+    engine.resetLaneStats();
+    EXPECT_EQ(engine.getLaneStats(EventPriority::System).popped, 0u);
+}
+
+TEST_F(EventEngineTest, CoalescesDuplicateIdempotentEvents) {
+    engine.setCoalescing(EventType::SYS_WASH_COMPLETE, true);
+    for (int i = 0; i < 10; i++) {
+        engine.pushEvent(EventType::SYS_WASH_COMPLETE);
+    }
+
+    EXPECT_EQ(engine.getQueueSize(), 1u);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::System).coalesced, 9u);
+
+    engine.popEvent();
+    engine.pushEvent(EventType::SYS_WASH_COMPLETE);
+    EXPECT_EQ(engine.getQueueSize(), 1u);
+}
+
+TEST_F(EventEngineTest, CoalescingLeavesOtherTypesAlone) {
+    engine.setCoalescing(EventType::SYS_WASH_COMPLETE, true);
+    engine.pushEvent(EventType::SYS_RINSE_COMPLETE);
+    engine.pushEvent(EventType::SYS_RINSE_COMPLETE);
+
+    EXPECT_EQ(engine.getQueueSize(), 2u);
+    EXPECT_FALSE(engine.isCoalescing(EventType::SYS_RINSE_COMPLETE));
+}
+
+TEST_F(EventEngineTest, ClearEmptiesAllLanes) {
+    engine.pushEvent(EventType::CMD_EMERGENCY);
+    engine.pushEvent(EventType::CMD_START);
+    engine.pushEvent(EventType::TIMER_TICK);
+
+    engine.clear();
+    EXPECT_FALSE(engine.hasEvents());
+    EXPECT_FALSE(engine.popEvent().has_value());
+}
+
+TEST_F(EventEngineTest, WaitForEventWakesOnPush) {
+    std::thread producer([this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        engine.pushEvent(EventType::CMD_START);
+    });
+
+    auto event = engine.waitForEvent();
+    producer.join();
+    ASSERT_TRUE(event.has_value());
+    EXPECT_EQ(event->getType(), EventType::CMD_START);
+}
+
+TEST_F(EventEngineTest, WaitForEventReturnsOnStop) {
+    std::thread stopper([this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        engine.stop();
+    });
+
+    auto event = engine.waitForEvent();
+    stopper.join();
+    EXPECT_FALSE(event.has_value());
+}
+
+TEST_F(EventEngineTest, ConcurrentProducersLoseNothing) {
+    const int producers = 4;
+    const int perProducer = 5000;
+    std::vector<std::thread> threads;
+    // Blocked producers only wait once a consumer exists; before that they
+    // spill and, with the spill full, are rejected.
+    engine.popEvent();
+    engine.setOverflowPolicy(EventPriority::Command, OverflowPolicy::Block);
+    engine.setOverflowPolicy(EventPriority::Telemetry, OverflowPolicy::Block);
+
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([this, p] {
+            EventType type = (p % 2 == 0) ? EventType::CMD_START : EventType::TIMER_TICK;
+            for (int i = 0; i < perProducer; i++) {
+                engine.pushEvent(type, i);
+            }
+        });
+    }
+
+    int received = 0;
+    while (received < producers * perProducer) {
+        if (engine.popEvent()) {
+            received++;
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(received, producers * perProducer);
+    EXPECT_FALSE(engine.hasEvents());
+}
+
+TEST_F(EventEngineTest, LanesAreBoundedWithDefaultPolicies) {
+    EXPECT_EQ(engine.getLaneCapacity(EventPriority::Safety), EventEngine::DEFAULT_SAFETY_CAPACITY);
+    EXPECT_EQ(engine.getOverflowPolicy(EventPriority::Safety), OverflowPolicy::Block);
+    EXPECT_EQ(engine.getOverflowPolicy(EventPriority::Command), OverflowPolicy::Reject);
+    EXPECT_EQ(engine.getOverflowPolicy(EventPriority::Telemetry), OverflowPolicy::DropOldest);
+}
+
+TEST_F(EventEngineTest, SafetyLaneCannotBeMadeLossy) {
+    EXPECT_FALSE(engine.setOverflowPolicy(EventPriority::Safety, OverflowPolicy::DropOldest));
+    EXPECT_FALSE(engine.setOverflowPolicy(EventPriority::Safety, OverflowPolicy::Reject));
+    EXPECT_EQ(engine.getOverflowPolicy(EventPriority::Safety), OverflowPolicy::Block);
+}
+
+TEST_F(EventEngineTest, RejectPolicyReturnsErrorWhenFull) {
+    size_t capacity = engine.getLaneCapacity(EventPriority::Command);
+    for (size_t i = 0; i < capacity; i++) {
+        EXPECT_EQ(engine.pushEvent(EventType::CMD_START), PushResult::Accepted);
+    }
+
+    EXPECT_EQ(engine.pushEvent(EventType::CMD_START), PushResult::Rejected);
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Command), capacity);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Command).rejected, 1u);
+}
+
+TEST_F(EventEngineTest, DropOldestKeepsNewestEvents) {
+    size_t capacity = engine.getLaneCapacity(EventPriority::Telemetry);
+    for (size_t i = 0; i < capacity + 10; i++) {
+        engine.pushEvent(EventType::TIMER_TICK, static_cast<int>(i));
+    }
+
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Telemetry), capacity);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Telemetry).dropped, 10u);
+
+    auto first = engine.popEvent();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getData<int>(), 10);
+}
+
+TEST_F(EventEngineTest, DropNewestDiscardsIncoming) {
+    engine.setOverflowPolicy(EventPriority::Telemetry, OverflowPolicy::DropNewest);
+    size_t capacity = engine.getLaneCapacity(EventPriority::Telemetry);
+    for (size_t i = 0; i < capacity + 5; i++) {
+        engine.pushEvent(EventType::TIMER_TICK, static_cast<int>(i));
+    }
+
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Telemetry).dropped, 5u);
+    auto first = engine.popEvent();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getData<int>(), 0);
+}
+
+TEST_F(EventEngineTest, ConsumerThreadOverflowSpillsInsteadOfDeadlocking) {
+    engine.popEvent();
+    size_t capacity = engine.getLaneCapacity(EventPriority::System);
+    for (size_t i = 0; i < capacity * 2; i++) {
+        EXPECT_EQ(engine.pushEvent(EventType::SYS_WATER_LEVEL_REACHED, static_cast<int>(i)), PushResult::Accepted);
+    }
+    EXPECT_EQ(engine.pushEvent(EventType::SYS_WATER_LEVEL_REACHED, -1), PushResult::Rejected);
+
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::System), capacity * 2);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::System).spilled, capacity);
+    for (size_t i = 0; i < capacity * 2; i++) {
+        auto event = engine.popEvent();
+        ASSERT_TRUE(event.has_value());
+        EXPECT_EQ(event->getData<int>(), static_cast<int>(i));
+    }
+    EXPECT_FALSE(engine.popEvent().has_value());
+}
+
+TEST_F(EventEngineTest, SafetyLaneNeverRejectsFromTheConsumerThread) {
+    engine.popEvent();
+    size_t capacity = engine.getLaneCapacity(EventPriority::Safety);
+    size_t count = capacity * 5;
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(engine.pushEvent(EventType::FAULT_MOTOR, static_cast<int>(i)), PushResult::Accepted);
+    }
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Safety), count);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Safety).rejected, 0u);
+
+    // Pushes made while the overflow drains still land behind it.
+    size_t next = count;
+    for (size_t i = 0; i < count + capacity; i++) {
+        auto event = engine.popEvent();
+        ASSERT_TRUE(event.has_value());
+        EXPECT_EQ(event->getData<int>(), static_cast<int>(i));
+        if (i % 3 == 0 && next < count + capacity) {
+            engine.pushEvent(EventType::FAULT_MOTOR, static_cast<int>(next++));
+        }
+    }
+    EXPECT_FALSE(engine.popEvent().has_value());
+}
+
+TEST_F(EventEngineTest, SafetyPushesAfterStopAreKept) {
+    engine.stop();
+    size_t capacity = engine.getLaneCapacity(EventPriority::Safety);
+    for (size_t i = 0; i < capacity * 3; i++) {
+        EXPECT_EQ(engine.pushEvent(EventType::CMD_EMERGENCY), PushResult::Accepted);
+    }
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::Safety), capacity * 3);
+}
+
+TEST_F(EventEngineTest, BlockedProducerWakesWhenConsumerPops) {
+    engine.popEvent();
+    size_t capacity = engine.getLaneCapacity(EventPriority::System);
+    std::atomic<size_t> pushed{0};
+    std::thread producer([this, capacity, &pushed] {
+        for (size_t i = 0; i < capacity + 1; i++) {
+            engine.pushEvent(EventType::SYS_WATER_LEVEL_REACHED, static_cast<int>(i));
+            pushed++;
+        }
+    });
+    while (engine.getLaneStats(EventPriority::System).blocked == 0) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(pushed.load(), capacity);
+
+    auto first = engine.popEvent();
+    producer.join();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getData<int>(), 0);
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::System), capacity);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::System).rejected, 0u);
+}
+
+TEST_F(EventEngineTest, StopReleasesBlockedProducer) {
+    engine.popEvent();
+    size_t capacity = engine.getLaneCapacity(EventPriority::System);
+    for (size_t i = 0; i < capacity; i++) {
+        engine.pushEvent(EventType::SYS_WATER_LEVEL_REACHED, static_cast<int>(i));
+    }
+    PushResult result = PushResult::Accepted;
+    std::thread producer([this, &result] {
+        result = engine.pushEvent(EventType::SYS_WATER_LEVEL_REACHED, -1);
+    });
+    while (engine.getLaneStats(EventPriority::System).blocked == 0) {
+        std::this_thread::yield();
+    }
+    engine.stop();
+    producer.join();
+    // With the consumer gone the push spills rather than waiting forever.
+    EXPECT_EQ(result, PushResult::Accepted);
+    EXPECT_EQ(engine.getLaneDepth(EventPriority::System), capacity + 1);
+}
+
+TEST_F(EventEngineTest, PushesQueueBehindSpilledEvents) {
+    engine.popEvent();
+    size_t capacity = engine.getLaneCapacity(EventPriority::Safety);
+    int next = 0;
+    for (size_t i = 0; i < capacity + 2; i++) {
+        engine.pushEvent(EventType::FAULT_MOTOR, next++);
+    }
+
+    // Room in the queue again, but two events are still spilled.
+    auto first = engine.popEvent();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getData<int>(), 0);
+    std::thread producer([this, &next] { engine.pushEvent(EventType::FAULT_MOTOR, next); });
+    producer.join();
+
+    for (int expected = 1; expected <= next; expected++) {
+        auto event = engine.popEvent();
+        ASSERT_TRUE(event.has_value());
+        EXPECT_EQ(event->getData<int>(), expected);
+    }
+}
+
+TEST_F(EventEngineTest, DropOldestReleasesCoalescedType) {
+    engine.setCoalescing(EventType::TIMER_TICK, true);
+    size_t capacity = engine.getLaneCapacity(EventPriority::Telemetry);
+    EXPECT_EQ(engine.pushEvent(EventType::TIMER_TICK), PushResult::Accepted);
+    for (size_t i = 0; i < capacity; i++) {
+        engine.pushEvent(EventType::TIMER_TICK, static_cast<int>(i));
+    }
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Telemetry).dropped, 1u);
+
+    EXPECT_NE(engine.pushEvent(EventType::TIMER_TICK), PushResult::Coalesced);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Telemetry).coalesced, 0u);
+}
+
+TEST_F(EventEngineTest, OverloadKeepsMemoryFlatAndSafetyIntact) {
+    engine.popEvent();
+    std::atomic<bool> done{false};
+    const int safetyEvents = 2000;
+
+    std::thread flooder([this, &done] {
+        while (!done) {
+            engine.pushEvent(EventType::TIMER_TICK);
+            engine.pushEvent(EventType::CMD_SET_LOAD, 1.0f);
+        }
+    });
+
+    std::thread safetyProducer([this] {
+        for (int i = 0; i < safetyEvents; i++) {
+            engine.pushEvent(EventType::FAULT_MOTOR, i);
+        }
+    });
+
+    int safetyReceived = 0;
+    int nextExpected = 0;
+    bool ordered = true;
+    size_t maxDepth = 0;
+    while (safetyReceived < safetyEvents) {
+        maxDepth = std::max(maxDepth, engine.getQueueSize());
+        auto event = engine.popEvent();
+        if (event && event->getType() == EventType::FAULT_MOTOR) {
+            ordered = ordered && event->getData<int>() == nextExpected;
+            nextExpected++;
+            safetyReceived++;
+        }
+    }
+
+    done = true;
+    flooder.join();
+    safetyProducer.join();
+
+    EXPECT_EQ(safetyReceived, safetyEvents);
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(engine.getLaneStats(EventPriority::Safety).dropped, 0u);
+
+    size_t totalCapacity = 0;
+    for (size_t i = 0; i < EVENT_PRIORITY_COUNT; i++) {
+        totalCapacity += engine.getLaneCapacity(static_cast<EventPriority>(i));
+    }
+    EXPECT_LE(maxDepth, totalCapacity + 2);
+}
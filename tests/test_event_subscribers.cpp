@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "EventSubscribers.hpp"
+#include "Fleet.hpp"
+#include "WashingMachine.hpp"
+
+#include <vector>
+
+namespace {
+
+// Counts phase completions; compiled into the core as a SubscriberPolicy.
+struct PhaseCounter {
+    static constexpr EventMask events =
+        eventMask(EventType::SYS_WASH_COMPLETE, EventType::SYS_RINSE_COMPLETE, EventType::SYS_SPIN_COMPLETE);
+    int completed = 0;
+
+    void onEvent(const Event&) {
+        completed++;
+    }
+};
+
+// Counts completed fills.
+struct FillWatcher {
+    static constexpr EventMask events = eventMask(EventType::SYS_WATER_LEVEL_REACHED);
+    int fills = 0;
+
+    void onEvent(const Event&) {
+        fills++;
+    }
+};
+
+using InlineMachine = BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, InlineEventSink>;
+using CountingMachine = BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, InlineEventSink,
+                                            StaticSubscribers<PhaseCounter, FillWatcher>>;
+
+static_assert(NoSubscribers::events == 0, "no static subscribers, no mask");
+static_assert(StaticSubscribers<PhaseCounter, FillWatcher>::events ==
+                  (PhaseCounter::events | FillWatcher::events),
+              "the policy's mask is the union of its subscribers'");
+
+template<typename Machine>
+void runCycle(Machine& machine) {
+    machine.initialize();
+    machine.setOutput(nullptr);
+    machine.closeDoor();
+    machine.setLoad(3.0f);
+    machine.selectMode(0);
+    machine.tick(0.1f);
+    machine.start();
+    for (int t = 0; t < 3000 && machine.getCurrentState() != State::Completed; t++) {
+        machine.tick(1.0f);
+    }
+}
+
+}
+
+TEST(EventSubscribersTest, DispatchesOnlyToSubscribersOfTheType) {
+    EventSubscribers subscribers;
+    int starts = 0;
+    int pauses = 0;
+    subscribers.subscribe(EventType::CMD_START, [&](EventSubscribers::MachineId, const Event&) { starts++; });
+    subscribers.subscribe(EventType::CMD_START, [&](EventSubscribers::MachineId, const Event&) { starts++; });
+    subscribers.subscribe(EventType::CMD_PAUSE, [&](EventSubscribers::MachineId, const Event&) { pauses++; });
+
+    EXPECT_EQ(subscribers.getSubscriberCount(EventType::CMD_START), 2u);
+    EXPECT_FALSE(subscribers.hasSubscribers(EventType::CMD_STOP));
+
+    subscribers.publish(0, Event(EventType::CMD_START));
+    subscribers.publish(0, Event(EventType::CMD_STOP));
+    EXPECT_EQ(starts, 2);
+    EXPECT_EQ(pauses, 0);
+}
+
+TEST(EventSubscribersTest, UnsubscribeClearsTheTypeBit) {
+    EventSubscribers subscribers;
+    int calls = 0;
+    auto handler = [&](EventSubscribers::MachineId, const Event&) { calls++; };
+    auto id = subscribers.subscribe(eventMask(EventType::CMD_START, EventType::CMD_STOP), handler);
+    auto other = subscribers.subscribe(EventType::CMD_STOP, handler);
+    EXPECT_EQ(subscribers.getSubscribedTypes(), eventMask(EventType::CMD_START, EventType::CMD_STOP));
+
+    EXPECT_TRUE(subscribers.unsubscribe(id));
+    EXPECT_FALSE(subscribers.unsubscribe(id));
+    EXPECT_FALSE(subscribers.hasSubscribers(EventType::CMD_START));
+    EXPECT_TRUE(subscribers.hasSubscribers(EventType::CMD_STOP));
+
+    subscribers.publish(0, Event(EventType::CMD_START));
+    subscribers.publish(0, Event(EventType::CMD_STOP));
+    EXPECT_EQ(calls, 1);
+
+    EXPECT_TRUE(subscribers.unsubscribe(other));
+    EXPECT_EQ(subscribers.getSubscribedTypes(), 0u);
+    EXPECT_EQ(subscribers.subscribe(EventMask(0), handler), EventSubscribers::NO_SUBSCRIPTION);
+}
+
+TEST(EventSubscribersTest, MachinePublishesAfterHandling) {
+    EventSubscribers subscribers;
+    std::vector<State> statesAtFill;
+    int completions = 0;
+    InlineMachine machine;
+    subscribers.subscribe(EventType::SYS_WATER_LEVEL_REACHED, [&](EventSubscribers::MachineId, const Event&) {
+        statesAtFill.push_back(machine.getCurrentState());
+    });
+    subscribers.subscribe(EventType::SYS_SPIN_COMPLETE, [&](EventSubscribers::MachineId, const Event&) {
+        completions++;
+    });
+    machine.connectSubscribers(&subscribers, 7);
+
+    runCycle(machine);
+    EXPECT_EQ(machine.getCurrentState(), State::Completed);
+    ASSERT_FALSE(statesAtFill.empty());
+    EXPECT_EQ(statesAtFill.front(), State::Washing);
+    EXPECT_EQ(completions, 1);
+}
+
+TEST(EventSubscribersTest, StaticSubscribersLeaveTheCycleUnchanged) {
+    InlineMachine plain;
+    CountingMachine counted;
+    runCycle(plain);
+    runCycle(counted);
+
+    EXPECT_EQ(counted.getCurrentState(), State::Completed);
+    EXPECT_EQ(counted.getSubscriberPolicy().get<PhaseCounter>().completed, 3);
+    EXPECT_GE(counted.getSubscriberPolicy().get<FillWatcher>().fills, 1);
+    EXPECT_EQ(plain.saveCheckpoint(), counted.saveCheckpoint());
+}
+
+TEST(EventSubscribersTest, FleetTagsEventsWithTheMachineId) {
+    EventSubscribers subscribers;
+    std::vector<EventSubscribers::MachineId> sources;
+    subscribers.subscribe(EventType::CMD_SELECT_MODE, [&](EventSubscribers::MachineId source, const Event& event) {
+        sources.push_back(source);
+        EXPECT_EQ(event.getData<int>(), 2);
+    });
+
+    Fleet fleet(2);
+    fleet.connectSubscribers(&subscribers);
+    fleet.addMachine();
+    fleet.getMachine(2).selectMode(2);
+    fleet.getMachine(1).selectMode(2);
+    fleet.tick(0.1f);
+
+    EXPECT_EQ(sources, (std::vector<EventSubscribers::MachineId>{1, 2}));
+}
+
+TEST(EventSubscribersTest, DetachedCoreDropsRuntimeSubscribers) {
+    EventSubscribers subscribers;
+    int calls = 0;
+    subscribers.subscribe(EventType::SYS_WATER_LEVEL_REACHED, [&](EventSubscribers::MachineId, const Event&) { calls++; });
+    CountingMachine machine;
+    machine.connectSubscribers(&subscribers);
+    machine.initialize();
+    machine.setOutput(nullptr);
+    machine.closeDoor();
+    machine.setLoad(3.0f);
+    machine.selectMode(0);
+    machine.tick(0.1f);
+    machine.start();
+    machine.tick(1.0f);
+    ASSERT_EQ(machine.getCurrentState(), State::Filling);
+
+    auto branch = machine.detachCore();
+    for (int t = 0; t < 3000 && branch.getCurrentState() != State::Completed; t++) {
+        branch.step(1.0f);
+    }
+    EXPECT_EQ(branch.getCurrentState(), State::Completed);
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(branch.getSubscriberPolicy().get<PhaseCounter>().completed, 3);
+    EXPECT_EQ(machine.getSubscriberPolicy().get<PhaseCounter>().completed, 0);
+}
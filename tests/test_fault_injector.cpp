@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include "CounterRng.hpp"
+#include "FaultInjector.hpp"
+#include "Fleet.hpp"
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using FaultTrace = std::vector<std::vector<FaultCode>>;
+
+FaultTrace runTrace(uint64_t seed, size_t machines, unsigned threads, double step, double horizon) {
+    FaultInjector injector(seed, machines);
+    injector.setRate(FaultCode::MotorFault, 3.0);
+    injector.setRate(FaultCode::DoorFault, 1.0);
+    injector.setRate(FaultCode::Timeout, 0.5);
+    injector.setThreadCount(threads);
+
+    FaultTrace trace(machines);
+    auto sink = [&trace](size_t machine, FaultCode fault) {
+        trace[machine].push_back(fault);
+        return true;
+    };
+    for (double t = 0.0; t < horizon; t += step) {
+        injector.advance(step, sink);
+    }
+    return trace;
+}
+
+void runUntil(WashingMachine& machine, State state) {
+    for (int i = 0; i < 200 && machine.getCurrentState() != state; i++) {
+        machine.tick(1.0f);
+    }
+}
+
+}
+
+TEST(CounterRngTest, PhiloxMatchesKnownAnswers) {
+    Philox4x32::Counter zero = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+    EXPECT_EQ(zero[0], 0x6627e8d5u);
+    EXPECT_EQ(zero[1], 0xe169c58du);
+    EXPECT_EQ(zero[2], 0xbc57ac4cu);
+    EXPECT_EQ(zero[3], 0x9b00dbd8u);
+
+    Philox4x32::Counter ones = Philox4x32::generate(
+        {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu});
+    EXPECT_EQ(ones[0], 0x408f276du);
+    EXPECT_EQ(ones[1], 0x41c83b0eu);
+    EXPECT_EQ(ones[2], 0xa20bc7c6u);
+    EXPECT_EQ(ones[3], 0x6d5451fdu);
+}
+
+TEST(CounterRngTest, DrawsArePureFunctionsOfPosition) {
+    CounterRng rng(42, 7);
+    uint64_t first = rng.next();
+    uint64_t second = rng.next();
+
+    EXPECT_EQ(CounterRng::at(42, 7, 0), first);
+    EXPECT_EQ(CounterRng::at(42, 7, 1), second);
+    EXPECT_NE(CounterRng::at(42, 8, 0), first);
+    EXPECT_NE(CounterRng::at(43, 7, 0), first);
+
+    rng.setPosition(0);
+    EXPECT_EQ(rng.next(), first);
+}
+
+TEST(CounterRngTest, UniformStaysInUnitInterval) {
+    CounterRng rng(1, 1);
+    double sum = 0.0;
+    for (int i = 0; i < 100000; i++) {
+        double u = rng.nextUniform();
+        ASSERT_GT(u, 0.0);
+        ASSERT_LE(u, 1.0);
+        sum += u;
+    }
+    EXPECT_NEAR(sum / 100000.0, 0.5, 0.01);
+}
+
+TEST(FaultInjectorTest, NoRatesNoFaults) {
+    FaultInjector injector(1, 100);
+    size_t calls = 0;
+    for (int i = 0; i < 100; i++) {
+        injector.advance(60.0, [&calls](size_t, FaultCode) {
+            calls++;
+            return true;
+        });
+    }
+    EXPECT_EQ(calls, 0u);
+    EXPECT_EQ(injector.getStats().total(), 0u);
+}
+
+TEST(FaultInjectorTest, ScheduledFaultFiresOnceWhenDue) {
+    FaultInjector injector(1, 4);
+    injector.schedule(2, FaultCode::Overload, 10.0);
+
+    std::vector<std::pair<size_t, FaultCode>> fired;
+    auto sink = [&fired](size_t machine, FaultCode fault) {
+        fired.emplace_back(machine, fault);
+        return true;
+    };
+    injector.advance(9.0, sink);
+    EXPECT_TRUE(fired.empty());
+    injector.advance(1.0, sink);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].first, 2u);
+    EXPECT_EQ(fired[0].second, FaultCode::Overload);
+    injector.advance(100.0, sink);
+    EXPECT_EQ(fired.size(), 1u);
+
+    FaultInjectorStats stats = injector.getStats();
+    EXPECT_EQ(stats.scheduled, 1u);
+    EXPECT_EQ(stats.injected[faultSlot(FaultCode::Overload)], 1u);
+    EXPECT_EQ(injector.getScheduledCount(), 0u);
+}
+
+TEST(FaultInjectorTest, SameSeedReproducesRegardlessOfStepAndThreads) {
+    FaultTrace serial = runTrace(99, 10000, 1, 1.0, 1800.0);
+    FaultTrace parallel = runTrace(99, 10000, 2, 8.0, 1800.0);
+    EXPECT_EQ(serial, parallel);
+
+    size_t total = 0;
+    for (const auto& faults : serial) {
+        total += faults.size();
+    }
+    EXPECT_GT(total, 0u);
+
+    FaultTrace other = runTrace(100, 10000, 1, 1.0, 1800.0);
+    EXPECT_NE(serial, other);
+}
+
+TEST(FaultInjectorTest, MachineStreamDoesNotDependOnFleetSize) {
+    FaultTrace small = runTrace(5, 10, 1, 10.0, 7200.0);
+    FaultTrace large = runTrace(5, 1000, 1, 10.0, 7200.0);
+    for (size_t machine = 0; machine < small.size(); machine++) {
+        EXPECT_EQ(small[machine], large[machine]);
+    }
+}
+
+TEST(FaultInjectorTest, ObservedRateMatchesConfiguredRate) {
+    FaultInjector injector(3, 10000);
+    injector.setRate(FaultCode::MotorFault, 6.0);
+    injector.setRate(5, FaultCode::MotorFault, 0.0);
+
+    std::atomic<size_t> machineFiveFaults{0};
+    for (int minute = 0; minute < 60; minute++) {
+        injector.advance(60.0, [&machineFiveFaults](size_t machine, FaultCode) {
+            if (machine == 5) {
+                machineFiveFaults++;
+            }
+            return true;
+        });
+    }
+
+    double expected = 6.0 * 9999;
+    double observed = static_cast<double>(injector.getStats().injected[faultSlot(FaultCode::MotorFault)]);
+    EXPECT_NEAR(observed, expected, expected * 0.03);
+    EXPECT_EQ(machineFiveFaults.load(), 0u);
+    EXPECT_DOUBLE_EQ(injector.getRate(5, FaultCode::MotorFault), 0.0);
+    EXPECT_DOUBLE_EQ(injector.getRate(6, FaultCode::MotorFault), 6.0);
+}
+
+TEST(FaultInjectorTest, InjectedFaultStopsRunningCycle) {
+    Fleet fleet(2);
+    WashingMachine& machine = fleet.getMachine(1);
+    machine.closeDoor();
+    machine.selectMode(0);
+    machine.setLoad(3.0f);
+    machine.start();
+    runUntil(machine, State::Washing);
+    ASSERT_EQ(machine.getCurrentState(), State::Washing);
+
+    FaultInjector injector(1, fleet.size());
+    injector.schedule(1, FaultCode::MotorFault, 1.0);
+    EXPECT_EQ(injector.advance(fleet, 1.0), 1u);
+    fleet.tick(0.1f);
+
+    SystemStatus status = machine.getStatus();
+    EXPECT_EQ(status.state, State::Fault);
+    EXPECT_EQ(status.fault, FaultCode::MotorFault);
+    EXPECT_EQ(status.motorRPM, 0);
+    EXPECT_EQ(status.doorStatus, DoorStatus::ClosedLocked);
+
+    machine.clearFault();
+    runUntil(machine, State::Idle);
+    for (int i = 0; i < 200 && machine.getStatus().doorStatus == DoorStatus::ClosedLocked; i++) {
+        machine.tick(1.0f);
+    }
+    status = machine.getStatus();
+    EXPECT_EQ(status.state, State::Idle);
+    EXPECT_EQ(status.waterLevel, 0.0f);
+    EXPECT_EQ(status.doorStatus, DoorStatus::ClosedUnlocked);
+}
+
+TEST(FaultInjectorTest, FaultOutsideItsPhaseIsIgnored) {
+    Fleet fleet(1);
+    FaultInjector injector(1, 1);
+    injector.schedule(0, FaultCode::Overload, 0.0);
+    injector.schedule(0, FaultCode::Timeout, 0.0);
+    injector.advance(fleet, 0.0);
+    fleet.tick(0.1f);
+
+    SystemStatus status = fleet.getMachine(0).getStatus();
+    EXPECT_EQ(status.state, State::Idle);
+    EXPECT_EQ(status.fault, FaultCode::None);
+}
+
+TEST(FaultInjectorTest, FaultsBeyondFleetAreRejected) {
+    Fleet fleet(2);
+    FaultInjector injector(1, 4);
+    injector.schedule(3, FaultCode::DoorFault, 0.0);
+    injector.schedule(9, FaultCode::DoorFault, 0.0);
+    injector.advance(fleet, 1.0);
+
+    FaultInjectorStats stats = injector.getStats();
+    EXPECT_EQ(stats.total(), 0u);
+    EXPECT_EQ(stats.rejected, 2u);
+}
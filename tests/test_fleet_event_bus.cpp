@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include "FleetEventBus.hpp"
+#include "ShardedFleet.hpp"
+#include "CounterRng.hpp"
+
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using MachineId = FleetEventBus::MachineId;
+
+struct Delivery {
+    MachineId machine;
+    EventType type;
+    int sequence;
+};
+
+std::vector<Delivery> drainAll(FleetEventBus& bus, size_t shard) {
+    std::vector<Delivery> log;
+    bus.drain(shard, [&log](MachineId machine, const Event& event) {
+        log.push_back({machine, event.getType(), event.hasData() ? event.getData<int>() : -1});
+    });
+    return log;
+}
+
+void applyCommand(uint64_t choice, uint64_t value, MachineCore& core) {
+    switch (choice % 12) {
+        case 0: core.openDoor(); break;
+        case 1: case 2: core.closeDoor(); break;
+        case 3: core.selectMode(static_cast<int>(value % 5) - 1); break;
+        case 4: core.setLoad(static_cast<float>(value % 80) / 10.0f - 0.5f); break;
+        case 5: case 6: core.start(); break;
+        case 7: core.pause(); break;
+        case 8: core.resume(); break;
+        case 9: core.stop(); break;
+        case 10: core.emergencyStop(); break;
+        case 11: core.injectFault(static_cast<FaultCode>(value % 6)); break;
+        default: break;
+    }
+}
+
+void expectSameCore(const MachineCore& a, const MachineCore& b, MachineId id, int step) {
+    SystemStatus x = a.getStatus();
+    SystemStatus y = b.getStatus();
+    ASSERT_EQ(x.state, y.state) << "machine " << id << " step " << step;
+    ASSERT_EQ(x.doorStatus, y.doorStatus) << "machine " << id << " step " << step;
+    ASSERT_EQ(std::memcmp(&x.waterLevel, &y.waterLevel, sizeof(float)), 0) << "machine " << id << " step " << step;
+    ASSERT_EQ(x.motorRPM, y.motorRPM) << "machine " << id << " step " << step;
+    ASSERT_EQ(x.loadKg, y.loadKg) << "machine " << id << " step " << step;
+    ASSERT_EQ(x.modeIndex, y.modeIndex) << "machine " << id << " step " << step;
+    ASSERT_EQ(std::memcmp(&x.progressPercent, &y.progressPercent, sizeof(float)), 0)
+        << "machine " << id << " step " << step;
+    ASSERT_EQ(x.fault, y.fault) << "machine " << id << " step " << step;
+    ASSERT_EQ(a.getPausedFromState(), b.getPausedFromState()) << "machine " << id << " step " << step;
+}
+
+}
+
+TEST(FleetEventBusTest, DrainGroupsByMachineAndKeepsPostingOrder) {
+    FleetEventBus bus(1);
+    bus.post(7, Event(EventType::CMD_START, 0));
+    bus.post(3, Event(EventType::CMD_START, 1));
+    bus.post(7, Event(EventType::CMD_PAUSE, 2));
+    bus.post(3, Event(EventType::CMD_STOP, 3));
+    bus.post(5, Event(EventType::CMD_STOP, 4));
+    bus.post(7, Event(EventType::CMD_RESUME, 5));
+    EXPECT_EQ(bus.getPendingCount(), 6u);
+
+    std::vector<Delivery> log = drainAll(bus, 0);
+    ASSERT_EQ(log.size(), 6u);
+    std::vector<MachineId> machines;
+    std::vector<int> sequences;
+    for (const Delivery& d : log) {
+        machines.push_back(d.machine);
+        sequences.push_back(d.sequence);
+    }
+    EXPECT_EQ(machines, (std::vector<MachineId>{3, 3, 5, 7, 7, 7}));
+    EXPECT_EQ(sequences, (std::vector<int>{1, 3, 4, 0, 2, 5}));
+    EXPECT_EQ(bus.getPendingCount(), 0u);
+    EXPECT_EQ(bus.getHandledCount(0), 6u);
+}
+
+TEST(FleetEventBusTest, MachinesAreSplitAcrossShardsByModulo) {
+    FleetEventBus bus(4);
+    EXPECT_EQ(bus.getShardCount(), 4u);
+    for (MachineId id = 0; id < 20; id++) {
+        bus.post(id, Event(EventType::CMD_STOP));
+        EXPECT_EQ(bus.shardOf(id), id % 4);
+    }
+    for (size_t shard = 0; shard < 4; shard++) {
+        EXPECT_EQ(bus.getPendingCount(shard), 5u);
+        for (const Delivery& d : drainAll(bus, shard)) {
+            EXPECT_EQ(d.machine % 4, shard);
+        }
+    }
+    EXPECT_THROW(FleetEventBus(0), std::invalid_argument);
+}
+
+TEST(FleetEventBusTest, BatchSubmitReachesEveryListedMachineOnce) {
+    FleetEventBus bus(3);
+    std::vector<MachineId> floorTwo = {40, 2, 17, 33, 5, 8};
+    bus.submit(floorTwo, Event(EventType::CMD_EMERGENCY));
+    bus.submitRange(100, 110, Event(EventType::CMD_STOP));
+    bus.submitRange(7, 7, Event(EventType::CMD_STOP));
+
+    std::map<MachineId, std::vector<EventType>> received;
+    for (size_t shard = 0; shard < 3; shard++) {
+        for (const Delivery& d : drainAll(bus, shard)) {
+            received[d.machine].push_back(d.type);
+        }
+    }
+    EXPECT_EQ(received.size(), floorTwo.size() + 10);
+    for (MachineId id : floorTwo) {
+        EXPECT_EQ(received[id], std::vector<EventType>{EventType::CMD_EMERGENCY}) << id;
+    }
+    for (MachineId id = 100; id < 110; id++) {
+        EXPECT_EQ(received[id], std::vector<EventType>{EventType::CMD_STOP}) << id;
+    }
+    EXPECT_EQ(bus.getPostedCount(0) + bus.getPostedCount(1) + bus.getPostedCount(2), 16u);
+}
+
+TEST(FleetEventBusTest, EventsPostedWhileDrainingRunInALaterRound) {
+    FleetEventBus bus(2);
+    bus.post(4, Event(EventType::CMD_START, 0));
+    bus.post(2, Event(EventType::CMD_START, 1));
+    std::vector<Delivery> log;
+    size_t handled = bus.drain(0, [&](MachineId machine, const Event& event) {
+        int sequence = event.getData<int>();
+        log.push_back({machine, event.getType(), sequence});
+        if (sequence < 2) {
+            bus.post(machine, Event(EventType::SYS_WATER_LEVEL_REACHED, sequence + 2));
+        }
+    });
+    EXPECT_EQ(handled, 4u);
+    ASSERT_EQ(log.size(), 4u);
+    EXPECT_EQ(log[0].machine, 2u);
+    EXPECT_EQ(log[1].machine, 4u);
+    EXPECT_EQ(log[2].sequence, 3);
+    EXPECT_EQ(log[3].sequence, 2);
+    EXPECT_EQ(bus.getRoundCount(0), 2u);
+}
+
+TEST(FleetEventBusTest, ConcurrentProducersKeepPerMachineOrder) {
+    const size_t producers = 4;
+    const int perMachine = 500;
+    const MachineId machines = 64;
+    FleetEventBus bus(3);
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&bus, p] {
+            for (int seq = 0; seq < perMachine; seq++) {
+                for (MachineId id = static_cast<MachineId>(p); id < machines; id += producers) {
+                    bus.post(id, Event(EventType::CMD_SET_LOAD, seq));
+                }
+            }
+        });
+    }
+
+    std::vector<int> last(machines, -1);
+    size_t handled = 0;
+    auto check = [&](MachineId machine, const Event& event) {
+        int seq = event.getData<int>();
+        EXPECT_EQ(seq, last[machine] + 1) << "machine " << machine;
+        last[machine] = seq;
+        handled++;
+    };
+    // Drain while the producers are still going, then once more at the end.
+    for (int pass = 0; pass < 50; pass++) {
+        for (size_t shard = 0; shard < 3; shard++) {
+            bus.drain(shard, check);
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t shard = 0; shard < 3; shard++) {
+        bus.drain(shard, check);
+    }
+    EXPECT_EQ(handled, static_cast<size_t>(machines) * perMachine);
+}
+
+TEST(FleetEventBusTest, DiscardFromDropsHighIds) {
+    FleetEventBus bus(2);
+    bus.submitRange(0, 10, Event(EventType::CMD_STOP));
+    bus.discardFrom(6);
+    EXPECT_EQ(bus.getPendingCount(), 6u);
+}
+
+TEST(ShardedFleetTest, MatchesDetachedCoresWithRandomCommands) {
+    const MachineId machines = 24;
+    ShardedFleet fleet(machines, 5);
+    std::vector<MachineCore> reference(machines);
+    for (MachineCore& core : reference) {
+        core.setOutput(nullptr);
+    }
+
+    CounterRng rng(44, 0);
+    static const float steps[] = {0.05f, 0.1f, 0.5f, 7.0f, 60.0f, 300.0f};
+    for (int step = 0; step < 3000; step++) {
+        if (rng.next() % 3 == 0) {
+            MachineId id = static_cast<MachineId>(rng.next() % machines);
+            uint64_t choice = rng.next();
+            uint64_t value = rng.next();
+            applyCommand(choice, value, reference[id]);
+            applyCommand(choice, value, fleet.getMachine(id));
+        } else if (rng.next() % 8 == 0) {
+            // A batch emergency stop for every third machine.
+            std::vector<MachineId> ids;
+            for (MachineId id = step % 3; id < machines; id += 3) {
+                ids.push_back(id);
+                reference[id].handleEvent(Event(EventType::CMD_EMERGENCY));
+            }
+            fleet.getBus().submit(ids, Event(EventType::CMD_EMERGENCY));
+            fleet.tick(0.0f);
+            for (MachineId id = 0; id < machines; id++) {
+                reference[id].step(0.0f);
+            }
+        } else {
+            float dt = steps[rng.next() % 6];
+            fleet.tick(dt);
+            for (MachineCore& core : reference) {
+                core.step(dt);
+            }
+        }
+        for (MachineId id = 0; id < machines; id++) {
+            expectSameCore(reference[id], fleet.getMachine(id), id, step);
+        }
+    }
+}
+
+TEST(ShardedFleetTest, QuickWashCompletesOnEveryShard) {
+    ShardedFleet fleet(10, 4);
+    for (ShardedFleet::MachineId id = 0; id < 10; id++) {
+        MachineCore& core = fleet.getMachine(id);
+        core.closeDoor();
+        core.selectMode(0);
+        core.setLoad(3.0f);
+    }
+    fleet.tick(0.1f);
+    for (ShardedFleet::MachineId id = 0; id < 10; id++) {
+        fleet.getMachine(id).start();
+    }
+    for (int i = 0; i < 4000; i++) {
+        fleet.tick(1.0f);
+    }
+    for (ShardedFleet::MachineId id = 0; id < 10; id++) {
+        EXPECT_EQ(fleet.getMachine(id).getCurrentState(), State::Completed) << id;
+    }
+}
+
+TEST(ShardedFleetTest, ShrinkDropsQueuedEventsOfRemovedMachines) {
+    ShardedFleet fleet(8, 2);
+    fleet.getBus().submitRange(0, 8, Event(EventType::CMD_SELECT_MODE, 1));
+    fleet.resize(5);
+    EXPECT_EQ(fleet.size(), 5u);
+    EXPECT_EQ(fleet.getBus().getPendingCount(), 5u);
+    fleet.tick(0.1f);
+    EXPECT_EQ(fleet.getMachine(4).getCurrentState(), State::Ready);
+    fleet.resize(8);
+    EXPECT_EQ(fleet.getMachine(7).getCurrentState(), State::Idle);
+}
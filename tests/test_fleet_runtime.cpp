@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include "FleetRuntime.hpp"
+#include "SpscRing.hpp"
+#include "CounterRng.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Kind = RuntimeCommand::Kind;
+
+void applyTo(MachineCore& core, Kind kind, float value) {
+    switch (kind) {
+        case Kind::OpenDoor: core.openDoor(); break;
+        case Kind::CloseDoor: core.closeDoor(); break;
+        case Kind::SelectMode: core.selectMode(static_cast<int>(value)); break;
+        case Kind::SetLoad: core.setLoad(value); break;
+        case Kind::Start: core.start(); break;
+        case Kind::Pause: core.pause(); break;
+        case Kind::Resume: core.resume(); break;
+        case Kind::Stop: core.stop(); break;
+        case Kind::EmergencyStop: core.emergencyStop(); break;
+        case Kind::ClearFault: core.clearFault(); break;
+        case Kind::InjectFault: core.injectFault(static_cast<FaultCode>(static_cast<int>(value))); break;
+    }
+}
+
+RuntimeOptions unpinned(size_t workers) {
+    RuntimeOptions options;
+    options.workers = workers;
+    options.pin = false;
+    return options;
+}
+
+void startQuickWash(FleetRuntime& runtime) {
+    runtime.broadcast(Kind::CloseDoor);
+    runtime.broadcast(Kind::SelectMode, 0.0f);
+    runtime.broadcast(Kind::SetLoad, 3.0f);
+    runtime.tick(0.1f);
+    runtime.broadcast(Kind::Start);
+}
+
+}
+
+TEST(SpscRingTest, FifoWithinCapacity) {
+    SpscRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(8));
+    EXPECT_EQ(ring.size(), 8u);
+    int value = -1;
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+TEST(SpscRingTest, TwoThreadsKeepOrder) {
+    SpscRing<uint64_t> ring(64);
+    const uint64_t count = 200000;
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < count; i++) {
+            while (!ring.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t expected = 0;
+    uint64_t value = 0;
+    while (expected < count) {
+        if (ring.tryPop(value)) {
+            ASSERT_EQ(value, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(FleetRuntimeTest, SplitsMachinesAcrossWorkers) {
+    FleetRuntime runtime(10, unpinned(3));
+    EXPECT_EQ(runtime.getWorkerCount(), 3u);
+    EXPECT_EQ(runtime.size(), 10u);
+    EXPECT_EQ(runtime.getShardReport(0).machines, 4u);
+    EXPECT_EQ(runtime.getShardReport(1).machines, 3u);
+    EXPECT_EQ(runtime.getShardReport(2).machines, 3u);
+    EXPECT_EQ(runtime.workerOf(7), 1u);
+    EXPECT_EQ(runtime.getTotals().stateCounts[static_cast<size_t>(State::Idle)], 10u);
+    EXPECT_EQ(runtime.getWorkerCpu(0), -1);
+}
+
+TEST(FleetRuntimeTest, MatchesDetachedCoresWithRandomCommands) {
+    const uint32_t machines = 23;
+    FleetRuntime runtime(machines, unpinned(4));
+    std::vector<MachineCore> reference(machines);
+    for (MachineCore& core : reference) {
+        core.setOutput(nullptr);
+    }
+
+    CounterRng rng(45, 0);
+    static const float steps[] = {0.1f, 0.5f, 7.0f, 60.0f, 300.0f};
+    for (int step = 0; step < 1500; step++) {
+        uint64_t roll = rng.next() % 6;
+        if (roll < 2) {
+            uint32_t id = static_cast<uint32_t>(rng.next() % machines);
+            Kind kind = static_cast<Kind>(rng.next() % 11);
+            float value = kind == Kind::SetLoad ? static_cast<float>(rng.next() % 70) / 10.0f
+                                                : static_cast<float>(rng.next() % 5);
+            runtime.send(id, kind, value);
+            applyTo(reference[id], kind, value);
+        } else if (roll == 2) {
+            Kind kind = static_cast<Kind>(rng.next() % 11);
+            float value = kind == Kind::SetLoad ? 3.0f : static_cast<float>(rng.next() % 4);
+            runtime.broadcast(kind, value);
+            for (MachineCore& core : reference) {
+                applyTo(core, kind, value);
+            }
+        } else {
+            float dt = steps[rng.next() % 5];
+            runtime.tick(dt);
+            for (MachineCore& core : reference) {
+                core.step(dt);
+            }
+        }
+        if (step % 25 == 0) {
+            for (uint32_t id = 0; id < machines; id++) {
+                SystemStatus a = reference[id].getStatus();
+                SystemStatus b = runtime.getStatus(id);
+                ASSERT_EQ(a.state, b.state) << "machine " << id << " step " << step;
+                ASSERT_EQ(a.doorStatus, b.doorStatus) << "machine " << id << " step " << step;
+                ASSERT_EQ(std::memcmp(&a.waterLevel, &b.waterLevel, sizeof(float)), 0) << "machine " << id;
+                ASSERT_EQ(a.motorRPM, b.motorRPM) << "machine " << id << " step " << step;
+                ASSERT_EQ(a.loadKg, b.loadKg) << "machine " << id << " step " << step;
+                ASSERT_EQ(a.fault, b.fault) << "machine " << id << " step " << step;
+            }
+        }
+    }
+}
+
+TEST(FleetRuntimeTest, HookRunsOnEachWorkerThread) {
+    std::vector<std::thread::id> seen(3);
+    std::atomic<int> calls{0};
+    FleetRuntime runtime(9, unpinned(3), [&](size_t worker, ShardedFleet& shard) {
+        seen[worker] = std::this_thread::get_id();
+        EXPECT_EQ(shard.size(), 3u);
+        calls++;
+    });
+    runtime.run(4, 1.0f);
+    EXPECT_EQ(calls.load(), 12);
+    EXPECT_EQ(runtime.getTickCount(), 4u);
+    std::set<std::thread::id> distinct(seen.begin(), seen.end());
+    EXPECT_EQ(distinct.size(), 3u);
+    EXPECT_EQ(distinct.count(std::this_thread::get_id()), 0u);
+}
+
+TEST(FleetRuntimeTest, QuickWashCompletesEverywhere) {
+    FleetRuntime runtime(50, unpinned(4));
+    startQuickWash(runtime);
+    runtime.run(4000, 1.0f);
+    ShardReport totals = runtime.getTotals();
+    EXPECT_EQ(totals.machines, 50u);
+    EXPECT_EQ(totals.stateCounts[static_cast<size_t>(State::Completed)], 50u);
+    EXPECT_EQ(totals.tick, 4001u);
+}
+
+TEST(FleetRuntimeTest, SharedWaterLimitHoldsAcrossWorkers) {
+    RuntimeOptions options = unpinned(3);
+    options.waterFlowLimit = 40.0f;
+    FleetRuntime runtime(12, options);
+    startQuickWash(runtime);
+
+    bool sawDemandAboveLimit = false;
+    for (int t = 0; t < 600; t++) {
+        runtime.tick(0.5f);
+        ShardReport totals = runtime.getTotals();
+        EXPECT_LE(totals.waterFlow, 40.0f + 1e-3f) << "tick " << t;
+        sawDemandAboveLimit = sawDemandAboveLimit || totals.waterDemand > 40.0f;
+        float shares = 0.0f;
+        for (size_t w = 0; w < 3; w++) {
+            shares += runtime.getWaterShare(w);
+        }
+        EXPECT_NEAR(shares, 40.0f, 1e-3f);
+    }
+    EXPECT_TRUE(sawDemandAboveLimit);
+    runtime.run(6000, 1.0f);
+    EXPECT_EQ(runtime.getTotals().stateCounts[static_cast<size_t>(State::Completed)], 12u);
+}
+
+TEST(FleetRuntimeTest, SharedPowerCapHoldsAcrossWorkers) {
+    RuntimeOptions options = unpinned(3);
+    float oneSpin = PowerAdmissionController::estimateSpinPower(1200);
+    options.powerLimitWatts = 2.5f * oneSpin;
+    FleetRuntime runtime(9, options);
+    startQuickWash(runtime);
+
+    float peak = 0.0f;
+    for (int t = 0; t < 8000 && runtime.getTotals().stateCounts[static_cast<size_t>(State::Completed)] < 9; t++) {
+        runtime.tick(1.0f);
+        ShardReport totals = runtime.getTotals();
+        EXPECT_LE(totals.powerCommitted, options.powerLimitWatts + 1e-2f) << "tick " << t;
+        peak = std::max(peak, totals.powerCommitted);
+    }
+    EXPECT_GT(peak, 0.0f);
+    EXPECT_EQ(runtime.getTotals().stateCounts[static_cast<size_t>(State::Completed)], 9u);
+}
+
+#ifdef __linux__
+TEST(FleetRuntimeTest, PinnedWorkersReportAnAllowedCpu) {
+    std::vector<int> cpus = FleetRuntime::allowedCpus();
+    ASSERT_FALSE(cpus.empty());
+    RuntimeOptions options;
+    options.workers = 2;
+    FleetRuntime runtime(4, options);
+    for (size_t w = 0; w < 2; w++) {
+        EXPECT_EQ(runtime.getWorkerCpu(w), cpus[w % cpus.size()]);
+    }
+    runtime.run(3, 1.0f);
+    EXPECT_EQ(runtime.getTotals().machines, 4u);
+}
+#endif
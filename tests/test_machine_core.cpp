@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include "WashingMachine.hpp"
+#include "MachineCore.hpp"
+#include <sstream>
+#include <thread>
+#include <vector>
+
+class MachineCoreTest : public ::testing::Test {
+protected:
+    WashingMachine machine;
+
+    void SetUp() override {
+        machine.initialize();
+        machine.setOutput(nullptr);
+        machine.closeDoor();
+        machine.setLoad(3.0f);
+        machine.selectMode(1);
+        machine.tick(0.05f);
+        machine.start();
+    }
+
+    void run(float seconds, float deltaTime = 0.5f) {
+        for (float t = 0.0f; t < seconds; t += deltaTime) {
+            machine.tick(deltaTime);
+        }
+    }
+
+    static void run(MachineCore& core, float seconds, float deltaTime = 0.5f) {
+        for (float t = 0.0f; t < seconds; t += deltaTime) {
+            core.step(deltaTime);
+        }
+    }
+};
+
+TEST_F(MachineCoreTest, DetachedCoreRunsCycleToCompletion) {
+    MachineCore core;
+    core.setOutput(nullptr);
+    core.closeDoor();
+    core.setLoad(2.0f);
+    core.selectMode(3);
+    core.start();
+    EXPECT_EQ(core.getPendingCount(), 3u);
+
+    run(core, 7200.0f, 1.0f);
+    EXPECT_EQ(core.getCurrentState(), State::Completed);
+    EXPECT_EQ(core.getPendingCount(), 0u);
+}
+
+TEST_F(MachineCoreTest, CloneSharesModeTableAndPlan) {
+    run(60.0f);
+    MachineCore branch = machine.detachCore();
+
+    EXPECT_EQ(&branch.getModeTable(), &machine.getConfigManager());
+    MachineCore second(branch);
+    ASSERT_NE(branch.getCyclePlan(), nullptr);
+    EXPECT_EQ(second.getCyclePlan(), branch.getCyclePlan());
+    EXPECT_EQ(branch.getCyclePlan()->modeIndex, 1);
+}
+
+TEST_F(MachineCoreTest, CloneTracksOriginalWhenDrivenIdentically) {
+    run(120.0f);
+    ASSERT_EQ(machine.getCurrentState(), State::Washing);
+    MachineCore branch = machine.detachCore();
+
+    run(900.0f);
+    run(branch, 900.0f);
+
+    SystemStatus a = machine.getStatus();
+    SystemStatus b = branch.getStatus();
+    EXPECT_EQ(a.state, b.state);
+    EXPECT_FLOAT_EQ(a.waterLevel, b.waterLevel);
+    EXPECT_EQ(a.motorRPM, b.motorRPM);
+    EXPECT_FLOAT_EQ(a.progressPercent, b.progressPercent);
+}
+
+TEST_F(MachineCoreTest, BranchesDivergeWithoutTouchingOriginal) {
+    run(120.0f);
+    ASSERT_EQ(machine.getCurrentState(), State::Washing);
+
+    MachineCore paused = machine.detachCore();
+    MachineCore stopped = machine.detachCore();
+
+    paused.pause();
+    paused.step(0.5f);
+    stopped.emergencyStop();
+    stopped.step(0.5f);
+
+    EXPECT_EQ(paused.getCurrentState(), State::Paused);
+    EXPECT_EQ(stopped.getCurrentState(), State::EmergencyStop);
+    EXPECT_EQ(machine.getCurrentState(), State::Washing);
+
+    paused.resume();
+    EXPECT_EQ(paused.getCurrentState(), State::Washing);
+}
+
+TEST_F(MachineCoreTest, CloneIsNotRegisteredWithSharedResources) {
+    WaterSupply supply;
+    PowerAdmissionController controller(1000.0f);
+    machine.connectWaterSupply(&supply);
+    machine.connectPowerController(&controller);
+    ASSERT_EQ(supply.getConsumerCount(), 1u);
+
+    {
+        MachineCore branch = machine.detachCore();
+        std::vector<MachineCore> futures(16, branch);
+        EXPECT_EQ(supply.getConsumerCount(), 1u);
+    }
+    EXPECT_EQ(supply.getConsumerCount(), 1u);
+
+    machine.connectWaterSupply(nullptr);
+    machine.connectPowerController(nullptr);
+    EXPECT_EQ(supply.getConsumerCount(), 0u);
+}
+
+TEST_F(MachineCoreTest, LoadCoreAdoptsBranchState) {
+    run(120.0f);
+    MachineCore branch = machine.detachCore();
+    branch.pause();
+    branch.step(0.5f);
+    ASSERT_EQ(branch.getCurrentState(), State::Paused);
+
+    machine.loadCore(branch);
+    EXPECT_EQ(machine.getCurrentState(), State::Paused);
+
+    machine.resume();
+    machine.tick(0.5f);
+    EXPECT_EQ(machine.getCurrentState(), State::Washing);
+}
+
+TEST_F(MachineCoreTest, StateMachineCopiesShareTransitionTable) {
+    StateMachine a;
+    a.transition(EventType::CMD_SELECT_MODE);
+    StateMachine b(a);
+    EXPECT_EQ(b.getCurrentState(), State::Ready);
+    EXPECT_TRUE(b.transition(EventType::CMD_START));
+    EXPECT_EQ(a.getCurrentState(), State::Ready);
+
+    State next;
+    EXPECT_TRUE(StateMachine::lookup(State::Ready, EventType::CMD_START, next));
+    EXPECT_EQ(next, State::Filling);
+    EXPECT_FALSE(StateMachine::lookup(State::Idle, EventType::CMD_START, next));
+}
+
+// Elapsed time is summed in integer nanoseconds. A float accumulator would be
+// adding 10 ms steps to a total of over 20 minutes here and end the phase
+// more than a second late.
+TEST_F(MachineCoreTest, SmallStepsDoNotDelayPhaseEnds) {
+    MachineCore core;
+    core.setOutput(nullptr);
+    core.closeDoor();
+    core.setLoad(3.0f);
+    core.selectMode(1);
+    core.start();
+
+    while (core.getCurrentState() != State::Washing) {
+        core.step(0.01f);
+    }
+    long washSteps = 0;
+    while (core.getCurrentState() == State::Washing) {
+        core.step(0.01f);
+        washSteps++;
+    }
+    ASSERT_GT(core.getCyclePlan()->washTime, 1000.0f);
+    EXPECT_NEAR(static_cast<double>(washSteps) * 0.01, core.getCyclePlan()->washTime, 0.02);
+}
+
+TEST_F(MachineCoreTest, NanosecondStepsMatchFloatSteps) {
+    MachineCore seconds;
+    seconds.setOutput(nullptr);
+    seconds.closeDoor();
+    seconds.setLoad(3.0f);
+    seconds.selectMode(1);
+    seconds.start();
+    MachineCore nanos(seconds);
+    for (int i = 0; i < 16000; i++) {
+        seconds.step(0.25f);
+        nanos.step(SimTime(250000000));
+    }
+
+    std::vector<uint8_t> a;
+    std::vector<uint8_t> b;
+    CheckpointWriter writerA(a);
+    CheckpointWriter writerB(b);
+    seconds.saveState(writerA);
+    nanos.saveState(writerB);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(seconds.getCurrentState(), State::Completed);
+}
+
+TEST_F(MachineCoreTest, LogGoesOnlyToTheCoresOwnStream) {
+    std::ostringstream first;
+    std::ostringstream second;
+    MachineCore a;
+    MachineCore b;
+    MachineCore silent;
+    a.setOutput(&first);
+    b.setOutput(&second);
+    silent.setOutput(nullptr);
+
+    a.setLoad(-1.0f);
+    b.selectMode(99);
+    silent.setLoad(-1.0f);
+    EXPECT_EQ(first.str(), "Load cannot be negative.\n");
+    EXPECT_NE(second.str().find("Invalid mode"), std::string::npos);
+    EXPECT_EQ(second.str().find("Load"), std::string::npos);
+}
+
+TEST_F(MachineCoreTest, SilentCoresLogFromSeveralThreads) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            MachineCore core;
+            core.setOutput(nullptr);
+            for (int i = 0; i < 1000; i++) {
+                core.setLoad(-1.0f);
+                core.selectMode(99);
+            }
+            EXPECT_EQ(core.getCurrentState(), State::Idle);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_F(MachineCoreTest, CycleClockStartsWhenStartIsHandled) {
+    MachineCore core;
+    core.setOutput(nullptr);
+    core.closeDoor();
+    core.setLoad(2.0f);
+    core.selectMode(0);
+    core.start();
+    EXPECT_EQ(core.getStatus().remainingSeconds, 0);
+
+    core.step(0.0f);
+    ASSERT_EQ(core.getCurrentState(), State::Filling);
+    int total = core.getStatus().remainingSeconds;
+    EXPECT_GT(total, 0);
+    core.step(10.0f);
+    EXPECT_EQ(core.getStatus().remainingSeconds, total - 10);
+}
+
+TEST_F(MachineCoreTest, TickedMachineKeepsNoLoopTiming) {
+    run(5.0f);
+    TickTimingStats stats = machine.getTickStats();
+    EXPECT_EQ(stats.getTickCount(), 0u);
+    EXPECT_EQ(stats.getPeriod(), std::chrono::milliseconds(50));
+    EXPECT_LT(sizeof(WashingMachine), sizeof(TickTimingStats));
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "WashingMachine.hpp"
+
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using InlineMachine = BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, InlineEventSink>;
+
+static_assert(EngineEventSink::THREAD_SAFE && !InlineEventSink::THREAD_SAFE,
+              "only the engine sink may back run()");
+
+// Counts the events the water model raises on their way to the core.
+struct CountingWater : WaterSystem {
+    static int raised;
+
+    template<typename Raise>
+    void update(SimTime deltaTime, Raise&& raise) {
+        WaterSystem::update(deltaTime, [&](EventType type) {
+            raised++;
+            raise(type);
+        });
+    }
+};
+
+int CountingWater::raised = 0;
+
+// A direct-drive motor: ramps a hundred times faster than the belt drive.
+struct DirectDriveMotor : MotorSystem {
+    void update(SimTime deltaTime) {
+        MotorSystem::update(deltaTime * 100);
+    }
+};
+
+template<typename Machine>
+void prepare(Machine& machine) {
+    machine.initialize();
+    machine.setOutput(nullptr);
+    machine.closeDoor();
+    machine.setLoad(3.0f);
+    machine.selectMode(0);
+    machine.tick(0.1f);
+    machine.start();
+}
+
+}
+
+TEST(MachinePoliciesTest, WashingMachineIsTheStandardBuild) {
+    EXPECT_TRUE((std::is_same<WashingMachine,
+                              BasicWashingMachine<DoorSystem, WaterSystem, MotorSystem, EngineEventSink>>::value));
+    EXPECT_TRUE((std::is_same<WashingMachine::Core, MachineCore>::value));
+}
+
+TEST(MachinePoliciesTest, InlineSinkMatchesEngineSinkTickForTick) {
+    WashingMachine engine;
+    InlineMachine inlined;
+    prepare(engine);
+    prepare(inlined);
+
+    for (int t = 0; t < 3000; t++) {
+        engine.tick(1.0f);
+        inlined.tick(1.0f);
+        ASSERT_EQ(engine.getCurrentState(), inlined.getCurrentState()) << "tick " << t;
+    }
+    EXPECT_EQ(inlined.getCurrentState(), State::Completed);
+    EXPECT_EQ(engine.saveCheckpoint(), inlined.saveCheckpoint());
+}
+
+TEST(MachinePoliciesTest, WaterPolicyEventsReachTheCore) {
+    CountingWater::raised = 0;
+    BasicWashingMachine<DoorSystem, CountingWater, MotorSystem, InlineEventSink> machine;
+    prepare(machine);
+
+    for (int t = 0; t < 3000 && machine.getCurrentState() != State::Completed; t++) {
+        machine.tick(1.0f);
+    }
+    EXPECT_EQ(machine.getCurrentState(), State::Completed);
+    EXPECT_GE(CountingWater::raised, 2);
+}
+
+TEST(MachinePoliciesTest, MotorPolicyReplacesTheRamp) {
+    InlineMachine belt;
+    BasicWashingMachine<DoorSystem, WaterSystem, DirectDriveMotor, InlineEventSink> direct;
+    prepare(belt);
+    prepare(direct);
+
+    while (belt.getCurrentState() != State::Washing) {
+        belt.tick(0.5f);
+        direct.tick(0.5f);
+    }
+    ASSERT_EQ(direct.getCurrentState(), State::Washing);
+
+    EXPECT_EQ(belt.getStatus().motorRPM, 100);
+    EXPECT_EQ(direct.getStatus().motorRPM, belt.getCurrentMode().spinSpeedRPM / 2);
+}
+
+TEST(MachinePoliciesTest, DetachedCoreKeepsItsPolicies) {
+    BasicWashingMachine<DoorSystem, WaterSystem, DirectDriveMotor, InlineEventSink> machine;
+    prepare(machine);
+    machine.tick(1.0f);
+
+    auto branch = machine.detachCore();
+    EXPECT_TRUE((std::is_same<decltype(branch), BasicMachineCore<DoorSystem, WaterSystem, DirectDriveMotor>>::value));
+    for (int t = 0; t < 3000; t++) {
+        branch.step(1.0f);
+    }
+    EXPECT_EQ(branch.getCurrentState(), State::Completed);
+    EXPECT_EQ(machine.getCurrentState(), State::Filling);
+}
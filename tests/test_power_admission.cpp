@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "PowerAdmissionController.hpp"
+#include "WashingMachine.hpp"
+
+using SlotState = PowerAdmissionController::SlotState;
+
+class PowerAdmissionTest : public ::testing::Test {
+protected:
+    const float spinWatts = PowerAdmissionController::estimateSpinPower(1200);
+};
+
+TEST_F(PowerAdmissionTest, SpinPowerGrowsWithSpeed) {
+    EXPECT_LT(PowerAdmissionController::estimateSpinPower(400),
+              PowerAdmissionController::estimateSpinPower(800));
+    EXPECT_LT(PowerAdmissionController::estimateSpinPower(800),
+              PowerAdmissionController::estimateSpinPower(1200));
+}
+
+TEST_F(PowerAdmissionTest, AdmitsWhileUnderLimit) {
+    PowerAdmissionController controller(spinWatts * 2.0f);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+
+    EXPECT_TRUE(controller.requestSpin(a, 1200));
+    EXPECT_TRUE(controller.requestSpin(b, 1200));
+    EXPECT_FLOAT_EQ(controller.getCommittedPower(), spinWatts * 2.0f);
+    EXPECT_EQ(controller.getWaitingCount(), 0u);
+}
+
+TEST_F(PowerAdmissionTest, DelaysSpinOverLimit) {
+    PowerAdmissionController controller(spinWatts * 1.5f);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+
+    EXPECT_TRUE(controller.requestSpin(a, 1200));
+    EXPECT_FALSE(controller.requestSpin(b, 1200));
+    EXPECT_EQ(controller.getSlotState(b), SlotState::Waiting);
+    EXPECT_EQ(controller.getWaitingCount(), 1u);
+    EXPECT_LE(controller.getCommittedPower(), controller.getPowerLimit());
+}
+
+TEST_F(PowerAdmissionTest, RepeatedRequestIsIdempotent) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+
+    EXPECT_TRUE(controller.requestSpin(a, 1200));
+    EXPECT_TRUE(controller.requestSpin(a, 1200));
+    EXPECT_EQ(controller.getAdmissionCount(), 1u);
+}
+
+TEST_F(PowerAdmissionTest, ReleaseAdmitsNextInQueue) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+
+    controller.requestSpin(a, 1200);
+    controller.requestSpin(b, 1200);
+    controller.update(30.0f);
+
+    controller.endSpin(a);
+    EXPECT_EQ(controller.getSlotState(b), SlotState::Admitted);
+    EXPECT_TRUE(controller.requestSpin(b, 1200));
+    EXPECT_EQ(controller.getDelayedAdmissionCount(), 1u);
+    EXPECT_DOUBLE_EQ(controller.getTotalDelaySeconds(), 30.0);
+}
+
+TEST_F(PowerAdmissionTest, QueueIsFifo) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+    size_t c = controller.registerMachine();
+
+    controller.requestSpin(a, 1200);
+    controller.requestSpin(b, 1200);
+    controller.requestSpin(c, 400);
+
+    EXPECT_EQ(controller.getSlotState(c), SlotState::Waiting);
+
+    controller.endSpin(a);
+    EXPECT_EQ(controller.getSlotState(b), SlotState::Admitted);
+    EXPECT_EQ(controller.getSlotState(c), SlotState::Waiting);
+}
+
+TEST_F(PowerAdmissionTest, CancelledWaiterIsSkipped) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+    size_t c = controller.registerMachine();
+
+    controller.requestSpin(a, 1200);
+    controller.requestSpin(b, 1200);
+    controller.requestSpin(c, 1200);
+    controller.endSpin(b);
+    EXPECT_EQ(controller.getWaitingCount(), 1u);
+
+    controller.endSpin(a);
+    EXPECT_EQ(controller.getSlotState(b), SlotState::Idle);
+    EXPECT_EQ(controller.getSlotState(c), SlotState::Admitted);
+}
+
+TEST_F(PowerAdmissionTest, RaisingLimitAdmitsWaiters) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+
+    controller.requestSpin(a, 1200);
+    controller.requestSpin(b, 1200);
+    controller.setPowerLimit(spinWatts * 2.0f);
+
+    EXPECT_EQ(controller.getSlotState(b), SlotState::Admitted);
+}
+
+TEST_F(PowerAdmissionTest, AggregateNeverExceedsLimit) {
+    const int machines = 10000;
+    PowerAdmissionController controller(spinWatts * 100.0f);
+    for (int i = 0; i < machines; i++) {
+        controller.registerMachine();
+    }
+
+    for (int i = 0; i < machines; i++) {
+        controller.requestSpin(i, 1200);
+        EXPECT_LE(controller.getCommittedPower(), controller.getPowerLimit() + 1.0f);
+    }
+    EXPECT_EQ(controller.getAdmissionCount(), 100u);
+
+    for (int tick = 0; tick < 200 && controller.getWaitingCount() > 0; tick++) {
+        controller.update(60.0f);
+        for (int i = 0; i < machines; i++) {
+            if (controller.getSlotState(i) == SlotState::Admitted) {
+                controller.endSpin(i);
+            }
+        }
+        EXPECT_LE(controller.getPeakPower(), controller.getPowerLimit() + 1.0f);
+    }
+
+    EXPECT_EQ(controller.getWaitingCount(), 0u);
+    EXPECT_EQ(controller.getAdmissionCount(), static_cast<uint64_t>(machines));
+    EXPECT_GT(controller.getAddedMinutesPerCycle(), 0.0);
+}
+
+TEST_F(PowerAdmissionTest, ForceAdmitBypassesQueue) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+    size_t b = controller.registerMachine();
+
+    controller.requestSpin(a, 1200);
+    controller.forceAdmit(b, 1200);
+
+    EXPECT_EQ(controller.getSlotState(b), SlotState::Admitted);
+    EXPECT_EQ(controller.getWaitingCount(), 0u);
+    EXPECT_EQ(controller.getAdmissionCount(), 1u);
+    EXPECT_EQ(controller.getForcedAdmissionCount(), 1u);
+}
+
+TEST_F(PowerAdmissionTest, ReleasedSlotIsReused) {
+    PowerAdmissionController controller(spinWatts);
+    size_t a = controller.registerMachine();
+    controller.requestSpin(a, 1200);
+    controller.releaseMachine(a);
+
+    EXPECT_FLOAT_EQ(controller.getCommittedPower(), 0.0f);
+    EXPECT_EQ(controller.registerMachine(), a);
+}
+
+TEST_F(PowerAdmissionTest, ThreadedMachineCannotShareAController) {
+    PowerAdmissionController controller(spinWatts);
+    WashingMachine machine;
+    machine.initialize();
+    machine.setOutput(nullptr);
+    ASSERT_TRUE(machine.connectPowerController(&controller));
+    EXPECT_FALSE(machine.run());
+
+    ASSERT_TRUE(machine.connectPowerController(nullptr));
+    ASSERT_TRUE(machine.run());
+    EXPECT_FALSE(machine.connectPowerController(&controller));
+    EXPECT_EQ(controller.getSlotState(0), SlotState::Unused);
+    machine.shutdown();
+}
+
+TEST_F(PowerAdmissionTest, ResumedSpinWaitsForPower) {
+    PowerAdmissionController controller(spinWatts);
+    MachineCore core;
+    core.setOutput(nullptr);
+    core.connectPowerController(&controller);
+    size_t other = controller.registerMachine();
+    core.closeDoor();
+    core.setLoad(3.0f);
+    core.selectMode(0);
+    core.start();
+    for (int t = 0; t < 5000 && core.getCurrentState() != State::Spinning; t++) {
+        core.step(1.0f);
+    }
+    ASSERT_EQ(core.getCurrentState(), State::Spinning);
+
+    core.pause();
+    core.step(1.0f);
+    ASSERT_EQ(core.getCurrentState(), State::Paused);
+    ASSERT_TRUE(controller.requestSpin(other, 1200));
+
+    core.resume();
+    for (int t = 0; t < 600; t++) {
+        core.step(1.0f);
+    }
+    EXPECT_EQ(core.getCurrentState(), State::Spinning);
+    EXPECT_EQ(core.getStatus().motorRPM, 0);
+    EXPECT_LE(controller.getCommittedPower(), controller.getPowerLimit());
+    EXPECT_EQ(controller.getForcedAdmissionCount(), 0u);
+
+    controller.endSpin(other);
+    for (int t = 0; t < 5000 && core.getCurrentState() == State::Spinning; t++) {
+        core.step(1.0f);
+    }
+    EXPECT_NE(core.getCurrentState(), State::Spinning);
+    EXPECT_EQ(controller.getDelayedAdmissionCount(), 1u);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "TickTimingStats.hpp"
+
+#include <chrono>
+
+TEST(TickTimingStatsTest, PerfectTicksHaveNoJitterOrDrift) {
+    TickTimingStats stats(std::chrono::milliseconds(50));
+    std::chrono::steady_clock::time_point start;
+    for (int i = 0; i < 10; i++) {
+        stats.recordTick(start + std::chrono::milliseconds(50) * i);
+    }
+    EXPECT_EQ(stats.getTickCount(), 10u);
+    EXPECT_EQ(stats.getPeriodCount(), 9u);
+    EXPECT_DOUBLE_EQ(stats.getMeanJitterMicros(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.getMaxJitterMicros(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.getDriftMicros(), 0.0);
+}
+
+TEST(TickTimingStatsTest, LateTicksAccumulateDrift) {
+    TickTimingStats stats(std::chrono::milliseconds(50));
+    std::chrono::steady_clock::time_point now;
+    stats.recordTick(now);
+    for (int i = 0; i < 4; i++) {
+        now += std::chrono::milliseconds(51);
+        stats.recordTick(now);
+    }
+    EXPECT_NEAR(stats.getMeanJitterMicros(), 1000.0, 1e-6);
+    EXPECT_NEAR(stats.getMaxJitterMicros(), 1000.0, 1e-6);
+    EXPECT_NEAR(stats.getDriftMicros(), 4000.0, 1e-6);
+}
+
+TEST(TickTimingStatsTest, MissedPeriodsAreNotJitter) {
+    TickTimingStats stats(std::chrono::milliseconds(50));
+    std::chrono::steady_clock::time_point now;
+    stats.recordTick(now);
+    stats.recordTick(now + std::chrono::milliseconds(150), 3);
+    EXPECT_EQ(stats.getPeriodCount(), 3u);
+    EXPECT_DOUBLE_EQ(stats.getMaxJitterMicros(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.getDriftMicros(), 0.0);
+}
+
+TEST(TickTimingStatsTest, PercentilesComeFromHistogram) {
+    TickTimingStats stats(std::chrono::milliseconds(10));
+    std::chrono::steady_clock::time_point now;
+    stats.recordTick(now);
+    for (int i = 0; i < 99; i++) {
+        now += std::chrono::milliseconds(10);
+        stats.recordTick(now);
+    }
+    now += std::chrono::milliseconds(12);
+    stats.recordTick(now);
+
+    EXPECT_LE(stats.getPercentileJitterMicros(50.0), 5.0);
+    EXPECT_LE(stats.getPercentileJitterMicros(99.0), 5.0);
+    EXPECT_NEAR(stats.getPercentileJitterMicros(100.0), 2000.0, 1e-6);
+
+    stats.reset();
+    EXPECT_EQ(stats.getTickCount(), 0u);
+    EXPECT_DOUBLE_EQ(stats.getPercentileJitterMicros(99.0), 0.0);
+}
+
+#ifdef __linux__
+
+#include "Reactor.hpp"
+#include "ReactorShell.hpp"
+#include "EventEngine.hpp"
+
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+TEST(ReactorTest, PeriodicTimerFires) {
+    Reactor reactor;
+    PeriodicTimer timer(std::chrono::milliseconds(5));
+    ASSERT_TRUE(reactor.isOpen());
+    ASSERT_TRUE(timer.isOpen());
+
+    uint64_t fired = 0;
+    reactor.add(timer.getFd(), EPOLLIN, [&](uint32_t) {
+        fired += timer.readExpirations();
+        if (fired >= 3) {
+            reactor.stop();
+        }
+    });
+    reactor.run();
+    EXPECT_GE(fired, 3u);
+}
+
+TEST(ReactorTest, NotifierWakesLoopFromAnotherThread) {
+    Reactor reactor;
+    EventNotifier notifier;
+    ASSERT_TRUE(notifier.isOpen());
+
+    int wakeups = 0;
+    reactor.add(notifier.getFd(), EPOLLIN, [&](uint32_t) {
+        notifier.drain();
+        wakeups++;
+        reactor.stop();
+    });
+
+    std::thread producer([&] {
+        for (int i = 0; i < 100; i++) {
+            notifier.notify();
+        }
+    });
+    reactor.run();
+    producer.join();
+    EXPECT_GE(wakeups, 1);
+}
+
+TEST(ReactorTest, EventPushSignalsWakeHandler) {
+    EventEngine engine;
+    engine.start();
+
+    int wakeups = 0;
+    engine.setWakeHandler([&] { wakeups++; });
+    engine.pushEvent(Event(EventType::CMD_START));
+    engine.pushEvent(Event(EventType::CMD_STOP));
+    EXPECT_EQ(wakeups, 2);
+
+    engine.setWakeHandler(nullptr);
+    engine.pushEvent(Event(EventType::CMD_PAUSE));
+    EXPECT_EQ(wakeups, 2);
+    engine.stop();
+}
+
+TEST(ReactorShellTest, RunsCommandsFromPipe) {
+    WashingMachine machine;
+    machine.initialize();
+    std::ostringstream output;
+    machine.setOutput(&output);
+    CLI cli(machine, output);
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const char script[] = "close\nload 3\nmode 1\nstart\nexit\n";
+    ASSERT_EQ(write(fds[1], script, sizeof(script) - 1), static_cast<ssize_t>(sizeof(script) - 1));
+    close(fds[1]);
+
+    ReactorShell shell(machine, cli, fds[0], std::chrono::milliseconds(5));
+    EXPECT_TRUE(shell.run());
+    close(fds[0]);
+
+    machine.tick(0.0f);
+    EXPECT_EQ(machine.getCurrentState(), State::Filling);
+    EXPECT_NE(output.str().find("washing-machine> "), std::string::npos);
+}
+
+TEST(ReactorShellTest, RunForTicksOnSchedule) {
+    WashingMachine machine;
+    machine.initialize();
+    machine.setOutput(nullptr);
+    std::ostringstream output;
+    CLI cli(machine, output);
+
+    ReactorShell shell(machine, cli, -1, std::chrono::milliseconds(5));
+    shell.runFor(std::chrono::milliseconds(60));
+
+    const TickTimingStats& stats = shell.getTickStats();
+    EXPECT_GE(stats.getTickCount(), 5u);
+    EXPECT_GE(stats.getPeriodCount() + 1, stats.getTickCount());
+}
+
+#endif
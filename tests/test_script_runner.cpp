@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "ScriptRunner.hpp"
+#include <sstream>
+#include <string>
+
+class ScriptRunnerTest : public ::testing::Test {
+protected:
+    WashingMachine machine;
+    std::ostringstream output;
+
+    void SetUp() override {
+        machine.initialize();
+    }
+
+    ScriptResult run(const std::string& script) {
+        ScriptRunner runner(machine, output);
+        std::istringstream input(script);
+        return runner.run(input);
+    }
+};
+
+TEST_F(ScriptRunnerTest, ParsesTimestamps) {
+    double seconds = 0.0;
+    EXPECT_TRUE(ScriptRunner::parseTimestamp("00:12:30", seconds));
+    EXPECT_DOUBLE_EQ(seconds, 750.0);
+    EXPECT_TRUE(ScriptRunner::parseTimestamp("05:30", seconds));
+    EXPECT_DOUBLE_EQ(seconds, 330.0);
+    EXPECT_TRUE(ScriptRunner::parseTimestamp("90", seconds));
+    EXPECT_DOUBLE_EQ(seconds, 90.0);
+    EXPECT_TRUE(ScriptRunner::parseTimestamp("01:00:00.5", seconds));
+    EXPECT_DOUBLE_EQ(seconds, 3600.5);
+
+    EXPECT_FALSE(ScriptRunner::parseTimestamp("", seconds));
+    EXPECT_FALSE(ScriptRunner::parseTimestamp("00:61", seconds));
+    EXPECT_FALSE(ScriptRunner::parseTimestamp("1:2:3:4", seconds));
+    EXPECT_FALSE(ScriptRunner::parseTimestamp("1.5:00", seconds));
+    EXPECT_FALSE(ScriptRunner::parseTimestamp("ab", seconds));
+}
+
+TEST_F(ScriptRunnerTest, RunsFullCycleOnVirtualClock) {
+    ScriptResult result = run(
+        "close\n"
+        "load 3\n"
+        "mode 1\n"
+        "start\n"
+        "@00:05:00 expect state washing\n"
+        "@01:00:00 expect state completed\n"
+        "expect door closed unlocked\n");
+
+    EXPECT_TRUE(result.passed());
+    EXPECT_EQ(result.commands, 4u);
+    EXPECT_EQ(result.expectations, 3u);
+    EXPECT_DOUBLE_EQ(result.simulatedSeconds, 3600.0);
+    EXPECT_NE(output.str().find("\"from\":\"Spinning\",\"to\":\"Draining\""), std::string::npos);
+}
+
+TEST_F(ScriptRunnerTest, RelativeOffsetsAccumulate) {
+    ScriptResult result = run(
+        "@00:10:00 close\n"
+        "+00:05:00 load 2\n"
+        "+30 expect state idle\n");
+
+    EXPECT_TRUE(result.passed());
+    EXPECT_DOUBLE_EQ(result.simulatedSeconds, 930.0);
+}
+
+TEST_F(ScriptRunnerTest, FailedExpectationFailsScript) {
+    ScriptResult result = run(
+        "close\n"
+        "expect state Washing\n");
+
+    EXPECT_FALSE(result.passed());
+    EXPECT_EQ(result.failures, 1u);
+    EXPECT_NE(output.str().find("\"pass\":false"), std::string::npos);
+}
+
+TEST_F(ScriptRunnerTest, ReportsErrorsWithLineNumbers) {
+    ScriptResult result = run(
+        "@00:10:00 close\n"
+        "@00:05:00 open\n"
+        "@xx start\n"
+        "expect colour blue\n");
+
+    EXPECT_EQ(result.errors, 3u);
+    EXPECT_EQ(result.commands, 1u);
+    EXPECT_NE(output.str().find("\"type\":\"error\",\"line\":2"), std::string::npos);
+    EXPECT_NE(output.str().find("\"type\":\"error\",\"line\":4"), std::string::npos);
+}
+
+TEST_F(ScriptRunnerTest, CommentsBlankLinesAndExitAreHonoured) {
+    ScriptResult result = run(
+        "# setup\n"
+        "\n"
+        "close   # inline comment\n"
+        "exit\n"
+        "open\n");
+
+    EXPECT_TRUE(result.passed());
+    EXPECT_EQ(result.commands, 1u);
+    EXPECT_EQ(machine.getCurrentState(), State::Idle);
+}
+
+TEST_F(ScriptRunnerTest, CommandOutputAndStatusAreJsonRecords) {
+    run("load -1\n");
+    EXPECT_NE(output.str().find("\"output\":\"Load cannot be negative.\""), std::string::npos);
+
+    output.str("");
+    run("status\n");
+    EXPECT_NE(output.str().find("\"type\":\"status\""), std::string::npos);
+    EXPECT_NE(output.str().find("\"state\":\"Idle\""), std::string::npos);
+}
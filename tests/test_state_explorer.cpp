@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "StateExplorer.hpp"
+
+#include <thread>
+#include <vector>
+
+TEST(StateExplorerTest, DefaultSafetyPropertiesHold) {
+    StateExplorer explorer;
+    explorer.addDefaultProperties();
+    ExplorationResult result = explorer.explore();
+
+    EXPECT_TRUE(result.complete);
+    EXPECT_GT(result.states, 1000u);
+    for (const ExplorerViolation& violation : result.violations) {
+        ADD_FAILURE() << violation.property << " -> " << violation.finalState;
+    }
+}
+
+TEST(StateExplorerTest, ResultDoesNotDependOnThreadCount) {
+    StateExplorer single;
+    single.setThreadCount(1);
+    single.setMaxDepth(8);
+    ExplorationResult a = single.explore();
+
+    StateExplorer parallel;
+    parallel.setThreadCount(4);
+    parallel.setMaxDepth(8);
+    ExplorationResult b = parallel.explore();
+
+    EXPECT_EQ(a.states, b.states);
+    EXPECT_EQ(a.transitions, b.transitions);
+    EXPECT_EQ(a.depth, 8);
+    EXPECT_FALSE(a.complete);
+}
+
+TEST(StateExplorerTest, InvariantViolationHasReplayableTrace) {
+    StateExplorer explorer;
+    explorer.addInvariant({"never spins", [](const SystemStatus& s) {
+        return s.state != State::Spinning;
+    }});
+    ExplorationResult result = explorer.explore();
+
+    ASSERT_EQ(result.violations.size(), 1u);
+    const ExplorerViolation& violation = result.violations[0];
+    EXPECT_EQ(violation.property, "never spins");
+    ASSERT_FALSE(violation.trace.empty());
+
+    MachineCore core;
+    core.setOutput(nullptr);
+    for (const ExplorerAction& action : violation.trace) {
+        action.apply(core);
+    }
+    EXPECT_EQ(core.getCurrentState(), State::Spinning);
+}
+
+TEST(StateExplorerTest, ReportsUnreachableTarget) {
+    StateExplorer explorer;
+    explorer.addReachability({"paused can spin with the door open",
+                              [](const SystemStatus& s) { return s.state == State::Paused; },
+                              [](const SystemStatus& s) {
+                                  return s.state == State::Spinning && s.doorStatus == DoorStatus::Open;
+                              }});
+    ExplorationResult result = explorer.explore();
+
+    ASSERT_TRUE(result.complete);
+    ASSERT_EQ(result.violations.size(), 1u);
+    EXPECT_NE(result.violations[0].finalState.find("Paused"), std::string::npos);
+}
+
+TEST(StateExplorerTest, KeyIgnoresExactLevels) {
+    SystemStatus status{};
+    status.state = State::Filling;
+    status.doorStatus = DoorStatus::ClosedLocked;
+    status.targetWaterLevel = 30.0f;
+    status.waterLevel = 5.0f;
+    ExplorerKey partial = explorerKey(status, State::Idle);
+
+    status.waterLevel = 12.5f;
+    EXPECT_EQ(explorerKey(status, State::Idle), partial);
+
+    status.waterLevel = 30.0f;
+    EXPECT_NE(explorerKey(status, State::Idle), partial);
+    EXPECT_NE(describeExplorerKey(partial).find("water partial"), std::string::npos);
+}
+
+TEST(ExplorerVisitedSetTest, KeepsSmallestTagUnderContention) {
+    ExplorerVisitedSet set(1024);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; t++) {
+        threads.emplace_back([&set, t] {
+            for (uint64_t key = 1; key <= 200; key++) {
+                bool lowered = false;
+                set.offer(key, 100 + t * 7 + key % 3, lowered);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(set.size(), 200u);
+    for (uint64_t key = 1; key <= 200; key++) {
+        EXPECT_EQ(set.tagOf(key), 100 + key % 3);
+    }
+
+    bool lowered = true;
+    EXPECT_TRUE(set.offer(7, 500, lowered));
+    EXPECT_FALSE(lowered);
+}
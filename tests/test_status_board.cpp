@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+
+#include "StatusBoard.hpp"
+#include "Fleet.hpp"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+class StatusBoardTest : public ::testing::Test {
+protected:
+    std::string name;
+    StatusBoard board;
+
+    void SetUp() override {
+        name = "/washing_machine_test." + std::to_string(getpid());
+    }
+};
+
+TEST_F(StatusBoardTest, SlotsAreCacheLineAligned) {
+    EXPECT_EQ(sizeof(StatusSlot), 64u);
+    EXPECT_EQ(alignof(StatusSlot), 64u);
+    EXPECT_EQ(StatusBoard::regionSize(10), 64u * 11);
+}
+
+TEST_F(StatusBoardTest, ReaderSeesPublishedFleet) {
+    Fleet fleet(3);
+    fleet.getMachine(1).closeDoor();
+    fleet.getMachine(1).setLoad(2.5f);
+    fleet.getMachine(1).selectMode(0);
+    fleet.getMachine(1).start();
+    fleet.tick(0.1f);
+
+    ASSERT_TRUE(board.create(name, 8));
+    board.publish(fleet, 7);
+
+    StatusBoardReader reader;
+    ASSERT_TRUE(reader.open(name));
+    EXPECT_EQ(reader.getCapacity(), 8u);
+    EXPECT_EQ(reader.getCount(), 3u);
+    EXPECT_EQ(reader.getTick(), 7u);
+    EXPECT_EQ(reader.getPublishCount(), 1u);
+
+    StatusRecord record;
+    uint64_t tick = 0;
+    ASSERT_TRUE(reader.read(1, record, &tick));
+    EXPECT_EQ(tick, 7u);
+    EXPECT_EQ(record.machineId, 1u);
+    EXPECT_EQ(record.state, static_cast<uint8_t>(State::Filling));
+    EXPECT_EQ(record.door, static_cast<uint8_t>(DoorStatus::ClosedLocked));
+    EXPECT_FLOAT_EQ(record.loadKg, 2.5f);
+    EXPECT_FALSE(reader.read(5, record));
+
+    std::vector<StatusRecord> records;
+    EXPECT_EQ(reader.scan(records), 3u);
+    EXPECT_EQ(records[0].state, static_cast<uint8_t>(State::Idle));
+}
+
+TEST_F(StatusBoardTest, OpenFailsWithoutBoard) {
+    StatusBoardReader reader;
+    EXPECT_FALSE(reader.open(name));
+
+    ASSERT_TRUE(board.create(name, 1));
+    EXPECT_TRUE(reader.open(name));
+    board.close();
+
+    StatusBoardReader late;
+    EXPECT_FALSE(late.open(name));
+}
+
+TEST_F(StatusBoardTest, ConcurrentReadsAreNeverTorn) {
+    ASSERT_TRUE(board.create(name, 4));
+    StatusBoardReader reader;
+    ASSERT_TRUE(reader.open(name));
+
+    // The writer waits for a read after every burst, so reads overlap the
+    // writes even on one core instead of all landing after the last publish.
+    constexpr int PUBLISHES = 200000;
+    constexpr int BURST = 1000;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::thread writer([&] {
+        SystemStatus status{};
+        for (int i = 1; i <= PUBLISHES; i++) {
+            status.motorRPM = i;
+            status.remainingSeconds = i;
+            status.waterLevel = static_cast<float>(i);
+            board.publish(2, status, static_cast<uint64_t>(i));
+            if (i % BURST == 0) {
+                uint64_t seen = reads.load();
+                while (reads.load() == seen) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        done = true;
+    });
+
+    auto isTorn = [](const StatusRecord& record, uint64_t tick) {
+        return record.motorRPM != record.remainingSeconds ||
+               static_cast<uint64_t>(record.motorRPM) != tick ||
+               record.waterLevel != static_cast<float>(record.motorRPM);
+    };
+
+    uint64_t torn = 0;
+    StatusRecord record;
+    uint64_t tick = 0;
+    while (!done) {
+        if (reader.read(2, record, &tick) && isTorn(record, tick)) {
+            torn++;
+        }
+        reads++;
+    }
+    writer.join();
+    EXPECT_EQ(torn, 0u);
+
+    ASSERT_TRUE(reader.read(2, record, &tick));
+    EXPECT_FALSE(isTorn(record, tick));
+    EXPECT_EQ(tick, static_cast<uint64_t>(PUBLISHES));
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "TelemetryRecorder.hpp"
+#include "MachineCore.hpp"
+#include "CounterRng.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<TelemetryRow> recordCycle(TelemetryRecorder& recorder, float step) {
+    MachineCore core;
+    core.setOutput(nullptr);
+    core.closeDoor();
+    core.selectMode(0);
+    core.setLoad(3.0f);
+    core.processPendingEvents();
+    core.start();
+
+    std::vector<TelemetryRow> expected;
+    double clock = 0.0;
+    for (int i = 0; i < 100000 && core.getCurrentState() != State::Completed; i++) {
+        core.step(step);
+        clock += step;
+        SensorSample sample = core.getSensorSample();
+        recorder.record(clock, sample);
+        expected.push_back({std::round(clock * 1e6) / 1e6, sample});
+    }
+    return expected;
+}
+
+void expectSameRows(const std::vector<TelemetryRow>& actual, const std::vector<TelemetryRow>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); i++) {
+        const SensorSample& a = actual[i].sample;
+        const SensorSample& b = expected[i].sample;
+        ASSERT_DOUBLE_EQ(actual[i].time, expected[i].time) << "row " << i;
+        ASSERT_EQ(a.state, b.state) << "row " << i;
+        ASSERT_EQ(a.doorStatus, b.doorStatus) << "row " << i;
+        ASSERT_EQ(a.direction, b.direction) << "row " << i;
+        ASSERT_EQ(a.fillValveOpen, b.fillValveOpen) << "row " << i;
+        ASSERT_EQ(a.drainValveOpen, b.drainValveOpen) << "row " << i;
+        ASSERT_EQ(a.motorRPM, b.motorRPM) << "row " << i;
+        ASSERT_EQ(std::memcmp(&a.waterLevel, &b.waterLevel, sizeof(float)), 0) << "row " << i;
+    }
+}
+
+}
+
+TEST(TelemetryRecorderTest, FullCycleRoundTripsLosslessly) {
+    TelemetryRecorder recorder;
+    std::vector<TelemetryRow> expected = recordCycle(recorder, 0.05f);
+    ASSERT_GT(expected.size(), 10000u);
+
+    std::vector<TelemetryRow> rows;
+    ASSERT_TRUE(recorder.decode(rows));
+    expectSameRows(rows, expected);
+    EXPECT_EQ(recorder.getSampleCount(), expected.size());
+}
+
+TEST(TelemetryRecorderTest, CompressesWellBelowRawSize) {
+    TelemetryRecorder recorder;
+    std::vector<TelemetryRow> expected = recordCycle(recorder, 0.05f);
+    recorder.flush();
+
+    double bytesPerSample = static_cast<double>(recorder.getCompressedBytes()) / expected.size();
+    EXPECT_LT(bytesPerSample, 1.0);
+    uint32_t chunk = TelemetryRecorder::DEFAULT_CHUNK_SAMPLES;
+    EXPECT_EQ(recorder.getChunkCount(), (expected.size() + chunk - 1) / chunk);
+}
+
+TEST(TelemetryRecorderTest, IrregularValuesRoundTrip) {
+    TelemetryRecorder recorder(64);
+    CounterRng rng(7, 0);
+    std::vector<TelemetryRow> expected;
+    double clock = 0.0;
+    for (int i = 0; i < 1000; i++) {
+        clock += static_cast<double>(rng.next() % 5000000) / 1e6;
+        SensorSample sample{};
+        sample.state = static_cast<State>(rng.next() % 12);
+        sample.doorStatus = static_cast<DoorStatus>(rng.next() % 3);
+        sample.direction = static_cast<Direction>(rng.next() % 3);
+        sample.fillValveOpen = rng.next() & 1;
+        sample.drainValveOpen = rng.next() & 1;
+        uint32_t bits = static_cast<uint32_t>(rng.next());
+        std::memcpy(&sample.waterLevel, &bits, sizeof(bits));
+        sample.motorRPM = static_cast<int>(rng.next() % 2000000) - 1000000;
+        recorder.record(clock, sample);
+        expected.push_back({std::round(clock * 1e6) / 1e6, sample});
+    }
+
+    std::vector<TelemetryRow> rows;
+    ASSERT_TRUE(recorder.decode(rows));
+    expectSameRows(rows, expected);
+}
+
+TEST(TelemetryRecorderTest, BinaryRoundTripIncludesOpenChunk) {
+    TelemetryRecorder recorder(256);
+    std::vector<TelemetryRow> expected = recordCycle(recorder, 0.1f);
+    ASSERT_NE(expected.size() % 256, 0u);
+
+    std::vector<uint8_t> buffer;
+    recorder.saveBinary(buffer);
+
+    TelemetryRecorder loaded;
+    ASSERT_TRUE(loaded.loadBinary(buffer));
+    EXPECT_EQ(loaded.getChunkSamples(), 256u);
+    EXPECT_EQ(loaded.getSampleCount(), expected.size());
+
+    std::vector<TelemetryRow> rows;
+    ASSERT_TRUE(loaded.decode(rows));
+    expectSameRows(rows, expected);
+
+    buffer.resize(buffer.size() - 3);
+    EXPECT_FALSE(loaded.loadBinary(buffer));
+    buffer[0] ^= 0xFF;
+    EXPECT_FALSE(loaded.loadBinary(buffer));
+}
+
+TEST(TelemetryRecorderTest, RetentionBoundsMemory) {
+    TelemetryRecorder recorder(128);
+    recorder.setRetentionBytes(2048);
+    std::vector<TelemetryRow> expected = recordCycle(recorder, 0.05f);
+
+    EXPECT_LE(recorder.getCompressedBytes(), 2048u);
+    EXPECT_GT(recorder.getDroppedSamples(), 0u);
+    EXPECT_EQ(recorder.getSampleCount() + recorder.getDroppedSamples(), expected.size());
+
+    std::vector<TelemetryRow> rows;
+    ASSERT_TRUE(recorder.decode(rows));
+    ASSERT_EQ(rows.size(), recorder.getSampleCount());
+    std::vector<TelemetryRow> tail(expected.end() - static_cast<long>(rows.size()), expected.end());
+    expectSameRows(rows, tail);
+}
+
+TEST(TelemetryRecorderTest, CsvExport) {
+    TelemetryRecorder recorder;
+    SensorSample sample{State::Filling, DoorStatus::ClosedLocked, Direction::Stopped, true, false, 2.5f, 0};
+    recorder.record(0.05, sample);
+    sample.waterLevel = 3.0f;
+    recorder.record(0.1, sample);
+
+    std::ostringstream out;
+    ASSERT_TRUE(recorder.writeCsv(out));
+    EXPECT_EQ(out.str(),
+              "time,state,door,direction,fill_valve,drain_valve,water_level,rpm\n"
+              "0.050000,Filling,Closed (Locked),Stopped,1,0,2.5,0\n"
+              "0.100000,Filling,Closed (Locked),Stopped,1,0,3,0\n");
+}
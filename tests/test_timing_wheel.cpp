@@ -0,0 +1,414 @@
+#include <gtest/gtest.h>
+#include "TimingWheel.hpp"
+#include "MachineCore.hpp"
+#include "Fleet.hpp"
+#include "CounterRng.hpp"
+
+#include <map>
+#include <vector>
+
+namespace {
+
+class Recorder : public TimerListener {
+public:
+    TimingWheel* wheel = nullptr;
+    std::map<uint32_t, uint64_t> fired;
+
+    void onTimerExpired(uint32_t tag) override {
+        fired[tag] = wheel->getNowTicks();
+    }
+};
+
+void stepCore(MachineCore& core, WaterSupply& supply, TimingWheel& wheel, float dt) {
+    core.step(dt);
+    supply.update(dt);
+    wheel.advance(dt);
+}
+
+// A supply with no starvation detection and no flow: the inlet opens but
+// nothing arrives, so without a watchdog the fill never ends.
+WaterSupply stuckSupply() {
+    return WaterSupply(0.0f, 3.0f, 0.0001f, 0.0f);
+}
+
+void startQuickWash(MachineCore& core) {
+    core.setOutput(nullptr);
+    core.closeDoor();
+    core.selectMode(0);
+    core.setLoad(3.0f);
+    core.processPendingEvents();
+    core.start();
+}
+
+}
+
+TEST(TimingWheelTest, FiresOnItsTickOnEveryLevel) {
+    TimingWheel wheel(1.0f);
+    Recorder recorder;
+    recorder.wheel = &wheel;
+
+    const std::vector<uint64_t> delays = {1, 2, 255, 256, 257, 511, 65535, 65536, 65537,
+                                          300000, 16777215, 16777216, 16777221, 20000000};
+    for (uint32_t i = 0; i < delays.size(); i++) {
+        wheel.armTicks(delays[i], &recorder, i);
+    }
+    EXPECT_EQ(wheel.getArmedCount(), delays.size());
+
+    CounterRng rng(46, 0);
+    while (wheel.getNowTicks() < 20000001) {
+        wheel.advanceTicks(1 + rng.next() % 70000);
+    }
+    ASSERT_EQ(recorder.fired.size(), delays.size());
+    for (uint32_t i = 0; i < delays.size(); i++) {
+        EXPECT_EQ(recorder.fired[i], delays[i]) << "delay " << delays[i];
+    }
+    EXPECT_EQ(wheel.getArmedCount(), 0u);
+}
+
+TEST(TimingWheelTest, MatchesReferenceUnderRandomArmAndCancel) {
+    TimingWheel wheel(1.0f);
+    Recorder recorder;
+    recorder.wheel = &wheel;
+
+    CounterRng rng(46, 1);
+    std::map<uint32_t, uint64_t> expected;
+    std::vector<TimingWheel::TimerId> ids;
+    for (uint32_t tag = 0; tag < 20000; tag++) {
+        if (rng.next() % 4 == 0) {
+            wheel.advanceTicks(rng.next() % 300);
+        }
+        uint64_t delay = 1 + rng.next() % (rng.next() % 2 ? 500 : 200000);
+        ids.push_back(wheel.armTicks(delay, &recorder, tag));
+        expected[tag] = wheel.getNowTicks() + delay;
+        if (rng.next() % 3 == 0) {
+            uint32_t victim = static_cast<uint32_t>(rng.next() % ids.size());
+            bool due = expected.count(victim) && expected[victim] > wheel.getNowTicks();
+            EXPECT_EQ(wheel.cancel(ids[victim]), due);
+            if (due) {
+                expected.erase(victim);
+            }
+        }
+    }
+    wheel.advanceTicks(300000);
+    EXPECT_EQ(recorder.fired, expected);
+    EXPECT_EQ(wheel.getArmedCount(), 0u);
+}
+
+TEST(TimingWheelTest, StaleIdsCannotTouchReusedTimers) {
+    TimingWheel wheel(1.0f);
+    Recorder recorder;
+    recorder.wheel = &wheel;
+
+    TimingWheel::TimerId first = wheel.armTicks(10, &recorder, 1);
+    EXPECT_TRUE(wheel.isArmed(first));
+    EXPECT_TRUE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.isArmed(first));
+
+    TimingWheel::TimerId second = wheel.armTicks(10, &recorder, 2);
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_TRUE(wheel.isArmed(second));
+    EXPECT_FALSE(wheel.cancel(TimingWheel::NO_TIMER));
+
+    wheel.advanceTicks(10);
+    EXPECT_EQ(recorder.fired.count(1), 0u);
+    EXPECT_EQ(recorder.fired[2], 10u);
+    EXPECT_FALSE(wheel.cancel(second));
+}
+
+TEST(TimingWheelTest, ListenersMayCancelAndArmWhileFiring) {
+    struct Chain : TimerListener {
+        TimingWheel* wheel = nullptr;
+        TimingWheel::TimerId ids[2] = {TimingWheel::NO_TIMER, TimingWheel::NO_TIMER};
+        std::vector<std::pair<uint32_t, uint64_t>> fired;
+
+        void onTimerExpired(uint32_t tag) override {
+            fired.emplace_back(tag, wheel->getNowTicks());
+            if (tag < 2) {
+                wheel->cancel(ids[1 - tag]);
+                wheel->armTicks(5, this, tag + 10);
+            }
+        }
+    };
+
+    TimingWheel wheel(1.0f);
+    Chain chain;
+    chain.wheel = &wheel;
+    // Both are due on the same tick; whichever fires first cancels the other.
+    chain.ids[0] = wheel.armTicks(3, &chain, 0);
+    chain.ids[1] = wheel.armTicks(3, &chain, 1);
+    wheel.advanceTicks(3);
+    ASSERT_EQ(chain.fired.size(), 1u);
+    EXPECT_FALSE(wheel.isArmed(chain.ids[0]));
+    EXPECT_FALSE(wheel.isArmed(chain.ids[1]));
+
+    wheel.advanceTicks(10);
+    ASSERT_EQ(chain.fired.size(), 2u);
+    EXPECT_EQ(chain.fired[1].first, chain.fired[0].first + 10);
+    EXPECT_EQ(chain.fired[1].second, 8u);
+}
+
+TEST(TimingWheelTest, SecondsRoundUpToTicks) {
+    TimingWheel wheel(0.1f);
+    Recorder recorder;
+    recorder.wheel = &wheel;
+
+    wheel.advance(0.05f);
+    TimingWheel::TimerId id = wheel.arm(0.25f, &recorder, 7);
+    EXPECT_NEAR(wheel.getRemaining(id), 0.25f, 1e-4f);
+    wheel.advance(0.2f);
+    EXPECT_TRUE(recorder.fired.empty());
+    EXPECT_NEAR(wheel.getRemaining(id), 0.05f, 1e-4f);
+    wheel.advance(0.05f);
+    EXPECT_EQ(recorder.fired.size(), 1u);
+    EXPECT_EQ(wheel.getRemaining(id), 0.0f);
+}
+
+TEST(TimingWheelTest, HoldsAMillionTimers) {
+    TimingWheel wheel(0.1f);
+    Recorder recorder;
+    recorder.wheel = &wheel;
+
+    const uint32_t count = 1000000;
+    wheel.reserve(count);
+    std::vector<TimingWheel::TimerId> ids(count);
+    CounterRng rng(46, 2);
+    for (uint32_t i = 0; i < count; i++) {
+        ids[i] = wheel.arm(static_cast<float>(rng.next() % 36000), &recorder, i);
+    }
+    for (uint32_t i = 0; i < count; i += 2) {
+        EXPECT_TRUE(wheel.cancel(ids[i]));
+    }
+    EXPECT_EQ(wheel.getArmedCount(), count / 2);
+    EXPECT_LT(wheel.getMemoryBytes() / count, 64u);
+
+    for (int t = 0; t < 36001; t++) {
+        wheel.advance(1.0f);
+    }
+    EXPECT_EQ(recorder.fired.size(), count / 2);
+    EXPECT_EQ(recorder.fired.count(0), 0u);
+    EXPECT_EQ(recorder.fired.count(1), 1u);
+    EXPECT_EQ(wheel.getArmedCount(), 0u);
+}
+
+TEST(MachineWatchdogTest, StuckFillFaultsWithTimeout) {
+    WaterSupply supply = stuckSupply();
+    TimingWheel wheel;
+    MachineCore core;
+    core.connectWaterSupply(&supply);
+    core.connectTimingWheel(&wheel);
+    startQuickWash(core);
+
+    core.step(0.5f);
+    ASSERT_EQ(core.getCurrentState(), State::Filling);
+    EXPECT_EQ(core.getWatchdogKind(), WatchdogKind::Fill);
+    EXPECT_EQ(wheel.getArmedCount(), 1u);
+    float deadline = core.getCyclePlan()->fillTime * core.getWatchdogLimits().fillFactor +
+                     core.getWatchdogLimits().graceSeconds;
+    EXPECT_NEAR(core.getWatchdogRemaining(), deadline, 0.2f);
+
+    float elapsed = 0.0f;
+    while (core.getCurrentState() == State::Filling && elapsed < 1000.0f) {
+        stepCore(core, supply, wheel, 0.5f);
+        elapsed += 0.5f;
+    }
+    EXPECT_EQ(core.getCurrentState(), State::Fault);
+    EXPECT_EQ(core.getStatus().fault, FaultCode::Timeout);
+    EXPECT_NEAR(elapsed, deadline, 1.0f);
+    EXPECT_EQ(core.getWatchdogKind(), WatchdogKind::None);
+}
+
+TEST(MachineWatchdogTest, StuckFillHangsWithoutAWheel) {
+    WaterSupply supply = stuckSupply();
+    MachineCore core;
+    core.connectWaterSupply(&supply);
+    startQuickWash(core);
+    for (int t = 0; t < 2000; t++) {
+        core.step(0.5f);
+        supply.update(0.5f);
+    }
+    EXPECT_EQ(core.getCurrentState(), State::Filling);
+}
+
+TEST(MachineWatchdogTest, NormalCycleFollowsPhasesWithoutFiring) {
+    WaterSupply supply;
+    TimingWheel wheel;
+    MachineCore core;
+    core.connectWaterSupply(&supply);
+    core.connectTimingWheel(&wheel);
+    startQuickWash(core);
+
+    std::map<State, WatchdogKind> seen;
+    for (int t = 0; t < 4000 && core.getCurrentState() != State::Completed; t++) {
+        stepCore(core, supply, wheel, 1.0f);
+        seen[core.getCurrentState()] = core.getWatchdogKind();
+        EXPECT_LE(wheel.getArmedCount(), 1u);
+    }
+    ASSERT_EQ(core.getCurrentState(), State::Completed);
+    EXPECT_EQ(seen[State::Filling], WatchdogKind::Fill);
+    EXPECT_EQ(seen[State::Washing], WatchdogKind::Phase);
+    EXPECT_EQ(seen[State::Rinsing], WatchdogKind::Phase);
+    EXPECT_EQ(seen[State::Spinning], WatchdogKind::Phase);
+    EXPECT_EQ(seen[State::Draining], WatchdogKind::Drain);
+    EXPECT_EQ(wheel.getExpiredCount(), 0u);
+
+    for (int t = 0; t < 20; t++) {
+        stepCore(core, supply, wheel, 1.0f);
+    }
+    EXPECT_EQ(core.getStatus().doorStatus, DoorStatus::ClosedUnlocked);
+    EXPECT_EQ(core.getWatchdogKind(), WatchdogKind::None);
+    EXPECT_EQ(wheel.getArmedCount(), 0u);
+}
+
+TEST(MachineWatchdogTest, PauseCancelsAndResumeRearms) {
+    WaterSupply supply = stuckSupply();
+    TimingWheel wheel;
+    MachineCore core;
+    core.connectWaterSupply(&supply);
+    core.connectTimingWheel(&wheel);
+    startQuickWash(core);
+    stepCore(core, supply, wheel, 1.0f);
+
+    core.pause();
+    stepCore(core, supply, wheel, 1.0f);
+    ASSERT_EQ(core.getCurrentState(), State::Paused);
+    EXPECT_EQ(core.getWatchdogKind(), WatchdogKind::None);
+    for (int t = 0; t < 600; t++) {
+        stepCore(core, supply, wheel, 1.0f);
+    }
+    EXPECT_EQ(core.getCurrentState(), State::Paused);
+    EXPECT_EQ(wheel.getArmedCount(), 0u);
+
+    core.resume();
+    EXPECT_EQ(core.getWatchdogKind(), WatchdogKind::Fill);
+    for (int t = 0; t < 600 && core.getCurrentState() == State::Filling; t++) {
+        stepCore(core, supply, wheel, 1.0f);
+    }
+    EXPECT_EQ(core.getStatus().fault, FaultCode::Timeout);
+}
+
+TEST(MachineWatchdogTest, StaleTimeoutsAreDroppedButRawOnesApply) {
+    MachineCore core;
+    startQuickWash(core);
+    core.step(1.0f);
+    core.handleEvent(Event(EventType::SYS_WATER_LEVEL_REACHED));
+    ASSERT_EQ(core.getCurrentState(), State::Washing);
+
+    core.handleEvent(Event(EventType::TIMER_TIMEOUT, -1));
+    EXPECT_EQ(core.getCurrentState(), State::Washing);
+
+    // The table has no timeout out of Washing.
+    core.handleEvent(Event(EventType::TIMER_TIMEOUT));
+    EXPECT_EQ(core.getCurrentState(), State::Washing);
+
+    core.stop();
+    ASSERT_EQ(core.getCurrentState(), State::Draining);
+    core.handleEvent(Event(EventType::TIMER_TIMEOUT));
+    EXPECT_EQ(core.getCurrentState(), State::Fault);
+    EXPECT_EQ(core.getStatus().fault, FaultCode::Timeout);
+}
+
+TEST(MachineWatchdogTest, DoorLockedTooLongAfterEmergencyStop) {
+    WaterSupply supply;
+    TimingWheel wheel;
+    MachineCore core;
+    WatchdogLimits limits;
+    limits.doorLockSeconds = 1.0f;
+    core.setWatchdogLimits(limits);
+    core.connectWaterSupply(&supply);
+    core.connectTimingWheel(&wheel);
+    startQuickWash(core);
+    for (int t = 0; t < 100 && core.getCurrentState() != State::Washing; t++) {
+        stepCore(core, supply, wheel, 1.0f);
+    }
+    ASSERT_GT(core.getStatus().waterLevel, 20.0f);
+
+    // The drum takes about two seconds to drain, longer than allowed.
+    core.emergencyStop();
+    stepCore(core, supply, wheel, 0.5f);
+    EXPECT_EQ(core.getCurrentState(), State::EmergencyStop);
+    EXPECT_EQ(core.getWatchdogKind(), WatchdogKind::DoorLock);
+    for (int t = 0; t < 10 && core.getCurrentState() != State::Fault; t++) {
+        stepCore(core, supply, wheel, 0.5f);
+    }
+    EXPECT_EQ(core.getCurrentState(), State::Fault);
+    EXPECT_EQ(core.getStatus().fault, FaultCode::Timeout);
+}
+
+TEST(MachineWatchdogTest, FleetSharesOneWheel) {
+    WaterSupply supply = stuckSupply();
+    TimingWheel wheel;
+    Fleet fleet(20);
+    fleet.connectWaterSupply(&supply);
+    fleet.connectTimingWheel(&wheel);
+    for (size_t id = 0; id < fleet.size(); id++) {
+        WashingMachine& machine = fleet.getMachine(id);
+        machine.closeDoor();
+        machine.selectMode(static_cast<int>(id % 4));
+        machine.setLoad(3.0f);
+    }
+    fleet.tick(0.1f);
+    for (size_t id = 0; id < fleet.size(); id++) {
+        fleet.getMachine(id).start();
+    }
+    fleet.tick(1.0f);
+    fleet.tick(1.0f);
+    EXPECT_EQ(wheel.getArmedCount(), 20u);
+
+    for (int t = 0; t < 600; t++) {
+        fleet.tick(1.0f);
+    }
+    for (size_t id = 0; id < fleet.size(); id++) {
+        EXPECT_EQ(fleet.getMachine(id).getStatus().fault, FaultCode::Timeout) << "machine " << id;
+    }
+    EXPECT_EQ(wheel.getExpiredCount(), 20u);
+}
+
+TEST(MachineWatchdogTest, WashingMachineUsesItsOwnWheelByDefault) {
+    WaterSupply supply = stuckSupply();
+    WashingMachine machine;
+    machine.initialize();
+    machine.setOutput(nullptr);
+    machine.connectWaterSupply(&supply);
+    machine.closeDoor();
+    machine.selectMode(0);
+    machine.setLoad(3.0f);
+    machine.tick(0.1f);
+    machine.start();
+    for (int t = 0; t < 600 && machine.getCurrentState() != State::Fault; t++) {
+        machine.tick(1.0f);
+        supply.update(1.0f);
+    }
+    EXPECT_EQ(machine.getCurrentState(), State::Fault);
+    EXPECT_EQ(machine.getStatus().fault, FaultCode::Timeout);
+    machine.shutdown();
+}
+
+TEST(MachineWatchdogTest, MachineMovesBetweenSharedAndOwnWheel) {
+    WaterSupply supply = stuckSupply();
+    TimingWheel wheel;
+    WashingMachine machine;
+    machine.initialize();
+    machine.setOutput(nullptr);
+    machine.connectWaterSupply(&supply);
+    machine.connectTimingWheel(&wheel);
+    machine.closeDoor();
+    machine.selectMode(0);
+    machine.setLoad(3.0f);
+    machine.tick(0.1f);
+    machine.start();
+    machine.tick(1.0f);
+    machine.tick(1.0f);
+    EXPECT_EQ(wheel.getArmedCount(), 1u);
+
+    machine.connectTimingWheel(nullptr);
+    EXPECT_EQ(wheel.getArmedCount(), 0u);
+    for (int t = 0; t < 600 && machine.getCurrentState() != State::Fault; t++) {
+        machine.tick(1.0f);
+        supply.update(1.0f);
+    }
+    EXPECT_EQ(machine.getStatus().fault, FaultCode::Timeout);
+    EXPECT_EQ(wheel.getExpiredCount(), 0u);
+    machine.shutdown();
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "WaterSupply.hpp"
+#include "WaterSystem.hpp"
+#include "WashingMachine.hpp"
+#include "Types.hpp"
+#include <memory>
+#include <vector>
+
+class WaterSupplyTest : public ::testing::Test {
+protected:
+    void stepFleet(WaterSupply& supply, std::vector<std::unique_ptr<WaterSystem>>& systems,
+                   float deltaTime, int ticks) {
+        for (int i = 0; i < ticks; i++) {
+            supply.update(deltaTime);
+            for (auto& system : systems) {
+                system->update(deltaTime);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<WaterSystem>> makeFleet(WaterSupply& supply, int count) {
+        std::vector<std::unique_ptr<WaterSystem>> systems;
+        for (int i = 0; i < count; i++) {
+            systems.push_back(std::make_unique<WaterSystem>());
+            systems.back()->attachSupply(&supply);
+        }
+        return systems;
+    }
+};
+
+TEST_F(WaterSupplyTest, IdleSupplyHoldsStaticPressure) {
+    WaterSupply supply;
+    supply.update(0.1f);
+
+    EXPECT_FLOAT_EQ(supply.getPressure(), 3.0f);
+    EXPECT_FLOAT_EQ(supply.getTotalFlow(), 0.0f);
+    EXPECT_TRUE(supply.hasPressure());
+}
+
+TEST_F(WaterSupplyTest, RegisterAndReleaseConsumers) {
+    WaterSupply supply;
+    size_t a = supply.registerConsumer();
+    size_t b = supply.registerConsumer();
+    EXPECT_NE(a, b);
+    EXPECT_EQ(supply.getConsumerCount(), 2u);
+
+    supply.releaseConsumer(a);
+    EXPECT_EQ(supply.getConsumerCount(), 1u);
+    EXPECT_EQ(supply.registerConsumer(), a);
+}
+
+TEST_F(WaterSupplyTest, SingleMachineFillsNearNominalRate) {
+    WaterSupply supply;
+    auto systems = makeFleet(supply, 1);
+
+    systems[0]->startFilling(20.0f);
+    stepFleet(supply, systems, 0.5f, 1);
+
+    EXPECT_GT(systems[0]->getCurrentLevel(), 4.9f);
+    EXPECT_LE(systems[0]->getCurrentLevel(), 5.0f);
+}
+
+TEST_F(WaterSupplyTest, FlowIsDividedAmongFillingMachines) {
+    WaterSupply supply(50.0f);
+    auto systems = makeFleet(supply, 20);
+
+    for (auto& system : systems) {
+        system->startFilling(40.0f);
+    }
+    stepFleet(supply, systems, 0.1f, 1);
+
+    EXPECT_EQ(supply.getActiveConsumers(), 20u);
+    EXPECT_LE(supply.getTotalFlow(), 50.0f + 1e-3f);
+    EXPECT_NEAR(systems[0]->getCurrentLevel(), 50.0f * 0.1f / 20.0f, 1e-3f);
+    EXPECT_LT(supply.getPressure(), 3.0f);
+}
+
+TEST_F(WaterSupplyTest, NonFillingMachinesDrawNothing) {
+    WaterSupply supply(50.0f);
+    auto systems = makeFleet(supply, 4);
+
+    systems[0]->startFilling(30.0f);
+    stepFleet(supply, systems, 0.1f, 1);
+
+    EXPECT_EQ(supply.getActiveConsumers(), 1u);
+    EXPECT_FLOAT_EQ(systems[1]->getCurrentLevel(), 0.0f);
+}
+
+TEST_F(WaterSupplyTest, DemandDropsWhenTargetReached) {
+    WaterSupply supply;
+    auto systems = makeFleet(supply, 1);
+
+    systems[0]->startFilling(5.0f);
+    stepFleet(supply, systems, 0.5f, 10);
+
+    EXPECT_FALSE(systems[0]->isFilling());
+    supply.update(0.5f);
+    EXPECT_EQ(supply.getActiveConsumers(), 0u);
+}
+
+TEST_F(WaterSupplyTest, SaturatedSupplyRaisesWaterUnavailable) {
+    WaterSupply supply(20.0f, 3.0f, 0.0001f, 0.3f, 2.0f);
+    auto systems = makeFleet(supply, 50);
+
+    int faults = 0;
+    for (auto& system : systems) {
+        system->setEventCallback([&](EventType type) {
+            if (type == EventType::FAULT_WATER_UNAVAILABLE) {
+                faults++;
+            }
+        });
+        system->startFilling(40.0f);
+    }
+
+    stepFleet(supply, systems, 0.5f, 3);
+    EXPECT_EQ(faults, 0);
+
+    stepFleet(supply, systems, 0.5f, 2);
+    EXPECT_EQ(faults, 50);
+    for (auto& system : systems) {
+        EXPECT_FALSE(system->isFilling());
+    }
+}
+
+TEST_F(WaterSupplyTest, ModerateLoadDoesNotFault) {
+    WaterSupply supply(100.0f);
+    auto systems = makeFleet(supply, 5);
+
+    int faults = 0;
+    for (auto& system : systems) {
+        system->setEventCallback([&](EventType type) {
+            if (type == EventType::FAULT_WATER_UNAVAILABLE) {
+                faults++;
+            }
+        });
+        system->startFilling(10.0f);
+    }
+
+    stepFleet(supply, systems, 0.5f, 20);
+    EXPECT_EQ(faults, 0);
+    for (auto& system : systems) {
+        EXPECT_FLOAT_EQ(system->getCurrentLevel(), 10.0f);
+    }
+}
+
+TEST_F(WaterSupplyTest, AttachedSystemBypassesPrivateReservoir) {
+    WaterSupply supply;
+    WaterSystem water;
+    water.attachSupply(&supply);
+    water.setReservoirLevel(0.0f);
+
+    EXPECT_TRUE(water.checkReservoir());
+    water.startFilling(10.0f);
+    EXPECT_TRUE(water.isFilling());
+
+    water.detachSupply();
+    EXPECT_FALSE(water.hasSupply());
+    EXPECT_EQ(supply.getConsumerCount(), 0u);
+}
+
+TEST_F(WaterSupplyTest, StandaloneMachineAdvancesItsSupply) {
+    WaterSupply supply;
+    WashingMachine machine;
+    machine.initialize();
+    machine.setOutput(nullptr);
+    ASSERT_TRUE(machine.connectWaterSupply(&supply));
+    machine.closeDoor();
+    machine.setLoad(3.0f);
+    machine.selectMode(0);
+    machine.tick(0.1f);
+    machine.start();
+    machine.tick(1.0f);
+    ASSERT_EQ(machine.getCurrentState(), State::Filling);
+    EXPECT_GT(supply.getTotalFlow(), 0.0f);
+
+    for (int t = 0; t < 600 && machine.getCurrentState() == State::Filling; t++) {
+        machine.tick(1.0f);
+    }
+    EXPECT_EQ(machine.getCurrentState(), State::Washing);
+}
+
+TEST_F(WaterSupplyTest, ThreadedMachineCannotShareASupply) {
+    WaterSupply supply;
+    WashingMachine machine;
+    machine.initialize();
+    machine.setOutput(nullptr);
+    ASSERT_TRUE(machine.connectWaterSupply(&supply));
+    EXPECT_FALSE(machine.run());
+
+    ASSERT_TRUE(machine.connectWaterSupply(nullptr));
+    ASSERT_TRUE(machine.run());
+    EXPECT_FALSE(machine.connectWaterSupply(&supply));
+    EXPECT_EQ(supply.getConsumerCount(), 0u);
+    machine.shutdown();
+}